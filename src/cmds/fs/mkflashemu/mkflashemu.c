@@ -39,7 +39,8 @@ int main(int argc, char **argv) {
 		}
 	}
 
-	if (argc != 2) {
+	/* Options are parsed up to the last argument, which is the name */
+	if (argc < 2 || optind != argc - 1) {
 		print_usage();
 		return 0;
 	}
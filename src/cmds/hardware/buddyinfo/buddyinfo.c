@@ -0,0 +1,68 @@
+/**
+ * @file
+ * @brief Prints fragmentation of physical memory
+ *
+ * @date 19.10.2026
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+
+#include <mem/page.h>
+#include <mem/phymem.h>
+
+static void print_usage(void) {
+	printf("Usage: buddyinfo [-h]\n");
+}
+
+static void show_stats(struct page_allocator *allocator) {
+	struct page_buddy_stats stats;
+	size_t usable;
+	int k;
+
+	page_buddy_stats(allocator, &stats);
+
+	printf("%u pages of %zu bytes, %zu free, %zu in per-CPU lists, "
+			"%lu failed allocations\n",
+			allocator->pages_n, allocator->page_size, stats.free_pages,
+			stats.hot_pages, stats.alloc_failed);
+
+	if (stats.largest_order < 0) {
+		return;
+	}
+
+	printf("order     blocks      pages unusable\n");
+
+	/* Free pages in blocks of order >= k */
+	usable = stats.free_pages;
+	for (k = 0; k <= stats.largest_order; k++) {
+		printf("%5d %10u %10zu %7zu%%\n", k, stats.free_blocks[k],
+				(size_t) stats.free_blocks[k] << k,
+				(stats.free_pages - usable) * 100 / stats.free_pages);
+		usable -= (size_t) stats.free_blocks[k] << k;
+	}
+}
+
+int main(int argc, char **argv) {
+	int opt;
+
+	while (-1 != (opt = getopt(argc, argv, "h"))) {
+		switch (opt) {
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -1;
+		}
+	}
+
+	if (!__phymem_allocator) {
+		printf("No physical memory allocator\n");
+		return -1;
+	}
+
+	show_stats(__phymem_allocator);
+
+	return 0;
+}
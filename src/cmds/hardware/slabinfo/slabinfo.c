@@ -0,0 +1,46 @@
+/**
+ * @file
+ * @brief Prints statistics of slab caches
+ *
+ * @date 19.10.2026
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mem/misc/slab.h>
+
+static void print_usage(void) {
+	printf("Usage: slabinfo [-h]\n");
+}
+
+int main(int argc, char **argv) {
+	char *buf;
+	int opt, len;
+
+	while (-1 != (opt = getopt(argc, argv, "h"))) {
+		switch (opt) {
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -1;
+		}
+	}
+
+	/* Caches can be created in between, take some more room */
+	len = cache_stats_print(NULL, 0) + 256;
+	buf = malloc(len);
+	if (!buf) {
+		return -1;
+	}
+
+	cache_stats_print(buf, len);
+	fputs(buf, stdout);
+
+	free(buf);
+
+	return 0;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file
+ * @brief Shows heap allocations by call site
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <execinfo.h>
+#include <hal/clock.h>
+#include <kernel/task.h>
+#include <kernel/task/kernel_task.h>
+#include <kernel/task/resource/task_heap.h>
+#include <kernel/time/time.h>
+#include <mem/heap_trace.h>
+#include <mem/heap/malloc_cache.h>
+#include <mem/heap/mspace_malloc.h>
+
+/* Width of the counters printed before a site */
+#define SITE_COLUMN 61
+
+enum sort_key {
+	SORT_LIVE,
+	SORT_BLOCKS,
+	SORT_ALLOCS,
+	SORT_BYTES,
+	SORT_AGE,
+};
+
+static enum sort_key sort_key;
+
+static void print_usage(void) {
+	printf("Usage: heapprof [-h] [-e] [-d] [-r] [-p PERIOD] [-n N] "
+			"[-s live|blocks|allocs|bytes|age]\n");
+}
+
+static int site_cmp(const void *a, const void *b) {
+	const struct heap_trace_site *x = a, *y = b;
+
+	switch (sort_key) {
+	case SORT_BLOCKS:
+		return (x->live_blocks < y->live_blocks)
+				- (x->live_blocks > y->live_blocks);
+	case SORT_ALLOCS:
+		return (x->allocs < y->allocs) - (x->allocs > y->allocs);
+	case SORT_BYTES:
+		return (x->alloc_bytes < y->alloc_bytes)
+				- (x->alloc_bytes > y->alloc_bytes);
+	case SORT_AGE:
+		/* Sites without live blocks are the youngest */
+		if (!x->live_blocks || !y->live_blocks) {
+			return !x->live_blocks - !y->live_blocks;
+		}
+		return (x->oldest > y->oldest) - (x->oldest < y->oldest);
+	default:
+		return (x->live_bytes < y->live_bytes)
+				- (x->live_bytes > y->live_bytes);
+	}
+}
+
+static void print_heap(const char *name, const struct task *task) {
+	struct mspace_stats st;
+
+	mspace_stats(&task_heap_get(task)->mm, &st);
+
+	printf("%s heap: %zu bytes in %d segments, %zu free, %zu cached,"
+			" largest free %zu", name, st.total, st.segments, st.free,
+			malloc_cache_bytes(task), st.largest_free);
+	if (st.free) {
+		printf(", fragmentation %zu%%",
+				100 - st.largest_free * 100 / st.free);
+	}
+	printf("\n");
+}
+
+static void print_site(const struct heap_trace_site *site, clock_t now) {
+	char sym[64];
+	int i;
+
+	printf("%9zu %6u %7zu %8lu %8lu %10llu ", site->live_bytes,
+			site->live_blocks, site->live_slack, site->allocs, site->frees,
+			site->alloc_bytes);
+	if (site->live_blocks) {
+		printf("%6lu", (unsigned long) (jiffies2ms(now - site->oldest) / 1000));
+	} else {
+		printf("%6s", "-");
+	}
+
+	/* Outer frames go under the innermost one */
+	for (i = 0; i < HEAP_TRACE_DEPTH && site->pc[i]; i++) {
+		backtrace_symbol_buf(site->pc[i], sym, sizeof(sym));
+		printf("%*s%s\n", i ? SITE_COLUMN : 1, "", sym);
+	}
+}
+
+int main(int argc, char **argv) {
+	struct heap_trace_site *sites;
+	struct heap_trace_stats st;
+	int opt, i, n, max, top = 10;
+	clock_t now;
+
+	sort_key = SORT_LIVE;
+
+	while (-1 != (opt = getopt(argc, argv, "hedrp:n:s:"))) {
+		switch (opt) {
+		case 'e':
+			heap_trace_enable(1);
+			break;
+		case 'd':
+			heap_trace_enable(0);
+			break;
+		case 'r':
+			heap_trace_reset();
+			break;
+		case 'p':
+			heap_trace_set_period(strtoul(optarg, NULL, 0));
+			break;
+		case 'n':
+			top = atoi(optarg);
+			break;
+		case 's':
+			if (!strcmp(optarg, "live")) {
+				sort_key = SORT_LIVE;
+			} else if (!strcmp(optarg, "blocks")) {
+				sort_key = SORT_BLOCKS;
+			} else if (!strcmp(optarg, "allocs")) {
+				sort_key = SORT_ALLOCS;
+			} else if (!strcmp(optarg, "bytes")) {
+				sort_key = SORT_BYTES;
+			} else if (!strcmp(optarg, "age")) {
+				sort_key = SORT_AGE;
+			} else {
+				print_usage();
+				return -1;
+			}
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -1;
+		}
+	}
+
+	heap_trace_stats(&st);
+	printf("tracing %s, 1/%u sampled, %u sites, %u live blocks, %lu dropped\n",
+			st.enabled ? "on" : "off", st.sample_period, st.sites,
+			st.live_blocks, st.dropped);
+
+	print_heap("kernel", task_kernel_task());
+	if (task_self() != task_kernel_task()) {
+		print_heap("task", task_self());
+	}
+
+	/* Sites can be added in between, take some more room */
+	max = st.sites + 8;
+	sites = malloc(max * sizeof(*sites));
+	if (!sites) {
+		return -1;
+	}
+
+	n = heap_trace_sites(sites, max);
+	now = clock_sys_ticks();
+	if (n > max) {
+		n = max;
+	}
+
+	qsort(sites, n, sizeof(*sites), site_cmp);
+
+	printf("%9s %6s %7s %8s %8s %10s %6s %s\n", "live", "blocks", "slack",
+			"allocs", "frees", "bytes", "age", "site");
+	for (i = 0; i < n && i < top; i++) {
+		print_site(&sites[i], now);
+	}
+
+	free(sites);
+
+	return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file
+ * @brief Shows lock contention by lock class
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <execinfo.h>
+#include <kernel/lockstat.h>
+
+enum sort_key {
+	SORT_WAIT,
+	SORT_CONTENDED,
+	SORT_ACQUIRED,
+	SORT_WAIT_MAX,
+	SORT_HOLD,
+	SORT_HOLD_MAX,
+};
+
+static enum sort_key sort_key;
+
+static const char *const type_names[] = {
+	[LOCKSTAT_SPIN]   = "spin",
+	[LOCKSTAT_MUTEX]  = "mutex",
+	[LOCKSTAT_RWLOCK] = "rwlock",
+	[LOCKSTAT_SCHED]  = "sched",
+};
+
+static void print_usage(void) {
+	printf("Usage: lockstat [-h] [-e] [-d] [-r] [-n N] "
+			"[-s wait|contended|acquired|waitmax|hold|holdmax]\n");
+}
+
+#define CMP_DESC(a, b) (((a) < (b)) - ((a) > (b)))
+
+static int class_cmp(const void *a, const void *b) {
+	const struct lockstat_class_info *x = a, *y = b;
+
+	switch (sort_key) {
+	case SORT_CONTENDED:
+		return CMP_DESC(x->contended, y->contended);
+	case SORT_ACQUIRED:
+		return CMP_DESC(x->acquired, y->acquired);
+	case SORT_WAIT_MAX:
+		return CMP_DESC(x->wait_max, y->wait_max);
+	case SORT_HOLD:
+		return CMP_DESC(x->hold_total, y->hold_total);
+	case SORT_HOLD_MAX:
+		return CMP_DESC(x->hold_max, y->hold_max);
+	default:
+		return CMP_DESC(x->wait_total, y->wait_total);
+	}
+}
+
+static void print_class(const struct lockstat_class_info *c) {
+	char sym[64];
+
+	printf("%-6s %9lu %9lu %12llu %10llu %12llu %10llu ",
+			type_names[c->type], c->acquired, c->contended,
+			(unsigned long long) c->wait_total,
+			(unsigned long long) c->wait_max,
+			(unsigned long long) c->hold_total,
+			(unsigned long long) c->hold_max);
+
+	if (c->site) {
+		printf("%s\n", c->site);
+	} else if (c->pc) {
+		backtrace_symbol_buf(c->pc, sym, sizeof(sym));
+		printf("init at %s\n", sym);
+	} else {
+		printf("lock %p\n", c->lock);
+	}
+}
+
+int main(int argc, char **argv) {
+	struct lockstat_class_info *classes;
+	int opt, i, n, max, top = 10;
+
+	sort_key = SORT_WAIT;
+
+	while (-1 != (opt = getopt(argc, argv, "hedrn:s:"))) {
+		switch (opt) {
+		case 'e':
+			lockstat_enable(1);
+			return 0;
+		case 'd':
+			lockstat_enable(0);
+			return 0;
+		case 'r':
+			lockstat_reset();
+			return 0;
+		case 'n':
+			top = atoi(optarg);
+			break;
+		case 's':
+			if (!strcmp(optarg, "wait")) {
+				sort_key = SORT_WAIT;
+			} else if (!strcmp(optarg, "contended")) {
+				sort_key = SORT_CONTENDED;
+			} else if (!strcmp(optarg, "acquired")) {
+				sort_key = SORT_ACQUIRED;
+			} else if (!strcmp(optarg, "waitmax")) {
+				sort_key = SORT_WAIT_MAX;
+			} else if (!strcmp(optarg, "hold")) {
+				sort_key = SORT_HOLD;
+			} else if (!strcmp(optarg, "holdmax")) {
+				sort_key = SORT_HOLD_MAX;
+			} else {
+				print_usage();
+				return -1;
+			}
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -1;
+		}
+	}
+
+	/* Classes can be added in between, take some more room */
+	n = lockstat_classes(NULL, 0);
+	max = n + 16;
+	classes = malloc(max * sizeof(*classes));
+	if (!classes) {
+		return -1;
+	}
+
+	n = lockstat_classes(classes, max);
+	if (n > max) {
+		n = max;
+	}
+
+	qsort(classes, n, sizeof(*classes), class_cmp);
+
+	printf("collecting %s, %d classes, %lu dropped\n",
+			lockstat_enabled ? "on" : "off", n, lockstat_dropped());
+	printf("%-6s %9s %9s %12s %10s %12s %10s %s\n", "type", "acquired",
+			"contended", "wait", "wait max", "hold", "hold max", "class");
+	for (i = 0; i < n && i < top; i++) {
+		print_class(&classes[i]);
+	}
+
+	if (!n) {
+		printf("No classes. Type \"lockstat -h\" for usage.\n");
+	}
+
+	free(classes);
+
+	return 0;
+}
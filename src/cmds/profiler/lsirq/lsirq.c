@@ -0,0 +1,211 @@
+/**
+ * @file
+ * @brief Shows interrupt counts and handler times
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <execinfo.h>
+#include <kernel/irq_stat.h>
+
+#define LINES_MAX    64
+#define HANDLERS_MAX 64
+
+static struct irq_stat_line_info lines[LINES_MAX];
+static struct irq_stat_handler_info handlers[HANDLERS_MAX];
+static struct irq_stat_handler_info prev[HANDLERS_MAX];
+
+static void print_usage(void) {
+	printf("Usage: lsirq [-h] [-l] [-r] [-n N] [INTERVAL]\n");
+}
+
+static int handler_cmp(const void *a, const void *b) {
+	const struct irq_stat_handler_info *x = a, *y = b;
+
+	return (x->cycles_total < y->cycles_total)
+			- (x->cycles_total > y->cycles_total);
+}
+
+static void print_handler_name(const struct irq_stat_handler_info *h) {
+	char sym[64];
+
+	backtrace_symbol_buf((void *) h->handler, sym, sizeof(sym));
+	printf("%s %s\n", sym, h->dev_name ? h->dev_name : "");
+}
+
+static void print_lines(void) {
+	int i, n;
+
+	n = irq_stat_lines(lines, LINES_MAX);
+	if (n > LINES_MAX) {
+		n = LINES_MAX;
+	}
+
+	printf("%4s %10s %10s %14s %10s\n", "irq", "count", "unhandled",
+			"cycles", "max");
+	for (i = 0; i < n; i++) {
+		printf("%4u %10lu %10lu %14llu %10llu\n", lines[i].irq_nr,
+				lines[i].count, lines[i].unhandled,
+				(unsigned long long) lines[i].cycles_total,
+				(unsigned long long) lines[i].cycles_max);
+	}
+}
+
+static void print_handlers(int top, int hist) {
+	struct irq_stat_handler_info *h;
+	int i, b, n;
+
+	n = irq_stat_handlers(handlers, HANDLERS_MAX);
+	if (n > HANDLERS_MAX) {
+		n = HANDLERS_MAX;
+	}
+	qsort(handlers, n, sizeof(handlers[0]), handler_cmp);
+	if (top >= 0 && top < n) {
+		n = top;
+	}
+
+	printf("\n%4s %10s %10s %14s %10s %s\n", "irq", "calls", "handled",
+			"cycles", "max", "handler");
+	for (i = 0; i < n; i++) {
+		h = &handlers[i];
+		printf("%4u %10lu %10lu %14llu %10llu ", h->irq_nr, h->calls,
+				h->handled, (unsigned long long) h->cycles_total,
+				(unsigned long long) h->cycles_max);
+		print_handler_name(h);
+
+		if (!hist) {
+			continue;
+		}
+		for (b = 0; b < IRQ_STAT_LAT_BUCKETS; b++) {
+			if (!h->lat_hist[b]) {
+				continue;
+			}
+			if (b < IRQ_STAT_LAT_BUCKETS - 1) {
+				printf("%16s < %-10lu %10lu\n", "latency",
+						1ul << (IRQ_STAT_LAT_SHIFT + b), h->lat_hist[b]);
+			} else {
+				printf("%16s >= %-9lu %10lu\n", "latency",
+						1ul << (IRQ_STAT_LAT_SHIFT + b - 1), h->lat_hist[b]);
+			}
+		}
+	}
+}
+
+static const struct irq_stat_handler_info *prev_find(int n,
+		const struct irq_stat_handler_info *h) {
+	int i;
+
+	for (i = 0; i < n; i++) {
+		if (prev[i].handler == h->handler && prev[i].dev_id == h->dev_id
+				&& prev[i].irq_nr == h->irq_nr) {
+			return &prev[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Leaves the increments since the previous snapshot in @c handlers and
+ * the new snapshot in @c prev, returns the number of handlers */
+static int handlers_delta(int prev_n) {
+	const struct irq_stat_handler_info *p;
+	struct irq_stat_handler_info *h;
+	int i, n;
+
+	n = irq_stat_handlers(handlers, HANDLERS_MAX);
+	if (n > HANDLERS_MAX) {
+		n = HANDLERS_MAX;
+	}
+
+	for (i = 0; i < n; i++) {
+		h = &handlers[i];
+		p = prev_find(prev_n, h);
+		if (!p || p->calls > h->calls) {
+			/* Attached or counters zeroed since the previous snapshot */
+			continue;
+		}
+		h->calls -= p->calls;
+		h->handled -= p->handled;
+		h->cycles_total -= p->cycles_total;
+	}
+
+	irq_stat_handlers(prev, HANDLERS_MAX);
+
+	return n;
+}
+
+static void irqtop(int interval, int top) {
+	struct irq_stat_handler_info *h;
+	int i, n;
+
+	n = irq_stat_handlers(prev, HANDLERS_MAX);
+	if (n > HANDLERS_MAX) {
+		n = HANDLERS_MAX;
+	}
+
+	while (1) {
+		sleep(interval);
+
+		n = handlers_delta(n);
+		qsort(handlers, n, sizeof(handlers[0]), handler_cmp);
+
+		printf("\n%4s %10s %10s %14s %10s %s\n", "irq", "calls/s",
+				"handled/s", "cycles/s", "avg", "handler");
+		for (i = 0; i < n && i < top; i++) {
+			h = &handlers[i];
+			printf("%4u %10lu %10lu %14llu %10llu ", h->irq_nr,
+					h->calls / interval, h->handled / interval,
+					(unsigned long long) h->cycles_total / interval,
+					(unsigned long long) (h->calls
+							? h->cycles_total / h->calls : 0));
+			print_handler_name(h);
+		}
+	}
+}
+
+int main(int argc, char **argv) {
+	int opt, top = -1, hist = 0, interval = 0;
+
+	while (-1 != (opt = getopt(argc, argv, "hlrn:"))) {
+		switch (opt) {
+		case 'l':
+			hist = 1;
+			break;
+		case 'r':
+			irq_stat_reset();
+			return 0;
+		case 'n':
+			top = atoi(optarg);
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	if (optind < argc) {
+		interval = atoi(argv[optind]);
+		if (interval <= 0) {
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	if (interval) {
+		irqtop(interval, top < 0 ? 10 : top);
+		return 0;
+	}
+
+	print_lines();
+	print_handlers(top, hist);
+
+	return 0;
+}
@@ -1,6 +1,6 @@
 /**
  * @file
- * @brief TODO check if profiler is running
+ * @brief Reports of the sampling profiler
  *
  * @date 15.12.2013
  * @author Denis Deryugin
@@ -8,44 +8,253 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #include <stdbool.h>
 
 #include <unistd.h>
-#include <lib/libds/array.h>
+#include <debug/symbol.h>
 #include <profiler/sampling/sample.h>
 
 typedef enum {START_PROFILING, STOP_PROFILING, SHOW_INFO} action;
+typedef enum {REPORT_FLAT, REPORT_FOLDED, REPORT_THREADS} report;
 
 struct entry {
-	int number, counter;
+	void *func;
+	int self;
 };
 
-int entry_cmp(const void *fst, const void *snd){
-	return - ((struct entry *)fst)->counter + ((struct entry *)snd)->counter;
-}
-
-int *counters;
-struct entry entries[SAMPLE_HASH_SIZE];
+struct func_count {
+	void *func;
+	int self, total;
+};
 
 static void print_usage(void) {
 	printf(	"Flags:\n"
 			"-h print usage\n"
 			"-s start profiling (discard statistics if already running)\n"
 			"-l show top N entries\n"
+			"-f print folded stacks\n"
+			"-p print samples per thread\n"
 			"-t stop profiler (do not discard information)\n"
 			"-i set custom timer interval\n");
 }
 
+/* Replaces return addresses with the start of their functions, addresses
+ * out of known symbols are kept as they are */
+static void resolve(struct sample_record *samples, int n) {
+	const struct symbol *s;
+	int i, j;
+
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < samples[i].depth; j++) {
+			/* A return address may be just past a noreturn call */
+			s = symbol_lookup(samples[i].pc[j] - 1);
+			if (s) {
+				samples[i].pc[j] = s->addr;
+			}
+		}
+	}
+}
+
+static void print_func(void *func) {
+	const struct symbol *s;
+
+	s = symbol_lookup(func);
+	if (s && s->addr == func) {
+		printf("%s", s->name);
+	} else {
+		printf("%p", func);
+	}
+}
+
+static int stack_cmp(const void *fst, const void *snd) {
+	const struct sample_record *a = fst, *b = snd;
+
+	if (a->depth != b->depth) {
+		return a->depth - b->depth;
+	}
+	return memcmp(a->pc, b->pc, a->depth * sizeof(a->pc[0]));
+}
+
+static void report_folded(struct sample_record *samples, int n) {
+	int i, j, count;
+
+	qsort(samples, n, sizeof(*samples), stack_cmp);
+
+	for (i = 0; i < n; i += count) {
+		for (count = 1; i + count < n; count++) {
+			if (stack_cmp(&samples[i], &samples[i + count])) {
+				break;
+			}
+		}
+		if (!samples[i].depth) {
+			printf("[unknown]");
+		}
+		for (j = samples[i].depth - 1; j >= 0; j--) {
+			print_func(samples[i].pc[j]);
+			if (j) {
+				putchar(';');
+			}
+		}
+		printf(" %d\n", count);
+	}
+}
+
+static int tid_cmp(const void *fst, const void *snd) {
+	return ((struct sample_record *)fst)->tid
+			- ((struct sample_record *)snd)->tid;
+}
+
+static void report_threads(struct sample_record *samples, int n) {
+	unsigned long long weight;
+	int i, count;
+
+	qsort(samples, n, sizeof(*samples), tid_cmp);
+
+	printf("%9s %9s %9s %7s %14s\n", "Thread Id", "Task Id", "Samples",
+			"", sample_source_unit());
+	for (i = 0; i < n; i += count) {
+		weight = 0;
+		for (count = 0; i + count < n; count++) {
+			if (samples[i + count].tid != samples[i].tid) {
+				break;
+			}
+			weight += samples[i + count].weight;
+		}
+		printf("%9d %9d %9d %6.2lf%% %14llu\n", samples[i].tid,
+				samples[i].task_id, count, 100.0 * count / n, weight);
+	}
+}
+
+static int entry_func_cmp(const void *fst, const void *snd) {
+	const struct entry *a = fst, *b = snd;
+
+	if (a->func != b->func) {
+		return a->func < b->func ? -1 : 1;
+	}
+	return 0;
+}
+
+static int func_count_cmp(const void *fst, const void *snd) {
+	const struct func_count *a = fst, *b = snd;
+
+	if (a->self != b->self) {
+		return b->self - a->self;
+	}
+	return b->total - a->total;
+}
+
+static int report_flat(struct sample_record *samples, int n, int limiter) {
+	struct entry *entries;
+	struct func_count *funcs;
+	int i, j, k, nentries = 0, nfuncs = 0;
+
+	entries = malloc(n * SAMPLE_DEPTH * sizeof(*entries));
+	funcs = malloc(n * SAMPLE_DEPTH * sizeof(*funcs));
+	if (!entries || !funcs) {
+		free(entries);
+		free(funcs);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < samples[i].depth; j++) {
+			/* Recursive functions are counted once per sample */
+			for (k = 0; k < j; k++) {
+				if (samples[i].pc[k] == samples[i].pc[j]) {
+					break;
+				}
+			}
+			if (k < j) {
+				continue;
+			}
+			entries[nentries].func = samples[i].pc[j];
+			entries[nentries].self = (j == 0);
+			nentries++;
+		}
+	}
+
+	qsort(entries, nentries, sizeof(*entries), entry_func_cmp);
+
+	for (i = 0; i < nentries; i++) {
+		if (!nfuncs || funcs[nfuncs - 1].func != entries[i].func) {
+			funcs[nfuncs].func = entries[i].func;
+			funcs[nfuncs].self = funcs[nfuncs].total = 0;
+			nfuncs++;
+		}
+		funcs[nfuncs - 1].self += entries[i].self;
+		funcs[nfuncs - 1].total++;
+	}
+
+	qsort(funcs, nfuncs, sizeof(*funcs), func_count_cmp);
+
+	if (limiter == 0 || limiter > nfuncs) {
+		limiter = nfuncs;
+	}
+
+	printf("%7s %7s %9s   %s\n", "Self", "Total", "Counter", "Function");
+	for (i = 0; i < limiter; i++) {
+		printf("%6.2lf%% %6.2lf%% %9d   ", 100.0 * funcs[i].self / n,
+				100.0 * funcs[i].total / n, funcs[i].total);
+		print_func(funcs[i].func);
+		printf("\n");
+	}
+
+	free(entries);
+	free(funcs);
+
+	return 0;
+}
+
+static int show_info(report rep, int limiter) {
+	struct sample_record *samples;
+	int n, res = 0;
+
+	samples = malloc(sample_capacity() * sizeof(*samples));
+	if (!samples) {
+		return -ENOMEM;
+	}
+
+	n = sample_read(samples, sample_capacity());
+	if (sample_dropped()) {
+		fprintf(stderr, "%lu oldest samples were overwritten\n",
+				sample_dropped());
+	}
+
+	if (n == 0) {
+		printf("No samples. Type \"sample -h\" for usage.\n");
+		free(samples);
+		return 0;
+	}
+
+	resolve(samples, n);
+
+	switch (rep) {
+	case REPORT_FOLDED:
+		report_folded(samples, n);
+		break;
+	case REPORT_THREADS:
+		report_threads(samples, n);
+		break;
+	default:
+		printf("Sampling information (%d samples):\n", n);
+		res = report_flat(samples, n, limiter);
+		break;
+	}
+
+	free(samples);
+
+	return res;
+}
+
 int main(int argc, char **argv) {
-	int i, total_counter = 0, total_entries = 0, limiter = 0, interval = 100;
+	int limiter = 0, interval = 100;
 	char c;
 	action act = SHOW_INFO;
+	report rep = REPORT_FLAT;
 
-	counters = get_counters();
-
-
-	while ((c = getopt(argc, argv, "hsl:ti:")) != (char) -1) {
+	while ((c = getopt(argc, argv, "hsl:tfpi:")) != (char) -1) {
 		switch (c) {
 			case 'i':
 				if (1 != sscanf(optarg, "%d", &interval)) {
@@ -63,6 +272,12 @@ int main(int argc, char **argv) {
 					return 0;
 				}
 				break;
+			case 'f':
+				rep = REPORT_FOLDED;
+				break;
+			case 'p':
+				rep = REPORT_THREADS;
+				break;
 			case 's':
 				act = START_PROFILING;
 				break;
@@ -90,30 +305,7 @@ int main(int argc, char **argv) {
 			}
 			return 0;
 		case SHOW_INFO:
-			/*if (!sampling_profiler_is_running()) {
-				printf("Profiler is not running. Type \"sample -h\" for usage.\n");
-				return 0;
-			}*/
-
-			printf("Sampling information:\n");
-			printf("%5s %10s   %s\n", "  ", "Counter", "Function");
-			for (i = 0; i < SAMPLE_HASH_SIZE; i++) {
-				total_counter += counters[i];
-				if (counters[i] != 0)
-					total_entries++;
-				entries[i].counter = counters[i];
-				entries[i].number = i;
-			}
-
-			qsort(entries, SAMPLE_HASH_SIZE, sizeof(struct entry), entry_cmp);
-
-			if (limiter == 0)
-				limiter = total_entries;
-
-			for (i = 0; i < limiter; i++) {
-				printf("%5.2lf%% %9d   %s\n", (double) 100.0 * entries[i].counter / total_counter,
-					entries[i].counter, get_name(entries[i].number));
-			}
+			return show_info(rep, limiter);
 	}
 
 	return 0;
@@ -0,0 +1,322 @@
+/**
+ * @file
+ * @brief Scheduling latency histograms from scheduler trace events
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <debug/symbol.h>
+#include <hal/cpu.h>
+#include <profiler/tracing/tracebuf.h>
+
+#define BUCKETS 40
+
+struct lat_hist {
+	unsigned long count[BUCKETS];
+	unsigned long n;
+	uint64_t max;
+};
+
+struct lat_thread {
+	uintptr_t tid;
+	uint64_t woken;      /* stamp of the pending wakeup, 0 if none */
+	uint64_t irq;        /* entry stamp of the IRQ which woke the thread */
+	struct lat_hist wakeup;
+	struct lat_hist irq_lat;
+};
+
+struct lat_cpu {
+	int irq_depth;
+	uint64_t irq_enter;
+};
+
+static struct lat_thread *threads;
+static int threads_n, threads_max;
+
+static void print_usage(void) {
+	printf("Usage: schedlat [-h] [-e] [-d] [-r] [-t TID]\n");
+}
+
+static struct lat_thread *thread_get(uintptr_t tid) {
+	struct lat_thread *t;
+	int i;
+
+	for (i = 0; i < threads_n; i++) {
+		if (threads[i].tid == tid) {
+			return &threads[i];
+		}
+	}
+
+	if (threads_n == threads_max) {
+		t = realloc(threads, (threads_max + 16) * sizeof(*t));
+		if (!t) {
+			return NULL;
+		}
+		threads = t;
+		threads_max += 16;
+	}
+
+	t = &threads[threads_n++];
+	memset(t, 0, sizeof(*t));
+	t->tid = tid;
+
+	return t;
+}
+
+static void hist_add(struct lat_hist *h, uint64_t lat) {
+	int b = 0;
+
+	while (b < BUCKETS - 1 && lat >= (2ULL << b)) {
+		b++;
+	}
+	h->count[b]++;
+	h->n++;
+	if (lat > h->max) {
+		h->max = lat;
+	}
+}
+
+static void hist_print(const char *name, struct lat_hist *h) {
+	unsigned long peak = 0;
+	int b, first, last, bar;
+
+	if (!h->n) {
+		return;
+	}
+
+	for (first = 0; !h->count[first]; first++);
+	for (last = BUCKETS - 1; !h->count[last]; last--);
+	for (b = first; b <= last; b++) {
+		if (h->count[b] > peak) {
+			peak = h->count[b];
+		}
+	}
+
+	printf("  %s, %lu samples, max %llu %s\n", name, h->n,
+			(unsigned long long) h->max, tracebuf_clock_unit());
+	for (b = first; b <= last; b++) {
+		printf("  %12llu .. %-12llu %8lu |", b ? 1ULL << b : 0ULL,
+				(2ULL << b) - 1, h->count[b]);
+		for (bar = 0; bar < 40 * h->count[b] / peak; bar++) {
+			putchar('#');
+		}
+		printf("\n");
+	}
+}
+
+static void print_id(uintptr_t id) {
+	if (id == TRACEBUF_ID_NONE) {
+		printf("%8s", "-");
+	} else {
+		printf("%8d", (int) id);
+	}
+}
+
+static void print_addr(uintptr_t addr) {
+	const struct symbol *s;
+
+	s = symbol_lookup((void *) addr);
+	if (s && s->addr == (void *) addr) {
+		printf(" %s", s->name);
+	} else {
+		printf(" %p", (void *) addr);
+	}
+}
+
+static void print_raw(const struct tracebuf_rec *r) {
+	printf("%16llu %3d ", (unsigned long long) r->stamp, r->cpu);
+
+	switch (r->event) {
+	case TRACEBUF_SCHED_SWITCH:
+		printf("switch   ");
+		print_id(r->arg1);
+		printf(" ->");
+		print_id(r->arg2);
+		printf(r->arg0 ? " (preempted)\n" : " (blocked)\n");
+		break;
+	case TRACEBUF_SCHED_WAKEUP:
+		printf("wakeup   ");
+		print_id(r->arg1);
+		printf(" by");
+		print_id(r->arg2);
+		printf(r->arg0 ? " in IRQ\n" : "\n");
+		break;
+	case TRACEBUF_WAITQ_WAKEUP:
+		printf("waitq    ");
+		print_addr(r->arg1);
+		printf(" nr %d\n", (int) r->arg0);
+		break;
+	case TRACEBUF_MUTEX_BLOCK:
+		printf("mutex blk");
+		print_addr(r->arg1);
+		printf(" held by");
+		print_id(r->arg2);
+		printf("\n");
+		break;
+	case TRACEBUF_MUTEX_ACQUIRE:
+		printf("mutex acq");
+		print_addr(r->arg1);
+		printf("\n");
+		break;
+	case TRACEBUF_MUTEX_RELEASE:
+		printf("mutex rel");
+		print_addr(r->arg1);
+		printf("\n");
+		break;
+	case TRACEBUF_IRQ_ENTER:
+		printf("irq enter %d\n", (int) r->arg0);
+		break;
+	case TRACEBUF_IRQ_EXIT:
+		printf("irq exit  %d\n", (int) r->arg0);
+		break;
+	default:
+		printf("event %d\n", r->event);
+		break;
+	}
+}
+
+static int process(const struct tracebuf_rec *recs, int n) {
+	struct lat_cpu cpus[NCPU];
+	const struct tracebuf_rec *r;
+	struct lat_thread *t;
+	int i;
+
+	memset(cpus, 0, sizeof(cpus));
+
+	for (i = 0; i < n; i++) {
+		r = &recs[i];
+		if (r->cpu >= NCPU) {
+			continue;
+		}
+
+		switch (r->event) {
+		case TRACEBUF_IRQ_ENTER:
+			if (cpus[r->cpu].irq_depth++ == 0) {
+				cpus[r->cpu].irq_enter = r->stamp;
+			}
+			break;
+		case TRACEBUF_IRQ_EXIT:
+			if (cpus[r->cpu].irq_depth > 0) {
+				cpus[r->cpu].irq_depth--;
+			}
+			break;
+		case TRACEBUF_SCHED_WAKEUP:
+			if (r->arg1 == TRACEBUF_ID_NONE) {
+				break;
+			}
+			t = thread_get(r->arg1);
+			if (!t) {
+				return -ENOMEM;
+			}
+			t->woken = r->stamp;
+			t->irq = cpus[r->cpu].irq_depth ? cpus[r->cpu].irq_enter : 0;
+			break;
+		case TRACEBUF_SCHED_SWITCH:
+			if (r->arg2 == TRACEBUF_ID_NONE) {
+				break;
+			}
+			t = thread_get(r->arg2);
+			if (!t) {
+				return -ENOMEM;
+			}
+			if (t->woken) {
+				hist_add(&t->wakeup, r->stamp - t->woken);
+			}
+			if (t->irq) {
+				hist_add(&t->irq_lat, r->stamp - t->irq);
+			}
+			t->woken = t->irq = 0;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	struct tracebuf_rec *recs, *tmp;
+	int opt, i, n, raw = 0, res;
+	long tid = -1;
+
+	while (-1 != (opt = getopt(argc, argv, "hedrt:"))) {
+		switch (opt) {
+		case 'e':
+			tracebuf_reset();
+			tracebuf_enable(1);
+			return 0;
+		case 'd':
+			tracebuf_enable(0);
+			return 0;
+		case 'r':
+			raw = 1;
+			break;
+		case 't':
+			tid = strtol(optarg, NULL, 0);
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	recs = malloc(tracebuf_capacity() * sizeof(*recs));
+	tmp = malloc(tracebuf_capacity() * sizeof(*tmp));
+	if (!recs || !tmp) {
+		free(recs);
+		free(tmp);
+		return -ENOMEM;
+	}
+
+	n = tracebuf_read(recs, tracebuf_capacity());
+	if (tracebuf_dropped()) {
+		fprintf(stderr, "%lu events dropped, the buffers were full\n",
+				tracebuf_dropped());
+	}
+	tracebuf_sort(recs, tmp, n);
+	free(tmp);
+
+	if (raw) {
+		for (i = 0; i < n; i++) {
+			print_raw(&recs[i]);
+		}
+		free(recs);
+		return 0;
+	}
+
+	res = process(recs, n);
+	free(recs);
+
+	for (i = 0; i < threads_n && !res; i++) {
+		if (tid >= 0 && threads[i].tid != tid) {
+			continue;
+		}
+		if (!threads[i].wakeup.n && !threads[i].irq_lat.n) {
+			continue;
+		}
+		printf("thread %d\n", (int) threads[i].tid);
+		hist_print("wakeup to run", &threads[i].wakeup);
+		hist_print("IRQ to run", &threads[i].irq_lat);
+	}
+
+	if (!n) {
+		printf("No events. Type \"schedlat -h\" for usage.\n");
+	}
+
+	free(threads);
+	threads = NULL;
+	threads_n = threads_max = 0;
+
+	return res;
+}
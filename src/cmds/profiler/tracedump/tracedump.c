@@ -0,0 +1,196 @@
+/**
+ * @file
+ * @brief Dumps the trace buffer as Chrome JSON or CTF
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <profiler/tracing/tracebuf.h>
+#include <profiler/tracing/tracebuf_export.h>
+
+static void print_usage(void) {
+	printf("Usage: tracedump [-h] [-e] [-d] [-r] [-f json|ctf] [-o PATH]"
+			" [-c ADDR:PORT]\n");
+}
+
+static int tcp_open(char *peer) {
+	struct sockaddr_in dst;
+	char *port;
+	int sock;
+
+	port = strchr(peer, ':');
+	if (!port) {
+		return -EINVAL;
+	}
+	*port++ = '\0';
+
+	memset(&dst, 0, sizeof(dst));
+	dst.sin_family = AF_INET;
+	dst.sin_port = htons(atoi(port));
+	if (!inet_aton(peer, &dst.sin_addr)) {
+		return -EINVAL;
+	}
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	if (connect(sock, (struct sockaddr *) &dst, sizeof(dst)) < 0) {
+		close(sock);
+		return -errno;
+	}
+
+	return sock;
+}
+
+static int ctf_file(const char *dir, const char *name,
+		const struct tracebuf_rec *recs, int n) {
+	char path[128];
+	int fd, res;
+
+	snprintf(path, sizeof(path), "%s/%s", dir, name);
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	if (recs) {
+		res = tracebuf_export_ctf_stream(fd, recs, n);
+	} else {
+		res = tracebuf_export_ctf_metadata(fd);
+	}
+
+	close(fd);
+
+	return res;
+}
+
+static int dump_ctf(const char *dir, const struct tracebuf_rec *recs, int n) {
+	int res;
+
+	if (mkdir(dir, 0755) < 0 && errno != EEXIST) {
+		return -errno;
+	}
+
+	res = ctf_file(dir, "metadata", NULL, 0);
+	if (res) {
+		return res;
+	}
+
+	return ctf_file(dir, "stream", recs, n);
+}
+
+static int dump_json(const char *path, char *peer,
+		const struct tracebuf_rec *recs, int n) {
+	int fd, res;
+
+	if (peer) {
+		fd = tcp_open(peer);
+	} else if (path) {
+		fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0) {
+			fd = -errno;
+		}
+	} else {
+		return tracebuf_export_json(STDOUT_FILENO, recs, n);
+	}
+
+	if (fd < 0) {
+		return fd;
+	}
+
+	res = tracebuf_export_json(fd, recs, n);
+	close(fd);
+
+	return res;
+}
+
+int main(int argc, char **argv) {
+	struct tracebuf_rec *recs, *tmp;
+	char *path = NULL, *peer = NULL;
+	int opt, n, ctf = 0, res;
+
+	while (-1 != (opt = getopt(argc, argv, "hedrf:o:c:"))) {
+		switch (opt) {
+		case 'e':
+			tracebuf_enable(1);
+			return 0;
+		case 'd':
+			tracebuf_enable(0);
+			return 0;
+		case 'r':
+			tracebuf_reset();
+			return 0;
+		case 'f':
+			if (!strcmp(optarg, "ctf")) {
+				ctf = 1;
+			} else if (strcmp(optarg, "json")) {
+				print_usage();
+				return -EINVAL;
+			}
+			break;
+		case 'o':
+			path = optarg;
+			break;
+		case 'c':
+			peer = optarg;
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	if (ctf && !path) {
+		fprintf(stderr, "CTF needs a directory, use -o\n");
+		return -EINVAL;
+	}
+
+	recs = malloc(tracebuf_capacity() * sizeof(*recs));
+	tmp = malloc(tracebuf_capacity() * sizeof(*tmp));
+	if (!recs || !tmp) {
+		free(recs);
+		free(tmp);
+		return -ENOMEM;
+	}
+
+	n = tracebuf_read(recs, tracebuf_capacity());
+	tracebuf_sort(recs, tmp, n);
+	free(tmp);
+
+	if (ctf) {
+		res = dump_ctf(path, recs, n);
+	} else {
+		res = dump_json(path, peer, recs, n);
+	}
+
+	free(recs);
+
+	if (res) {
+		fprintf(stderr, "tracedump: error %d\n", res);
+	} else if (path || peer) {
+		printf("%d events written\n", n);
+	}
+	if (tracebuf_dropped()) {
+		fprintf(stderr, "%lu events dropped, the buffers were full\n",
+				tracebuf_dropped());
+	}
+
+	return res;
+}
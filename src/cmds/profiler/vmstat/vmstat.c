@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @brief Prints kernel event counters
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <kernel/kcounter.h>
+
+static void print_usage(void) {
+	printf("Usage: vmstat [-h] [-n COUNT] [INTERVAL]\n");
+}
+
+static void print_totals(unsigned long *snap) {
+	const struct kcounter *kc;
+	int i = 0;
+
+	kcounter_foreach(kc) {
+		snap[i] = kcounter_read(kc);
+		printf("%-28s %12lu\n", kc->name, snap[i]);
+		i++;
+	}
+}
+
+static void print_deltas(unsigned long *snap, int interval) {
+	const struct kcounter *kc;
+	unsigned long val;
+	int i = 0;
+
+	printf("%-28s %12s %12s\n", "counter", "delta", "per sec");
+	kcounter_foreach(kc) {
+		val = kcounter_read(kc);
+		printf("%-28s %12lu %12lu\n", kc->name, val - snap[i],
+				(val - snap[i]) / interval);
+		snap[i] = val;
+		i++;
+	}
+}
+
+int main(int argc, char **argv) {
+	unsigned long *snap;
+	int opt, interval = 0, count = -1;
+
+	while (-1 != (opt = getopt(argc, argv, "hn:"))) {
+		switch (opt) {
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	if (optind < argc) {
+		interval = atoi(argv[optind]);
+		if (interval <= 0) {
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	snap = malloc((kcounter_count() + 1) * sizeof(*snap));
+	if (!snap) {
+		return -ENOMEM;
+	}
+
+	print_totals(snap);
+	if (count > 0) {
+		count--;
+	}
+
+	while (interval && count != 0) {
+		sleep(interval);
+		printf("\n");
+		print_deltas(snap, interval);
+		if (count > 0) {
+			count--;
+		}
+	}
+
+	free(snap);
+
+	return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @brief Runs microbenchmarks and prints the results as JSON
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <framework/test/bench.h>
+
+static void print_usage(void) {
+	printf("Usage: bench [-h] [-l] [-s SAMPLES] [NAME]...\n");
+}
+
+static int run_one(const struct bench *bench, int samples) {
+	struct bench_result res;
+	int ret;
+
+	ret = bench_run(bench, samples, &res);
+	if (ret) {
+		printf("{\"bench\":\"%s\",\"error\":%d}\n", bench->name, ret);
+		return ret;
+	}
+
+	bench_print_json(bench, &res);
+
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	const struct bench *bench;
+	int opt, i, samples = 31, ret = 0;
+
+	while (-1 != (opt = getopt(argc, argv, "hls:"))) {
+		switch (opt) {
+		case 'l':
+			bench_foreach(bench) {
+				printf("%s\n", bench->name);
+			}
+			return 0;
+		case 's':
+			samples = atoi(optarg);
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	if (optind == argc) {
+		bench_foreach(bench) {
+			if (run_one(bench, samples)) {
+				ret = -EIO;
+			}
+		}
+		return ret;
+	}
+
+	for (i = optind; i < argc; i++) {
+		bench = bench_lookup(argv[i]);
+		if (!bench) {
+			fprintf(stderr, "bench: no benchmark named %s\n", argv[i]);
+			ret = -ENOENT;
+			continue;
+		}
+		if (run_one(bench, samples)) {
+			ret = -EIO;
+		}
+	}
+
+	return ret;
+}
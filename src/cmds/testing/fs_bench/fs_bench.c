@@ -0,0 +1,141 @@
+/**
+ * @file
+ * @brief File system read/write throughput benchmark
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <framework/test/bench_clock.h>
+
+#define BENCH_FILE_NAME "fs_bench.dat"
+
+static void print_help(char **argv) {
+	printf("Usage: %s [-h] [-s SIZE] [-b BLOCK] [-r REPEAT] DIR...\n", argv[0]);
+}
+
+/* Returns KiB per second */
+static unsigned long throughput(uint64_t bytes, uint64_t ns) {
+	return bench_per_sec(bytes, ns) / 1024;
+}
+
+static int bench_pass(int fd, char *buf, size_t size, size_t block, int do_write) {
+	size_t done, n;
+	ssize_t ret;
+
+	if (lseek(fd, 0, SEEK_SET) != 0) {
+		return -errno;
+	}
+
+	for (done = 0; done < size; done += ret) {
+		n = size - done < block ? size - done : block;
+
+		if (do_write) {
+			ret = write(fd, buf, n);
+		} else {
+			ret = read(fd, buf, n);
+		}
+
+		if (ret <= 0) {
+			return ret < 0 ? -errno : -EIO;
+		}
+	}
+
+	return 0;
+}
+
+static int bench_dir(const char *dir, char *buf, size_t size, size_t block,
+		int repeat) {
+	char path[PATH_MAX];
+	uint64_t t_write, t_read, start;
+	int fd, err = 0;
+
+	snprintf(path, sizeof(path), "%s/%s", dir, BENCH_FILE_NAME);
+
+	fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0666);
+	if (fd < 0) {
+		printf("%s: can't create file (%d)\n", path, errno);
+		return -errno;
+	}
+
+	start = bench_time_ns();
+	for (int i = 0; i < repeat && !err; i++) {
+		err = bench_pass(fd, buf, size, block, 1);
+	}
+	t_write = bench_time_ns() - start;
+
+	start = bench_time_ns();
+	for (int i = 0; i < repeat && !err; i++) {
+		err = bench_pass(fd, buf, size, block, 0);
+	}
+	t_read = bench_time_ns() - start;
+
+	close(fd);
+	unlink(path);
+
+	if (err) {
+		printf("%s: I/O error (%d)\n", dir, err);
+		return err;
+	}
+
+	printf("%-16s write %8lu KiB/s  read %8lu KiB/s\n", dir,
+			throughput((uint64_t) size * repeat, t_write),
+			throughput((uint64_t) size * repeat, t_read));
+
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	size_t size = 4096, block = 512;
+	int repeat = 256;
+	char *buf;
+	int opt, err = 0;
+
+	while (-1 != (opt = getopt(argc, argv, "hs:b:r:"))) {
+		switch (opt) {
+		case 's':
+			size = strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			block = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			repeat = strtol(optarg, NULL, 0);
+			break;
+		case 'h':
+		default:
+			print_help(argv);
+			return 0;
+		}
+	}
+
+	if (optind >= argc || block == 0) {
+		print_help(argv);
+		return -EINVAL;
+	}
+
+	if (NULL == (buf = malloc(block))) {
+		return -ENOMEM;
+	}
+	memset(buf, 0xa5, block);
+
+	printf("file %zu bytes, block %zu bytes, %d passes\n", size, block, repeat);
+
+	for (int i = optind; i < argc; i++) {
+		if (bench_dir(argv[i], buf, size, block, repeat)) {
+			err = -EIO;
+		}
+	}
+
+	free(buf);
+
+	return err;
+}
@@ -0,0 +1,276 @@
+/**
+ * @file
+ * @brief Heap allocator latency benchmark
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <framework/test/bench_clock.h>
+#include <lib/libds/array.h>
+#include <lib/libds/bit.h>
+#include <mem/heap_bm.h>
+#include <mem/heap_tlsf.h>
+
+#define HIST_BUCKETS   14
+#define HIST_MIN_SHIFT 7 /* first bucket is below 128 ns */
+
+struct bench_heap {
+	const char *name;
+	void (*init)(void *heap, size_t size);
+	void *(*alloc)(void *heap, size_t size);
+	void (*free)(void *heap, void *ptr);
+};
+
+struct bench_lat {
+	uint32_t *ns;
+	int n;
+	int failed;
+	unsigned hist[HIST_BUCKETS];
+};
+
+struct bench_params {
+	int ops;
+	int slots;
+	size_t min_size;
+	size_t max_size;
+	size_t heap_size;
+	unsigned seed;
+};
+
+static void *bm_alloc(void *heap, size_t size) {
+	return bm_memalign(heap, 8, size);
+}
+
+static void *tlsf_alloc(void *heap, size_t size) {
+	return tlsf_memalign(heap, TLSF_ALIGN, size);
+}
+
+static const struct bench_heap bench_heaps[] = {
+	{ "heap_bm", bm_init, bm_alloc, bm_free },
+	{ "tlsf", tlsf_init, tlsf_alloc, tlsf_free },
+};
+
+static void print_help(char **argv) {
+	printf("Usage: %s [-h] [-n OPS] [-k SLOTS] [-s MIN] [-S MAX] [-H KB] "
+			"[-r SEED]\n", argv[0]);
+}
+
+/* Cost of reading the clock twice, subtracted from every sample */
+static uint64_t timer_overhead(void) {
+	uint64_t t, min = UINT64_MAX;
+	int i;
+
+	for (i = 0; i < 100; i++) {
+		t = bench_time_ns();
+		t = bench_time_ns() - t;
+		if (t < min) {
+			min = t;
+		}
+	}
+
+	return min;
+}
+
+static void lat_add(struct bench_lat *lat, uint64_t ns, uint64_t overhead) {
+	int b;
+
+	ns = ns > overhead ? ns - overhead : 0;
+	if (ns > UINT32_MAX) {
+		ns = UINT32_MAX;
+	}
+	lat->ns[lat->n++] = ns;
+
+	b = bit_fls(ns >> HIST_MIN_SHIFT);
+	if (b >= HIST_BUCKETS) {
+		b = HIST_BUCKETS - 1;
+	}
+	lat->hist[b]++;
+}
+
+static int lat_cmp(const void *a, const void *b) {
+	uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+
+	return x < y ? -1 : x > y;
+}
+
+static void lat_print(const char *what, struct bench_lat *lat) {
+	uint64_t sum = 0;
+	int i;
+
+	if (!lat->n) {
+		printf("  %-6s no samples\n", what);
+		return;
+	}
+
+	qsort(lat->ns, lat->n, sizeof(lat->ns[0]), lat_cmp);
+	for (i = 0; i < lat->n; i++) {
+		sum += lat->ns[i];
+	}
+
+	printf("  %-6s %6d ops min %6lu avg %6lu p99 %6lu max %8lu ns",
+			what, lat->n, (unsigned long) lat->ns[0],
+			(unsigned long) (sum / lat->n),
+			(unsigned long) lat->ns[(lat->n - 1) * 99 / 100],
+			(unsigned long) lat->ns[lat->n - 1]);
+	if (lat->failed) {
+		printf(", %d failed", lat->failed);
+	}
+	printf("\n");
+}
+
+static void bench_run(const struct bench_heap *bh, void *heap,
+		struct bench_params *p, void **slots,
+		struct bench_lat *lat_alloc, struct bench_lat *lat_free) {
+	uint64_t overhead, t;
+	size_t size;
+	void *ptr;
+	int i, k;
+
+	overhead = timer_overhead();
+
+	bh->init(heap, p->heap_size);
+	memset(slots, 0, p->slots * sizeof(*slots));
+	srand(p->seed);
+
+	for (i = 0; i < p->ops; i++) {
+		k = rand() % p->slots;
+
+		if (!slots[k]) {
+			size = p->min_size + rand() % (p->max_size - p->min_size + 1);
+
+			t = bench_time_ns();
+			ptr = bh->alloc(heap, size);
+			t = bench_time_ns() - t;
+
+			if (!ptr) {
+				lat_alloc->failed++;
+				continue;
+			}
+			lat_add(lat_alloc, t, overhead);
+			slots[k] = ptr;
+		} else {
+			t = bench_time_ns();
+			bh->free(heap, slots[k]);
+			t = bench_time_ns() - t;
+
+			lat_add(lat_free, t, overhead);
+			slots[k] = NULL;
+		}
+	}
+
+	for (k = 0; k < p->slots; k++) {
+		if (slots[k]) {
+			bh->free(heap, slots[k]);
+		}
+	}
+}
+
+int main(int argc, char **argv) {
+	struct bench_params p = {
+		.ops = 20000,
+		.slots = 256,
+		.min_size = 16,
+		.max_size = 1024,
+		.heap_size = 256 * 1024,
+		.seed = 1,
+	};
+	struct bench_lat lat[ARRAY_SIZE(bench_heaps)][2];
+	void *heap = NULL, **slots = NULL;
+	int opt, i, b, err = 0;
+
+	while (-1 != (opt = getopt(argc, argv, "hn:k:s:S:H:r:"))) {
+		switch (opt) {
+		case 'n':
+			p.ops = atoi(optarg);
+			break;
+		case 'k':
+			p.slots = atoi(optarg);
+			break;
+		case 's':
+			p.min_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'S':
+			p.max_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'H':
+			p.heap_size = strtoul(optarg, NULL, 0) * 1024;
+			break;
+		case 'r':
+			p.seed = strtoul(optarg, NULL, 0);
+			break;
+		case 'h':
+			print_help(argv);
+			return 0;
+		default:
+			print_help(argv);
+			return -EINVAL;
+		}
+	}
+
+	if (p.ops <= 0 || p.slots <= 0 || p.min_size == 0
+			|| p.min_size > p.max_size || p.heap_size < 16 * 1024) {
+		print_help(argv);
+		return -EINVAL;
+	}
+
+	memset(lat, 0, sizeof(lat));
+	heap = malloc(p.heap_size);
+	slots = malloc(p.slots * sizeof(*slots));
+	if (!heap || !slots) {
+		err = -ENOMEM;
+		goto out;
+	}
+	for (i = 0; i < ARRAY_SIZE(bench_heaps); i++) {
+		lat[i][0].ns = malloc(p.ops * sizeof(uint32_t));
+		lat[i][1].ns = malloc(p.ops * sizeof(uint32_t));
+		if (!lat[i][0].ns || !lat[i][1].ns) {
+			err = -ENOMEM;
+			goto out;
+		}
+	}
+
+	printf("%d ops, %d slots, %zu..%zu bytes, %zu KB heap\n", p.ops, p.slots,
+			p.min_size, p.max_size, p.heap_size / 1024);
+
+	for (i = 0; i < ARRAY_SIZE(bench_heaps); i++) {
+		bench_run(&bench_heaps[i], heap, &p, slots, &lat[i][0], &lat[i][1]);
+
+		printf("%s:\n", bench_heaps[i].name);
+		lat_print("malloc", &lat[i][0]);
+		lat_print("free", &lat[i][1]);
+	}
+
+	printf("malloc latency histogram:\n  %10s", "ns");
+	for (i = 0; i < ARRAY_SIZE(bench_heaps); i++) {
+		printf(" %8s", bench_heaps[i].name);
+	}
+	printf("\n");
+	for (b = 0; b < HIST_BUCKETS; b++) {
+		if (b < HIST_BUCKETS - 1) {
+			printf("  < %8lu", 1UL << (HIST_MIN_SHIFT + b));
+		} else {
+			printf("  >=%8lu", 1UL << (HIST_MIN_SHIFT + b - 1));
+		}
+		for (i = 0; i < ARRAY_SIZE(bench_heaps); i++) {
+			printf(" %8u", lat[i][0].hist[b]);
+		}
+		printf("\n");
+	}
+
+out:
+	for (i = 0; i < ARRAY_SIZE(bench_heaps); i++) {
+		free(lat[i][0].ns);
+		free(lat[i][1].ns);
+	}
+	free(slots);
+	free(heap);
+
+	return err;
+}
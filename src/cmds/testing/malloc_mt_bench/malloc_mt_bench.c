@@ -0,0 +1,217 @@
+/**
+ * @file
+ * @brief Multithreaded malloc throughput benchmark
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <framework/test/bench_clock.h>
+
+struct bench_params {
+	int ops;
+	int slots;
+	size_t min_size;
+	size_t max_size;
+};
+
+struct bench_thread {
+	pthread_t thread;
+	const struct bench_params *p;
+	pthread_mutex_t *start;
+	uint32_t seed;
+	int failed;
+};
+
+static void print_help(char **argv) {
+	printf("Usage: %s [-h] [-t THREADS] [-n OPS] [-k SLOTS] [-s MIN] [-S MAX]\n",
+			argv[0]);
+}
+
+/* rand() is shared and locked, threads use their own generator */
+static uint32_t bench_rand(uint32_t *seed) {
+	uint32_t x = *seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+
+	return *seed = x;
+}
+
+static void *bench_thread_run(void *arg) {
+	struct bench_thread *bt = arg;
+	const struct bench_params *p = bt->p;
+	void **slots;
+	size_t size;
+	int i, k;
+
+	slots = calloc(p->slots, sizeof(*slots));
+	if (!slots) {
+		bt->failed = p->ops;
+	}
+
+	/* Wait until all threads are created */
+	pthread_mutex_lock(bt->start);
+	pthread_mutex_unlock(bt->start);
+
+	if (!slots) {
+		return NULL;
+	}
+
+	for (i = 0; i < p->ops; i++) {
+		k = bench_rand(&bt->seed) % p->slots;
+
+		if (slots[k]) {
+			free(slots[k]);
+			slots[k] = NULL;
+			continue;
+		}
+
+		size = p->min_size + bench_rand(&bt->seed)
+				% (p->max_size - p->min_size + 1);
+		slots[k] = malloc(size);
+		if (!slots[k]) {
+			bt->failed++;
+			continue;
+		}
+		/* Touch the block as a real user would */
+		*(volatile char *) slots[k] = 0;
+	}
+
+	for (k = 0; k < p->slots; k++) {
+		free(slots[k]);
+	}
+	free(slots);
+
+	return NULL;
+}
+
+/* Returns operations per second of @a nthreads threads running together */
+static int bench_run(const struct bench_params *p, struct bench_thread *bt,
+		int nthreads, uint64_t *ops_per_sec) {
+	pthread_mutex_t start;
+	uint64_t t;
+	int i, err = 0, failed = 0;
+
+	pthread_mutex_init(&start, NULL);
+	pthread_mutex_lock(&start);
+
+	for (i = 0; i < nthreads; i++) {
+		bt[i].p = p;
+		bt[i].start = &start;
+		bt[i].seed = 2463534242U + i;
+		bt[i].failed = 0;
+		err = pthread_create(&bt[i].thread, NULL, bench_thread_run, &bt[i]);
+		if (err) {
+			/* Let the created ones go and wait for them */
+			nthreads = i;
+			break;
+		}
+	}
+
+	t = bench_time_ns();
+	pthread_mutex_unlock(&start);
+	for (i = 0; i < nthreads; i++) {
+		pthread_join(bt[i].thread, NULL);
+		failed += bt[i].failed;
+	}
+	t = bench_time_ns() - t;
+
+	pthread_mutex_destroy(&start);
+
+	if (err) {
+		return -err;
+	}
+	if (failed) {
+		printf("  %d allocations failed\n", failed);
+	}
+
+	*ops_per_sec = bench_per_sec((uint64_t) p->ops * nthreads, t);
+
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	struct bench_params p = {
+		.ops = 100000,
+		.slots = 64,
+		.min_size = 16,
+		.max_size = 256,
+	};
+	struct bench_thread *bt;
+	uint64_t ops, ops1 = 0;
+	int opt, n, nthreads, err = 0;
+
+	nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthreads < 1) {
+		nthreads = 1;
+	}
+
+	while (-1 != (opt = getopt(argc, argv, "ht:n:k:s:S:"))) {
+		switch (opt) {
+		case 't':
+			nthreads = atoi(optarg);
+			break;
+		case 'n':
+			p.ops = atoi(optarg);
+			break;
+		case 'k':
+			p.slots = atoi(optarg);
+			break;
+		case 's':
+			p.min_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'S':
+			p.max_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'h':
+			print_help(argv);
+			return 0;
+		default:
+			print_help(argv);
+			return -EINVAL;
+		}
+	}
+
+	if (nthreads <= 0 || p.ops <= 0 || p.slots <= 0 || p.min_size == 0
+			|| p.min_size > p.max_size) {
+		print_help(argv);
+		return -EINVAL;
+	}
+
+	bt = malloc(nthreads * sizeof(*bt));
+	if (!bt) {
+		return -ENOMEM;
+	}
+
+	printf("%d ops per thread, %d slots, %zu..%zu bytes\n", p.ops, p.slots,
+			p.min_size, p.max_size);
+	printf("  %7s %12s %8s\n", "threads", "ops/s", "speedup");
+
+	for (n = 1; n <= nthreads; n++) {
+		err = bench_run(&p, bt, n, &ops);
+		if (err) {
+			printf("  %7d failed to start threads: %d\n", n, err);
+			break;
+		}
+		if (n == 1) {
+			ops1 = ops;
+		}
+
+		printf("  %7d %12llu %5llu.%02llu\n", n, (unsigned long long) ops,
+				(unsigned long long) (ops1 ? ops / ops1 : 0),
+				(unsigned long long) (ops1 ? ops * 100 / ops1 % 100 : 0));
+	}
+
+	free(bt);
+
+	return err;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file
+ * @brief File system create/unlink benchmark
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <framework/test/bench_clock.h>
+
+static void print_help(char **argv) {
+	printf("Usage: %s [-h] [-n FILES] DIR...\n", argv[0]);
+}
+
+static int bench_file(char *path, size_t size, const char *dir, int i) {
+	int len;
+
+	len = snprintf(path, size, "%s/mb%d", dir, i);
+	if (len < 0 || (size_t) len >= size) {
+		return -ENAMETOOLONG;
+	}
+
+	return 0;
+}
+
+static void print_rate(const char *what, int done, uint64_t ns) {
+	printf("  %-8s %6d files %8lu ops/s %8lu us/op\n", what, done,
+			(unsigned long) bench_per_sec(done, ns),
+			(unsigned long) (done ? ns / 1000 / done : 0));
+}
+
+static int bench_dir(const char *dir, int nfiles) {
+	char path[PATH_MAX];
+	uint64_t start, t_create, t_unlink;
+	int i, fd, created, removed, err = 0;
+
+	start = bench_time_ns();
+	for (created = 0; created < nfiles; created++) {
+		if ((err = bench_file(path, sizeof(path), dir, created))) {
+			break;
+		}
+		fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0666);
+		if (fd < 0) {
+			err = -errno;
+			break;
+		}
+		close(fd);
+	}
+	t_create = bench_time_ns() - start;
+
+	start = bench_time_ns();
+	for (i = 0, removed = 0; i < created; i++) {
+		if (bench_file(path, sizeof(path), dir, i)) {
+			continue;
+		}
+		if (unlink(path) == 0) {
+			removed++;
+		} else if (!err) {
+			err = -errno;
+		}
+	}
+	t_unlink = bench_time_ns() - start;
+
+	printf("%s:\n", dir);
+	print_rate("create", created, t_create);
+	print_rate("unlink", removed, t_unlink);
+
+	if (err) {
+		printf("%s: stopped after %d files (%d)\n", dir, created, err);
+	}
+
+	return err;
+}
+
+int main(int argc, char **argv) {
+	int nfiles = 10000;
+	int opt, err = 0;
+
+	while (-1 != (opt = getopt(argc, argv, "hn:"))) {
+		switch (opt) {
+		case 'n':
+			nfiles = strtol(optarg, NULL, 0);
+			break;
+		case 'h':
+		default:
+			print_help(argv);
+			return 0;
+		}
+	}
+
+	if (optind >= argc || nfiles <= 0) {
+		print_help(argv);
+		return -EINVAL;
+	}
+
+	for (int i = optind; i < argc; i++) {
+		if (bench_dir(argv[i], nfiles)) {
+			err = -EIO;
+		}
+	}
+
+	return err;
+}
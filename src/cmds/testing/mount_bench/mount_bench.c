@@ -0,0 +1,191 @@
+/**
+ * @file
+ * @brief File system mount time benchmark
+ *
+ * @date 19.10.2026
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <framework/test/bench_clock.h>
+#include <fs/mount.h>
+
+struct mount_stat {
+	uint64_t min;
+	uint64_t max;
+	uint64_t sum;
+};
+
+static void print_help(char **argv) {
+	printf("Usage: %s [-h] [-n FILES] [-s SIZE] [-r ROUNDS] "
+			"-t FSTYPE DEV DIR\n", argv[0]);
+}
+
+/* mount() and umount() either return a negative error or set errno */
+static int fs_error(int res) {
+	if (res >= 0) {
+		return 0;
+	}
+
+	return (res == -1 && errno > 0) ? -errno : res;
+}
+
+static int populate(const char *dir, int nfiles, size_t size) {
+	char path[PATH_MAX];
+	char buf[256];
+	size_t left, n;
+	int i, fd, len;
+
+	memset(buf, 0xa5, sizeof(buf));
+
+	for (i = 0; i < nfiles; i++) {
+		len = snprintf(path, sizeof(path), "%s/mnt%d", dir, i);
+		if (len < 0 || (size_t) len >= sizeof(path)) {
+			return -ENAMETOOLONG;
+		}
+
+		fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0666);
+		if (fd < 0) {
+			return -errno;
+		}
+
+		for (left = size; left > 0; left -= n) {
+			n = left < sizeof(buf) ? left : sizeof(buf);
+			if (write(fd, buf, n) != (ssize_t) n) {
+				close(fd);
+				return -EIO;
+			}
+		}
+
+		close(fd);
+	}
+
+	return 0;
+}
+
+static int count_entries(const char *dir) {
+	DIR *d;
+	int n = 0;
+
+	d = opendir(dir);
+	if (!d) {
+		return -errno;
+	}
+
+	while (readdir(d)) {
+		n++;
+	}
+	closedir(d);
+
+	return n;
+}
+
+static void stat_add(struct mount_stat *st, uint64_t ns) {
+	if (ns < st->min) {
+		st->min = ns;
+	}
+	if (ns > st->max) {
+		st->max = ns;
+	}
+	st->sum += ns;
+}
+
+static void print_stat(const char *what, struct mount_stat *st, int rounds) {
+	printf("  %-8s min %8lu avg %8lu max %8lu us\n", what,
+			(unsigned long) (st->min / 1000),
+			(unsigned long) (st->sum / rounds / 1000),
+			(unsigned long) (st->max / 1000));
+}
+
+int main(int argc, char **argv) {
+	struct mount_stat st_mount = { .min = UINT64_MAX };
+	struct mount_stat st_umount = { .min = UINT64_MAX };
+	const char *fs_type = NULL;
+	char *dev, *dir;
+	size_t size = 4096;
+	int nfiles = 0, rounds = 5;
+	int opt, i, entries = 0, err;
+	uint64_t start;
+
+	while (-1 != (opt = getopt(argc, argv, "hn:s:r:t:"))) {
+		switch (opt) {
+		case 'n':
+			nfiles = atoi(optarg);
+			break;
+		case 's':
+			size = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			rounds = atoi(optarg);
+			break;
+		case 't':
+			fs_type = optarg;
+			break;
+		case 'h':
+			print_help(argv);
+			return 0;
+		default:
+			print_help(argv);
+			return -EINVAL;
+		}
+	}
+
+	if (!fs_type || optind + 2 != argc || nfiles < 0 || rounds <= 0) {
+		print_help(argv);
+		return -EINVAL;
+	}
+	dev = argv[optind];
+	dir = argv[optind + 1];
+
+	if (nfiles > 0) {
+		if ((err = fs_error(mount(dev, dir, fs_type)))) {
+			printf("mount %s on %s failed: %d\n", dev, dir, err);
+			return err;
+		}
+		err = populate(dir, nfiles, size);
+		umount(dir);
+		if (err) {
+			printf("populating %s failed: %d\n", dir, err);
+			return err;
+		}
+	}
+
+	for (i = 0; i < rounds; i++) {
+		start = bench_time_ns();
+		if ((err = fs_error(mount(dev, dir, fs_type)))) {
+			printf("mount %s on %s failed: %d\n", dev, dir, err);
+			return err;
+		}
+		stat_add(&st_mount, bench_time_ns() - start);
+
+		/* Lookups after mount must see the whole tree */
+		entries = count_entries(dir);
+
+		start = bench_time_ns();
+		if ((err = fs_error(umount(dir)))) {
+			printf("umount %s failed: %d\n", dir, err);
+			return err;
+		}
+		stat_add(&st_umount, bench_time_ns() - start);
+
+		if (entries < 0) {
+			printf("reading %s failed: %d\n", dir, entries);
+			return entries;
+		}
+	}
+
+	printf("%s (%s) on %s: %d rounds, %d entries\n", dev, fs_type, dir,
+			rounds, entries);
+	print_stat("mount", &st_mount, rounds);
+	print_stat("umount", &st_umount, rounds);
+
+	return 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file
+ * @brief sk_buff allocation and fragment benchmark
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <framework/test/bench_clock.h>
+#include <lib/libds/array.h>
+#include <net/skbuff.h>
+
+#define BATCH_MAX   128
+#define HDR_LEN     54   /* ethernet, IP and TCP headers */
+#define PAYLOAD_LEN 1460
+
+/* Frame sizes of a TCP stream: mostly ACKs and full frames */
+static const size_t mix_sizes[] = {
+	64, 64, 64, 64, 64, 1514, 1514, 1514, 590, 9014
+};
+
+static char payload[PAYLOAD_LEN];
+
+static void print_help(char **argv) {
+	printf("Usage: %s [-h] [-n ROUNDS] [-b BATCH]\n", argv[0]);
+}
+
+static int bench_mix(int rounds, int batch) {
+	struct sk_buff *skbs[BATCH_MAX];
+	uint64_t t, t_total = 0;
+	unsigned long long held = 0, held_single = 0;
+	unsigned long n = 0;
+	size_t size;
+	int r, i, k = 0;
+
+	for (r = 0; r < rounds; r++) {
+		t = bench_time_ns();
+		for (i = 0; i < batch; i++) {
+			size = mix_sizes[k++ % ARRAY_SIZE(mix_sizes)];
+			skbs[i] = skb_alloc(size);
+			if (skbs[i] == NULL) {
+				break;
+			}
+			held += skb_data_size(skbs[i]->data);
+			/* A single pool holds an MTU buffer for each frame which fits */
+			held_single += size <= skb_max_size() ? skb_max_size() : size;
+		}
+		batch = i;
+		for (i = 0; i < batch; i++) {
+			skb_free(skbs[i]);
+		}
+		t_total += bench_time_ns() - t;
+		n += batch;
+	}
+
+	if (!n) {
+		printf("mix: no sk_buff allocated\n");
+		return -ENOMEM;
+	}
+
+	printf("mix   : %8lu pkts/s %6lu ns/pkt data %5lu B/pkt "
+			"(single pool %5lu B/pkt)\n",
+			(unsigned long) bench_per_sec(n, t_total),
+			(unsigned long) (t_total / n), (unsigned long) (held / n),
+			(unsigned long) (held_single / n));
+
+	return 0;
+}
+
+static struct sk_buff *frame_copy(void) {
+	struct sk_buff *skb;
+
+	skb = skb_alloc(HDR_LEN + PAYLOAD_LEN);
+	if (skb != NULL) {
+		memcpy(skb->mac.raw + HDR_LEN, payload, PAYLOAD_LEN);
+	}
+
+	return skb;
+}
+
+static struct sk_buff *frame_frag(void) {
+	struct sk_buff *skb;
+
+	skb = skb_alloc(HDR_LEN);
+	if (skb != NULL && skb_add_frag(skb, payload, PAYLOAD_LEN, NULL)) {
+		skb_free(skb);
+		skb = NULL;
+	}
+
+	return skb;
+}
+
+static int bench_frames(const char *name, struct sk_buff *(*build)(void),
+		int rounds, int batch) {
+	struct sk_buff *skbs[BATCH_MAX];
+	uint64_t t, t_total = 0;
+	unsigned long n = 0;
+	int r, i;
+
+	for (r = 0; r < rounds; r++) {
+		t = bench_time_ns();
+		for (i = 0; i < batch; i++) {
+			skbs[i] = build();
+			if (skbs[i] == NULL) {
+				break;
+			}
+		}
+		batch = i;
+		for (i = 0; i < batch; i++) {
+			skb_free(skbs[i]);
+		}
+		t_total += bench_time_ns() - t;
+		n += batch;
+	}
+
+	if (!n) {
+		printf("%s: no sk_buff built\n", name);
+		return -ENOMEM;
+	}
+
+	printf("%s: %8lu pkts/s %6lu ns/pkt\n", name,
+			(unsigned long) bench_per_sec(n, t_total),
+			(unsigned long) (t_total / n));
+
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	int rounds = 1000, batch = 32;
+	int opt, err;
+
+	while (-1 != (opt = getopt(argc, argv, "hn:b:"))) {
+		switch (opt) {
+		case 'n':
+			rounds = atoi(optarg);
+			break;
+		case 'b':
+			batch = atoi(optarg);
+			break;
+		case 'h':
+			print_help(argv);
+			return 0;
+		default:
+			print_help(argv);
+			return -EINVAL;
+		}
+	}
+
+	if (rounds <= 0 || batch <= 0 || batch > BATCH_MAX) {
+		print_help(argv);
+		return -EINVAL;
+	}
+
+	printf("%d rounds of %d sk_buffs\n", rounds, batch);
+
+	err = bench_mix(rounds, batch);
+	if (err) {
+		return err;
+	}
+	err = bench_frames("copy  ", frame_copy, rounds, batch);
+	if (err) {
+		return err;
+	}
+
+	return bench_frames("frag  ", frame_frag, rounds, batch);
+}
@@ -0,0 +1,184 @@
+/**
+ * @file
+ * @brief Path lookup benchmark for deep paths and large directories
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <framework/test/bench_clock.h>
+
+#define BENCH_DIR_NAME "stat_bench"
+
+static char deep_path[PATH_MAX];
+static char wide_path[PATH_MAX];
+
+static void print_help(char **argv) {
+	printf("Usage: %s [-h] [-d DEPTH] [-n FILES] [-r REPEAT] DIR\n", argv[0]);
+}
+
+/* Path of the file number @i in the large directory */
+static char *wide_file(char *buf, char prefix, int i) {
+	if (snprintf(buf, PATH_MAX, "%s/%c%d", wide_path, prefix, i) >= PATH_MAX) {
+		buf[0] = '\0';
+	}
+	return buf;
+}
+
+static void report(const char *what, uint64_t ns, unsigned long calls) {
+	if (calls == 0) {
+		calls = 1;
+	}
+	printf("%-24s %8lu ns/stat\n", what, (unsigned long) (ns / calls));
+}
+
+static int make_tree(const char *dir, int depth, int files) {
+	char path[PATH_MAX];
+	size_t len;
+	int fd, i;
+
+	len = snprintf(deep_path, sizeof(deep_path), "%s/%s", dir, BENCH_DIR_NAME);
+	if (len >= sizeof(deep_path)) {
+		return -ENAMETOOLONG;
+	}
+	if (mkdir(deep_path, 0777)) {
+		return -errno;
+	}
+
+	if (snprintf(wide_path, sizeof(wide_path), "%s/wide", deep_path)
+			>= sizeof(wide_path)) {
+		return -ENAMETOOLONG;
+	}
+	if (mkdir(wide_path, 0777)) {
+		return -errno;
+	}
+
+	for (i = 0; i < depth; i++) {
+		len += snprintf(deep_path + len, sizeof(deep_path) - len, "/d%d", i);
+		if (len >= sizeof(deep_path)) {
+			return -ENAMETOOLONG;
+		}
+		if (mkdir(deep_path, 0777)) {
+			return -errno;
+		}
+	}
+
+	for (i = 0; i < files; i++) {
+		fd = open(wide_file(path, 'f', i), O_CREAT | O_WRONLY, 0666);
+		if (fd < 0) {
+			return -errno;
+		}
+		close(fd);
+	}
+
+	return 0;
+}
+
+static void remove_tree(const char *dir, int files) {
+	char path[PATH_MAX];
+	char *slash;
+	int i;
+
+	for (i = 0; i < files; i++) {
+		unlink(wide_file(path, 'f', i));
+	}
+	rmdir(wide_path);
+
+	snprintf(path, sizeof(path), "%s/%s", dir, BENCH_DIR_NAME);
+	while (strlen(deep_path) > strlen(path)) {
+		rmdir(deep_path);
+		slash = strrchr(deep_path, '/');
+		*slash = '\0';
+	}
+	rmdir(path);
+}
+
+int main(int argc, char **argv) {
+	char path[PATH_MAX];
+	struct stat st;
+	int depth = 16, files = 64, repeat = 100;
+	uint64_t start;
+	int opt, err, i, j;
+
+	while (-1 != (opt = getopt(argc, argv, "hd:n:r:"))) {
+		switch (opt) {
+		case 'd':
+			depth = strtol(optarg, NULL, 0);
+			break;
+		case 'n':
+			files = strtol(optarg, NULL, 0);
+			break;
+		case 'r':
+			repeat = strtol(optarg, NULL, 0);
+			break;
+		case 'h':
+		default:
+			print_help(argv);
+			return 0;
+		}
+	}
+
+	if (optind >= argc || depth < 0 || files < 1 || repeat < 1) {
+		print_help(argv);
+		return -EINVAL;
+	}
+
+	err = make_tree(argv[optind], depth, files);
+	if (err) {
+		printf("%s: can't create test tree (%d)\n", argv[optind], err);
+		remove_tree(argv[optind], files);
+		return err;
+	}
+
+	printf("depth %d, %d files, %d passes\n", depth, files, repeat);
+
+	start = bench_time_ns();
+	for (i = 0; i < repeat; i++) {
+		if (stat(deep_path, &st)) {
+			err = -errno;
+			break;
+		}
+	}
+	report("deep path", bench_time_ns() - start, repeat);
+
+	start = bench_time_ns();
+	for (i = 0; i < repeat && !err; i++) {
+		for (j = 0; j < files; j++) {
+			if (stat(wide_file(path, 'f', j), &st)) {
+				err = -errno;
+				break;
+			}
+		}
+	}
+	report("large directory", bench_time_ns() - start,
+			(unsigned long) repeat * files);
+
+	start = bench_time_ns();
+	for (i = 0; i < repeat && !err; i++) {
+		for (j = 0; j < files; j++) {
+			if (!stat(wide_file(path, 'x', j), &st)) {
+				err = -EEXIST;
+				break;
+			}
+		}
+	}
+	report("missing in large dir", bench_time_ns() - start,
+			(unsigned long) repeat * files);
+
+	remove_tree(argv[optind], files);
+
+	if (err) {
+		printf("stat failed (%d)\n", err);
+	}
+
+	return err;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @brief Throughput of stdio with different buffering
+ *
+ * @date 19.10.2026
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <framework/test/bench_clock.h>
+#include <lib/libds/array.h>
+
+struct bench_mode {
+	const char *name;
+	int type;
+	size_t size;
+};
+
+static const struct bench_mode bench_modes[] = {
+	{ "unbuffered", _IONBF, 0 },
+	{ "default",    -1,     0 },
+	{ "4K",         _IOFBF, 4096 },
+	{ "16K",        _IOFBF, 16384 },
+};
+
+static const char *bench_words[] = {
+	"lorem", "ipsum", "dolor", "sit", "amet", "consectetur",
+	"adipiscing", "elit", "sed", "do", "eiusmod", "tempor",
+};
+
+static void print_help(char **argv) {
+	printf("Usage: %s [-h] [-s KB] [FILE]\n", argv[0]);
+}
+
+static int bench_setbuf(FILE *f, const struct bench_mode *mode) {
+	if (mode->type < 0) {
+		return 0;
+	}
+
+	return setvbuf(f, NULL, mode->type, mode->size);
+}
+
+/* Lines of random words, @a size bytes in total */
+static int bench_write(const char *path, size_t size,
+		const struct bench_mode *mode) {
+	char line[96];
+	size_t done = 0, len;
+	unsigned seed = 1;
+	FILE *f;
+	int n;
+
+	f = fopen(path, "w");
+	if (!f) {
+		return -errno;
+	}
+	bench_setbuf(f, mode);
+
+	while (done < size) {
+		len = 0;
+		for (n = 0; n < 10; n++) {
+			seed = seed * 1103515245 + 12345;
+			len += sprintf(line + len, "%s ",
+					bench_words[(seed >> 16) % ARRAY_SIZE(bench_words)]);
+		}
+		line[len - 1] = '\n';
+		if (len > size - done) {
+			len = size - done;
+			line[len] = '\0';
+		}
+		if (fputs(line, f) < 0) {
+			fclose(f);
+			return -EIO;
+		}
+		done += len;
+	}
+
+	return fclose(f);
+}
+
+/* Same counting as wc does */
+static int bench_wc(const char *path, const struct bench_mode *mode,
+		size_t *lines, size_t *words, size_t *bytes) {
+	int c, in_word = 0;
+	FILE *f;
+
+	f = fopen(path, "r");
+	if (!f) {
+		return -errno;
+	}
+	bench_setbuf(f, mode);
+
+	*lines = *words = *bytes = 0;
+	while ((c = fgetc(f)) != EOF) {
+		(*bytes)++;
+		if (c == '\n') {
+			(*lines)++;
+		}
+		if (isspace(c)) {
+			in_word = 0;
+		} else if (!in_word) {
+			in_word = 1;
+			(*words)++;
+		}
+	}
+
+	return fclose(f);
+}
+
+static void print_result(const char *what, const struct bench_mode *mode,
+		size_t size, uint64_t ns) {
+	printf("%-6s %-11s %8lu ms %8lu KB/s\n", what, mode->name,
+			(unsigned long) (ns / 1000000),
+			(unsigned long) (bench_per_sec(size, ns) / 1024));
+}
+
+int main(int argc, char **argv) {
+	const char *path = "/tmp/stdio_bench.txt";
+	size_t size = 4096 * 1024;
+	size_t lines, words, bytes;
+	uint64_t t;
+	int opt, i, err = 0;
+
+	while (-1 != (opt = getopt(argc, argv, "hs:"))) {
+		switch (opt) {
+		case 's':
+			size = strtoul(optarg, NULL, 0) * 1024;
+			break;
+		case 'h':
+			print_help(argv);
+			return 0;
+		default:
+			print_help(argv);
+			return -EINVAL;
+		}
+	}
+
+	if (optind < argc) {
+		path = argv[optind];
+	}
+
+	if (size == 0) {
+		print_help(argv);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(bench_modes); i++) {
+		t = bench_time_ns();
+		err = bench_write(path, size, &bench_modes[i]);
+		t = bench_time_ns() - t;
+		if (err) {
+			printf("%s: write failed: %d\n", path, err);
+			goto out;
+		}
+		print_result("write", &bench_modes[i], size, t);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(bench_modes); i++) {
+		t = bench_time_ns();
+		err = bench_wc(path, &bench_modes[i], &lines, &words, &bytes);
+		t = bench_time_ns() - t;
+		if (err) {
+			printf("%s: read failed: %d\n", path, err);
+			goto out;
+		}
+		print_result("wc", &bench_modes[i], size, t);
+	}
+
+	printf("%zu lines, %zu words, %zu bytes\n", lines, words, bytes);
+
+out:
+	unlink(path);
+
+	return err;
+}
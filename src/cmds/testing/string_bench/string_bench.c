@@ -0,0 +1,196 @@
+/**
+ * @file
+ * @brief Throughput benchmark of memcpy and friends
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <framework/test/bench_clock.h>
+#include <lib/libds/array.h>
+
+/* Misalignment of destination and source */
+static const struct {
+	int dst;
+	int src;
+} bench_aligns[] = {
+	{ 0, 0 }, { 1, 1 }, { 0, 1 }, { 3, 0 },
+};
+
+enum bench_op {
+	OP_MEMCPY,
+	OP_MEMMOVE,
+	OP_MEMSET,
+	OP_STRLEN,
+	OP_MEMCHR,
+};
+
+static const char *bench_op_names[] = {
+	"memcpy", "memmove", "memset", "strlen", "memchr",
+};
+
+static void print_help(char **argv) {
+	printf("Usage: %s [-h] [-k KB] [-m MAX]\n", argv[0]);
+}
+
+/* References a compiler can't turn into library calls: every access is
+ * volatile, which is what a byte-at-a-time implementation costs. */
+static void byte_op(enum bench_op op, volatile char *dst,
+		volatile const char *src, size_t n) {
+	size_t i;
+
+	switch (op) {
+	case OP_MEMCPY:
+		for (i = 0; i < n; i++) {
+			dst[i] = src[i];
+		}
+		break;
+	case OP_MEMMOVE:
+		for (i = n; i > 0; i--) {
+			dst[i - 1] = src[i - 1];
+		}
+		break;
+	case OP_MEMSET:
+		for (i = 0; i < n; i++) {
+			dst[i] = 0x5a;
+		}
+		break;
+	case OP_STRLEN:
+	case OP_MEMCHR:
+		for (i = 0; src[i] != '\0'; i++)
+			;
+		break;
+	}
+}
+
+static size_t lib_op(enum bench_op op, char *dst, const char *src, size_t n) {
+	switch (op) {
+	case OP_MEMCPY:
+		memcpy(dst, src, n);
+		break;
+	case OP_MEMMOVE:
+		memmove(dst, src, n);
+		break;
+	case OP_MEMSET:
+		memset(dst, 0x5a, n);
+		break;
+	case OP_STRLEN:
+		return strlen(src);
+	case OP_MEMCHR:
+		return (size_t) memchr(src, '\0', n + 1);
+	}
+
+	return 0;
+}
+
+/* Returns MB/s */
+static unsigned long bench_one(enum bench_op op, int lib, char *buf,
+		size_t size, int dst_off, int src_off, size_t total) {
+	volatile size_t sink = 0;
+	char *dst, *src;
+	uint64_t t;
+	size_t iters, i;
+
+	src = buf + src_off;
+	if (op == OP_MEMMOVE) {
+		/* Overlapping, so it has to go backwards */
+		dst = src + 8 + dst_off;
+	} else {
+		dst = buf + 2 * size + 64 + dst_off;
+	}
+
+	/* Search functions look for the terminating zero */
+	memset(src, 'a', size);
+	src[size] = '\0';
+
+	iters = total / size;
+	if (iters == 0) {
+		iters = 1;
+	}
+
+	t = bench_time_ns();
+	for (i = 0; i < iters; i++) {
+		if (lib) {
+			sink += lib_op(op, dst, src, size);
+		} else {
+			byte_op(op, dst, src, size);
+		}
+	}
+	t = bench_time_ns() - t;
+	(void) sink;
+
+	if (t == 0) {
+		t = 1;
+	}
+	/* bytes per ns * 1000 = MB/s */
+	return (unsigned long) ((uint64_t) iters * size * 1000 / t);
+}
+
+int main(int argc, char **argv) {
+	size_t total = 4096 * 1024, max = 65536, size;
+	unsigned long lib_mbs, byte_mbs;
+	char *buf;
+	int opt, op, a;
+
+	while (-1 != (opt = getopt(argc, argv, "hk:m:"))) {
+		switch (opt) {
+		case 'k':
+			total = strtoul(optarg, NULL, 0) * 1024;
+			break;
+		case 'm':
+			max = strtoul(optarg, NULL, 0);
+			break;
+		case 'h':
+			print_help(argv);
+			return 0;
+		default:
+			print_help(argv);
+			return -EINVAL;
+		}
+	}
+
+	if (total == 0 || max < 8) {
+		print_help(argv);
+		return -EINVAL;
+	}
+
+	buf = malloc(3 * max + 128);
+	if (!buf) {
+		return -ENOMEM;
+	}
+
+	printf("%-8s %7s %4s %4s %9s %9s %7s\n", "func", "size", "dst", "src",
+			"MB/s", "byte MB/s", "speedup");
+
+	for (op = OP_MEMCPY; op <= OP_MEMCHR; op++) {
+		for (size = 8; size <= max; size *= 8) {
+			for (a = 0; a < ARRAY_SIZE(bench_aligns); a++) {
+				/* Only the source matters for search functions */
+				if (op >= OP_STRLEN && bench_aligns[a].dst) {
+					continue;
+				}
+
+				lib_mbs = bench_one(op, 1, buf, size, bench_aligns[a].dst,
+						bench_aligns[a].src, total);
+				byte_mbs = bench_one(op, 0, buf, size, bench_aligns[a].dst,
+						bench_aligns[a].src, total);
+
+				printf("%-8s %7zu %4d %4d %9lu %9lu %6lu.%lux\n",
+						bench_op_names[op], size, bench_aligns[a].dst,
+						bench_aligns[a].src, lib_mbs, byte_mbs,
+						byte_mbs ? lib_mbs / byte_mbs : 0,
+						byte_mbs ? lib_mbs * 10 / byte_mbs % 10 : 0);
+			}
+		}
+	}
+
+	free(buf);
+
+	return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @brief Thread create/join throughput benchmark
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <framework/test/bench_clock.h>
+#include <util/err.h>
+#include <lib/libds/array.h>
+#include <kernel/thread.h>
+
+#define BATCH_MAX 64
+
+static const size_t default_stacks[] = { 4096, 8192, 16384 };
+
+static void print_help(char **argv) {
+	printf("Usage: %s [-h] [-n ROUNDS] [-b BATCH] [-s KB]\n", argv[0]);
+}
+
+static void *bench_thread_run(void *arg) {
+	return arg;
+}
+
+static int bench_run(size_t stack_sz, int rounds, int batch) {
+	struct thread *threads[BATCH_MAX];
+	uint64_t t, t_create = 0, t_join = 0;
+	int r, i, n = 0, err = 0;
+
+	for (r = 0; r < rounds && !err; r++) {
+		t = bench_time_ns();
+		for (i = 0; i < batch; i++) {
+			threads[i] = thread_create_with_stack(0, stack_sz,
+					bench_thread_run, NULL);
+			if (ptr2err(threads[i])) {
+				err = ptr2err(threads[i]);
+				break;
+			}
+		}
+		t_create += bench_time_ns() - t;
+
+		t = bench_time_ns();
+		batch = i;
+		for (i = 0; i < batch; i++) {
+			thread_join(threads[i], NULL);
+		}
+		t_join += bench_time_ns() - t;
+
+		n += batch;
+	}
+
+	if (!n) {
+		printf("%6zu KB: no threads created, error %d\n", stack_sz / 1024, err);
+		return err;
+	}
+
+	printf("%6zu KB: %6d threads %8lu threads/s create %6lu ns join %6lu ns\n",
+			stack_sz / 1024, n,
+			(unsigned long) bench_per_sec(n, t_create + t_join),
+			(unsigned long) (t_create / n), (unsigned long) (t_join / n));
+	if (err) {
+		printf("stopped after error %d\n", err);
+	}
+
+	return err;
+}
+
+int main(int argc, char **argv) {
+	int rounds = 200, batch = 4;
+	size_t stack_sz = 0;
+	int opt, i, err;
+
+	while (-1 != (opt = getopt(argc, argv, "hn:b:s:"))) {
+		switch (opt) {
+		case 'n':
+			rounds = atoi(optarg);
+			break;
+		case 'b':
+			batch = atoi(optarg);
+			break;
+		case 's':
+			stack_sz = strtoul(optarg, NULL, 0) * 1024;
+			break;
+		case 'h':
+			print_help(argv);
+			return 0;
+		default:
+			print_help(argv);
+			return -EINVAL;
+		}
+	}
+
+	if (rounds <= 0 || batch <= 0 || batch > BATCH_MAX) {
+		print_help(argv);
+		return -EINVAL;
+	}
+
+	printf("%d rounds of %d threads\n", rounds, batch);
+
+	if (stack_sz) {
+		return bench_run(stack_sz, rounds, batch);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(default_stacks); i++) {
+		err = bench_run(default_stacks[i], rounds, batch);
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
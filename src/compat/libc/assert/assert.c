@@ -43,12 +43,14 @@ static void print_oops(void) {
 
 void __assertion_handle_failure(const struct __assertion_point *point) {
 	if (cpudata_var(assert_recursive_lock)) {
+		printk_flush();
 		printk("\nrecursion detected on CPU %d\n", cpu_get_id());
 		goto out;
 	}
 	cpudata_var(assert_recursive_lock) = 1;
 
 	spin_lock_ipl_disable(&assert_lock);
+	printk_flush();
 
 #if BANNER_PRINT
 	print_oops();
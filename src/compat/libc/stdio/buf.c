@@ -6,6 +6,7 @@
  * @date    24.11.2014
  */
 
+#include <fcntl.h>
 #include "file_struct.h"
 
 #include <stdio.h>
@@ -17,10 +18,24 @@ int setvbuf(FILE *stream, char *buf, int mode, size_t size) {
 	}
 
 	fflush(stream);
-
-	stream->obuf = buf;
-	stream->obuf_sz = size;
-	stream->obuf_len = 0;
+	stdio_buf_release(stream);
+
+	stream->buftype = mode;
+	stream->obuf = stream->ibuf = NULL;
+	stream->obuf_len = stream->ibuf_len = stream->ibuf_pos = 0;
+
+	/* Without a buffer given, one of @a size is allocated on first use */
+	stream->obuf_sz = stream->ibuf_sz = (mode == _IONBF) ? 0 : size;
+
+	if (mode != _IONBF && buf) {
+		/* A stream open for both reading and writing gets the
+		 * buffer for output, the input one is allocated */
+		if ((stream->flags & O_ACCESS_MASK) == O_RDONLY) {
+			stream->ibuf = buf;
+		} else {
+			stream->obuf = buf;
+		}
+	}
 
 	return 0;
 }
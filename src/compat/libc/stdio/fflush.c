@@ -6,7 +6,6 @@
  * @date    24.11.2014
  */
 
-#include <fcntl.h>
 #include "file_struct.h"
 
 #include <errno.h>
@@ -23,9 +22,14 @@ int fflush(FILE *stream) {
 		return EOF;
 	}
 
-	if (stream->flags & O_WRONLY) {
+	if (stream->obuf_len) {
 		libc_ob_forceflush(stream);
 	}
 
+	/* The file position goes back to what was actually consumed */
+	if (stream->ibuf_len) {
+		stdio_ibuf_drop(stream);
+	}
+
 	return 0;
 }
@@ -8,9 +8,16 @@
  */
 
 #include <stdio.h>
+#include "file_struct.h"
 
 int fgetc(FILE *file) {
 	unsigned char ch;
+
+	/* Fast path, the character is already read ahead */
+	if (file && !file->has_ungetc && file->ibuf_pos < file->ibuf_len) {
+		return ((unsigned char *) file->ibuf)[file->ibuf_pos++];
+	}
+
 	if (fread(&ch, 1, 1, file) != 1) {
 		return EOF;
 	}
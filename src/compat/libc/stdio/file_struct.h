@@ -27,10 +27,29 @@ struct file_struct {
 	void *obuf;
 	int obuf_sz;
 	int obuf_len;
+
+	/* Data read ahead and not consumed yet is ibuf[ibuf_pos..ibuf_len) */
+	void *ibuf;
+	int ibuf_sz;
+	int ibuf_pos;
+	int ibuf_len;
+
+	/* Buffers allocated by stdio itself, freed with the stream */
+	char obuf_own;
+	char ibuf_own;
 };
 
 extern int funopen_check(FILE *f);
 
+/* Allocate a default buffer if the stream is buffered and has none yet */
+extern void stdio_ibuf_alloc(FILE *f);
+extern void stdio_obuf_alloc(FILE *f);
+/* Free buffers allocated by stdio */
+extern void stdio_buf_release(FILE *f);
+/* Forget read ahead data moving the file position back to where the
+ * reader is */
+extern void stdio_ibuf_drop(FILE *f);
+
 #define IO_EOF_		   	0x0010  /* To check if EOF is seen*/
 #define IO_ERR_		   	0x0020  /* To check if an error is seen*/
 #define SET_IO_EOF(fp)		((fp)->flags |= IO_EOF_) /*Sets the field 0x0010*/
@@ -17,8 +17,12 @@
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 
+#include <framework/mod/options.h>
+
 #define DEFAULT_MODE (S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH) /* 0666 */
 
+#define FOPEN_BUFFERED OPTION_GET(BOOLEAN,buffered)
+
 extern FILE *stdio_file_alloc(int fd);
 
 static int mode2flag(const char *mode) {
@@ -80,6 +84,10 @@ FILE *fopen(const char *path, const char *mode) {
 	}
 
 	file->flags = flags;
+	if (FOPEN_BUFFERED) {
+		/* Buffers are allocated on first use */
+		file->buftype = isatty(fd) ? _IOLBF : _IOFBF;
+	}
 
 	return file;
 
@@ -120,6 +128,9 @@ FILE *freopen(const char *path, const char *mode, FILE *file) {
 	}
 	old_fd = file->fd;
 
+	/* Read ahead data belongs to the old file */
+	file->ibuf_pos = file->ibuf_len = 0;
+
 	dup2(fd, old_fd);
 	file->flags = flags;
 	clearerr(file); /* redundant but just-in-case */
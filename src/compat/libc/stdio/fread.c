@@ -7,20 +7,28 @@
 
 #include <errno.h>
 #include <stddef.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <util/math.h>
 #include "file_struct.h"
 
 #include <stdio.h>
 
+extern int libc_ob_forceflush(FILE *file);
+
 static size_t __fread(FILE *file, void *buf, size_t len) {
-	size_t cnt;
+	int cnt;
 
 	if (funopen_check(file)) {
 		cnt = (file->readfn) ? file->readfn((void *) file->cookie, buf, len) : 0;
 	} else {
 		cnt = read(file->fd,  buf, len);
 	}
+	if (cnt < 0) {
+		file->flags |= IO_ERR_;
+		return 0;
+	}
 	if (cnt == 0) {
 		file->flags |= IO_EOF_;
 		return 0;
@@ -28,6 +36,14 @@ static size_t __fread(FILE *file, void *buf, size_t len) {
 	return cnt;
 }
 
+/* Read as much as one read() gives into the input buffer */
+static size_t ib_fill(FILE *file) {
+	file->ibuf_pos = 0;
+	file->ibuf_len = __fread(file, file->ibuf, file->ibuf_sz);
+
+	return file->ibuf_len;
+}
+
 size_t fread(void *buf, size_t size, size_t count, FILE *file) {
 	char *cbuff = buf;
 	size_t len = size * count, l = len, ret;
@@ -42,17 +58,46 @@ size_t fread(void *buf, size_t size, size_t count, FILE *file) {
 		return 0;
 	}
 
+	if (!len) {
+		return 0;
+	}
+
+	/* Switching from writing to reading */
+	if (file->obuf_len) {
+		libc_ob_forceflush(file);
+	}
+
 	if (file->has_ungetc) {
 		file->has_ungetc = 0;
 		*cbuff++ = (char)file->ungetc;
 		l--;
 	}
-	for (; l; l -= ret, cbuff += ret ) {
-		ret = (file->flags & IO_EOF_) ? 0 : __fread(file, cbuff, l);
-		if (!ret) {
-			return (len - l) / size;
+
+	stdio_ibuf_alloc(file);
+
+	for (; l; l -= ret, cbuff += ret) {
+		if (file->ibuf_pos < file->ibuf_len) {
+			ret = min(l, file->ibuf_len - file->ibuf_pos);
+			memcpy(cbuff, file->ibuf + file->ibuf_pos, ret);
+			file->ibuf_pos += ret;
+			continue;
+		}
+
+		if (file->flags & (IO_EOF_ | IO_ERR_)) {
+			break;
+		}
+
+		/* Large requests go around the buffer */
+		if (!file->ibuf || l >= file->ibuf_sz) {
+			ret = __fread(file, cbuff, l);
+		} else {
+			ret = 0;
+			ib_fill(file);
+			if (!file->ibuf_len) {
+				break;
+			}
 		}
 	}
 
-	return count;
+	return (len - l) / size;
 }
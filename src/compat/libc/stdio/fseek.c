@@ -27,6 +27,9 @@ int fseek(FILE *file, long int offset, int origin) {
 		return -1;
 	}
 
+	/* Write out buffered data and move back over read ahead one */
+	fflush(file);
+
 	ret = lseek(file->fd, offset, origin);
 	if (ret == (off_t)-1) {
 		return -1;
@@ -42,12 +45,26 @@ int fseeko(FILE *file, off_t offset, int origin) {
 	return fseek(file, offset, origin);
 }
 
+/* Position of the stream taking into account data held in buffers */
+static off_t stream_pos(FILE *file) {
+	off_t pos;
+
+	pos = lseek(file->fd, 0L, SEEK_CUR);
+	if (pos == (off_t)-1) {
+		return -1;
+	}
+
+	/* A char pushed back by ungetc() is read before the buffer */
+	return pos - (file->ibuf_len - file->ibuf_pos) + file->obuf_len
+			- (file->has_ungetc ? 1 : 0);
+}
+
 long int ftell(FILE *file) {
 	if (NULL == file) {
 		SET_ERRNO(EBADF);
 		return -1;
 	}
-	return lseek(file->fd, 0L, SEEK_CUR);
+	return stream_pos(file);
 }
 
 off_t ftello(FILE *file) {
@@ -62,7 +79,7 @@ int fgetpos(FILE *stream, fpos_t *pos) {
 		return -1;
 	}
 
-	mypos = lseek(stream->fd, 0L, SEEK_CUR);
+	mypos = stream_pos(stream);
 
 	if (-1 == mypos) {
 		return -1;
@@ -81,6 +98,8 @@ int fsetpos(FILE *stream, const fpos_t *pos) {
 		return -1;
 	}
 
+	fflush(stream);
+
 	ret = lseek(stream->fd, *pos, SEEK_SET);
 	if (ret == (off_t)-1) {
 		return -1;
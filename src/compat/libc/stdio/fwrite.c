@@ -88,7 +88,7 @@ static int libc_ob_add(FILE *file, const void *buf, size_t len) {
 		int i_fullob;
 
 		for (i_fullob = 0; i_fullob < fullob_n; ++i_fullob) {
-			libc_write(file, buf + i_fullob * file->obuf_sz, file->obuf_sz);
+			libc_write(file, cbuf + i_fullob * file->obuf_sz, file->obuf_sz);
 		}
 
 		cbuf += fullob_n * file->obuf_sz;
@@ -113,7 +113,7 @@ static int libc_ob_line(FILE *file, const void *buf, size_t len) {
 		if (0 > (err = libc_ob_forceflush(file))) {
 			return err;
 		}
-		err = libc_ob_add(file, buf, len - writelen);
+		err = libc_ob_add(file, buf + writelen, len - writelen);
 	} else {
 		err = libc_ob_add(file, buf, len);
 	}
@@ -134,6 +134,13 @@ size_t fwrite(const void *buf, size_t size, size_t count, FILE *file) {
 		return 0;
 	}
 
+	/* Switching from reading to writing */
+	if (file->ibuf_len) {
+		stdio_ibuf_drop(file);
+	}
+
+	stdio_obuf_alloc(file);
+
 	for (i_block = 0; i_block < count; ++i_block) {
 		const void *block = buf + i_block * size;
 		int err;
@@ -10,9 +10,12 @@
 #include "file_struct.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #define FILE_QUANTITY OPTION_GET(NUMBER,file_quantity)
+#define BUF_SIZE      OPTION_GET(NUMBER,buf_size)
 
 POOL_DEF(file_pool, FILE, FILE_QUANTITY);
 
@@ -31,6 +34,71 @@ FILE *stdio_file_alloc(int fd) {
 
 void stdio_file_free(FILE *file) {
 	if ((file != stdin) && (file != stdout)	&& (file != stderr)) {
+		stdio_buf_release(file);
 		pool_free(&file_pool, file);
 	}
 }
+
+/* Size set by setvbuf() or the default one */
+static void *stdio_buf_malloc(int *size) {
+	void *buf;
+
+	if (*size <= 0) {
+		*size = BUF_SIZE;
+	}
+	if (*size <= 0) {
+		return NULL;
+	}
+
+	buf = malloc(*size);
+	if (!buf) {
+		/* Stay unbuffered */
+		*size = 0;
+	}
+
+	return buf;
+}
+
+void stdio_ibuf_alloc(FILE *file) {
+	if (file->ibuf || file->buftype == _IONBF) {
+		return;
+	}
+
+	file->ibuf = stdio_buf_malloc(&file->ibuf_sz);
+	file->ibuf_own = file->ibuf != NULL;
+	file->ibuf_pos = file->ibuf_len = 0;
+}
+
+void stdio_obuf_alloc(FILE *file) {
+	if (file->obuf || file->buftype == _IONBF) {
+		return;
+	}
+
+	file->obuf = stdio_buf_malloc(&file->obuf_sz);
+	file->obuf_own = file->obuf != NULL;
+	file->obuf_len = 0;
+}
+
+void stdio_buf_release(FILE *file) {
+	if (file->ibuf_own) {
+		free(file->ibuf);
+		file->ibuf = NULL;
+		file->ibuf_own = 0;
+	}
+	if (file->obuf_own) {
+		free(file->obuf);
+		file->obuf = NULL;
+		file->obuf_own = 0;
+	}
+}
+
+void stdio_ibuf_drop(FILE *file) {
+	int unread = file->ibuf_len - file->ibuf_pos;
+
+	/* Streams made by funopen() have no file position to fix */
+	if (unread > 0 && file->fd >= 0) {
+		lseek(file->fd, -unread, SEEK_CUR);
+	}
+
+	file->ibuf_pos = file->ibuf_len = 0;
+}
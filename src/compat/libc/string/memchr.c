@@ -2,20 +2,43 @@
  * @file
  * @brief Implementation of #memchr() function.
  *
+ * @details Compares a long word at a time: after XOR with the character
+ *     repeated in every byte, a matching byte becomes zero.
+ *
  * @date 10.11.11
  * @author Nikolay Korotkiy
  */
 
 #include <string.h>
+#include <stdint.h>
+
+#define BLOCK_SZ (sizeof(unsigned long))
+#define ONES     ((unsigned long) -1 / 0xff)
+#define HIGHS    (ONES * 0x80)
+
+/* Nonzero if any byte of X is zero.  */
+#define has_zero(x) (((x) - ONES) & ~(x) & HIGHS)
 
 void *memchr(const void *s, int c, size_t n) {
 	const unsigned char *src = (const unsigned char *) s;
+	const unsigned long *w;
 	unsigned char d = c;
+	unsigned long mask;
+
+	for (; n && ((uintptr_t) src & (BLOCK_SZ - 1)); n--, src++) {
+		if (*src == d)
+			return (void *) src;
+	}
+
+	mask = ONES * d;
+	for (w = (const unsigned long *) src; n >= BLOCK_SZ; n -= BLOCK_SZ, w++) {
+		if (has_zero(*w ^ mask))
+			break;
+	}
 
-	while (n--) {
+	for (src = (const unsigned char *) w; n--; src++) {
 		if (*src == d)
 			return (void *) src;
-		src++;
 	}
 
 	return NULL;
@@ -4,6 +4,11 @@
  * @file
  * @brief Implementation of #memcpy() function.
  *
+ * @details The destination is aligned first. If the source is aligned
+ *     too, long words are copied as is, otherwise aligned source words are
+ *     read and each destination word is merged from two neighbouring ones,
+ *     so a misaligned copy never reads or writes memory byte by byte.
+ *
  * @date 20.02.13
  * @author Eldar Abusalimov
  */
@@ -12,41 +17,74 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "inhibit_libcall.h"
+
 /* How many bytes are copied each iteration of the word copy loop.  */
 #define BLOCK_SZ (sizeof(long))
 
-/* Nonzero if either X or Y is not aligned on a "long" boundary.  */
-#define unaligned(x, y) \
-  (((long) x | (long) y) & (sizeof(long) - 1))
+/* Nonzero if X is not aligned on a "long" boundary.  */
+#define unaligned(x) \
+  ((uintptr_t) (x) & (BLOCK_SZ - 1))
 
+/* Bytes of the word @a lo starting at @a sh bits followed by
+ * the first bytes of the word @a hi.  */
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define merge(lo, hi, sh) \
+  (((lo) << (sh)) | ((hi) >> (BLOCK_SZ * 8 - (sh))))
+#else
+#define merge(lo, hi, sh) \
+  (((lo) >> (sh)) | ((hi) << (BLOCK_SZ * 8 - (sh))))
+#endif
+
+inhibit_loop_to_libcall
 void *memcpy(void *dst_, const void *src_, size_t n) {
-	char *dst = dst_;
-	long *aligned_dst;
-	const char *src = src_;
-	const long *aligned_src;
-
-	/* If the size is small, or either SRC or DST is unaligned,
-	 then punt into the byte copy loop.  This should be rare.  */
-	if (n >= BLOCK_SZ * 4 && !unaligned((intptr_t) src, (intptr_t) dst)) {
-		aligned_dst = (long *) dst;
-		aligned_src = (long *) src;
-
-		/* Copy 4X long words at a time if possible.  */
-		for (; n >= BLOCK_SZ * 4; n -= BLOCK_SZ * 4) {
-			*aligned_dst++ = *aligned_src++;
-			*aligned_dst++ = *aligned_src++;
-			*aligned_dst++ = *aligned_src++;
-			*aligned_dst++ = *aligned_src++;
+	unsigned char *dst = dst_;
+	const unsigned char *src = src_;
+	unsigned long *aligned_dst;
+	const unsigned long *aligned_src;
+	unsigned long lo, hi;
+	unsigned int sh;
+
+	/* If the size is small punt into the byte copy loop.  */
+	if (n >= BLOCK_SZ * 2) {
+		while (unaligned(dst)) {
+			*dst++ = *src++;
+			n--;
 		}
 
-		/* Copy one long word at a time if possible.  */
-		for (; n >= BLOCK_SZ; n -= BLOCK_SZ) {
-			*aligned_dst++ = *aligned_src++;
+		aligned_dst = (unsigned long *) dst;
+
+		if (!unaligned(src)) {
+			aligned_src = (const unsigned long *) src;
+
+			/* Copy 4X long words at a time if possible.  */
+			for (; n >= BLOCK_SZ * 4; n -= BLOCK_SZ * 4) {
+				*aligned_dst++ = *aligned_src++;
+				*aligned_dst++ = *aligned_src++;
+				*aligned_dst++ = *aligned_src++;
+				*aligned_dst++ = *aligned_src++;
+			}
+
+			/* Copy one long word at a time if possible.  */
+			for (; n >= BLOCK_SZ; n -= BLOCK_SZ) {
+				*aligned_dst++ = *aligned_src++;
+			}
+		} else {
+			/* Only whole aligned words containing source bytes are read */
+			sh = unaligned(src) * 8;
+			aligned_src = (const unsigned long *) (src - unaligned(src));
+
+			lo = *aligned_src++;
+			for (; n >= BLOCK_SZ; n -= BLOCK_SZ) {
+				hi = *aligned_src++;
+				*aligned_dst++ = merge(lo, hi, sh);
+				lo = hi;
+			}
 		}
 
 		/* Pick up any residual with a byte copier.  */
-		dst = (char *) aligned_dst;
-		src = (char *) aligned_src;
+		src += (unsigned char *) aligned_dst - dst;
+		dst = (unsigned char *) aligned_dst;
 	}
 
 	while (n--) {
@@ -10,23 +10,49 @@
  */
 
 #include <string.h>
+#include <stdint.h>
 
 #include "inhibit_libcall.h"
 
+#define BLOCK_SZ (sizeof(long))
+
+/* Nonzero if X is not aligned on a "long" boundary.  */
+#define unaligned(x) ((uintptr_t) (x) & (BLOCK_SZ - 1))
+
 inhibit_loop_to_libcall
 void *memmove(void *_dst, const void *_src, size_t n) {
 	char *dst = _dst;
 	const char *src = _src;
+	unsigned long *aligned_dst;
+	const unsigned long *aligned_src;
 
 	if (src < dst && dst < src + n) {
 		/* Moving from low mem to hi mem; start at end.  */
 		src += n;
 		dst += n;
+
+		/* Go by long words if both ends can be aligned at once.  */
+		if (n >= BLOCK_SZ * 2 && unaligned(src) == unaligned(dst)) {
+			while (unaligned(dst)) {
+				*--dst = *--src;
+				n--;
+			}
+
+			aligned_dst = (unsigned long *) dst;
+			aligned_src = (const unsigned long *) src;
+			for (; n >= BLOCK_SZ; n -= BLOCK_SZ) {
+				*--aligned_dst = *--aligned_src;
+			}
+			dst = (char *) aligned_dst;
+			src = (const char *) aligned_src;
+		}
+
 		while (n--) {
 			*--dst = *--src;
 		}
 		return _dst;
 	}
 
+	/* Forward copy never overwrites source bytes it has not read yet */
 	return memcpy(_dst, _src, n);
 }
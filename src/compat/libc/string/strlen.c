@@ -2,17 +2,39 @@
  * @file
  * @brief Implementation of #strlen() function.
  *
+ * @details Looks for the terminating zero a long word at a time. Words
+ *     are read only at aligned addresses, so reading past the end of the
+ *     string never crosses into another page.
+ *
  * @date 23.11.09
  * @author Nikolay Korotky
  */
 
 #include <string.h>
+#include <stdint.h>
+
+#define BLOCK_SZ (sizeof(unsigned long))
+#define ONES     ((unsigned long) -1 / 0xff)
+#define HIGHS    (ONES * 0x80)
+
+/* Nonzero if any byte of X is zero.  */
+#define has_zero(x) (((x) - ONES) & ~(x) & HIGHS)
 
 size_t strlen(const char *str) {
 	const char *s = str;
+	const unsigned long *w;
+
+	for (; (uintptr_t) s & (BLOCK_SZ - 1); s++) {
+		if (!*s) {
+			return (size_t) (s - str);
+		}
+	}
+
+	for (w = (const unsigned long *) s; !has_zero(*w); w++)
+		;
 
-	while (*s++)
+	for (s = (const char *) w; *s; s++)
 		;
 
-	return (size_t) (s - str - 1);
+	return (size_t) (s - str);
 }
@@ -18,3 +18,18 @@ TEST_CASE("find a not existed character with memchr()") {
     /* Checking that a character is not found */
     test_assert_null(memchr(src, 1, sizeof(src)));
 }
+
+TEST_CASE("find a character at any position of a long buffer") {
+    char src[64];
+    int off, pos;
+
+    for (off = 0; off < 8; off++) {
+        for (pos = off; pos < sizeof(src); pos++) {
+            memset(src, 'A', sizeof(src));
+            src[pos] = 'B';
+            test_assert_equal(memchr(&src[off], 'B', sizeof(src) - off),
+                    &src[pos]);
+            test_assert_null(memchr(&src[off], 'B', pos - off));
+        }
+    }
+}
@@ -25,7 +25,7 @@ TEST_CASE("copy string with memcpy") {
 	memset(dst, 0x55, sizeof(dst));
 
 	test_assert_equal(strlen(src),\
-		strlen(memcpy(dst, src, sizeof(dst))));
+		strlen(memcpy(dst, src, sizeof(src))));
 	test_assert_zero(strcmp(dst, src));
 }
 
@@ -64,3 +64,27 @@ TEST_CASE("copy char array without overflow") {
 	test_assert_zero(dst[100]);
 }
 
+
+TEST_CASE("copy with every source and destination misalignment") {
+	char src[80], dst[80];
+	int so, d, n, i;
+
+	for (i = 0; i < sizeof(src); i++) {
+		src[i] = i + 1;
+	}
+
+	for (so = 0; so < 8; so++) {
+		for (d = 0; d < 8; d++) {
+			for (n = 0; n < 64; n++) {
+				memset(dst, 0, sizeof(dst));
+				memcpy(&dst[d], &src[so], n);
+
+				test_assert_zero(memcmp(&dst[d], &src[so], n));
+				for (i = 0; i < d; i++) {
+					test_assert_zero(dst[i]);
+				}
+				test_assert_zero(dst[d + n]);
+			}
+		}
+	}
+}
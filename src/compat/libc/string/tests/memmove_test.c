@@ -64,3 +64,24 @@ TEST_CASE("Memory is not allocated enough") {
 
     test_assert_equal(strlen(dest), strlen(memmove(dest, src, strlen(dest))));
 }
+
+TEST_CASE("move overlapping data in both directions") {
+    char buf[96], ref[96];
+    int from, to, n, i;
+
+    for (from = 8; from < 16; from++) {
+        for (to = from - 7; to < from + 8; to++) {
+            for (n = 0; n < 64; n++) {
+                for (i = 0; i < sizeof(buf); i++) {
+                    buf[i] = ref[i] = i;
+                }
+                for (i = 0; i < n; i++) {
+                    ref[to + i] = from + i;
+                }
+
+                memmove(&buf[to], &buf[from], n);
+                test_assert_zero(memcmp(buf, ref, sizeof(buf)));
+            }
+        }
+    }
+}
@@ -33,6 +33,8 @@
 #include <util/log.h>
 #include <util/binalign.h>
 
+#include <framework/mod/options.h>
+
 #include "e1000.h"
 
 static const struct pci_id e1000_id_table[] = {
@@ -57,6 +59,12 @@ PCI_DRIVER_TABLE("e1000", e1000_init, e1000_id_table);
 
 #define E1000_MAX_RX_LEN (ETH_FRAME_LEN + E1000_RX_CHECKSUM_LEN)
 
+#define E1000_IRQ_PRIORITY OPTION_GET(NUMBER, irq_priority)
+
+#define E1000_IRQ_CAUSES \
+	(E1000_REG_ICR_RXO | E1000_REG_ICR_RXT | E1000_REG_ICR_TXDW \
+		| E1000_REG_ICR_TXQE | E1000_REG_ICR_LSC)
+
 static int e1000_stop(struct net_device *dev);
 
 struct e1000_rx_desc {
@@ -89,6 +97,7 @@ struct e1000_priv {
 	struct sk_buff *rx_skbs[E1000_RXDESC_NR];
 
 	char link_status;
+	uint32_t cause;  /* ICR bits read by the primary handler */
 };
 
 static inline struct e1000_priv *e1000_get_priv(struct net_device *dev) {
@@ -182,62 +191,77 @@ static void e1000_rx(struct net_device *dev) {
 	uint16_t tail;
 	uint16_t cur;
 
-	/* nested irq locked to prevent already handled packets handled once more
-	 * as tail updated at exit
-	 */
-	irq_lock();
-	{
-		head = REG32_LOAD(e1000_reg(dev, E1000_REG_RDH));
-		tail = REG32_LOAD(e1000_reg(dev, E1000_REG_RDT));
-		cur = (1 + tail) % E1000_RXDESC_NR;
+	/* Runs in the interrupt thread only, which is not reentered while the
+	 * IRQ is masked, so the ring is not locked */
+	head = REG32_LOAD(e1000_reg(dev, E1000_REG_RDH));
+	tail = REG32_LOAD(e1000_reg(dev, E1000_REG_RDT));
+	cur = (1 + tail) % E1000_RXDESC_NR;
 
-		while (cur != head) {
-			int len;
-
-			if (!(nic_priv->rx_descs[cur].status)) {
-				break;
-			}
-
-			len = nic_priv->rx_descs[cur].length - E1000_RX_CHECKSUM_LEN;
-
-			if (0 != nf_test_raw(NF_CHAIN_INPUT,
-						NF_TARGET_ACCEPT,
-						(char *) (uintptr_t) nic_priv->rx_descs[cur].buffer_address,
-						ETH_ALEN + (char *) (uintptr_t) nic_priv->rx_descs[cur].buffer_address,
-						ETH_ALEN)) {
-				goto drop_pack;
-			}
-
-			new_skb = skb_alloc(E1000_MAX_RX_LEN);
-			if (!new_skb) {
-				goto drop_pack;
-			}
-
-			skb = nic_priv->rx_skbs[cur];
-			nic_priv->rx_skbs[cur] = new_skb;
-			nic_priv->rx_descs[cur].buffer_address = (uint32_t) (uintptr_t) new_skb->mac.raw;
-			assert(skb);
-
-			skb = skb_realloc(len, skb);
-			if (!skb) {
-				goto drop_pack;
-			}
-			skb->dev = dev;
-			netif_rx(skb);
-drop_pack:
-			tail = cur;
+	while (cur != head) {
+		int len;
+
+		if (!(nic_priv->rx_descs[cur].status)) {
+			break;
+		}
+
+		len = nic_priv->rx_descs[cur].length - E1000_RX_CHECKSUM_LEN;
+
+		if (0 != nf_test_raw(NF_CHAIN_INPUT,
+					NF_TARGET_ACCEPT,
+					(char *) (uintptr_t) nic_priv->rx_descs[cur].buffer_address,
+					ETH_ALEN + (char *) (uintptr_t) nic_priv->rx_descs[cur].buffer_address,
+					ETH_ALEN)) {
+			goto drop_pack;
+		}
+
+		new_skb = skb_alloc(E1000_MAX_RX_LEN);
+		if (!new_skb) {
+			goto drop_pack;
+		}
 
-			cur = (1 + tail) % E1000_RXDESC_NR;
+		skb = nic_priv->rx_skbs[cur];
+		nic_priv->rx_skbs[cur] = new_skb;
+		nic_priv->rx_descs[cur].buffer_address = (uint32_t) (uintptr_t) new_skb->mac.raw;
+		assert(skb);
+
+		skb = skb_realloc(len, skb);
+		if (!skb) {
+			goto drop_pack;
 		}
-		REG32_STORE(e1000_reg(dev, E1000_REG_RDT), tail);
+		skb->dev = dev;
+		netif_rx(skb);
+drop_pack:
+		tail = cur;
+
+		cur = (1 + tail) % E1000_RXDESC_NR;
 	}
-	irq_unlock();
+	REG32_STORE(e1000_reg(dev, E1000_REG_RDT), tail);
 }
 
+/* Reading ICR acks the interrupt, the causes are served by the thread */
 static irq_return_t e1000_interrupt(unsigned int irq_num, void *dev_id) {
 	struct e1000_priv *nic_priv = e1000_get_priv(dev_id);
-	int cause = REG32_LOAD(e1000_reg(dev_id, E1000_REG_ICR));
+	uint32_t cause = REG32_LOAD(e1000_reg(dev_id, E1000_REG_ICR));
+
+	if (!(cause & E1000_IRQ_CAUSES)) {
+		return IRQ_NONE;
+	}
+	nic_priv->cause |= cause;
+
+	return IRQ_HANDLED;
+}
+
+static irq_return_t e1000_interrupt_thread(unsigned int irq_num,
+		void *dev_id) {
+	struct e1000_priv *nic_priv = e1000_get_priv(dev_id);
 	irq_return_t ret = IRQ_NONE;
+	uint32_t cause;
+
+	/* An interrupt latched before the IRQ was masked may add causes */
+	irq_lock();
+	cause = nic_priv->cause;
+	nic_priv->cause = 0;
+	irq_unlock();
 
 	if (cause & (E1000_REG_ICR_RXO | E1000_REG_ICR_RXT)) {
 		e1000_rx(dev_id);
@@ -428,7 +452,9 @@ static int e1000_init(struct pci_slot_dev *pci_dev) {
 	skb_queue_init(&nic_priv->txing_queue);
 	skb_queue_init(&nic_priv->tx_dev_queue);
 
-	res = irq_attach(pci_dev->irq, e1000_interrupt, IF_SHARESUP, nic, "e1000");
+	res = irq_attach_threaded(pci_dev->irq, e1000_interrupt,
+			e1000_interrupt_thread, IF_SHARESUP, E1000_IRQ_PRIORITY, nic,
+			"e1000");
 	if (res < 0) {
 		return res;
 	}
@@ -53,6 +53,15 @@ static int i8250_setup(struct uart *dev, const struct uart_params *params) {
 	out8(line_stat, dev->base_addr + UART_LCR);
 	/* Uart enable FIFO */
 	out8(UART_ENABLE_FIFO, dev->base_addr + UART_FCR);
+	if (!dev->tx_fifo_sz) {
+		/* 8250 and 16450 have no FIFO, 16550 has a broken one */
+		if ((in8(dev->base_addr + UART_IIR) & UART_IIR_FIFO_MASK)
+				== UART_IIR_FIFO_ON) {
+			dev->tx_fifo_sz = UART_FIFO_SZ;
+		} else {
+			dev->tx_fifo_sz = 1;
+		}
+	}
 	/* Uart enable modem (turn on DTR, RTS, and OUT2) */
 	out8(UART_ENABLE_MODEM, dev->base_addr + UART_MCR);
 
@@ -66,24 +75,62 @@ static int i8250_setup(struct uart *dev, const struct uart_params *params) {
 }
 
 static int i8250_irq_en(struct uart *dev, const struct uart_params *params) {
+	uint8_t ier;
+
 	/*enable rx interrupt*/
 	if (params->uart_param_flags & UART_PARAM_FLAGS_USE_IRQ) {
 		/*enable rx interrupt*/
-		out8(UART_IER_RX_ENABLE, dev->base_addr + UART_IER);
+		ier = in8(dev->base_addr + UART_IER);
+		out8(ier | UART_IER_RX_ENABLE, dev->base_addr + UART_IER);
 	}
 
 	return 0;
 }
 
 static int i8250_irq_dis(struct uart *dev, const struct uart_params *params) {
+	uint8_t ier;
+
 	if (params->uart_param_flags & UART_PARAM_FLAGS_USE_IRQ) {
-		/*disable rx interrupt*/
-		out8(0, dev->base_addr + UART_IER);
+		/*disable rx interrupt, tx one is left as is*/
+		ier = in8(dev->base_addr + UART_IER);
+		out8(ier & ~UART_IER_RX_ENABLE, dev->base_addr + UART_IER);
 	}
 
 	return 0;
 }
 
+static int i8250_tx_irq_en(struct uart *dev) {
+	uint8_t ier;
+
+	ier = in8(dev->base_addr + UART_IER);
+	out8(ier | UART_IER_TX_ENABLE, dev->base_addr + UART_IER);
+
+	return 0;
+}
+
+static int i8250_tx_irq_dis(struct uart *dev) {
+	uint8_t ier;
+
+	ier = in8(dev->base_addr + UART_IER);
+	out8(ier & ~UART_IER_TX_ENABLE, dev->base_addr + UART_IER);
+
+	return 0;
+}
+
+static int i8250_tx_room(struct uart *dev) {
+	/* The whole FIFO is free once the holding register is empty */
+	if (in8(dev->base_addr + UART_LSR) & UART_EMPTY_TX) {
+		return dev->tx_fifo_sz ? dev->tx_fifo_sz : 1;
+	}
+
+	return 0;
+}
+
+static int i8250_tx_put(struct uart *dev, int ch) {
+	out8((uint8_t) ch, dev->base_addr + UART_TX);
+	return 0;
+}
+
 static int i8250_putc(struct uart *dev, int ch) {
 	while (!(in8(dev->base_addr + UART_LSR) & UART_EMPTY_TX));
 	out8((uint8_t) ch, dev->base_addr + UART_TX);
@@ -105,5 +152,9 @@ const struct uart_ops i8250_uart_ops = {
 		.uart_setup = i8250_setup,
 		.uart_irq_en = i8250_irq_en,
 		.uart_irq_dis = i8250_irq_dis,
+		.uart_tx_irq_en = i8250_tx_irq_en,
+		.uart_tx_irq_dis = i8250_tx_irq_dis,
+		.uart_tx_room = i8250_tx_room,
+		.uart_tx_put = i8250_tx_put,
 };
 
@@ -83,5 +83,13 @@
 #define DIVISOR(baud) (115200 / baud)
 
 #define UART_IER_RX_ENABLE  0x1
+#define UART_IER_TX_ENABLE  0x2
+
+/* IIR bits 7:6 tell whether FIFOs are on after UART_ENABLE_FIFO */
+#define UART_IIR_FIFO_MASK  0xC0
+#define UART_IIR_FIFO_ON    0xC0
+
+/* 16550A FIFO depth, UART_ENABLE_FIFO doesn't turn on 64 byte ones */
+#define UART_FIFO_SZ        16
 
 #endif /* SERIAL_8250_H_ */
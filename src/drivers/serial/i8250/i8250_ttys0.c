@@ -19,6 +19,7 @@
 #define UART_BASE      OPTION_GET(NUMBER, base_addr)
 #define IRQ_NUM        OPTION_GET(NUMBER, irq_num)
 #define BAUD_RATE      OPTION_GET(NUMBER, baud_rate)
+#define FIFO_SIZE      OPTION_GET(NUMBER, fifo_size)
 
 #define TTY_NAME    ttyS0
 
@@ -30,6 +31,7 @@ static struct uart i8250_uart_ttyS0 = {
 		.uart_ops = &i8250_uart_ops,
 		.irq_num = IRQ_NUM,
 		.base_addr = UART_BASE,
+		.tx_fifo_sz = FIFO_SIZE,
 		.params =  {
 				.baud_rate = BAUD_RATE,
 				.uart_param_flags = UART_PARAM_FLAGS_8BIT_WORD | UART_PARAM_FLAGS_USE_IRQ,
@@ -123,6 +123,30 @@ static int ns16550_irq_dis(struct uart *dev, const struct uart_params *params) {
 	return 0;
 }
 
+static int ns16550_tx_irq_en(struct uart *dev) {
+	UART_REG_ORIN(UART_IER(dev->base_addr), UART_IER_THRE);
+
+	return 0;
+}
+
+static int ns16550_tx_irq_dis(struct uart *dev) {
+	UART_REG_CLEAR(UART_IER(dev->base_addr), UART_IER_THRE);
+
+	return 0;
+}
+
+static int ns16550_tx_room(struct uart *dev) {
+	/* FIFOs are left as the boot code configured them, so only the holding
+	 * register is known to be free */
+	return !!(UART_REG_LOAD(UART_LSR(dev->base_addr)) & UART_LSR_THRE);
+}
+
+static int ns16550_tx_put(struct uart *dev, int ch) {
+	UART_REG_STORE(UART_THR(dev->base_addr), ch);
+
+	return 0;
+}
+
 static int ns16550_putc(struct uart *dev, int ch) {
 	while (!(UART_REG_LOAD(UART_LSR(dev->base_addr)) & UART_LSR_THRE)) {}
 
@@ -146,4 +170,8 @@ const struct uart_ops ns16550_uart_ops = {
     .uart_setup = ns16550_setup,
     .uart_irq_en = ns16550_irq_en,
     .uart_irq_dis = ns16550_irq_dis,
+    .uart_tx_irq_en = ns16550_tx_irq_en,
+    .uart_tx_irq_dis = ns16550_tx_irq_dis,
+    .uart_tx_room = ns16550_tx_room,
+    .uart_tx_put = ns16550_tx_put,
 };
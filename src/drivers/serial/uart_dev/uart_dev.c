@@ -17,6 +17,7 @@
 #include <lib/libds/array.h>
 
 #include <kernel/irq.h>
+#include <kernel/irq_lock.h>
 #include <mem/misc/pool.h>
 
 #include <drivers/device.h>
@@ -77,6 +78,10 @@ static void uart_internal_init(struct uart *uart) {
 
 	ring_buff_init(&uart->uart_rx_ring, sizeof(uart->uart_rx_buff[0]),
 			UART_RX_BUFF_SZ, uart->uart_rx_buff);
+#if UART_TX_BUFF_SZ
+	ring_buff_init(&uart->uart_tx_ring, sizeof(uart->uart_tx_buff[0]),
+			UART_TX_BUFF_SZ, uart->uart_tx_buff);
+#endif
 
 	dlist_add_next(&uart->uart_lnk, &uart_list);
 }
@@ -99,6 +104,16 @@ int uart_close(struct uart *uart) {
 		return -EINVAL;
 	}
 
+	irq_lock();
+	if (uart_state_test(uart, UART_STATE_TX_ACTIVE)) {
+		uart->uart_ops->uart_tx_irq_dis(uart);
+		uart_state_clear(uart, UART_STATE_TX_ACTIVE);
+	}
+#if UART_TX_BUFF_SZ
+	ring_init(&uart->uart_tx_ring.ring);
+#endif
+	irq_unlock();
+
 	uart_state_clear(uart, UART_STATE_OPEN);
 
 	return uart_detach_irq(uart);
@@ -115,6 +130,13 @@ int uart_set_params(struct uart *uart, const struct uart_params *params) {
 	if (uart_state_test(uart, UART_STATE_OPEN)) {
 		uart_attach_irq(uart);
 		uart_setup(uart);
+
+		/* Setup may have reset the interrupt enable register */
+		irq_lock();
+		if (uart_state_test(uart, UART_STATE_TX_ACTIVE)) {
+			uart->uart_ops->uart_tx_irq_en(uart);
+		}
+		irq_unlock();
 	}
 
 	return 0;
@@ -126,3 +148,69 @@ int uart_get_params(struct uart *uart, struct uart_params *params) {
 
 	return 0;
 }
+
+#if UART_TX_BUFF_SZ
+/* Called with IRQs locked */
+static void uart_tx_fill(struct uart *uart) {
+	int room;
+	char ch;
+
+	room = uart->uart_ops->uart_tx_room(uart);
+	while (room-- > 0 && ring_buff_dequeue(&uart->uart_tx_ring, &ch, 1)) {
+		uart->uart_ops->uart_tx_put(uart, ch);
+	}
+}
+
+int uart_tx_queue(struct uart *uart, const void *buf, int len) {
+	int n;
+
+	irq_lock();
+
+	n = ring_buff_enqueue(&uart->uart_tx_ring, (void *)buf, len);
+	if (n && !uart_state_test(uart, UART_STATE_TX_ACTIVE)) {
+		uart_state_set(uart, UART_STATE_TX_ACTIVE);
+		uart_tx_fill(uart);
+		uart->uart_ops->uart_tx_irq_en(uart);
+	}
+
+	irq_unlock();
+
+	return n;
+}
+
+int uart_tx_irq(struct uart *uart) {
+	int space;
+
+	irq_lock();
+
+	if (uart_state_test(uart, UART_STATE_TX_ACTIVE)) {
+		uart_tx_fill(uart);
+
+		if (!ring_buff_get_cnt(&uart->uart_tx_ring)) {
+			uart->uart_ops->uart_tx_irq_dis(uart);
+			uart_state_clear(uart, UART_STATE_TX_ACTIVE);
+		}
+	}
+	space = ring_buff_get_space(&uart->uart_tx_ring);
+
+	irq_unlock();
+
+	return space;
+}
+
+int uart_tx_space(struct uart *uart) {
+	return ring_buff_get_space(&uart->uart_tx_ring);
+}
+#else
+int uart_tx_queue(struct uart *uart, const void *buf, int len) {
+	return 0;
+}
+
+int uart_tx_irq(struct uart *uart) {
+	return 0;
+}
+
+int uart_tx_space(struct uart *uart) {
+	return 0;
+}
+#endif
@@ -9,12 +9,17 @@
 #define UART_DEVICE_H_
 
 #include <stdint.h>
+#include <framework/mod/options.h>
 #include <lib/libds/dlist.h>
 #include <lib/libds/ring_buff.h>
 #include <kernel/irq.h>
 
+#include <module/embox/driver/serial/core.h>
+
 #define UART_NAME_MAXLEN  8
 #define UART_RX_BUFF_SZ   8
+#define UART_TX_BUFF_SZ \
+	OPTION_MODULE_GET(embox__driver__serial__core, NUMBER, tx_buff_size)
 
 #define UART_STATE_OPEN      (1 << 0)
 /*
@@ -26,6 +31,7 @@
 #define UART_SYNC_FIFO   (1 << 6))
 */
 #define UART_STATE_RX_ACTIVE  (1 << 8)
+#define UART_STATE_TX_ACTIVE  (1 << 9)
 #define UART_STATE_INITED     (1 << 10)
 
 struct uart;
@@ -84,6 +90,14 @@ struct uart_ops {
 	int (*uart_setup)(struct uart *dev, const struct uart_params *params);
 	int (*uart_irq_en)(struct uart *dev, const struct uart_params *params);
 	int (*uart_irq_dis)(struct uart *dev, const struct uart_params *params);
+
+	/* Optional, transmission from the TX empty interrupt */
+	int (*uart_tx_irq_en)(struct uart *dev);
+	int (*uart_tx_irq_dis)(struct uart *dev);
+	/* Number of symbols which can be put without waiting */
+	int (*uart_tx_room)(struct uart *dev);
+	/* Puts a symbol without polling, only as many as uart_tx_room() said */
+	int (*uart_tx_put)(struct uart *dev, int symbol);
 };
 
 struct uart {
@@ -92,6 +106,8 @@ struct uart {
 	short irq_num;
 	uintptr_t base_addr;
 	irq_handler_t irq_handler;
+	/* TX FIFO depth, 0 if the driver detects it */
+	int tx_fifo_sz;
 
 	/* management */
 	struct dlist_head uart_lnk;
@@ -104,6 +120,10 @@ struct uart {
 	struct tty *tty;
 	int uart_rx_buff[UART_RX_BUFF_SZ];
 	struct ring_buff uart_rx_ring;
+#if UART_TX_BUFF_SZ
+	char uart_tx_buff[UART_TX_BUFF_SZ];
+	struct ring_buff uart_tx_ring;
+#endif
 };
 
 
@@ -177,6 +197,27 @@ extern int uart_get_params(struct uart *uart, struct uart_params *params);
  */
 extern int uart_set_params(struct uart *uart, const struct uart_params *params);
 
+/**
+ * @brief Queue symbols to be put by the TX empty interrupt handler. Does not
+ * block, see uart_tx_irq_mode()
+ *
+ * @return Number of symbols queued, less than @a len if the TX ring is full
+ */
+extern int uart_tx_queue(struct uart *uart, const void *buf, int len);
+
+/**
+ * @brief Move queued symbols to the transmitter. Called by the UART
+ * interrupt handler
+ *
+ * @return Free space in the TX ring
+ */
+extern int uart_tx_irq(struct uart *uart);
+
+/**
+ * @brief Free space in the TX ring
+ */
+extern int uart_tx_space(struct uart *uart);
+
 static inline int uart_putc(struct uart *uart, int ch) {
 	return uart->uart_ops->uart_putc(uart, ch);
 }
@@ -202,6 +243,16 @@ static inline void uart_state_clear(struct uart *uart, int mask) {
 	uart->state &= ~mask;
 }
 
+/**
+ * @brief Whether output goes through the TX ring and the TX empty interrupt
+ * rather than uart_putc() polling
+ */
+static inline int uart_tx_irq_mode(struct uart *uart) {
+	return UART_TX_BUFF_SZ && uart->uart_ops->uart_tx_irq_en
+		&& (uart->params.uart_param_flags & UART_PARAM_FLAGS_USE_IRQ)
+		&& uart_state_test(uart, UART_STATE_OPEN);
+}
+
 extern struct dlist_head *uart_get_list(void);
 
 #define uart_opened_foreach(uart_dev) \
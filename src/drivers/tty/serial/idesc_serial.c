@@ -44,7 +44,6 @@ static ssize_t serial_write(struct char_dev *cdev, const void *buf,
 	struct uart *uart;
 	size_t written;
 	size_t left;
-	int ch;
 
 	assert(buf);
 	assert(cdev);
@@ -57,10 +56,13 @@ static ssize_t serial_write(struct char_dev *cdev, const void *buf,
 	assert(uart->tty);
 
 	do {
+		/* tty_write() hands the output to the UART itself, with
+		 * uart_out_wake(), and sleeps while the tty output buffer is
+		 * full. It is woken when the TX interrupt makes room. */
 		written = tty_write(uart->tty, buf, left);
-
-		while (-1 != (ch = tty_out_getc(uart->tty))) {
-			uart_putc(uart, ch);
+		if ((ssize_t)written < 0) {
+			/* -EAGAIN for a non-blocking write, -EINTR etc */
+			return left != nbyte ? (ssize_t)(nbyte - left) : (ssize_t)written;
 		}
 
 		left -= written;
@@ -36,6 +36,8 @@ struct serial_dev {
 };
 
 extern irq_return_t uart_irq_handler(unsigned int irq_nr, void *data);
+/* Moves tty output into the TX ring of the UART, see uart_tx_queue() */
+extern void uart_tx_refill(struct uart *uart);
 extern int ttys_register(const char *name, struct uart *uart);
 
 extern const struct tty_ops __uart_tty_ops;
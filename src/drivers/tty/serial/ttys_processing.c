@@ -12,12 +12,14 @@
 #include <mem/misc/pool.h>
 #include <lib/libds/dlist.h>
 #include <util/log.h>
+#include <util/math.h>
 
 EMBOX_UNIT_INIT(idesc_serial_init);
 
 #define UART_RX_HND_PRIORITY 128
 
 static struct lthread uart_rx_irq_handler;
+static struct lthread uart_tx_irq_handler;
 
 static int uart_rx_buff_put(struct uart *dev) {
 	int ch;
@@ -71,11 +73,52 @@ static int uart_rx_action(struct lthread *self) {
 	return 0;
 }
 
+void uart_tx_refill(struct uart *dev) {
+	char buf[16];
+	int space, n;
+
+	irq_lock();
+	while ((space = uart_tx_space(dev)) > 0) {
+		n = tty_out_buf(dev->tty, buf, min(space, (int)sizeof(buf)));
+		if (!n) {
+			break;
+		}
+		uart_tx_queue(dev, buf, n);
+	}
+	irq_unlock();
+}
+
+static void uart_tx_buff_get(struct uart *dev) {
+	if (!uart_tx_irq_mode(dev)) {
+		return;
+	}
+
+	/* Output left in the tty is moved to the TX ring by the lthread once
+	 * the ring is half empty, not symbol by symbol from here */
+	if (uart_tx_irq(dev) >= UART_TX_BUFF_SZ / 2 && dev->tty
+			&& !ring_empty(&dev->tty->o_ring)) {
+		lthread_launch(&uart_tx_irq_handler);
+	}
+}
+
+static int uart_tx_action(struct lthread *self) {
+	struct uart *uart = NULL;
+
+	uart_opened_foreach(uart) {
+		if (uart->tty && uart_tx_irq_mode(uart)) {
+			uart_tx_refill(uart);
+		}
+	}
+
+	return 0;
+}
+
 irq_return_t uart_irq_handler(unsigned int irq_nr, void *data) {
 	struct uart *dev = data;
 
 	log_debug("irq_nr %d", irq_nr);
 	uart_rx_buff_put(dev);
+	uart_tx_buff_get(dev);
 
 	return IRQ_HANDLED;
 }
@@ -83,5 +126,7 @@ irq_return_t uart_irq_handler(unsigned int irq_nr, void *data) {
 static int idesc_serial_init(void) {
 	lthread_init(&uart_rx_irq_handler, &uart_rx_action);
 	schedee_priority_set(&uart_rx_irq_handler.schedee, UART_RX_HND_PRIORITY);
+	lthread_init(&uart_tx_irq_handler, &uart_tx_action);
+	schedee_priority_set(&uart_tx_irq_handler.schedee, UART_RX_HND_PRIORITY);
 	return 0;
 }
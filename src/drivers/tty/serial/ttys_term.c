@@ -21,6 +21,12 @@ static void uart_out_wake(struct tty *t) {
 	struct uart *uart_dev = tty2uart(t);
 	int ich;
 
+	if (uart_tx_irq_mode(uart_dev)) {
+		/* The rest goes from the TX interrupt */
+		uart_tx_refill(uart_dev);
+		return;
+	}
+
 	irq_lock();
 
 	while ((ich = tty_out_getc(t)) != -1)
@@ -355,7 +355,11 @@ int tty_out_buf(struct tty *t, void *buf, size_t len) {
 
 	ret = ring_read_all_into(&t->o_ring, t->o_buff, TTY_IO_BUFF_SZ, buf, len);
 
-	tty_notify(t, POLLOUT);
+	/* A writer waiting for room calls this itself, it would wake up
+	 * at once and spin while the UART is still busy */
+	if (ret > 0) {
+		tty_notify(t, POLLOUT);
+	}
 
 	return ret;
 }
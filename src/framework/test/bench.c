@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @brief Microbenchmark runner.
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <framework/mod/options.h>
+#include <framework/test/bench.h>
+#include <lib/libcpu_info.h>
+
+#define SAMPLES_MAX OPTION_GET(NUMBER, max_samples)
+#define WARMUP      OPTION_GET(NUMBER, warmup)
+#define BATCH_US    OPTION_GET(NUMBER, batch_us)
+
+#define ITERS_MAX   (1UL << 24)
+
+ARRAY_SPREAD_DEF(const struct bench *const, __bench_registry);
+
+const struct bench *bench_lookup(const char *name) {
+	const struct bench *bench;
+
+	bench_foreach(bench) {
+		if (strcmp(bench->name, name) == 0) {
+			return bench;
+		}
+	}
+
+	return NULL;
+}
+
+static uint64_t bench_batch(const struct bench *bench, unsigned long iters) {
+	uint64_t c0;
+
+	c0 = get_cpu_counter();
+	bench->run(iters);
+
+	return get_cpu_counter() - c0;
+}
+
+static void samples_sort(uint64_t *s, int n) {
+	uint64_t v;
+	int i, j;
+
+	for (i = 1; i < n; i++) {
+		v = s[i];
+		for (j = i; j > 0 && s[j - 1] > v; j--) {
+			s[j] = s[j - 1];
+		}
+		s[j] = v;
+	}
+}
+
+int bench_run(const struct bench *bench, int samples,
+		struct bench_result *res) {
+	uint64_t s[SAMPLES_MAX];
+	uint64_t target;
+	unsigned long iters;
+	int i, ret;
+
+	if (samples < 1) {
+		samples = 1;
+	}
+	if (samples > SAMPLES_MAX) {
+		samples = SAMPLES_MAX;
+	}
+
+	if (bench->setup && (ret = bench->setup()) != 0) {
+		return ret;
+	}
+
+	res->hz = cpu_counter_hz();
+	target = res->hz * BATCH_US / 1000000;
+
+	/* The first call touches the code and data, then the batch is doubled
+	 * until it takes long enough for the counter resolution not to matter */
+	bench_batch(bench, 1);
+	for (iters = 1; iters < ITERS_MAX; iters *= 2) {
+		if (bench_batch(bench, iters) >= target) {
+			break;
+		}
+	}
+
+	for (i = 0; i < WARMUP; i++) {
+		bench_batch(bench, iters);
+	}
+	for (i = 0; i < samples; i++) {
+		s[i] = bench_batch(bench, iters);
+	}
+
+	if (bench->teardown && (ret = bench->teardown()) != 0) {
+		return ret;
+	}
+
+	samples_sort(s, samples);
+
+	res->iters = iters;
+	res->samples = samples;
+	res->min = s[0] * 100 / iters;
+	res->median = s[samples / 2] * 100 / iters;
+	res->p99 = s[(samples * 99 + 99) / 100 - 1] * 100 / iters;
+
+	return 0;
+}
+
+static void print_hundredths(const char *key, uint64_t v) {
+	printf(",\"%s\":%llu.%02u", key, (unsigned long long) (v / 100),
+			(unsigned int) (v % 100));
+}
+
+void bench_print_json(const struct bench *bench,
+		const struct bench_result *res) {
+	printf("{\"bench\":\"%s\",\"unit\":\"cycles\",\"hz\":%llu,"
+			"\"iters\":%lu,\"samples\":%d", bench->name,
+			(unsigned long long) res->hz, res->iters, res->samples);
+	print_hundredths("min", res->min);
+	print_hundredths("median", res->median);
+	print_hundredths("p99", res->p99);
+	printf(",\"per_sec\":%llu}\n", (unsigned long long) (res->median
+			? res->hz * 100 / res->median : 0));
+}
@@ -13,9 +13,11 @@
 #include <lib/libds/hashtable.h>
 
 #include <mem/misc/pool.h>
+#include <mem/objalloc.h>
 #include <mem/sysmalloc.h>
 
 #include <fs/bcache.h>
+#include <kernel/kcounter.h>
 
 #include <embox/unit.h>
 EMBOX_UNIT_INIT(bcache_init);
@@ -23,7 +25,10 @@ EMBOX_UNIT_INIT(bcache_init);
 #define BCACHE_SIZE   OPTION_GET(NUMBER, bcache_size)
 #define BCACHE_ALIGN  OPTION_GET(NUMBER, bcache_align)
 
-POOL_DEF(buffer_head_pool, struct buffer_head, BCACHE_SIZE);
+KCOUNTER_DEF(bcache_hit, "bcache.hit");
+KCOUNTER_DEF(bcache_miss, "bcache.miss");
+
+OBJALLOC_DEF(buffer_head_pool, struct buffer_head, BCACHE_SIZE);
 static DLIST_DEFINE(bh_list);
 
 
@@ -40,6 +45,7 @@ static void free_more_memory(size_t size);
 struct buffer_head *bcache_getblk_locked(struct block_dev *bdev, int block, size_t size) {
 	struct buffer_head key = { .bdev = bdev, .block = block };
 	struct buffer_head *bh;
+	int miss = 0;
 
 	assert(bdev);
 
@@ -48,12 +54,18 @@ struct buffer_head *bcache_getblk_locked(struct block_dev *bdev, int block, size
 		bh = (struct buffer_head *)hashtable_get(bcache, &key);
 
 		if (bh) {
+			if (miss) {
+				kcounter_inc(bcache_miss);
+			} else {
+				kcounter_inc(bcache_hit);
+			}
 			assert(size == bh->blocksize);
 			bcache_buffer_lock(bh);
 			mutex_unlock(&bcache_mutex);
 			return bh;
 		}
 
+		miss = 1;
 		while (-1 == graw_buffers(bdev, block, size)) {
 			free_more_memory(size);
 		}
@@ -95,7 +107,7 @@ static void free_more_memory(size_t size) {
 
 		sysfree(bh->data);
 		pool_free(&bcach_ht_item_pool, ht_item);
-		pool_free(&buffer_head_pool, bh);
+		objfree(&buffer_head_pool, bh);
 	}
 }
 
@@ -103,7 +115,7 @@ static int graw_buffers(struct block_dev *bdev, int block, size_t size) {
 	struct buffer_head *bh;
 	struct hashtable_item *ht_item;
 
-	bh = pool_alloc(&buffer_head_pool);
+	bh = objalloc(&buffer_head_pool);
 
 	if (!bh) {
 		return -1;
@@ -120,13 +132,13 @@ static int graw_buffers(struct block_dev *bdev, int block, size_t size) {
 	bh->data = sysmemalign(BCACHE_ALIGN, size);
 
 	if (!bh->data) {
-		pool_free(&buffer_head_pool, bh);
+		objfree(&buffer_head_pool, bh);
 		return -1;
 	}
 	ht_item = pool_alloc(&bcach_ht_item_pool);
 	if (!ht_item) {
 		sysfree(bh->data);
-		pool_free(&buffer_head_pool, bh);
+		objfree(&buffer_head_pool, bh);
 		return -1;
 	}
 	ht_item = hashtable_item_init(ht_item, bh, bh);
@@ -170,6 +170,8 @@ int devfs_fill_sb(struct super_block *sb, const char *source) {
 	sb->sb_iops = &devfs_iops;
 	sb->sb_fops = &devfs_fops;
 	sb->sb_ops = &devfs_sbops;
+	/* Devices are registered without VFS knowing about it */
+	sb->sb_flags |= SB_NO_NEGATIVE_DENTRY;
 
 	return block_devs_init();
 }
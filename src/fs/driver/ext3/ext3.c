@@ -274,7 +274,7 @@ static int ext3fs_create_jornal(struct super_block *sb, struct inode *dest) {
 	assert(jp->j_blocksize == fsi->s_block_size);
 	fsi->journal = jp;
 
-	return 0;
+	return journal_start_thread(jp);
 }
 
 static int ext3fs_fill_sb(struct super_block *sb, const char *source) {
@@ -18,18 +18,10 @@ static int journal_write_desc_blocks(journal_t *jp);
 static int journal_write_commit_block(journal_t *jp);
 
 int ext3_journal_commit(journal_t *jp) {
-    if (jp->j_running_transaction == NULL) {
+    if (jp->j_committing_transaction == NULL) {
 		return -EAGAIN;
     }
 
-    /* We cannot commit two transactions at the same time. */
-    if (jp->j_committing_transaction != NULL) {
-		return -EBUSY;
-    }
-
-    jp->j_committing_transaction = jp->j_running_transaction;
-    jp->j_running_transaction    = journal_new_trans(jp);
-
     if (journal_write_desc_blocks(jp) != 0) {
     	return -1;
     }
@@ -37,9 +29,6 @@ int ext3_journal_commit(journal_t *jp) {
     	return -1;
     }
 
-    dlist_add_prev(&jp->j_committing_transaction->t_next, &jp->j_checkpoint_transactions);
-    jp->j_committing_transaction = NULL;
-
     return 0;
 }
 
@@ -85,67 +74,87 @@ int ext3_journal_trans_freespace(journal_t *jp, size_t nblocks) {
     	return -1;
     }
 
+    /* Called under j_lock, journal_start() checkpoints to free the log */
     if (EXT3_JOURNAL_NBLOCKS_NEEDED(jp, nblocks) > jp->j_free) {
-    	journal_checkpoint_transactions(jp);
-    	if (EXT3_JOURNAL_NBLOCKS_NEEDED(jp, nblocks) > jp->j_free) {
-    		return -1;
-    	}
+    	return -1;
     }
 
     return 0;
 }
 
+/**
+ * Writes the transaction's blocks to the log. Every EXT3_JOURNAL_NTAGS_PER_DESC
+ * blocks are preceded by a descriptor block. The place for a descriptor is
+ * reserved before its blocks and the descriptor itself is written when
+ * all of its tags are known.
+ */
 static int journal_write_desc_blocks(journal_t *jp) {
     transaction_t *t = jp->j_committing_transaction;
     journal_block_t *b, *desc_b = NULL;
     ext3_journal_header_t *hdr = NULL;
     ext3_journal_block_tag_t *tag = NULL;
+    unsigned long j_head, desc_pos = 0;
+    int ntags, i = 0;
 
     t->t_state = T_FLUSH;
+    t->t_log_start = jp->j_head;
 
     desc_b = journal_new_block(jp, jp->j_head);
-    assert(desc_b);
-
-	hdr = (ext3_journal_header_t *)desc_b->data;
-	hdr->h_magic     = htonl(EXT3_MAGIC_NUMBER);
-	hdr->h_blocktype = htonl(EXT3_DESCRIPTOR_BLOCK);
-	hdr->h_sequence  = htonl(t->t_tid);
+    if (!desc_b) {
+    	return -1;
+    }
 
-	tag  = (ext3_journal_block_tag_t *) (((ext3_journal_header_t *)desc_b->data) + 1);
+    ntags  = EXT3_JOURNAL_NTAGS_PER_DESC(jp);
+    /* used to restore previous j_head position if write failed */
+    j_head = jp->j_head;
 
-    /* Fill descriptor block and add it as first element */
     dlist_foreach_entry(b, &t->t_buffers, b_next) {
-		/* Fill descriptor with update tags. */
-		t->t_log_blocks++;
+    	if (i % ntags == 0) {
+    		desc_pos = jp->j_head;
+    		jp->j_head = journal_wrap(jp, jp->j_head + 1);
+    		t->t_log_blocks++;
+
+    		memset(desc_b->data, 0, jp->j_blocksize);
+    		hdr = (ext3_journal_header_t *)desc_b->data;
+    		hdr->h_magic     = htonl(EXT3_MAGIC_NUMBER);
+    		hdr->h_blocktype = htonl(EXT3_DESCRIPTOR_BLOCK);
+    		hdr->h_sequence  = htonl(t->t_tid);
+    		tag = (ext3_journal_block_tag_t *) (hdr + 1);
+    	}
+    	i++;
 
-		if (t->t_log_blocks == t->t_nr_buffers ||
-				t->t_log_blocks >= EXT3_JOURNAL_NTAGS_PER_DESC(jp)) {
+		/* Fill descriptor with update tags. */
+		if (i == t->t_nr_buffers || i % ntags == 0) {
 			tag->t_flags = htonl(EXT3_FLAG_LAST_TAG);
 		} else {
 			tag->t_flags = htonl(EXT3_FLAG_SAME_UUID); /* XXX check it */
 		}
-
 		(tag++)->t_blocknr = htonl(b->blocknr);
-    }
-    /* desc_b */
-    t->t_log_blocks++;
-
-    /**
-     * TODO journal must support multiple descriptor blocks per transaction
-     */
-    assert(t->t_log_blocks <= EXT3_JOURNAL_NTAGS_PER_DESC(jp));
 
-    dlist_add_next(dlist_head_init(&desc_b->b_next), &t->t_buffers);
+		if (0 >= journal_write_block(jp, b->data, 1,
+				jp->j_fs_specific.bmap(jp, jp->j_head))) {
+			goto err;
+		}
+		jp->j_head = journal_wrap(jp, jp->j_head + 1);
+		t->t_log_blocks++;
 
-    if (0 > journal_write_blocks_list(jp, &t->t_buffers, t->t_log_blocks)) {
-    	dlist_del(&desc_b->b_next);
-    	journal_free_block(jp, desc_b);
-    	return -1;
+		if (i == t->t_nr_buffers || i % ntags == 0) {
+			if (0 >= journal_write_block(jp, desc_b->data, 1,
+					jp->j_fs_specific.bmap(jp, desc_pos))) {
+				goto err;
+			}
+		}
     }
 
-    dlist_del(&desc_b->b_next);
+    journal_free_block(jp, desc_b);
 
     return 0;
+
+err:
+	journal_free_block(jp, desc_b);
+	jp->j_head = j_head;
+	t->t_log_blocks = 0;
+	return -1;
 }
 
 static int journal_write_commit_block(journal_t *jp) {
@@ -156,7 +165,9 @@ static int journal_write_commit_block(journal_t *jp) {
     t->t_state = T_COMMIT;
 
     commit_b = journal_new_block(jp, jp->j_head);
-    assert(commit_b);
+    if (!commit_b) {
+    	return -1;
+    }
 
     /* Fill commit block. */
     memset(commit_b->data, 0, jp->j_blocksize);
@@ -172,7 +183,7 @@ static int journal_write_commit_block(journal_t *jp) {
     }
     journal_free_block(jp, commit_b);
 
-    jp->j_head = journal_wrap(jp, jp->j_head++);
+    jp->j_head = journal_wrap(jp, jp->j_head + 1);
 
     t->t_log_blocks++;
     t->t_state = T_FINISHED;
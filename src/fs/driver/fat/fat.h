@@ -12,6 +12,13 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <framework/mod/options.h>
+#include <module/embox/fs/driver/fat.h>
+
+#define FAT_MAX_SECTOR_SIZE OPTION_MODULE_GET(embox__fs__driver__fat, NUMBER, fat_max_sector_size)
+#define FAT_CACHE_SECTORS   OPTION_MODULE_GET(embox__fs__driver__fat, NUMBER, fat_cache_sectors)
+#define FAT_FILE_EXTENTS    OPTION_MODULE_GET(embox__fs__driver__fat, NUMBER, file_extents)
+
 #define DIR_SEPARATOR   '/'	/* character separating directory components*/
 #define ROOT_DIR        "/"
 #define MSDOS_NAME      11
@@ -232,10 +239,34 @@ struct volinfo {
  */
 #define DFS_DI_BLANKENT		0x01	/* Searching for blank entry */
 
+/*
+ * Cached sector of the first FAT copy. Dirty sectors are written to both
+ * copies on eviction or by fat_fat_flush()
+ */
+struct fat_cache_sector {
+	uint32_t sector;
+	uint32_t stamp;				/* LRU stamp */
+	uint8_t valid;
+	uint8_t dirty;
+	uint8_t data[FAT_MAX_SECTOR_SIZE];
+};
+
 struct fat_fs_info {
 	struct volinfo vi;
 	struct block_dev *bdev;
 	struct inode *root;
+
+	struct fat_cache_sector fat_cache[FAT_CACHE_SECTORS];
+	uint32_t fat_cache_stamp;
+	unsigned long *free_map;	/* bit per cluster, set if cluster is used */
+	uint32_t free_hint;			/* where to start next free cluster search */
+};
+
+/* Run of physically contiguous clusters of a file */
+struct fat_extent {
+	uint32_t fclus;				/* index of the first cluster within file */
+	uint32_t dclus;				/* cluster number on disk */
+	uint32_t len;				/* number of clusters */
 };
 
 struct fat_file_info {
@@ -249,7 +280,14 @@ struct fat_file_info {
 	uint32_t filelen;			/* byte length of file */
 
 	uint32_t pointer;
-	uint32_t cluster;			/* current cluster */
+	uint32_t cluster;			/* first cluster, used to match dir entries */
+
+	/* Cluster chain cache. Extents cover the chain from its beginning,
+	 * the walk cursor remembers the farthest cluster seen beyond them */
+	int ext_n;
+	struct fat_extent ext[FAT_FILE_EXTENTS];
+	uint32_t cur_fclus;
+	uint32_t cur_dclus;
 };
 
 /*
@@ -264,9 +302,6 @@ struct dirinfo {
 	uint8_t flags;				/* internal DOSFS flags */
 };
 
-#include <framework/mod/options.h>
-#define FAT_MAX_SECTOR_SIZE OPTION_MODULE_GET(embox__fs__driver__fat, NUMBER, fat_max_sector_size)
-
 static inline int fat_sec_by_clus(struct fat_fs_info *fsi, int clus) {
 	return (clus - 2) * fsi->vi.secperclus + fsi->vi.dataarea;
 }
@@ -295,6 +330,10 @@ extern uint32_t fat_write_file(struct fat_file_info *fi, uint8_t *p_scratch,
 extern int      fat_root_dir_record(void *bdev);
 extern int      fat_create_file(struct fat_file_info *fi, struct dirinfo *di, char *name, int mode);
 extern int      fat_unlike_file(struct fat_file_info *fi, uint8_t *p_scratch);
+extern uint32_t fat_get_fat(struct fat_fs_info *fsi, uint32_t cluster);
+extern int      fat_fat_flush(struct fat_fs_info *fsi);
+extern void     fat_fs_release(struct fat_fs_info *fsi);
+extern void     fat_file_chain_reset(struct fat_file_info *fi);
 
 extern struct fat_fs_info *fat_fs_alloc(void);
 extern void fat_fs_free(struct fat_fs_info *fsi);
@@ -24,6 +24,8 @@
 #include <fs/super_block.h>
 
 #include <fs/mbr.h>
+#include <lib/libds/bitmap.h>
+#include <mem/sysmalloc.h>
 
 #include "fat.h"
 
@@ -442,74 +444,163 @@ uint32_t fat_get_volinfo(void *bdev, struct volinfo * volinfo, uint32_t startsec
 }
 
 /*
- *	Fetch FAT entry for specified cluster number You must provide a scratch
- *	buffer for one sector (SECTOR_SIZE) and a populated struct volinfo
- *	Returns a FAT32 BAD_CLUSTER value for any error, otherwise the contents
- *	of the desired FAT entry.
+ * FAT sectors are kept in a small LRU cache, so walking a cluster chain
+ * does not read the same sector again for every entry, and updates of
+ * neighbouring entries are written back once.
  */
-uint32_t fat_get_fat(struct fat_fs_info *fsi,
-		uint8_t *p_scratch, uint32_t cluster) {
-	uint32_t offset, sector, result;
-	struct volinfo *volinfo = &fsi->vi;
+static int fat_cache_writeback(struct fat_fs_info *fsi,
+		struct fat_cache_sector *cs) {
+	if (fat_write_sector(fsi, cs->data, cs->sector)) {
+		return DFS_ERRMISC;
+	}
+	/* mirror the FAT into copy 2 */
+	if (fat_write_sector(fsi, cs->data, cs->sector + fsi->vi.secperfat)) {
+		return DFS_ERRMISC;
+	}
+	cs->dirty = 0;
+
+	return DFS_OK;
+}
+
+static struct fat_cache_sector *fat_cache_get(struct fat_fs_info *fsi,
+		uint32_t sector) {
+	struct fat_cache_sector *cs, *victim = NULL;
+	int i;
+
+	for (i = 0; i < FAT_CACHE_SECTORS; i++) {
+		cs = &fsi->fat_cache[i];
+		if (cs->valid && cs->sector == sector) {
+			cs->stamp = ++fsi->fat_cache_stamp;
+			return cs;
+		}
+		if (!victim || (victim->valid &&
+				(!cs->valid || cs->stamp < victim->stamp))) {
+			victim = cs;
+		}
+	}
+
+	/* The victim is clean once written back, so a failed read can bring
+	 * its sector back from the disk */
+	if (victim->valid && victim->dirty) {
+		if (fat_cache_writeback(fsi, victim)) {
+			return NULL;
+		}
+	}
+
+	if (fat_read_sector(fsi, victim->data, sector)) {
+		if (victim->valid
+				&& fat_read_sector(fsi, victim->data, victim->sector)) {
+			victim->valid = 0;
+		}
+		return NULL;
+	}
+	victim->sector = sector;
+	victim->valid = 1;
+	victim->dirty = 0;
+	victim->stamp = ++fsi->fat_cache_stamp;
+
+	return victim;
+}
+
+/*
+ * Write all modified FAT sectors to the disk
+ */
+int fat_fat_flush(struct fat_fs_info *fsi) {
+	int i, res = DFS_OK;
+
+	for (i = 0; i < FAT_CACHE_SECTORS; i++) {
+		if (fsi->fat_cache[i].valid && fsi->fat_cache[i].dirty) {
+			if (fat_cache_writeback(fsi, &fsi->fat_cache[i])) {
+				res = DFS_ERRMISC;
+			}
+		}
+	}
 
+	return res;
+}
+
+/*
+ * Flush FAT and drop in-memory state of the volume
+ */
+void fat_fs_release(struct fat_fs_info *fsi) {
+	fat_fat_flush(fsi);
+
+	if (fsi->free_map) {
+		sysfree(fsi->free_map);
+		fsi->free_map = NULL;
+	}
+}
+
+static uint32_t fat_entry_offset(struct volinfo *volinfo, uint32_t cluster) {
 	switch (volinfo->filesystem) {
 	case FAT12:
-		offset = cluster + (cluster / 2);
-		break;
+		return cluster + (cluster / 2);
 	case FAT16:
-		offset = cluster * 2;
-		break;
+		return cluster * 2;
 	case FAT32:
-		offset = cluster * 4;
-		break;
+		return cluster * 4;
 	default:
+		return DFS_ERRMISC;
+	}
+}
+
+/*
+ *	Fetch FAT entry for specified cluster number.
+ *	Returns a FAT32 BAD_CLUSTER value for any error, otherwise the contents
+ *	of the desired FAT entry.
+ */
+uint32_t fat_get_fat(struct fat_fs_info *fsi, uint32_t cluster) {
+	uint32_t offset, sector, result;
+	struct volinfo *volinfo = &fsi->vi;
+	struct fat_cache_sector *cs;
+	uint8_t *p;
+
+	offset = fat_entry_offset(volinfo, cluster);
+	if (offset == DFS_ERRMISC) {
 		return DFS_BAD_CLUS;
 	}
 
 	sector = offset / volinfo->bytepersec + volinfo->fat1;
 
-	if (fat_read_sector(fsi, p_scratch, sector)) {
+	if (NULL == (cs = fat_cache_get(fsi, sector))) {
 		return DFS_BAD_CLUS;
 	}
+	p = cs->data;
 
 	/*
 	 * At this point, we "merely" need to extract the relevant entry.
 	 * This is easy for FAT16 and FAT32, but a royal PITA for FAT12 as
-	 * a single entry may span a sector boundary. The normal way around this is
-	 * always to read two FAT sectors, but that luxury is (by design intent)
-	 * unavailable to DOSFS.
+	 * a single entry may span a sector boundary.
 	 */
 	offset %= volinfo->bytepersec;
 	if (volinfo->filesystem == FAT12) {
 		/* Special case for sector boundary - Store last byte of current sector
-		 * Then read in the next sector and put the first byte of that sector
+		 * Then fetch the next sector and put the first byte of that sector
 		 * into the high byte of result.
 		 */
 		if (offset == volinfo->bytepersec - 1) {
-			result = (uint32_t) p_scratch[offset];
-			sector++;
-			if (fat_read_sector(fsi, p_scratch, sector)) {
+			result = (uint32_t) p[offset];
+			if (NULL == (cs = fat_cache_get(fsi, sector + 1))) {
 				return DFS_BAD_CLUS;
 			}
-			result |= ((uint32_t) p_scratch[0]) << 8;
+			result |= ((uint32_t) cs->data[0]) << 8;
 		} else {
-			result = (uint32_t) p_scratch[offset] |
-			  ((uint32_t) p_scratch[offset+1]) << 8;
+			result = (uint32_t) p[offset] |
+			  ((uint32_t) p[offset+1]) << 8;
 		}
 		if (cluster & 1)
 			result = result >> 4;
 		else
 			result = result & 0xfff;
 	} else if (volinfo->filesystem == FAT16) {
-		result = (uint32_t) p_scratch[offset] |
-		  ((uint32_t) p_scratch[offset+1]) << 8;
-	} else if (volinfo->filesystem == FAT32) {
-		result = ((uint32_t) p_scratch[offset] |
-		  ((uint32_t) p_scratch[offset+1]) << 8 |
-		  ((uint32_t) p_scratch[offset+2]) << 16 |
-		  ((uint32_t) p_scratch[offset+3]) << 24) & 0x0fffffff;
-	} else
-		result = DFS_BAD_CLUS;
+		result = (uint32_t) p[offset] |
+		  ((uint32_t) p[offset+1]) << 8;
+	} else {
+		result = ((uint32_t) p[offset] |
+		  ((uint32_t) p[offset+1]) << 8 |
+		  ((uint32_t) p[offset+2]) << 16 |
+		  ((uint32_t) p[offset+3]) << 24) & 0x0fffffff;
+	}
 
 	return result;
 }
@@ -541,27 +632,19 @@ static uint32_t fat_is_end_of_chain(struct fat_fs_info *fsi, uint32_t clus) {
 }
 
 /*
- * Set FAT entry for specified cluster number
- * You must provide a scratch buffer for one sector (SECTOR_SIZE)
- * and a populated volinfo_t Returns DFS_ERRMISC for any error, otherwise
- * DFS_OK p_scratchcache should point to a UINT32.
- * */
-static uint32_t fat_set_fat(struct fat_fs_info *fsi, uint8_t *p_scratch,
+ * Set FAT entry for specified cluster number.
+ * The change stays in the FAT cache until fat_fat_flush() or eviction.
+ * Returns DFS_ERRMISC for any error, otherwise DFS_OK.
+ */
+static uint32_t fat_set_fat(struct fat_fs_info *fsi,
 		uint32_t cluster, uint32_t new_contents) {
-	uint32_t offset, sector, result;
+	uint32_t offset, sector;
 	struct volinfo *volinfo = &fsi->vi;
+	struct fat_cache_sector *cs;
+	uint8_t *p;
 
-	switch (volinfo->filesystem) {
-	case FAT12:
-		offset = cluster + (cluster / 2);
-		break;
-	case FAT16:
-		offset = cluster * 2;
-		break;
-	case FAT32:
-		offset = cluster * 4;
-		break;
-	default:
+	offset = fat_entry_offset(volinfo, cluster);
+	if (offset == DFS_ERRMISC) {
 		return DFS_ERRMISC;
 	}
 
@@ -573,17 +656,12 @@ static uint32_t fat_set_fat(struct fat_fs_info *fsi, uint8_t *p_scratch,
 	 */
 	sector = offset / volinfo->bytepersec + volinfo->fat1;
 
-	if (fat_read_sector(fsi, p_scratch, sector)) {
+	if (NULL == (cs = fat_cache_get(fsi, sector))) {
 		return DFS_ERRMISC;
 	}
+	p = cs->data;
+	cs->dirty = 1;
 
-	/*
-	 * At this point, we "merely" need to extract the relevant entry.
-	 * This is easy for FAT16 and FAT32, but a royal PITA for FAT12 as a
-	 * single entry may span a sector boundary. The normal way around this
-	 * is always to read two FAT sectors, but that luxury is (by design intent)
-	 * unavailable to DOSFS.
-	 */
 	offset %= volinfo->bytepersec;
 
 	switch (volinfo->filesystem) {
@@ -594,46 +672,26 @@ static uint32_t fat_set_fat(struct fat_fs_info *fsi, uint8_t *p_scratch,
 		if (offset == volinfo->bytepersec - 1) {
 			/* Odd cluster: High 12 bits being set */
 			if (cluster & 1) {
-				p_scratch[offset] = (p_scratch[offset] & 0x0f) |
-						(new_contents & 0xf0);
+				p[offset] = (p[offset] & 0x0f) | (new_contents & 0xf0);
 			}
 			/* Even cluster: Low 12 bits being set */
 			else {
-				p_scratch[offset] = new_contents & 0xff;
+				p[offset] = new_contents & 0xff;
 			}
-			result = fat_write_sector(fsi, p_scratch, sector);
-			/* mirror the FAT into copy 2 */
-			if (DFS_OK == result) {
-				result = fat_write_sector(fsi, p_scratch,
-						sector + volinfo->secperfat);
+
+			/* The rest of the entry lives in the next sector */
+			if (NULL == (cs = fat_cache_get(fsi, sector + 1))) {
+				return DFS_ERRMISC;
 			}
+			p = cs->data;
+			cs->dirty = 1;
 
-			/*
-			 * If we wrote that sector OK, then read in the subsequent sector
-			 * and poke the first byte with the remainder of this FAT entry.
-			 */
-			if (DFS_OK == result) {
-				result = fat_read_sector(fsi, p_scratch, ++sector);
-				if (DFS_OK == result) {
-					/* Odd cluster: High 12 bits being set*/
-					if (cluster & 1) {
-						p_scratch[0] = new_contents & 0xff00;
-					}
-					/* Even cluster: Low 12 bits being set */
-					else {
-						p_scratch[0] = (p_scratch[0] & 0xf0) |
-								(new_contents & 0x0f);
-					}
-					result = fat_write_sector(fsi, p_scratch, sector);
-					/* mirror the FAT into copy 2 */
-					if (DFS_OK == result) {
-						result = fat_write_sector(fsi, p_scratch,
-								sector+volinfo->secperfat);
-					}
-				}
+			if (cluster & 1) {
+				p[0] = (new_contents & 0xff00) >> 8;
+			} else {
+				p[0] = (p[0] & 0xf0) | ((new_contents & 0x0f00) >> 8);
 			}
 		}
-
 		/*
 		 * Not a sector boundary. But we still have to worry about if it's an
 		 * odd or even cluster number.
@@ -641,45 +699,37 @@ static uint32_t fat_set_fat(struct fat_fs_info *fsi, uint8_t *p_scratch,
 		else {
 			/* Odd cluster: High 12 bits being set */
 			if (cluster & 1) {
-				p_scratch[offset] = (p_scratch[offset] & 0x0f) |
-						(new_contents & 0xf0);
-				p_scratch[offset + 1] = (new_contents & 0xff00) >> 8;
+				p[offset] = (p[offset] & 0x0f) | (new_contents & 0xf0);
+				p[offset + 1] = (new_contents & 0xff00) >> 8;
 			}
 			/* Even cluster: Low 12 bits being set */
 			else {
-				p_scratch[offset] = new_contents & 0xff;
-				p_scratch[offset+1] = (p_scratch[offset+1] & 0xf0) |
+				p[offset] = new_contents & 0xff;
+				p[offset+1] = (p[offset+1] & 0xf0) |
 						((new_contents & 0x0f00) >> 8);
 			}
-			result = fat_write_sector(fsi, p_scratch, sector);
-			/* mirror the FAT into copy 2 */
-			if (DFS_OK == result) {
-				result = fat_write_sector(fsi, p_scratch,
-						sector + volinfo->secperfat);
-			}
 		}
 		break;
 	case FAT32:
-		p_scratch[offset + 3] = (p_scratch[offset  + 3] & 0xf0) |
+		p[offset + 3] = (p[offset  + 3] & 0xf0) |
 				((new_contents & 0x0f000000) >> 24);
-		p_scratch[offset + 2] = (new_contents & 0xff0000) >> 16;
+		p[offset + 2] = (new_contents & 0xff0000) >> 16;
 		/* Fall through */
 	case FAT16:
-		p_scratch[offset + 1] = (new_contents & 0xff00) >> 8;
-		p_scratch[offset] = (new_contents & 0xff);
-		result = fat_write_sector(fsi, p_scratch, sector);
-		/* mirror the FAT into copy 2 */
-		if (DFS_OK == result)
-			result = fat_write_sector(
-					fsi,
-					p_scratch,
-					sector + volinfo->secperfat
-				);
+		p[offset + 1] = (new_contents & 0xff00) >> 8;
+		p[offset] = (new_contents & 0xff);
 		break;
-	default:
-		result = DFS_ERRMISC;
 	}
-	return result;
+
+	if (fsi->free_map && cluster < volinfo->numclusters) {
+		if (new_contents) {
+			bitmap_set_bit(fsi->free_map, cluster);
+		} else {
+			bitmap_clear_bit(fsi->free_map, cluster);
+		}
+	}
+
+	return DFS_OK;
 }
 
 /* For long names string is divided in a pretty ugly way so old drivers
@@ -719,27 +769,275 @@ static void fat_append_longname(char *name, struct fat_dirent *di) {
 }
 
 /*
- * 	Find the first unused FAT entry
- * 	You must provide a scratch buffer for one sector (SECTOR_SIZE) and a
- * 	populated volinfo_t Returns a FAT32 BAD_CLUSTER value for any error,
- * 	otherwise the contents of the desired FAT entry.
+ * Build the map of used clusters with a single pass over the FAT. If there
+ * is no memory for it free cluster search falls back to scanning the FAT.
+ */
+static void fat_free_map_init(struct fat_fs_info *fsi) {
+	uint32_t i, n = fsi->vi.numclusters;
+
+	fsi->free_map = sysmalloc(BITMAP_SIZE(n) * sizeof(unsigned long));
+	if (!fsi->free_map) {
+		return;
+	}
+	memset(fsi->free_map, 0, BITMAP_SIZE(n) * sizeof(unsigned long));
+
+	/* Clusters 0 and 1 are reserved */
+	bitmap_set_bit(fsi->free_map, 0);
+	bitmap_set_bit(fsi->free_map, 1);
+	for (i = 2; i < n; i++) {
+		if (fat_get_fat(fsi, i)) {
+			bitmap_set_bit(fsi->free_map, i);
+		}
+	}
+	fsi->free_hint = 2;
+}
+
+/*
+ * 	Find an unused FAT entry, preferably the one at @goal or after it so
+ * 	files grow into contiguous runs. Zero @goal means "next to the
+ * 	previous allocation".
  * 	Returns FAT32 bad_sector (0x0ffffff7) if there is no free cluster available
  */
-static uint32_t fat_get_free_fat(struct fat_fs_info *fsi, uint8_t *p_scratch) {
-	uint32_t i;
+static uint32_t fat_get_free_fat(struct fat_fs_info *fsi, uint32_t goal) {
+	uint32_t i, n = fsi->vi.numclusters;
+
+	if (!fsi->free_map) {
+		fat_free_map_init(fsi);
+	}
+
+	if (goal < 2 || goal >= n) {
+		goal = fsi->free_hint;
+	}
+	if (goal < 2 || goal >= n) {
+		goal = 2;
+	}
+
+	if (fsi->free_map) {
+		i = bitmap_find_zero_bit(fsi->free_map, n, goal);
+		if (i >= n) {
+			i = bitmap_find_zero_bit(fsi->free_map, n, 2);
+		}
+		if (i >= n) {
+			return DFS_BAD_CLUS;
+		}
+		fsi->free_hint = i + 1;
+		return i;
+	}
+
 	/*
-	 * Search starts at cluster 2, which is the first usable cluster
 	 * NOTE: This search can't terminate at a bad cluster, because there might
 	 * legitimately be bad clusters on the disk.
 	 */
-	for (i = 2; i < fsi->vi.numclusters; i++) {
-		if (!fat_get_fat(fsi, p_scratch, i)) {
+	for (i = goal; i < n; i++) {
+		if (!fat_get_fat(fsi, i)) {
+			fsi->free_hint = i + 1;
+			return i;
+		}
+	}
+	for (i = 2; i < goal; i++) {
+		if (!fat_get_fat(fsi, i)) {
+			fsi->free_hint = i + 1;
 			return i;
 		}
 	}
 	return DFS_BAD_CLUS;
 }
 
+static inline int fat_clus_valid(struct fat_fs_info *fsi, uint32_t clus) {
+	return clus >= 2 && !fat_is_end_of_chain(fsi, clus);
+}
+
+/*
+ * Forget cached cluster chain of the file, e.g. when first cluster changes
+ */
+void fat_file_chain_reset(struct fat_file_info *fi) {
+	fi->ext_n = 0;
+	fi->cur_fclus = 0;
+	fi->cur_dclus = fi->firstcluster;
+}
+
+/* Remember that cluster @fclus of the file is disk cluster @dclus */
+static void fat_file_extent_add(struct fat_file_info *fi,
+		uint32_t fclus, uint32_t dclus) {
+	struct fat_extent *last;
+
+	if (fi->ext_n) {
+		last = &fi->ext[fi->ext_n - 1];
+		if (fclus != last->fclus + last->len) {
+			/* Extents must cover the chain without gaps */
+			return;
+		}
+		if (dclus == last->dclus + last->len) {
+			last->len++;
+			return;
+		}
+	} else if (fclus != 0) {
+		return;
+	}
+
+	if (fi->ext_n == FAT_FILE_EXTENTS) {
+		return;
+	}
+
+	fi->ext[fi->ext_n++] = (struct fat_extent) {
+		.fclus = fclus,
+		.dclus = dclus,
+		.len   = 1,
+	};
+}
+
+static struct fat_extent *fat_file_extent_find(struct fat_file_info *fi,
+		uint32_t fclus) {
+	int lo = 0, hi = fi->ext_n, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (fclus < fi->ext[mid].fclus) {
+			hi = mid;
+		} else if (fclus >= fi->ext[mid].fclus + fi->ext[mid].len) {
+			lo = mid + 1;
+		} else {
+			return &fi->ext[mid];
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Get disk cluster holding cluster @fclus of the file. @run is set to the
+ * number of physically contiguous clusters known to start there. Returns
+ * end of chain mark if the file is shorter. On return the walk cursor
+ * points to the farthest cluster reached.
+ */
+static uint32_t fat_file_cluster(struct fat_file_info *fi, uint32_t fclus,
+		uint32_t *run) {
+	struct fat_fs_info *fsi = fi->fsi;
+	struct fat_extent *e;
+	uint32_t f, d;
+
+	e = fat_file_extent_find(fi, fclus);
+	if (e) {
+		*run = e->len - (fclus - e->fclus);
+		return e->dclus + (fclus - e->fclus);
+	}
+
+	/* Walk the chain from the farthest known point before fclus */
+	if (fi->ext_n) {
+		e = &fi->ext[fi->ext_n - 1];
+		f = e->fclus + e->len - 1;
+		d = e->dclus + e->len - 1;
+	} else {
+		f = 0;
+		d = fi->firstcluster;
+		if (!fat_clus_valid(fsi, d)) {
+			return fat_end_of_chain(fsi);
+		}
+		fat_file_extent_add(fi, 0, d);
+	}
+	if (fi->cur_fclus > f && fi->cur_fclus <= fclus) {
+		f = fi->cur_fclus;
+		d = fi->cur_dclus;
+	}
+
+	while (f < fclus) {
+		uint32_t next = fat_get_fat(fsi, d);
+
+		if (!fat_clus_valid(fsi, next)) {
+			break;
+		}
+		d = next;
+		f++;
+		fat_file_extent_add(fi, f, d);
+	}
+	fi->cur_fclus = f;
+	fi->cur_dclus = d;
+
+	if (f < fclus) {
+		return fat_end_of_chain(fsi);
+	}
+
+	e = fat_file_extent_find(fi, fclus);
+	*run = e ? e->len - (fclus - e->fclus) : 1;
+
+	return d;
+}
+
+/*
+ * Make sure the file has clusters up to @fclus, allocating and linking
+ * new clusters after the current last one. On failure the clusters
+ * linked so far are given back, so the file keeps its old length.
+ */
+static uint32_t fat_file_extend(struct fat_file_info *fi, uint32_t fclus) {
+	struct fat_fs_info *fsi = fi->fsi;
+	uint32_t run, f, tail, last, clus, next;
+
+	if (fat_clus_valid(fsi, fat_file_cluster(fi, fclus, &run))) {
+		return DFS_OK;
+	}
+
+	f = fi->cur_fclus;
+	tail = last = fi->cur_dclus;
+	while (f < fclus) {
+		clus = fat_get_free_fat(fsi, last + 1);
+		if (clus == DFS_BAD_CLUS) {
+			goto err;
+		}
+		if (fat_set_fat(fsi, clus, fat_end_of_chain(fsi))) {
+			fat_set_fat(fsi, clus, 0);
+			goto err;
+		}
+		if (fat_set_fat(fsi, last, clus)) {
+			fat_set_fat(fsi, clus, 0);
+			goto err;
+		}
+		f++;
+		last = clus;
+		fat_file_extent_add(fi, f, clus);
+		fi->cur_fclus = f;
+		fi->cur_dclus = clus;
+	}
+
+	return DFS_OK;
+
+err:
+	if (last != tail) {
+		clus = fat_get_fat(fsi, tail);
+		fat_set_fat(fsi, tail, fat_end_of_chain(fsi));
+		while (fat_clus_valid(fsi, clus)) {
+			next = fat_get_fat(fsi, clus);
+			fat_set_fat(fsi, clus, 0);
+			clus = next;
+		}
+	}
+	fat_file_chain_reset(fi);
+
+	return DFS_ERRMISC;
+}
+
+/* Transfer @count sectors starting at @sector with a single request */
+static int fat_read_sectors(struct fat_fs_info *fsi, uint8_t *buffer,
+		uint32_t sector, uint32_t count) {
+	size_t len = count * fsi->vi.bytepersec;
+	int blk = sector * (fsi->vi.bytepersec / fsi->bdev->block_size);
+
+	if (block_dev_read(fsi->bdev, (char *) buffer, len, blk) != (int) len) {
+		return DFS_ERRMISC;
+	}
+	return DFS_OK;
+}
+
+static int fat_write_sectors(struct fat_fs_info *fsi, uint8_t *buffer,
+		uint32_t sector, uint32_t count) {
+	size_t len = count * fsi->vi.bytepersec;
+	int blk = sector * (fsi->vi.bytepersec / fsi->bdev->block_size);
+
+	if (block_dev_write(fsi->bdev, (char *) buffer, len, blk) != (int) len) {
+		return DFS_ERRMISC;
+	}
+	return DFS_OK;
+}
+
 uint32_t fat_open_rootdir(struct fat_fs_info *fsi, struct dirinfo *dirinfo) {
 	struct volinfo *volinfo;
 	uint32_t ret;
@@ -795,9 +1093,7 @@ static uint32_t fat_fetch_dir(struct dirinfo *dir) {
 
 				dir->currentsector = 0;
 
-				tempclus = fat_get_fat(fsi,
-						dir->p_scratch,
-						dir->currentcluster);
+				tempclus = fat_get_fat(fsi, dir->currentcluster);
 
 				if (fat_is_end_of_chain(fsi, tempclus)) {
 					return DFS_ALLOCNEW;
@@ -983,7 +1279,7 @@ static uint32_t fat_clear_clus(struct fat_fs_info *fsi,
 static uint32_t fat_dir_extend(struct dirinfo *di) {
 	struct fat_fs_info *fsi = di->fi.fsi;
 	uint32_t clus;
-	clus = fat_get_free_fat(fsi, di->p_scratch);
+	clus = fat_get_free_fat(fsi, di->currentcluster + 1);
 	if (clus == DFS_BAD_CLUS) {
 		return DFS_ERRMISC;
 	}
@@ -992,7 +1288,7 @@ static uint32_t fat_dir_extend(struct dirinfo *di) {
 		return DFS_ERRMISC;
 	}
 
-	fat_set_fat(fsi, di->p_scratch, di->currentcluster, clus);
+	fat_set_fat(fsi, di->currentcluster, clus);
 
 	di->currentcluster = clus;
 	di->currentsector = 0;
@@ -1000,7 +1296,11 @@ static uint32_t fat_dir_extend(struct dirinfo *di) {
 				 so next loop will call */
 	clus = fat_end_of_chain(fsi);
 
-	fat_set_fat(fsi, di->p_scratch, di->currentcluster, clus);
+	fat_set_fat(fsi, di->currentcluster, clus);
+
+	if (fat_fat_flush(fsi)) {
+		return DFS_ERRMISC;
+	}
 
 	read_dir_buf(di);
 
@@ -1073,28 +1373,36 @@ static void fat_set_direntry(uint32_t dir_cluster, uint32_t cluster) {
 
 int fat_root_dir_record(void *bdev) {
 	uint32_t cluster;
-	struct fat_fs_info fsi;
+	struct fat_fs_info *fsi;
 	uint32_t pstart, psize;
 	uint8_t pactive, ptype;
 	struct fat_dirent de;
 	int dev_blk_size = block_dev(bdev)->block_size;
 	int root_dir_sz;
+	int res = DFS_ERRMISC;
 
 	assert(dev_blk_size > 0);
 
-	fsi.bdev = bdev;
+	/* FAT cache makes fat_fs_info too big for the stack */
+	if (NULL == (fsi = fat_fs_alloc())) {
+		return -1;
+	}
+	memset(fsi, 0, sizeof(*fsi));
+	fsi->bdev = bdev;
 
 	/* Obtain pointer to first partition on first (only) unit */
 	pstart = fat_get_ptn_start(bdev, 0, &pactive, &ptype, &psize);
 	if (pstart == 0xffffffff) {
-		return -1;
+		res = -1;
+		goto out;
 	}
 
-	if (fat_get_volinfo(bdev, &fsi.vi, pstart)) {
-		return -1;
+	if (fat_get_volinfo(bdev, &fsi->vi, pstart)) {
+		res = -1;
+		goto out;
 	}
 
-	cluster = fsi.vi.rootdir / fsi.vi.secperclus;
+	cluster = fsi->vi.rootdir / fsi->vi.secperclus;
 
 	de = (struct fat_dirent) {
 		.name = "ROOT DIR   ",
@@ -1116,13 +1424,13 @@ int fat_root_dir_record(void *bdev) {
 
 	if (0 > block_dev_write(	bdev,
 					(char *) fat_sector_buff,
-					fsi.vi.bytepersec,
-					fsi.vi.rootdir * fsi.vi.bytepersec / dev_blk_size)) {
-		return DFS_ERRMISC;
+					fsi->vi.bytepersec,
+					fsi->vi.rootdir * fsi->vi.bytepersec / dev_blk_size)) {
+		goto out;
 	}
 
-	root_dir_sz = (fsi.vi.rootentries * sizeof(struct fat_dirent) +
-	               fsi.vi.bytepersec - 1) / fsi.vi.bytepersec - 1;
+	root_dir_sz = (fsi->vi.rootentries * sizeof(struct fat_dirent) +
+	               fsi->vi.bytepersec - 1) / fsi->vi.bytepersec - 1;
 
 	if (root_dir_sz)
 		memset(fat_sector_buff, 0, sizeof(struct fat_dirent)); /* The rest is zeroes already */
@@ -1130,15 +1438,18 @@ int fat_root_dir_record(void *bdev) {
 	while (root_dir_sz) {
 		block_dev_write(bdev,
 				(char *) fat_sector_buff,
-				fsi.vi.bytepersec,
-				(root_dir_sz + fsi.vi.rootdir) * fsi.vi.bytepersec / dev_blk_size);
+				fsi->vi.bytepersec,
+				(root_dir_sz + fsi->vi.rootdir) * fsi->vi.bytepersec / dev_blk_size);
 		root_dir_sz--;
 	}
 
-	cluster = fat_end_of_chain(&fsi);
-	fat_set_fat(&fsi, fat_sector_buff, cluster, cluster);
+	cluster = fat_end_of_chain(fsi);
+	fat_set_fat(fsi, cluster, cluster);
 
-	return DFS_OK;
+	res = fat_fat_flush(fsi);
+out:
+	fat_fs_free(fsi);
+	return res;
 }
 
 /*
@@ -1155,6 +1466,8 @@ uint32_t fat_read_file(struct fat_file_info *fi, uint8_t *p_scratch,
 	uint32_t sector;
 	uint32_t bytesread;
 	uint32_t clastersize;
+	uint32_t clus, run, secoff, count;
+	uint16_t bytepersec;
 	struct fat_fs_info *fsi;
 	fsi = fi->fsi;
 
@@ -1164,19 +1477,29 @@ uint32_t fat_read_file(struct fat_file_info *fi, uint8_t *p_scratch,
 	result = DFS_OK;
 	remain = len;
 	*successcount = 0;
-	clastersize = fi->volinfo->secperclus * fi->volinfo->bytepersec;
+	bytepersec = fi->volinfo->bytepersec;
+	clastersize = fi->volinfo->secperclus * bytepersec;
+
+	if (len) {
+		/* Walk the chain for the whole request at once, so the extents
+		 * describe contiguous runs which are read with a single request */
+		fat_file_cluster(fi, (fi->pointer + len - 1) / clastersize, &run);
+	}
 
 	while (remain && result == DFS_OK) {
-		/* This is a bit complicated. The sector we want to read is addressed
-		 * at a cluster granularity by the fi->cluster member. The file
-		 * pointer tells us how many extra sectors to add to that number.
+		/* The sector we want to read is addressed at a cluster granularity
+		 * by the file pointer and the cluster chain of the file.
 		 */
-		sector = fi->volinfo->dataarea +
-		  ((fi->cluster - 2) * fi->volinfo->secperclus) +
-		  div(div(fi->pointer, clastersize).rem, fi->volinfo->bytepersec).quot;
+		clus = fat_file_cluster(fi, fi->pointer / clastersize, &run);
+		if (!fat_clus_valid(fsi, clus)) {
+			result = DFS_EOF;
+			break;
+		}
+		secoff = (fi->pointer % clastersize) / bytepersec;
+		sector = fat_sec_by_clus(fsi, clus) + secoff;
 
 		/* Case 1 - File pointer is not on a sector boundary */
-		if (div(fi->pointer, fi->volinfo->bytepersec).rem) {
+		if (fi->pointer % bytepersec) {
 			uint16_t tempreadsize;
 
 			/* We always have to go through scratch in this case */
@@ -1186,73 +1509,36 @@ uint32_t fat_read_file(struct fat_file_info *fi, uint8_t *p_scratch,
 			 * This is the number of bytes that we actually care about in the
 			 * sector just read.
 			 */
-			tempreadsize = fi->volinfo->bytepersec -
-					(div(fi->pointer, fi->volinfo->bytepersec).rem);
+			tempreadsize = bytepersec - (fi->pointer % bytepersec);
+			bytesread = min(remain, (uint32_t) tempreadsize);
 
-			/* Case 1A - We want the entire remainder of the sector. After this
-			 * point, all passes through the read loop will be aligned on a
-			 * sector boundary, which allows us to go through the optimal path
-			 *  2A below.
-			 */
-		   	if (remain >= tempreadsize) {
-				memcpy(buffer, p_scratch + (fi->volinfo->bytepersec - tempreadsize),
-						tempreadsize);
-				bytesread = tempreadsize;
-				buffer += tempreadsize;
-				fi->pointer += tempreadsize;
-				remain -= tempreadsize;
-			}
-			/* Case 1B - This read concludes the file read operation */
-			else {
-				memcpy(buffer, p_scratch +
-						(fi->volinfo->bytepersec - tempreadsize), remain);
-
-				buffer += remain;
-				fi->pointer += remain;
-				bytesread = remain;
-				remain = 0;
-			}
+			memcpy(buffer, p_scratch + (bytepersec - tempreadsize), bytesread);
 		}
-		/* Case 2 - File pointer is on sector boundary */
+		/* Case 2A - We have at least one more full sector to read and
+		 * don't have to go through the scratch buffer. Read as many whole
+		 * sectors as the contiguous run of clusters allows.
+		 */
+		else if (remain >= bytepersec) {
+			count = min(remain / bytepersec,
+					run * fi->volinfo->secperclus - secoff);
+			result = fat_read_sectors(fsi, buffer, sector, count);
+			bytesread = count * bytepersec;
+		}
+		/* Case 2B - We are only reading a partial sector */
 		else {
-			/*
-			 * Case 2A - We have at least one more full sector to read and
-			 * don't have to go through the scratch buffer. You could insert
-			 * optimizations here to read multiple sectors at a time, if you
-			 * were thus inclined (note that the maximum multi-read you could
-			 * perform is a single cluster, so it would be advantageous to have
-			 * code similar to case 1A above that would round the pointer to a
-			 * cluster boundary the first pass through, so all subsequent
-			 * [large] read requests would be able to go a cluster at a time).
-			 */
-			 if (remain >= fi->volinfo->bytepersec) {
-				result = fat_read_sector(fsi, buffer, sector);
-				remain -= fi->volinfo->bytepersec;
-				buffer += fi->volinfo->bytepersec;
-				fi->pointer += fi->volinfo->bytepersec;
-				bytesread = fi->volinfo->bytepersec;
-			}
-			/* Case 2B - We are only reading a partial sector */
-			else {
-				result = fat_read_sector(fsi, p_scratch, sector);
-				memcpy(buffer, p_scratch, remain);
-				buffer += remain;
-				fi->pointer += remain;
-				bytesread = remain;
-				remain = 0;
-			}
+			result = fat_read_sector(fsi, p_scratch, sector);
+			memcpy(buffer, p_scratch, remain);
+			bytesread = remain;
 		}
 
-		*successcount += bytesread;
-		/* check to see if we stepped over a cluster boundary */
-		if (div(fi->pointer - bytesread, clastersize).quot !=
-			div(fi->pointer, clastersize).quot) {
-			if (fat_is_end_of_chain(fsi, fi->cluster)) {
-				result = DFS_EOF;
-			} else {
-				fi->cluster = fat_get_fat(fsi, p_scratch, fi->cluster);
-			}
+		if (result != DFS_OK) {
+			break;
 		}
+
+		buffer += bytesread;
+		fi->pointer += bytesread;
+		remain -= bytesread;
+		*successcount += bytesread;
 	}
 
 	return result;
@@ -1272,8 +1558,9 @@ uint32_t fat_write_file(struct fat_file_info *fi, uint8_t *p_scratch,
 	uint32_t result = DFS_OK;
 	uint32_t sector;
 	uint32_t byteswritten;
-	uint32_t lastcluster, nextcluster;
 	uint32_t clastersize;
+	uint32_t clus, run, secoff, count;
+	uint16_t bytepersec;
 	uint32_t new_clus = 0;
 	struct fat_fs_info *fsi;
 	fsi = fi->fsi;
@@ -1286,28 +1573,37 @@ uint32_t fat_write_file(struct fat_file_info *fi, uint8_t *p_scratch,
 			len, fi->volinfo->secperclus, fi->volinfo->bytepersec );
 
 	if (fi->firstcluster == 0) {
-		new_clus = fat_get_free_fat(fsi, fat_sector_buff);
-		fat_set_fat(fsi, fat_sector_buff, new_clus, fat_end_of_chain(fsi));
+		new_clus = fat_get_free_fat(fsi, 0);
+		if (new_clus == DFS_BAD_CLUS) {
+			return DFS_ERRMISC;
+		}
+		fat_set_fat(fsi, new_clus, fat_end_of_chain(fsi));
 		fi->firstcluster = fi->cluster = new_clus;
+		fat_file_chain_reset(fi);
 	}
 
 	remain = len;
 	*successcount = 0;
-	clastersize = fi->volinfo->secperclus * fi->volinfo->bytepersec;
+	bytepersec = fi->volinfo->bytepersec;
+	clastersize = fi->volinfo->secperclus * bytepersec;
+
+	/* Allocate all clusters the write needs before copying any data, so
+	 * they are taken as one contiguous run whenever possible */
+	if (len && fat_file_extend(fi, (fi->pointer + len - 1) / clastersize)) {
+		result = DFS_ERRMISC;
+	}
 
 	while (remain && result == DFS_OK) {
-		/*
-		 * This is a bit complicated. The sector we want to read is addressed
-		 * at a cluster granularity by  the fi->cluster member.
-		 * The file pointer tells us how many extra sectors to add to that
-		 * number.
-		 */
-		sector = fi->volinfo->dataarea +
-		  ((fi->cluster - 2) * fi->volinfo->secperclus) +
-		  div(div(fi->pointer, clastersize).rem, fi->volinfo->bytepersec).quot;
+		clus = fat_file_cluster(fi, fi->pointer / clastersize, &run);
+		if (!fat_clus_valid(fsi, clus)) {
+			result = DFS_ERRMISC;
+			break;
+		}
+		secoff = (fi->pointer % clastersize) / bytepersec;
+		sector = fat_sec_by_clus(fsi, clus) + secoff;
 
 		/* Case 1 - File pointer is not on a sector boundary */
-		if (div(fi->pointer, fi->volinfo->bytepersec).rem) {
+		if (fi->pointer % bytepersec) {
 			uint16_t tempsize;
 
 			/* We always have to go through scratch in this case */
@@ -1317,148 +1613,61 @@ uint32_t fat_write_file(struct fat_file_info *fi, uint8_t *p_scratch,
 			 * This is the number of bytes that we don't want to molest in the
 			 * scratch sector just read.
 			 */
-			tempsize = div(fi->pointer, fi->volinfo->bytepersec).rem;
-
-			/*
-			 * Case 1A - We are writing the entire remainder of the sector.
-			 * After this point, all passes through the read loop will be
-			 * aligned on a sector boundary, which allows us to go through the
-			 * optimal path
-			 * 2A below.
-			 */
-		   	if (remain >= fi->volinfo->bytepersec - tempsize) {
-				memcpy(p_scratch + tempsize, buffer, fi->volinfo->bytepersec - tempsize);
-				if (!result) {
-					result = fat_write_sector(fsi, p_scratch, sector);
-				}
-
-				byteswritten = fi->volinfo->bytepersec - tempsize;
-				buffer += fi->volinfo->bytepersec - tempsize;
-				fi->pointer += fi->volinfo->bytepersec - tempsize;
-				if (*size < fi->pointer) {
-					*size = fi->pointer;
-				}
-				remain -= fi->volinfo->bytepersec - tempsize;
-			}
-			/* Case 1B - This concludes the file write operation */
-			else {
-				memcpy(p_scratch + tempsize, buffer, remain);
-				if (!result) {
-					result = fat_write_sector(fsi, p_scratch, sector);
-				}
+			tempsize = fi->pointer % bytepersec;
+			byteswritten = min(remain, (uint32_t) (bytepersec - tempsize));
 
-				buffer += remain;
-				fi->pointer += remain;
-				if (*size < fi->pointer) {
-					*size = fi->pointer;
-				}
-				byteswritten = remain;
-				remain = 0;
+			memcpy(p_scratch + tempsize, buffer, byteswritten);
+			if (!result) {
+				result = fat_write_sector(fsi, p_scratch, sector);
 			}
-		} /* case 1 */
-		/* Case 2 - File pointer is on sector boundary */
+		}
+		/* Case 2A - We have at least one more full sector to write and
+		 * don't have to go through the scratch buffer. Write as many whole
+		 * sectors as the contiguous run of clusters allows.
+		 */
+		else if (remain >= bytepersec) {
+			count = min(remain / bytepersec,
+					run * fi->volinfo->secperclus - secoff);
+			result = fat_write_sectors(fsi, buffer, sector, count);
+			byteswritten = count * bytepersec;
+		}
+		/*
+		 * Case 2B - We are only writing a partial sector and potentially
+		 * need to go through the scratch buffer.
+		 */
 		else {
-			/* Case 2A - We have at least one more full sector to write and
-			 * don't have to go through the scratch buffer. You could insert
-			 * optimizations here to write multiple sectors at a time, if you
-			 * were thus inclined. Refer to similar notes in fat_read_file.
+			/* If the current file pointer is not yet at or beyond the file
+			 * length, we are writing somewhere in the middle of the file
+			 * and need to load the original sector to do
+			 * a read-modify-write.
 			 */
-			if (remain >= fi->volinfo->bytepersec) {
-				result = fat_write_sector(fsi, buffer, sector);
-				remain -= fi->volinfo->bytepersec;
-				buffer += fi->volinfo->bytepersec;
-				fi->pointer += fi->volinfo->bytepersec;
-				if (*size < fi->pointer) {
-					*size = fi->pointer;
-				}
-				byteswritten = fi->volinfo->bytepersec;
+			if (fi->pointer < *size) {
+				result = fat_read_sector(fsi, p_scratch, sector);
+			} else {
+				memset(p_scratch, 0, bytepersec);
 			}
-			/*
-			 * Case 2B - We are only writing a partial sector and potentially
-			 * need to go through the scratch buffer.
-			 */
-			else {
-				/* If the current file pointer is not yet at or beyond the file
-				 * length, we are writing somewhere in the middle of the file
-				 * and need to load the original sector to do
-				 * a read-modify-write.
-				 */
-				if (fi->pointer < *size) {
-					result = fat_read_sector(fsi, p_scratch, sector);
-					if (!result) {
-						memcpy(p_scratch, buffer, remain);
-						result = fat_write_sector(fsi, p_scratch, sector);
-					}
-				}
-				else {
-					memset(p_scratch, 0, fi->volinfo->bytepersec);
-					memcpy(p_scratch, buffer, remain);
-					result = fat_write_sector(fsi, p_scratch, sector);
-				}
-
-				buffer += remain;
-				fi->pointer += remain;
-				if (*size < fi->pointer) {
-					*size = fi->pointer;
-				}
-				byteswritten = remain;
-				remain = 0;
+			if (!result) {
+				memcpy(p_scratch, buffer, remain);
+				result = fat_write_sector(fsi, p_scratch, sector);
 			}
+			byteswritten = remain;
 		}
 
-		*successcount += byteswritten;
+		if (result != DFS_OK) {
+			break;
+		}
 
-		/* check to see if we stepped over a cluster boundary */
-		if (div(fi->pointer - byteswritten, clastersize).quot !=
-				div(fi->pointer, clastersize).quot) {
-
-		  	/* We've transgressed into another cluster. If we were already
-		  	 * at EOF, we need to allocate a new cluster.
-		  	 * An act of minor evil - we use byteswritten as a scratch integer,
-		  	 * knowing that its value is not used after updating *successcount
-		  	 * above
-		  	 */
-		  	byteswritten = 0;
-
-			lastcluster = fi->cluster;
-			fi->cluster = fat_get_fat(fsi, p_scratch, fi->cluster);
-
-			/* Allocate a new cluster? */
-			if (fat_is_end_of_chain(fsi, fi->cluster)) {
-			  	uint32_t tempclus;
-				tempclus = fat_get_free_fat(fsi, p_scratch);
-				if (tempclus == DFS_BAD_CLUS)
-					return DFS_ERRMISC;
-				/* Link new cluster onto file */
-				fat_set_fat(fsi, p_scratch, lastcluster, tempclus);
-				fi->cluster = tempclus;
-				tempclus = fat_end_of_chain(fsi);
-				fat_set_fat(fsi, p_scratch, fi->cluster, tempclus);
-
-				result = DFS_OK;
-			}
+		buffer += byteswritten;
+		fi->pointer += byteswritten;
+		remain -= byteswritten;
+		if (*size < fi->pointer) {
+			*size = fi->pointer;
 		}
+		*successcount += byteswritten;
 	}
-	/* If cleared, then mark free clusters*/
-	// TODO implement fat truncate
-	if (0 && *size > fi->pointer) {
-		if (div(*size, clastersize).quot !=
-			div(fi->pointer, clastersize).quot) {
-
-			nextcluster = fat_get_fat(fsi, p_scratch, fi->cluster);
-
-			lastcluster = fat_end_of_chain(fsi);
-			fat_set_fat(fsi, p_scratch, fi->cluster, lastcluster);
-
-			/* Now follow the cluster chain to free the file space */
-			while (!fat_is_end_of_chain(fsi, nextcluster)) {
-				lastcluster = nextcluster;
-				nextcluster = fat_get_fat(fsi, p_scratch, nextcluster);
-
-				fat_set_fat(fsi, p_scratch, lastcluster, 0);
-			}
 
-		}
+	if (fat_fat_flush(fsi)) {
+		return DFS_ERRMISC;
 	}
 
 	/* Update directory entry */
@@ -1581,12 +1790,14 @@ int fat_unlike_file(struct fat_file_info *fi, uint8_t *p_scratch) {
 	}
 
 	/* Now follow the cluster chain to free the file space */
-	while (!fat_is_end_of_chain(fsi, fi->firstcluster)) {
+	while (fat_clus_valid(fsi, fi->firstcluster)) {
 		tempclus = fi->firstcluster;
-		fi->firstcluster = fat_get_fat(fsi, p_scratch, fi->firstcluster);
-		fat_set_fat(fsi, p_scratch, tempclus, 0);
+		fi->firstcluster = fat_get_fat(fsi, fi->firstcluster);
+		fat_set_fat(fsi, tempclus, 0);
 	}
-	return DFS_OK;
+	fat_file_chain_reset(fi);
+
+	return fat_fat_flush(fsi);
 }
 
 /**
@@ -1713,7 +1924,10 @@ int fat_create_file(struct fat_file_info *fi, struct dirinfo *di, char *name, in
 		memcpy(filename, name, sizeof(filename));
 	}
 
-	cluster = fat_get_free_fat(fsi, fat_sector_buff);
+	cluster = fat_get_free_fat(fsi, 0);
+	if (cluster == DFS_BAD_CLUS) {
+		return DFS_ERRMISC;
+	}
 	de = (struct fat_dirent) {
 		.attr = S_ISDIR(mode) ? ATTR_DIRECTORY : 0,
 	};
@@ -1727,11 +1941,15 @@ int fat_create_file(struct fat_file_info *fi, struct dirinfo *di, char *name, in
 	fi->diroffset = di->currententry;
 	fi->cluster = cluster;
 	fi->firstcluster = cluster;
+	fat_file_chain_reset(fi);
 
 	fat_write_de(di, &de);
 
 	cluster = fat_end_of_chain(fsi);
-	fat_set_fat(fsi, fat_sector_buff, fi->cluster, cluster);
+	fat_set_fat(fsi, fi->cluster, cluster);
+	if (fat_fat_flush(fsi)) {
+		return DFS_ERRMISC;
+	}
 
 	if (S_ISDIR(mode)) {
 		/* create . and ..  files of this catalog */
@@ -2068,6 +2286,7 @@ int fat_fill_inode(struct inode *inode, struct fat_dirent *de, struct dirinfo *d
 	fi->cluster      = fat_direntry_get_clus(de);
 	fi->firstcluster = fi->cluster;
 	fi->filelen      = fat_direntry_get_size(de);
+	fat_file_chain_reset(fi);
 	fi->fdi          = di;
 
 	inode_size_set(inode, fi->filelen);
@@ -9,6 +9,7 @@
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
+#include <sys/stat.h>
 
 #include <fs/inode.h>
 #include <fs/super_block.h>
@@ -79,10 +80,19 @@ int fat_iterate(struct inode *next, char *name, struct inode *parent, struct dir
 }
 
 int fat_truncate(struct inode *node, off_t length) {
+	struct fat_file_info *fi;
+
 	assert(node);
 
 	inode_size_set(node, length);
 
+	fi = inode_priv(node);
+	if (fi && S_ISREG(node->i_mode)) {
+		fi->filelen = length;
+		/* Cached extents must not outlive the clusters they describe */
+		fat_file_chain_reset(fi);
+	}
+
 	/* TODO realloc blocks*/
 
 	return 0;
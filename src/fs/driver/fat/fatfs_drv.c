@@ -161,6 +161,7 @@ int fat_clean_sb(struct super_block *sb) {
 
 	assert(fsi);
 
+	fat_fs_release(fsi);
 	fat_fs_free(fsi);
 
 	fat_dirinfo_free(inode_priv(sb->sb_root));
@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @brief Background garbage collection for JFFS2
+ *
+ * @date 19.10.2026
+ */
+
+#include <linux/kernel.h>
+#include "nodelist.h"
+
+#include <util/err.h>
+#include <util/member.h>
+#include <kernel/task.h>
+#include <kernel/task/kernel_task.h>
+#include <kernel/thread.h>
+#include <kernel/thread/waitq.h>
+
+#ifdef CYGOPT_FS_JFFS2_GCTHREAD
+
+static struct jffs2_super_block *jffs2_gc_sb(struct jffs2_sb_info *c) {
+	return member_cast_out(c, struct jffs2_super_block, jffs2_sb);
+}
+
+/* GC keeps going until there are JFFS2_GC_EXTRA_BLOCKS free blocks above
+ * the point where jffs2_thread_should_wake() kicks in, so writers rarely
+ * have to collect garbage themselves in jffs2_reserve_space(). */
+static int jffs2_gc_needed(struct jffs2_sb_info *c) {
+	if (c->unchecked_size) {
+		return 1;
+	}
+
+	return c->nr_free_blocks + c->nr_erasing_blocks <
+			c->resv_blocks_gctrigger + JFFS2_GC_EXTRA_BLOCKS &&
+		c->dirty_size > c->nospc_dirty_size;
+}
+
+static void *jffs2_gc_thread(void *arg) {
+	struct jffs2_super_block *sb = arg;
+	struct jffs2_sb_info *c = &sb->jffs2_sb;
+	int failed = 0;
+	int ret;
+
+	while (1) {
+		/* After a failed pass sleep out the interval instead of
+		 * retrying on every wake up */
+		WAITQ_WAIT_TIMEOUT(&sb->s_gc_wait,
+				sb->s_gc_stop || (!failed && jffs2_thread_should_wake(c)),
+				JFFS2_GC_INTERVAL);
+		failed = 0;
+
+		if (sb->s_gc_stop) {
+			break;
+		}
+
+		/* One pass per lock round, so file operations interleave */
+		while (!sb->s_gc_stop) {
+			mutex_lock(&sb->s_lock);
+			if (sb->s_gc_stop) {
+				/* Umount has evicted the inode cache already */
+				mutex_unlock(&sb->s_lock);
+				break;
+			}
+			if (!jffs2_gc_needed(c)) {
+				jffs2_erase_pending_blocks(c, 0);
+				mutex_unlock(&sb->s_lock);
+				break;
+			}
+			ret = jffs2_garbage_collect_pass(c);
+			mutex_unlock(&sb->s_lock);
+
+			if (ret) {
+				/* -ENOSPC, -EIO etc: nothing we can do now,
+				 * wait for the next trigger */
+				D1(printk("jffs2_gc_thread: pass returned %d\n", ret));
+				failed = 1;
+				break;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+void jffs2_garbage_collect_trigger(struct jffs2_sb_info *c) {
+	struct jffs2_super_block *sb = jffs2_gc_sb(c);
+
+	if (sb->s_gc_thread && jffs2_thread_should_wake(c)) {
+		waitq_wakeup_all(&sb->s_gc_wait);
+	}
+}
+
+int jffs2_start_garbage_collect_thread(struct jffs2_sb_info *c) {
+	struct jffs2_super_block *sb = jffs2_gc_sb(c);
+	struct thread *t;
+
+	waitq_init(&sb->s_gc_wait);
+	sb->s_gc_stop = 0;
+
+	/* Erase blocks are reclaimed in the background of any task using the
+	 * file system, so the thread is not charged to the mounting task */
+	t = thread_create(THREAD_FLAG_NOTASK | THREAD_FLAG_SUSPENDED,
+			jffs2_gc_thread, sb);
+	if (ptr2err(t)) {
+		return ptr2err(t);
+	}
+	task_thread_register(task_kernel_task(), t);
+	sb->s_gc_thread = t;
+
+	return thread_launch(t);
+}
+
+void jffs2_stop_garbage_collect_thread(struct jffs2_sb_info *c) {
+	struct jffs2_super_block *sb = jffs2_gc_sb(c);
+
+	if (!sb->s_gc_thread) {
+		return;
+	}
+
+	sb->s_gc_stop = 1;
+	waitq_wakeup_all(&sb->s_gc_wait);
+	thread_join(sb->s_gc_thread, NULL);
+	sb->s_gc_thread = NULL;
+}
+
+#endif /* CYGOPT_FS_JFFS2_GCTHREAD */
@@ -62,6 +62,12 @@ int jffs2_flash_direct_writev(struct jffs2_sb_info *c, const struct iovec *vecs,
 	unsigned long i;
 	size_t totlen = 0, thislen;
 	int ret = 0;
+	uint32_t ofs = to;
+	size_t veclen = 0;
+
+	for (i = 0; i < count; i++) {
+		veclen += vecs[i].iov_len;
+	}
 
 	for (i = 0; i < count; i++) {
 		/*
@@ -144,6 +150,10 @@ int jffs2_flash_direct_writev(struct jffs2_sb_info *c, const struct iovec *vecs,
 		*retlen = totlen;
 	}
 
+	if (!ret && totlen == veclen) {
+		jffs2_sum_add_kvec(c, vecs, count, ofs);
+	}
+
 	return ret;
 }
 
@@ -671,6 +671,7 @@ static int jffs2_garbage_collect_pristine(struct jffs2_sb_info *c,
 		goto out_node;
 	}
 	nraw->flash_offset |= REF_PRISTINE;
+	jffs2_sum_add_mem(c, node, phys_ofs);
 	jffs2_add_physical_node_ref(c, nraw);
 
 	/* Link into per-inode list. This is safe because of the ic
@@ -278,14 +278,21 @@ static int jffs2_find(jffs2_dirsearch_t * d) {
  */
 static int jffs2_read_super(struct jffs2_super_block *sb) {
 	struct jffs2_sb_info *c;
+	int erase_size;
 	int err;
 
 	D1(printk( "jffs2: read_super\n"));
 
 	c = &sb->jffs2_sb;
 
+	/* Erase block size of a flash device, block size of anything else */
+	erase_size = block_dev_ioctl(sb->bdev, FLASH_IOCTL_BLOCKSIZE, NULL, 0);
+	if (erase_size <= 0) {
+		erase_size = sb->bdev->block_size;
+	}
+
 	c->flash_size = sb->bdev->size < 4096 ? 4096 : sb->bdev->size;
-	c->sector_size = sb->bdev->block_size < 4096 ? 4096 : sb->bdev->size;
+	c->sector_size = erase_size < 4096 ? 4096 : erase_size;
 	/* Number 4096 is used here beacuse actually there are no real flash
 	 * drives with less than 4KiB erasable block. But if device is provided
 	 * with QEMU, than it's just a block device with 512 bytes block size.
@@ -296,8 +303,14 @@ static int jffs2_read_super(struct jffs2_super_block *sb) {
 
 	c->cleanmarker_size = sizeof(struct jffs2_unknown_node);
 
+	err = jffs2_sum_init(c);
+	if (err) {
+		return -err;
+	}
+
 	err = jffs2_do_mount_fs(c);
 	if (err) {
+		jffs2_sum_exit(c);
 		return -err;
 	}
 	D1(printk( "jffs2_read_super(): Getting root inode\n"));
@@ -312,6 +325,7 @@ static int jffs2_read_super(struct jffs2_super_block *sb) {
 	return 0;
 
     out_nodes:
+	jffs2_sum_exit(c);
 	jffs2_free_ino_caches(c);
 	jffs2_free_raw_node_refs(c);
 	sysfree(c->blocks);
@@ -338,6 +352,7 @@ static int jffs2_mount(struct inode *dir_node) {
 	memset(jffs2_sb, 0, sizeof (struct jffs2_super_block));
 
 	jffs2_sb->bdev = dir_node->i_sb->bdev;
+	mutex_init(&jffs2_sb->s_lock);
 
 	c->inocache_list = sysmalloc(sizeof(struct jffs2_inode_cache *) * INOCACHE_HASHSIZE);
 	if (!c->inocache_list) {
@@ -368,7 +383,10 @@ static int jffs2_mount(struct inode *dir_node) {
 	jffs2_erase_pending_blocks(c, 0);
 
 #ifdef CYGOPT_FS_JFFS2_GCTHREAD
-	jffs2_start_garbage_collect_thread(c);
+	if (jffs2_start_garbage_collect_thread(c)) {
+		/* Writers still collect garbage inline */
+		printk(KERN_WARNING "jffs2: can't start GC thread\n");
+	}
 #endif
 
 	D2(printf("jffs2_mounted superblock"));
@@ -393,13 +411,24 @@ static int jffs2_clean_sb(struct super_block *sb) {
 
 	D2(printf("jffs2_umount\n"));
 
+	/* GC passes fetch inodes into the cache, none runs under the lock */
+	mutex_lock(&jffs2_sb->s_lock);
+
 	/* Only really umount if this is the only mount */
 	icache_evict(root, NULL);
 
 	if (root->i_count != 1) {
+		mutex_unlock(&jffs2_sb->s_lock);
 		printf("Ino #1 has use count %d\n", root->i_count);
 		return EBUSY;
 	}
+
+#ifdef CYGOPT_FS_JFFS2_GCTHREAD
+	/* The GC thread sees it before its next pass */
+	jffs2_sb->s_gc_stop = 1;
+#endif
+	mutex_unlock(&jffs2_sb->s_lock);
+
 #ifdef CYGOPT_FS_JFFS2_GCTHREAD
 	jffs2_stop_garbage_collect_thread(c);
 #endif
@@ -414,6 +443,7 @@ static int jffs2_clean_sb(struct super_block *sb) {
 	sysfree(root);
 
 	/* Clean up the super block and root inode */
+	jffs2_sum_exit(c);
 	jffs2_free_ino_caches(c);
 	jffs2_free_raw_node_refs(c);
 	sysfree(c->blocks);
@@ -1350,6 +1380,13 @@ static struct file_operations jffs2_fop = {
 	.write = jffs2fs_write,
 };
 
+/* VFS calls and the GC thread share the inode cache and the flash */
+static struct mutex *jffs2fs_lock(struct super_block *sb) {
+	struct jffs2_fs_info *fsi = sb->sb_data;
+
+	return &fsi->jffs2_sb.s_lock;
+}
+
 /*
  * file_operation
  */
@@ -1366,7 +1403,9 @@ static struct idesc *jffs2fs_open(struct inode *node, struct idesc *idesc, int _
 
 	vfs_get_relative_path(node, path, PATH_MAX);
 
+	mutex_lock(jffs2fs_lock(node->i_sb));
 	res = jffs2_open(fsi->jffs2_sb.s_root, path, idesc->idesc_flags);
+	mutex_unlock(jffs2fs_lock(node->i_sb));
 	if (res) {
 		return err2ptr(-res);
 	}
@@ -1375,6 +1414,7 @@ static struct idesc *jffs2fs_open(struct inode *node, struct idesc *idesc, int _
 
 static int jffs2fs_close(struct file_desc *desc) {
 	struct jffs2_file_info *fi;
+	int res;
 
 	if (NULL == desc) {
 		return 0;
@@ -1382,7 +1422,11 @@ static int jffs2fs_close(struct file_desc *desc) {
 	fi = inode_priv(desc->f_inode);
 	file_set_size(desc, fi->_inode->i_size);
 
-	return jffs2_fo_close(fi->_inode);
+	mutex_lock(jffs2fs_lock(desc->f_inode->i_sb));
+	res = jffs2_fo_close(fi->_inode);
+	mutex_unlock(jffs2fs_lock(desc->f_inode->i_sb));
+
+	return res;
 }
 
 static size_t jffs2fs_read(struct file_desc *desc, void *buff, size_t size) {
@@ -1402,8 +1446,10 @@ static size_t jffs2fs_read(struct file_desc *desc, void *buff, size_t size) {
 
 	len = min(size, fi->_inode->i_size - pos);
 
-	if (0 != (rc = jffs2_read_inode_range(c, f,
-			(unsigned char *) buff, pos, len))) {
+	mutex_lock(jffs2fs_lock(desc->f_inode->i_sb));
+	rc = jffs2_read_inode_range(c, f, (unsigned char *) buff, pos, len);
+	mutex_unlock(jffs2fs_lock(desc->f_inode->i_sb));
+	if (0 != rc) {
 		SET_ERRNO(rc);
 		return 0;
 	}
@@ -1417,7 +1463,9 @@ static size_t jffs2fs_write(struct file_desc *desc, void *buff, size_t size) {
 
 	fi = inode_priv(desc->f_inode);
 
+	mutex_lock(jffs2fs_lock(desc->f_inode->i_sb));
 	bytecount = jffs2_fo_write(desc, buff, size);
+	mutex_unlock(jffs2fs_lock(desc->f_inode->i_sb));
 
 	file_set_size(desc, fi->_inode->i_size);
 
@@ -1506,7 +1554,7 @@ static int mount_vfs_dir_enty(struct inode *dir_node) {
 	return 0;
 }
 
-static int jffs2fs_create(struct inode *i_new, struct inode *parent_node, int mode) {
+static int jffs2fs_do_create(struct inode *i_new, struct inode *parent_node, int mode) {
 	int rc;
 	struct jffs2_file_info *fi, *parents_fi;
 
@@ -1536,7 +1584,17 @@ static int jffs2fs_create(struct inode *i_new, struct inode *parent_node, int mo
 	return 0;
 }
 
-static int jffs2fs_delete(struct inode *node) {
+static int jffs2fs_create(struct inode *i_new, struct inode *parent_node, int mode) {
+	int rc;
+
+	mutex_lock(jffs2fs_lock(parent_node->i_sb));
+	rc = jffs2fs_do_create(i_new, parent_node, mode);
+	mutex_unlock(jffs2fs_lock(parent_node->i_sb));
+
+	return rc;
+}
+
+static int jffs2fs_do_delete(struct inode *node) {
 	int rc;
 	struct inode *parent;
 	struct jffs2_file_info *par_fi, *fi;
@@ -1567,6 +1625,16 @@ static int jffs2fs_delete(struct inode *node) {
 	return 0;
 }
 
+static int jffs2fs_delete(struct inode *node) {
+	int rc;
+
+	mutex_lock(jffs2fs_lock(node->i_sb));
+	rc = jffs2fs_do_delete(node);
+	mutex_unlock(jffs2fs_lock(node->i_sb));
+
+	return rc;
+}
+
 static int jffs2fs_format(struct block_dev *bdev, void *priv) {
 	char flash_node_name[PATH_MAX];
 
@@ -1595,7 +1663,7 @@ struct inode *jffs2fs_lookup(char const *name, struct inode const *dir) {
 	return NULL;
 }
 
-static int jffs2fs_iterate(struct inode *next, char *next_name, struct inode *parent, struct dir_ctx *dir_ctx) {
+static int jffs2fs_do_iterate(struct inode *next, char *next_name, struct inode *parent, struct dir_ctx *dir_ctx) {
 	struct jffs2_inode_info *dir_f;
 	struct jffs2_full_dirent *fd_list;
 	struct _inode *inode = NULL;
@@ -1644,6 +1712,16 @@ static int jffs2fs_iterate(struct inode *next, char *next_name, struct inode *pa
 	return -1;
 }
 
+static int jffs2fs_iterate(struct inode *next, char *next_name, struct inode *parent, struct dir_ctx *dir_ctx) {
+	int rc;
+
+	mutex_lock(jffs2fs_lock(parent->i_sb));
+	rc = jffs2fs_do_iterate(next, next_name, parent, dir_ctx);
+	mutex_unlock(jffs2fs_lock(parent->i_sb));
+
+	return rc;
+}
+
 static int jffs2fs_create_root(struct super_block *sb, struct inode *dest) {
 	int rc;
 	struct jffs2_file_info *fi;
@@ -1704,7 +1782,9 @@ static int jffs2fs_truncate (struct inode *node, off_t length) {
 	inode_size_set(node, length);
 
 	fi = inode_priv(node);
+	mutex_lock(jffs2fs_lock(node->i_sb));
 	jffs2_truncate_file(fi->_inode);
+	mutex_unlock(jffs2fs_lock(node->i_sb));
 
 	return 0;
 }
@@ -39,6 +39,11 @@
 
 #include <kernel/time/clock_source.h>
 #include <kernel/thread.h>
+#include <kernel/sched/waitq.h>
+#include <kernel/thread/sync/mutex.h>
+
+#include <framework/mod/options.h>
+#include <module/embox/fs/driver/jffs2.h>
 
 #include <linux/types.h>
 #include <linux/list.h>
@@ -93,6 +98,7 @@
 #define JFFS2_NODETYPE_INODE (JFFS2_FEATURE_INCOMPAT | JFFS2_NODE_ACCURATE | 2)
 #define JFFS2_NODETYPE_CLEANMARKER (JFFS2_FEATURE_RWCOMPAT_DELETE | JFFS2_NODE_ACCURATE | 3)
 #define JFFS2_NODETYPE_PADDING (JFFS2_FEATURE_RWCOMPAT_DELETE | JFFS2_NODE_ACCURATE | 4)
+#define JFFS2_NODETYPE_SUMMARY (JFFS2_FEATURE_RWCOMPAT_DELETE | JFFS2_NODE_ACCURATE | 6)
 
 #define JFFS2_INO_FLAG_PREREAD	  1	/* Do read_inode() for this one at
 					   mount time, don't wait for it to
@@ -256,6 +262,9 @@ struct jffs2_sb_info {
 	   to an obsoleted node. I don't like this. Alternatives welcomed. */
 	struct semaphore erase_free_sem;
 
+	struct jffs2_summary *summary;		/* Erase block summary being collected
+						   for nextblock, see summary.c */
+
 #ifdef CONFIG_JFFS2_FS_WRITEBUFFER
 	/* Write-behind buffer for NAND flash */
 	unsigned char *wbuf;
@@ -317,7 +326,20 @@ struct jffs2_inode_info {
 #define get_seconds clock_sys_ticks
 
 #define CONFIG_JFFS2_ZLIB 1
-//#define CYGOPT_FS_JFFS2_GCTHREAD 0
+
+#if OPTION_MODULE_GET(embox__fs__driver__jffs2, BOOLEAN, summary)
+#define CONFIG_JFFS2_SUMMARY 1
+#endif
+
+#if OPTION_MODULE_GET(embox__fs__driver__jffs2, BOOLEAN, gc_thread)
+#define CYGOPT_FS_JFFS2_GCTHREAD 1
+#endif
+/* GC thread wakes at least this often (ms) to keep free blocks above
+ * resv_blocks_gctrigger + JFFS2_GC_EXTRA_BLOCKS */
+#define JFFS2_GC_INTERVAL \
+	OPTION_MODULE_GET(embox__fs__driver__jffs2, NUMBER, gc_interval)
+#define JFFS2_GC_EXTRA_BLOCKS \
+	OPTION_MODULE_GET(embox__fs__driver__jffs2, NUMBER, gc_extra_blocks)
 #define CYGNUM_JFFS2_GC_THREAD_PRIORITY 30
 #define CYGNUM_JFFS2_GC_THREAD_PRIORITY_30
 #define CYGNUM_JFFS2_GC_THREAD_STACK_SIZE 8192
@@ -392,11 +414,12 @@ struct jffs2_super_block {
 	struct _inode *s_root;
 	struct block_dev *bdev;
 
+	struct mutex s_lock;        /* Serializes VFS calls and GC passes */
+
 #ifdef CYGOPT_FS_JFFS2_GCTHREAD
-	struct mutex s_lock;        /* Lock the inode cache */
-	struct thread s_gc_thread;
-    char s_gc_thread_stack[CYGNUM_JFFS2_GC_THREAD_STACK_SIZE];
-//       mtab_entry *mte;
+	struct thread *s_gc_thread;
+	struct waitq s_gc_wait;
+	int s_gc_stop;
 #endif
 };
 
@@ -406,7 +429,7 @@ struct jffs2_super_block {
 /* background.c */
 #ifdef CYGOPT_FS_JFFS2_GCTHREAD
 void jffs2_garbage_collect_trigger(struct jffs2_sb_info *c);
-void jffs2_start_garbage_collect_thread(struct jffs2_sb_info *c);
+int jffs2_start_garbage_collect_thread(struct jffs2_sb_info *c);
 void jffs2_stop_garbage_collect_thread(struct jffs2_sb_info *c);
 #else
 static inline void jffs2_garbage_collect_trigger(struct jffs2_sb_info *c) {
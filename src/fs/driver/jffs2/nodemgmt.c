@@ -170,9 +170,13 @@ int jffs2_reserve_space_gc(struct jffs2_sb_info *c,
 static int jffs2_do_reserve_space(struct jffs2_sb_info *c,
 		uint32_t minsize, uint32_t *ofs, uint32_t *len) {
 	struct jffs2_eraseblock *jeb = c->nextblock;
+	uint32_t reserved_size;
 
  restart:
-	if (jeb && minsize > jeb->free_size) {
+	/* Keep room for the erase block summary at the end of the block */
+	reserved_size = jffs2_sum_reserved_size(c, jeb, minsize);
+
+	if (jeb && minsize + reserved_size > jeb->free_size) {
 		/* Skip the end of this block and file it as having some dirty space */
 		/* If there's a pending write to it, flush now */
 		if (jffs2_wbuf_dirty(c)) {
@@ -183,6 +187,9 @@ static int jffs2_do_reserve_space(struct jffs2_sb_info *c,
 			jeb = c->nextblock;
 			goto restart;
 		}
+		/* The summary takes the rest of the block if there is one */
+		jffs2_sum_write_sumnode(c);
+
 		c->wasted_size += jeb->free_size;
 		c->free_size -= jeb->free_size;
 		jeb->wasted_size += jeb->free_size;
@@ -268,6 +275,8 @@ static int jffs2_do_reserve_space(struct jffs2_sb_info *c,
 		list_del(next);
 		c->nextblock = jeb = list_entry(next, struct jffs2_eraseblock, list);
 		c->nr_free_blocks--;
+		jffs2_sum_reset_collected(c->summary);
+		reserved_size = jffs2_sum_reserved_size(c, jeb, minsize);
 
 		if (jeb->free_size != c->sector_size - c->cleanmarker_size) {
 			printk(KERN_WARNING "Eep. Block 0x%08x taken from free_list had free_size of 0x%08x!!\n", jeb->offset, jeb->free_size);
@@ -277,7 +286,7 @@ static int jffs2_do_reserve_space(struct jffs2_sb_info *c,
 	/* OK, jeb (==c->nextblock) is now pointing at a block which definitely has
 	   enough space */
 	*ofs = jeb->offset + (c->sector_size - jeb->free_size);
-	*len = jeb->free_size;
+	*len = jeb->free_size - reserved_size;
 
 	if (c->cleanmarker_size && jeb->used_size == c->cleanmarker_size &&
 	    !jeb->first_node->next_in_ino) {
@@ -451,6 +451,16 @@ static int jffs2_get_inode_nodes(struct jffs2_sb_info *c, struct jffs2_inode_inf
 			goto free_out;
 		}
 
+		/* Blocks built from a summary may list nodes which were
+		 * obsoleted on flash after the summary had been written */
+		if (retlen >= sizeof(struct jffs2_unknown_node) &&
+				!(je16_to_cpu(node.u.nodetype) & JFFS2_NODE_ACCURATE)) {
+			JFFS2_DBG_READINODE("node at %08x is obsolete on flash\n", ref_offset(ref));
+			jffs2_mark_node_obsolete(c, ref);
+			spin_lock(&c->erase_completion_lock);
+			continue;
+		}
+
 		switch (je16_to_cpu(node.u.nodetype)) {
 
 		case JFFS2_NODETYPE_DIRENT:
@@ -58,13 +58,6 @@ static int jffs2_scan_inode_node(struct jffs2_sb_info *c, struct jffs2_erasebloc
 static int jffs2_scan_dirent_node(struct jffs2_sb_info *c, struct jffs2_eraseblock *jeb,
 				 struct jffs2_raw_dirent *rd, uint32_t ofs);
 
-#define BLK_STATE_ALLFF		0
-#define BLK_STATE_CLEAN		1
-#define BLK_STATE_PARTDIRTY	2
-#define BLK_STATE_CLEANMARKER	3
-#define BLK_STATE_ALLDIRTY	4
-#define BLK_STATE_BADBLOCK	5
-
 static inline int min_free(struct jffs2_sb_info *c)
 {
 	uint32_t min = 2 * sizeof(struct jffs2_raw_inode);
@@ -315,6 +308,14 @@ static int jffs2_scan_eraseblock (struct jffs2_sb_info *c,
 		}
 	}
 #endif
+	if (buf_size) {
+		/* A valid summary describes the whole block, no need to scan it */
+		err = jffs2_sum_scan_sumnode(c, jeb, buf, buf_size, &pseudo_random);
+		if (err) {
+			return err;
+		}
+	}
+
 	buf_ofs = jeb->offset;
 
 	if (!buf_size) {
@@ -624,6 +625,11 @@ scan_more:
 	}
 
 
+	return jffs2_scan_classify_jeb(c, jeb);
+}
+
+int jffs2_scan_classify_jeb(struct jffs2_sb_info *c, struct jffs2_eraseblock *jeb)
+{
 	D1(printk( "Block at 0x%08x: free 0x%08x, dirty 0x%08x, unchecked 0x%08x, used 0x%08x\n", jeb->offset,
 		  jeb->free_size, jeb->dirty_size, jeb->unchecked_size, jeb->used_size));
 
@@ -653,7 +659,42 @@ scan_more:
 	}
 }
 
-static struct jffs2_inode_cache *jffs2_scan_make_ino_cache(struct jffs2_sb_info *c, uint32_t ino)
+void jffs2_scan_dirty_space(struct jffs2_sb_info *c, struct jffs2_eraseblock *jeb,
+		uint32_t size)
+{
+	DIRTY_SPACE(size);
+}
+
+/* Link a node found on flash into the block and, if @ic is given, into
+ * the per-inode list. REF_UNCHECKED nodes are accounted as unchecked,
+ * all others as used. */
+void jffs2_scan_link_node_ref(struct jffs2_sb_info *c, struct jffs2_eraseblock *jeb,
+		struct jffs2_raw_node_ref *raw, uint32_t ofs, uint32_t len,
+		struct jffs2_inode_cache *ic)
+{
+	raw->flash_offset = ofs;
+	raw->__totlen = len;
+	raw->next_phys = NULL;
+	if (ic) {
+		raw->next_in_ino = ic->nodes;
+		ic->nodes = raw;
+	} else {
+		raw->next_in_ino = NULL;
+	}
+	if (!jeb->first_node)
+		jeb->first_node = raw;
+	if (jeb->last_node)
+		jeb->last_node->next_phys = raw;
+	jeb->last_node = raw;
+
+	if (ref_flags(raw) == REF_UNCHECKED) {
+		UNCHECKED_SPACE(len);
+	} else {
+		USED_SPACE(len);
+	}
+}
+
+struct jffs2_inode_cache *jffs2_scan_make_ino_cache(struct jffs2_sb_info *c, uint32_t ino)
 {
 	struct jffs2_inode_cache *ic;
 
@@ -727,17 +768,8 @@ static int jffs2_scan_inode_node(struct jffs2_sb_info *c, struct jffs2_erasebloc
 
 	/* Wheee. It worked */
 
-	raw->flash_offset = ofs | REF_UNCHECKED;
-	raw->__totlen = PAD(je32_to_cpu(ri->totlen));
-	raw->next_phys = NULL;
-	raw->next_in_ino = ic->nodes;
-
-	ic->nodes = raw;
-	if (!jeb->first_node)
-		jeb->first_node = raw;
-	if (jeb->last_node)
-		jeb->last_node->next_phys = raw;
-	jeb->last_node = raw;
+	jffs2_scan_link_node_ref(c, jeb, raw, ofs | REF_UNCHECKED,
+			PAD(je32_to_cpu(ri->totlen)), ic);
 
 	D1(printk( "Node is ino #%u, version %d. Range 0x%x-0x%x\n",
 		  je32_to_cpu(ri->ino), je32_to_cpu(ri->version),
@@ -746,7 +778,6 @@ static int jffs2_scan_inode_node(struct jffs2_sb_info *c, struct jffs2_erasebloc
 
 	pseudo_random += je32_to_cpu(ri->version);
 
-	UNCHECKED_SPACE(PAD(je32_to_cpu(ri->totlen)));
 	return 0;
 }
 
@@ -805,16 +836,8 @@ static int jffs2_scan_dirent_node(struct jffs2_sb_info *c, struct jffs2_eraseblo
 		return -ENOMEM;
 	}
 
-	raw->__totlen = PAD(je32_to_cpu(rd->totlen));
-	raw->flash_offset = ofs | REF_PRISTINE;
-	raw->next_phys = NULL;
-	raw->next_in_ino = ic->nodes;
-	ic->nodes = raw;
-	if (!jeb->first_node)
-		jeb->first_node = raw;
-	if (jeb->last_node)
-		jeb->last_node->next_phys = raw;
-	jeb->last_node = raw;
+	jffs2_scan_link_node_ref(c, jeb, raw, ofs | REF_PRISTINE,
+			PAD(je32_to_cpu(rd->totlen)), ic);
 
 	fd->raw = raw;
 	fd->next = NULL;
@@ -822,7 +845,6 @@ static int jffs2_scan_dirent_node(struct jffs2_sb_info *c, struct jffs2_eraseblo
 	fd->ino = je32_to_cpu(rd->ino);
 	fd->nhash = full_name_hash(fd->name, rd->nsize);
 	fd->type = rd->type;
-	USED_SPACE(PAD(je32_to_cpu(rd->totlen)));
 	jffs2_add_fd_to_list(c, fd, &ic->scan_dents);
 
 	return 0;
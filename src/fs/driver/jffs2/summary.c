@@ -0,0 +1,556 @@
+/*
+ * JFFS2 -- Journalling Flash File System, Version 2.
+ *
+ * Copyright (C) 2004  Ferenc Havasi <havasi@inf.u-szeged.hu>,
+ *                     Zoltan Sogor <weth@inf.u-szeged.hu>,
+ *                     Patrik Kluba <pajko@halom.u-szeged.hu>,
+ *                     University of Szeged, Hungary
+ *
+ * For licensing information, see the file 'LICENCE' in this directory.
+ *
+ * Entries for every node written to c->nextblock are collected in core.
+ * When the block is closed they are written as a single summary node
+ * filling the rest of the block, with a marker in the last 8 bytes
+ * pointing to it. At mount the marker is checked first and, if the
+ * summary is intact, the block is built from it without being scanned.
+ */
+
+#include <linux/kernel.h>
+#include <linux/slab.h>
+#include <linux/crc32.h>
+#include <linux/compiler.h>
+#include "nodelist.h"
+
+#include <mem/sysmalloc.h>
+
+#ifdef CONFIG_JFFS2_SUMMARY
+
+int jffs2_sum_init(struct jffs2_sb_info *c) {
+	c->summary = sysmalloc(sizeof(struct jffs2_summary));
+	if (!c->summary) {
+		return -ENOMEM;
+	}
+	memset(c->summary, 0, sizeof(struct jffs2_summary));
+
+	c->summary->sum_buf = sysmalloc(c->sector_size);
+	if (!c->summary->sum_buf) {
+		sysfree(c->summary);
+		c->summary = NULL;
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+void jffs2_sum_exit(struct jffs2_sb_info *c) {
+	if (!c->summary) {
+		return;
+	}
+	sysfree(c->summary->sum_buf);
+	sysfree(c->summary);
+	c->summary = NULL;
+}
+
+void jffs2_sum_reset_collected(struct jffs2_summary *s) {
+	if (!s) {
+		return;
+	}
+	s->jeb = NULL;
+	s->disabled = 0;
+	s->sum_size = 0;
+	s->sum_num = 0;
+	s->nodes_size = 0;
+}
+
+/* Entries can describe a block only if we saw every valid node written to
+ * it, i.e. it held nothing but the (soon obsoleted) cleanmarker when we
+ * started to collect. */
+static int jffs2_sum_collecting(struct jffs2_sb_info *c,
+		struct jffs2_eraseblock *jeb) {
+	struct jffs2_summary *s = c->summary;
+
+	if (!s) {
+		return 0;
+	}
+	if (s->jeb == jeb) {
+		return !s->disabled;
+	}
+	return !jeb->unchecked_size && jeb->used_size <= c->cleanmarker_size;
+}
+
+/* Space which must stay free at the end of @jeb after a node of at least
+ * @minsize bytes is written, so that the summary still fits */
+uint32_t jffs2_sum_reserved_size(struct jffs2_sb_info *c,
+		struct jffs2_eraseblock *jeb, uint32_t minsize) {
+	struct jffs2_summary *s = c->summary;
+	uint32_t entry, collected;
+
+	if (!jeb || !jffs2_sum_collecting(c, jeb)) {
+		return 0;
+	}
+
+	/* Each reservation is for a single node. Dirent callers reserve
+	 * exactly sizeof(dirent) + name, so the name can't be longer. */
+	entry = JFFS2_SUMMARY_DIRENT_SIZE(JFFS2_MAX_NAME_LEN);
+	if (minsize < sizeof(struct jffs2_raw_dirent) + JFFS2_MAX_NAME_LEN) {
+		entry = JFFS2_SUMMARY_DIRENT_SIZE(minsize > sizeof(struct jffs2_raw_dirent) ?
+				minsize - sizeof(struct jffs2_raw_dirent) : 0);
+	}
+	if (entry < JFFS2_SUMMARY_INODE_SIZE) {
+		entry = JFFS2_SUMMARY_INODE_SIZE;
+	}
+
+	collected = (s->jeb == jeb) ? s->sum_size : 0;
+
+	return PAD(collected + entry + JFFS2_SUMMARY_FRAME_SIZE);
+}
+
+static void jffs2_sum_add(struct jffs2_sb_info *c, union jffs2_node_union *node,
+		const unsigned char *name, uint32_t ofs) {
+	struct jffs2_summary *s = c->summary;
+	struct jffs2_eraseblock *jeb;
+	union jffs2_sum_flash *entry;
+	uint32_t size;
+
+	if (!s) {
+		return;
+	}
+
+	jeb = &c->blocks[ofs / c->sector_size];
+	if (s->jeb != jeb) {
+		jffs2_sum_reset_collected(s);
+		s->disabled = !jffs2_sum_collecting(c, jeb);
+		s->jeb = jeb;
+	}
+	if (s->disabled) {
+		return;
+	}
+
+	switch (je16_to_cpu(node->u.nodetype)) {
+	case JFFS2_NODETYPE_INODE:
+		size = JFFS2_SUMMARY_INODE_SIZE;
+		break;
+	case JFFS2_NODETYPE_DIRENT:
+		size = JFFS2_SUMMARY_DIRENT_SIZE(node->d.nsize);
+		break;
+	default:
+		/* Node we can't describe, the block will be scanned */
+		s->disabled = 1;
+		return;
+	}
+
+	if (sizeof(struct jffs2_raw_summary) + s->sum_size + size +
+			sizeof(struct jffs2_sum_marker) > c->sector_size) {
+		s->disabled = 1;
+		return;
+	}
+
+	entry = (void *) (s->sum_buf + sizeof(struct jffs2_raw_summary) + s->sum_size);
+	entry->u.nodetype = node->u.nodetype;
+
+	if (je16_to_cpu(node->u.nodetype) == JFFS2_NODETYPE_INODE) {
+		entry->i.inode = node->i.ino;
+		entry->i.version = node->i.version;
+		entry->i.offset = cpu_to_je32(ofs - jeb->offset);
+		entry->i.totlen = node->i.totlen;
+	} else {
+		entry->d.totlen = node->d.totlen;
+		entry->d.offset = cpu_to_je32(ofs - jeb->offset);
+		entry->d.pino = node->d.pino;
+		entry->d.version = node->d.version;
+		entry->d.ino = node->d.ino;
+		entry->d.nsize = node->d.nsize;
+		entry->d.type = node->d.type;
+		memcpy(entry->d.name, name, node->d.nsize);
+	}
+
+	s->sum_size += size;
+	s->sum_num++;
+	s->nodes_size += PAD(je32_to_cpu(node->u.totlen));
+}
+
+/* Called after a successful writev of a node: vecs[0] is the node header,
+ * vecs[1] the data or the dirent name */
+void jffs2_sum_add_kvec(struct jffs2_sb_info *c, const struct iovec *vecs,
+		unsigned long count, uint32_t ofs) {
+	union jffs2_node_union *node = vecs[0].iov_base;
+	const unsigned char *name;
+
+	if (count > 1) {
+		name = vecs[1].iov_base;
+	} else {
+		name = (unsigned char *) node + sizeof(struct jffs2_raw_dirent);
+	}
+
+	jffs2_sum_add(c, node, name, ofs);
+}
+
+/* Called after a node was copied as a whole, e.g. by pristine GC */
+void jffs2_sum_add_mem(struct jffs2_sb_info *c, union jffs2_node_union *node,
+		uint32_t ofs) {
+	jffs2_sum_add(c, node, node->d.name, ofs);
+}
+
+/**
+ * Write the collected summary to the free end of c->nextblock. Called from
+ * jffs2_do_reserve_space() with alloc_sem and erase_completion_lock held,
+ * right before nextblock is closed. If there is no summary for the block
+ * nothing is written and the block will be scanned at mount.
+ */
+void jffs2_sum_write_sumnode(struct jffs2_sb_info *c) {
+	struct jffs2_summary *s = c->summary;
+	struct jffs2_eraseblock *jeb = c->nextblock;
+	struct jffs2_raw_summary *isum;
+	struct jffs2_sum_marker *sm;
+	struct jffs2_raw_node_ref *raw;
+	uint32_t sumofs, infosize, cln_mkr;
+	size_t retlen = 0;
+	int ret;
+
+	if (!s) {
+		return;
+	}
+	if (!jeb || s->jeb != jeb || s->disabled || !s->sum_num) {
+		goto out;
+	}
+
+	infosize = jeb->free_size;
+	if (infosize < PAD(sizeof(struct jffs2_raw_summary) + s->sum_size +
+			sizeof(struct jffs2_sum_marker))) {
+		goto out;
+	}
+	sumofs = c->sector_size - jeb->free_size;
+
+	/* Blocks are collected from right after the cleanmarker */
+	cln_mkr = jffs2_cleanmarker_oob(c) ? 0 : c->cleanmarker_size;
+	if (PAD(cln_mkr) + s->nodes_size > sumofs) {
+		goto out;
+	}
+
+	/* Summary node covers the rest of the block, marker is at its end */
+	isum = (void *) s->sum_buf;
+	sm = (void *) (s->sum_buf + infosize - sizeof(struct jffs2_sum_marker));
+	memset(s->sum_buf + sizeof(struct jffs2_raw_summary) + s->sum_size, 0xff,
+			infosize - sizeof(struct jffs2_raw_summary) - s->sum_size -
+			sizeof(struct jffs2_sum_marker));
+	sm->offset = cpu_to_je32(sumofs);
+	sm->magic = cpu_to_je32(JFFS2_SUM_MAGIC);
+
+	isum->magic = cpu_to_je16(JFFS2_MAGIC_BITMASK);
+	isum->nodetype = cpu_to_je16(JFFS2_NODETYPE_SUMMARY);
+	isum->totlen = cpu_to_je32(infosize);
+	isum->hdr_crc = cpu_to_je32(crc32(0, isum, sizeof(struct jffs2_unknown_node) - 4));
+	isum->sum_num = cpu_to_je32(s->sum_num);
+	isum->cln_mkr = cpu_to_je32(cln_mkr);
+	/* Linux accounts it as dirty space. Besides padding it covers the
+	 * space of failed writes, so the block adds up without a scan */
+	isum->padded = cpu_to_je32(sumofs - PAD(cln_mkr) - s->nodes_size);
+	isum->sum_crc = cpu_to_je32(crc32(0, s->sum_buf + sizeof(struct jffs2_raw_summary),
+			infosize - sizeof(struct jffs2_raw_summary)));
+	isum->node_crc = cpu_to_je32(crc32(0, isum, sizeof(struct jffs2_raw_summary) - 8));
+
+	raw = jffs2_alloc_raw_node_ref();
+	if (!raw) {
+		goto out;
+	}
+
+	spin_unlock(&c->erase_completion_lock);
+	ret = jffs2_flash_write(c, jeb->offset + sumofs, infosize, &retlen, s->sum_buf);
+	spin_lock(&c->erase_completion_lock);
+
+	if (ret || retlen != infosize) {
+		printk(KERN_WARNING "Write of %u bytes of summary at 0x%08x failed. returned %d, retlen %zd\n",
+				infosize, jeb->offset + sumofs, ret, retlen);
+		if (!retlen) {
+			jffs2_free_raw_node_ref(raw);
+			goto out;
+		}
+		raw->flash_offset = (jeb->offset + sumofs) | REF_OBSOLETE;
+	} else {
+		raw->flash_offset = (jeb->offset + sumofs) | REF_NORMAL;
+	}
+
+	/* Doesn't belong to any inode, GC just drops it */
+	raw->__totlen = infosize;
+	raw->next_in_ino = NULL;
+	raw->next_phys = NULL;
+	if (!jeb->first_node) {
+		jeb->first_node = raw;
+	}
+	if (jeb->last_node) {
+		jeb->last_node->next_phys = raw;
+	}
+	jeb->last_node = raw;
+
+	jeb->free_size -= infosize;
+	c->free_size -= infosize;
+	if (ref_obsolete(raw)) {
+		jeb->dirty_size += infosize;
+		c->dirty_size += infosize;
+	} else {
+		jeb->used_size += infosize;
+		c->used_size += infosize;
+	}
+
+ out:
+	jffs2_sum_reset_collected(s);
+}
+
+/* Check CRCs and that the entries are sane before anything is built */
+static int jffs2_sum_verify(struct jffs2_raw_summary *isum,
+		uint32_t sumofs, uint32_t sumlen) {
+	union jffs2_sum_flash *entry;
+	unsigned char *p, *lim;
+	uint32_t i, size, ofs, len, end = 0;
+
+	if (je16_to_cpu(isum->magic) != JFFS2_MAGIC_BITMASK ||
+			je16_to_cpu(isum->nodetype) != JFFS2_NODETYPE_SUMMARY ||
+			je32_to_cpu(isum->totlen) != sumlen) {
+		return 0;
+	}
+	if (crc32(0, isum, sizeof(struct jffs2_unknown_node) - 4) !=
+			je32_to_cpu(isum->hdr_crc)) {
+		return 0;
+	}
+	if (crc32(0, isum, sizeof(struct jffs2_raw_summary) - 8) !=
+			je32_to_cpu(isum->node_crc)) {
+		return 0;
+	}
+	if (crc32(0, (unsigned char *) isum + sizeof(struct jffs2_raw_summary),
+			sumlen - sizeof(struct jffs2_raw_summary)) != je32_to_cpu(isum->sum_crc)) {
+		return 0;
+	}
+
+	p = (unsigned char *) isum->sum;
+	lim = (unsigned char *) isum + sumlen - sizeof(struct jffs2_sum_marker);
+
+	for (i = 0; i < je32_to_cpu(isum->sum_num); i++) {
+		entry = (void *) p;
+
+		if (p + sizeof(struct jffs2_sum_unknown_flash) > lim) {
+			return 0;
+		}
+
+		switch (je16_to_cpu(entry->u.nodetype)) {
+		case JFFS2_NODETYPE_INODE:
+			size = JFFS2_SUMMARY_INODE_SIZE;
+			if (p + size > lim) {
+				return 0;
+			}
+			ofs = je32_to_cpu(entry->i.offset);
+			len = je32_to_cpu(entry->i.totlen);
+			if (len < sizeof(struct jffs2_raw_inode)) {
+				return 0;
+			}
+			break;
+		case JFFS2_NODETYPE_DIRENT:
+			if (p + JFFS2_SUMMARY_DIRENT_SIZE(0) > lim) {
+				return 0;
+			}
+			size = JFFS2_SUMMARY_DIRENT_SIZE(entry->d.nsize);
+			if (p + size > lim) {
+				return 0;
+			}
+			ofs = je32_to_cpu(entry->d.offset);
+			len = je32_to_cpu(entry->d.totlen);
+			if (len < sizeof(struct jffs2_raw_dirent) + entry->d.nsize) {
+				return 0;
+			}
+			break;
+		default:
+			return 0;
+		}
+
+		/* Nodes are listed in the order they were written */
+		if ((ofs & 3) || ofs < end || len > sumofs || ofs > sumofs - PAD(len)) {
+			return 0;
+		}
+		end = ofs + PAD(len);
+		p += size;
+	}
+
+	return 1;
+}
+
+/* Dirents are used to build the tree at mount, so unlike data nodes they
+ * can't be checked lazily. Those deleted after the summary was written
+ * are only marked obsolete in their header, look at it. */
+static int jffs2_sum_dirent_obsolete(struct jffs2_sb_info *c, uint32_t ofs) {
+	struct jffs2_unknown_node n;
+	size_t retlen;
+
+	if (jffs2_flash_read(c, ofs, sizeof(n), &retlen, (unsigned char *) &n) ||
+			retlen != sizeof(n)) {
+		return 1;
+	}
+
+	return !(je16_to_cpu(n.nodetype) & JFFS2_NODE_ACCURATE);
+}
+
+static int jffs2_sum_process(struct jffs2_sb_info *c, struct jffs2_eraseblock *jeb,
+		struct jffs2_raw_summary *isum, uint32_t sumofs, uint32_t *pseudo_random) {
+	union jffs2_sum_flash *entry;
+	struct jffs2_inode_cache *ic;
+	struct jffs2_raw_node_ref *raw;
+	struct jffs2_full_dirent *fd;
+	unsigned char *p;
+	uint32_t i, ofs, len, end = 0;
+
+	p = (unsigned char *) isum->sum;
+
+	for (i = 0; i < je32_to_cpu(isum->sum_num); i++) {
+		entry = (void *) p;
+
+		switch (je16_to_cpu(entry->u.nodetype)) {
+		case JFFS2_NODETYPE_INODE:
+			ofs = je32_to_cpu(entry->i.offset);
+			len = PAD(je32_to_cpu(entry->i.totlen));
+			p += JFFS2_SUMMARY_INODE_SIZE;
+
+			ic = jffs2_scan_make_ino_cache(c, je32_to_cpu(entry->i.inode));
+			if (!ic) {
+				return -ENOMEM;
+			}
+			raw = jffs2_alloc_raw_node_ref();
+			if (!raw) {
+				return -ENOMEM;
+			}
+
+			if (ofs > end) {
+				jffs2_scan_dirty_space(c, jeb, ofs - end);
+			}
+			/* CRCs will be checked later, as for scanned nodes */
+			jffs2_scan_link_node_ref(c, jeb, raw,
+					(jeb->offset + ofs) | REF_UNCHECKED, len, ic);
+			*pseudo_random += je32_to_cpu(entry->i.version);
+			break;
+
+		case JFFS2_NODETYPE_DIRENT:
+			ofs = je32_to_cpu(entry->d.offset);
+			len = PAD(je32_to_cpu(entry->d.totlen));
+			p += JFFS2_SUMMARY_DIRENT_SIZE(entry->d.nsize);
+
+			if (jffs2_sum_dirent_obsolete(c, jeb->offset + ofs)) {
+				/* Leave it to the gap accounting below */
+				continue;
+			}
+
+			fd = jffs2_alloc_full_dirent(entry->d.nsize + 1);
+			if (!fd) {
+				return -ENOMEM;
+			}
+			memcpy(&fd->name, entry->d.name, entry->d.nsize);
+			fd->name[entry->d.nsize] = 0;
+
+			ic = jffs2_scan_make_ino_cache(c, je32_to_cpu(entry->d.pino));
+			if (!ic) {
+				jffs2_free_full_dirent(fd);
+				return -ENOMEM;
+			}
+			raw = jffs2_alloc_raw_node_ref();
+			if (!raw) {
+				jffs2_free_full_dirent(fd);
+				return -ENOMEM;
+			}
+
+			if (ofs > end) {
+				jffs2_scan_dirty_space(c, jeb, ofs - end);
+			}
+			jffs2_scan_link_node_ref(c, jeb, raw,
+					(jeb->offset + ofs) | REF_PRISTINE, len, ic);
+
+			fd->raw = raw;
+			fd->next = NULL;
+			fd->version = je32_to_cpu(entry->d.version);
+			fd->ino = je32_to_cpu(entry->d.ino);
+			fd->nhash = full_name_hash(fd->name, entry->d.nsize);
+			fd->type = entry->d.type;
+			jffs2_add_fd_to_list(c, fd, &ic->scan_dents);
+			*pseudo_random += fd->version;
+			break;
+
+		default:
+			/* Rejected by jffs2_sum_verify() */
+			BUG();
+			return -EINVAL;
+		}
+
+		end = ofs + len;
+	}
+
+	if (sumofs > end) {
+		jffs2_scan_dirty_space(c, jeb, sumofs - end);
+	}
+
+	raw = jffs2_alloc_raw_node_ref();
+	if (!raw) {
+		return -ENOMEM;
+	}
+	jffs2_scan_link_node_ref(c, jeb, raw, (jeb->offset + sumofs) | REF_NORMAL,
+			c->sector_size - sumofs, NULL);
+
+	return 0;
+}
+
+/**
+ * Try to build @jeb from its summary.
+ *
+ * Returns the block state as jffs2_scan_eraseblock() does, 0 if the block
+ * has no usable summary and must be scanned, or a negative error code.
+ */
+int jffs2_sum_scan_sumnode(struct jffs2_sb_info *c, struct jffs2_eraseblock *jeb,
+		unsigned char *buf, uint32_t buf_size, uint32_t *pseudo_random) {
+	struct jffs2_sum_marker sm;
+	unsigned char *sumbuf;
+	uint32_t sumofs, sumlen;
+	size_t retlen;
+	int ret;
+
+	ret = jffs2_flash_read(c, jeb->offset + c->sector_size - sizeof(sm),
+			sizeof(sm), &retlen, (unsigned char *) &sm);
+	if (ret || retlen != sizeof(sm) || je32_to_cpu(sm.magic) != JFFS2_SUM_MAGIC) {
+		return 0;
+	}
+
+	sumofs = je32_to_cpu(sm.offset);
+	if ((sumofs & 3) || sumofs > c->sector_size - JFFS2_SUMMARY_FRAME_SIZE) {
+		return 0;
+	}
+	sumlen = c->sector_size - sumofs;
+
+	sumbuf = buf;
+	if (sumlen > buf_size) {
+		sumbuf = sysmalloc(sumlen);
+		if (!sumbuf) {
+			return -ENOMEM;
+		}
+	}
+
+	ret = jffs2_flash_read(c, jeb->offset + sumofs, sumlen, &retlen, sumbuf);
+	if (ret || retlen != sumlen) {
+		ret = 0;
+		goto out;
+	}
+
+	if (!jffs2_sum_verify((void *) sumbuf, sumofs, sumlen)) {
+		printk(KERN_NOTICE "JFFS2: Summary of block at 0x%08x is not valid, scanning it\n",
+				jeb->offset);
+		ret = 0;
+		goto out;
+	}
+
+	D1(printk("Block at 0x%08x built from summary\n", jeb->offset));
+
+	ret = jffs2_sum_process(c, jeb, (void *) sumbuf, sumofs, pseudo_random);
+	if (!ret) {
+		ret = jffs2_scan_classify_jeb(c, jeb);
+	}
+
+ out:
+	if (sumbuf != buf) {
+		sysfree(sumbuf);
+	}
+	return ret;
+}
+
+#endif /* CONFIG_JFFS2_SUMMARY */
@@ -0,0 +1,116 @@
+/*
+ * JFFS2 -- Journalling Flash File System, Version 2.
+ *
+ * Copyright (C) 2004  Ferenc Havasi <havasi@inf.u-szeged.hu>,
+ *                     Zoltan Sogor <weth@inf.u-szeged.hu>,
+ *                     Patrik Kluba <pajko@halom.u-szeged.hu>,
+ *                     University of Szeged, Hungary
+ *
+ * For licensing information, see the file 'LICENCE' in this directory.
+ *
+ * Erase block summary: the last node of every closed erase block lists
+ * all nodes of the block, so mount reads one node per block instead of
+ * scanning it. The on-flash format is the one of Linux JFFS2.
+ */
+
+#ifndef __JFFS2_SUMMARY_H__
+#define __JFFS2_SUMMARY_H__
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+#define JFFS2_SUM_MAGIC	0x02851885
+
+struct jffs2_sum_unknown_flash {
+	jint16_t nodetype;	/* node type */
+} __attribute__((packed));
+
+struct jffs2_sum_inode_flash {
+	jint16_t nodetype;	/* node type */
+	jint32_t inode;		/* inode number */
+	jint32_t version;	/* inode version */
+	jint32_t offset;	/* offset on jeb */
+	jint32_t totlen;	/* record length */
+} __attribute__((packed));
+
+struct jffs2_sum_dirent_flash {
+	jint16_t nodetype;	/* == JFFS_NODETYPE_DIRENT */
+	jint32_t totlen;	/* record length */
+	jint32_t offset;	/* offset on jeb */
+	jint32_t pino;		/* parent inode */
+	jint32_t version;	/* dirent version */
+	jint32_t ino;		/* == zero for unlink */
+	uint8_t nsize;		/* dirent name size */
+	uint8_t type;		/* dirent type */
+	uint8_t name[0];	/* dirent name */
+} __attribute__((packed));
+
+union jffs2_sum_flash {
+	struct jffs2_sum_unknown_flash u;
+	struct jffs2_sum_inode_flash i;
+	struct jffs2_sum_dirent_flash d;
+};
+
+struct jffs2_raw_summary {
+	jint16_t magic;
+	jint16_t nodetype;	/* = JFFS2_NODETYPE_SUMMARY */
+	jint32_t totlen;
+	jint32_t hdr_crc;
+	jint32_t sum_num;	/* number of sum entries*/
+	jint32_t cln_mkr;	/* clean marker size, 0 = no cleanmarker */
+	jint32_t padded;	/* sum of the size of padding nodes */
+	jint32_t sum_crc;	/* summary information crc */
+	jint32_t node_crc;	/* node crc */
+	jint32_t sum[0];	/* inode summary info */
+} __attribute__((packed));
+
+/* Last 8 bytes of a block with summary, offset is relative to the block */
+struct jffs2_sum_marker {
+	jint32_t offset;
+	jint32_t magic;
+} __attribute__((packed));
+
+#define JFFS2_SUMMARY_INODE_SIZE (sizeof(struct jffs2_sum_inode_flash))
+#define JFFS2_SUMMARY_DIRENT_SIZE(x) (sizeof(struct jffs2_sum_dirent_flash) + (x))
+#define JFFS2_SUMMARY_FRAME_SIZE (sizeof(struct jffs2_raw_summary) + \
+		sizeof(struct jffs2_sum_marker))
+
+/* Summary collected in core for c->nextblock */
+struct jffs2_summary {
+	struct jffs2_eraseblock *jeb;	/* block the entries describe */
+	int disabled;			/* block had nodes we have no entries for */
+	uint32_t sum_size;		/* size of collected entries */
+	uint32_t sum_num;
+	uint32_t nodes_size;		/* padded size of the nodes they list */
+	unsigned char *sum_buf;		/* raw summary node followed by entries */
+};
+
+#ifdef CONFIG_JFFS2_SUMMARY
+
+int jffs2_sum_init(struct jffs2_sb_info *c);
+void jffs2_sum_exit(struct jffs2_sb_info *c);
+void jffs2_sum_reset_collected(struct jffs2_summary *s);
+uint32_t jffs2_sum_reserved_size(struct jffs2_sb_info *c,
+		struct jffs2_eraseblock *jeb, uint32_t minsize);
+void jffs2_sum_add_kvec(struct jffs2_sb_info *c, const struct iovec *vecs,
+		unsigned long count, uint32_t ofs);
+void jffs2_sum_add_mem(struct jffs2_sb_info *c, union jffs2_node_union *node,
+		uint32_t ofs);
+void jffs2_sum_write_sumnode(struct jffs2_sb_info *c);
+int jffs2_sum_scan_sumnode(struct jffs2_sb_info *c, struct jffs2_eraseblock *jeb,
+		unsigned char *buf, uint32_t buf_size, uint32_t *pseudo_random);
+
+#else
+
+#define jffs2_sum_init(c) (0)
+#define jffs2_sum_exit(c) do { } while (0)
+#define jffs2_sum_reset_collected(s) do { } while (0)
+#define jffs2_sum_reserved_size(c, jeb, minsize) (0)
+#define jffs2_sum_add_kvec(c, vecs, count, ofs) do { (void) (ofs); } while (0)
+#define jffs2_sum_add_mem(c, node, ofs) do { } while (0)
+#define jffs2_sum_write_sumnode(c) do { } while (0)
+#define jffs2_sum_scan_sumnode(c, jeb, buf, buf_size, pseudo_random) (0)
+
+#endif /* CONFIG_JFFS2_SUMMARY */
+
+#endif /* __JFFS2_SUMMARY_H__ */
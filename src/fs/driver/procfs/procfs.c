@@ -1,4 +1,6 @@
 #include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -11,6 +13,7 @@
 #include <drivers/device.h>
 #include <framework/mod/options.h>
 #include <fs/dvfs.h>
+#include <fs/procfs.h>
 
 #include <lib/libds/array.h>
 
@@ -21,6 +24,8 @@
 #include <net/net_namespace.h>
 #include <kernel/task.h>
 
+ARRAY_SPREAD_DEF(const struct procfs_file, __procfs_file_registry);
+
 extern net_namespace_p net_ns_lookup(const char *name);
 extern net_namespace_p net_ns_lookup_by_inode(struct inode *inode);
 
@@ -34,7 +39,20 @@ static int is_number(const char *str) {
 		return 1;
 }
 
+static int procfs_file_is(void *p) {
+	const struct procfs_file *pf;
+
+	procfs_file_foreach(pf) {
+		if (pf == p) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
 static struct inode *procfs_lookup(char const *name, struct inode const *dir) {
+	const struct procfs_file *pf;
 	struct inode *node;
 	net_namespace_p net_ns_p;
 
@@ -42,13 +60,24 @@ static struct inode *procfs_lookup(char const *name, struct inode const *dir) {
 		return NULL;
 	}
 
+	/* /proc/<file> of other subsystems */
+	if (dir == dir->i_sb->sb_root) {
+		procfs_file_foreach(pf) {
+			if (strcmp(name, pf->name) == 0) {
+				node->i_mode = S_IFREG;
+				inode_priv_set(node, (void *)pf);
+				return node;
+			}
+		}
+	}
+
 	/* /proc/pid/ns/net case */
 	if (is_number(name))
 		node->i_mode = S_IFDIR;
 	else if (strcmp(name, "ns") == 0)
 		node->i_mode = S_IFDIR;
 	else if (strcmp(name, "net") == 0) {
-		node->length = NAME_MAX + 1;
+		inode_size_set(node, NAME_MAX + 1);
 		node->i_mode = S_IFLNK;
 	}
 
@@ -69,22 +98,44 @@ static struct inode *procfs_lookup(char const *name, struct inode const *dir) {
 
 static int procfs_iterate(struct inode *next, char *name, struct inode *parent,
 			  struct dir_ctx *ctx) {
+	const struct procfs_file *pf;
 	struct task *tsk, *last;
 	int show_this_task = 0;
+	int show_this_file = 0;
+
+	/* Tasks go first, then files of other subsystems */
+	if (!procfs_file_is(ctx->fs_ctx)) {
+		last = (struct task *)ctx->fs_ctx;
+
+		task_foreach(tsk) {
+			if (show_this_task || last == NULL) {
+				ctx->fs_ctx = (void *)tsk;
+				next->i_mode = S_IFDIR; 
+				snprintf(name, NAME_MAX - 1, "%d", tsk->tsk_id);
+				name[NAME_MAX - 1] = '\0';
+				return 0;
+			}
+
+			if (tsk == last) {
+				show_this_task = 1;
+			}
+		}
 
-	last = (struct task *)ctx->fs_ctx;
+		show_this_file = 1;
+	}
 
-	task_foreach(tsk) {
-		if (show_this_task || last == NULL) {
-			ctx->fs_ctx = (void *)tsk;
-			next->i_mode = S_IFDIR; 
-			snprintf(name, NAME_MAX - 1, "%d", tsk->tsk_id);
+	procfs_file_foreach(pf) {
+		if (show_this_file) {
+			ctx->fs_ctx = (void *)pf;
+			next->i_mode = S_IFREG;
+			inode_priv_set(next, (void *)pf);
+			strncpy(name, pf->name, NAME_MAX - 1);
 			name[NAME_MAX - 1] = '\0';
 			return 0;
 		}
 
-		if (tsk == last) {
-			show_this_task = 1;
+		if (pf == ctx->fs_ctx) {
+			show_this_file = 1;
 		}
 	}
 
@@ -108,12 +159,63 @@ static size_t procfs_fill_read_buff(struct file_desc *desc, void *buf,
 	return size;
 }
 
+/* Prints the whole file and copies the part at the current position */
+static size_t procfs_file_read(struct file_desc *desc, void *buf, size_t size,
+				const struct procfs_file *pf) {
+	char *content;
+	size_t len;
+	off_t pos;
+	int n;
+
+	n = pf->print(NULL, 0);
+	if (n < 0) {
+		return 0;
+	}
+
+	/* Leave some room, the content may grow between the two calls */
+	len = n + 256;
+	content = malloc(len);
+	if (!content) {
+		return 0;
+	}
+
+	n = pf->print(content, len);
+	if (n < 0) {
+		n = 0;
+	}
+	if ((size_t) n < len) {
+		len = n;
+	} else {
+		len--;
+	}
+
+	pos = file_get_pos(desc);
+	if (pos < 0 || (size_t) pos >= len) {
+		size = 0;
+	} else {
+		if (size > len - pos) {
+			size = len - pos;
+		}
+		memcpy(buf, content + pos, size);
+	}
+
+	free(content);
+
+	return size;
+}
+
 static size_t procfs_read(struct file_desc *desc, void *buf, size_t size) {
 	char netns_name[NAME_MAX + 1];
 	char netns_path[1024];
 	unsigned long pid;
 	struct task *tsk;
 
+	if (S_ISREG(desc->f_inode->i_mode) && procfs_file_is(
+			inode_priv(desc->f_inode))) {
+		return procfs_file_read(desc, buf, size,
+				inode_priv(desc->f_inode));
+	}
+
 	if (S_ISLNK(desc->f_inode->i_mode)) { /* /proc/pid/ns/net case */
 		pid = strtoul(desc->f_dentry->parent->parent->name, NULL, 10);
 		task_foreach(tsk) {
@@ -178,6 +280,7 @@ static int procfs_fill_sb(struct super_block *sb, const char *source) {
 	sb->sb_iops = &procfs_iops;
 	sb->sb_fops = &procfs_fops;
 	sb->sb_ops  = &procfs_sbops;
+	sb->sb_flags |= SB_NO_NEGATIVE_DENTRY;
 
 	return 0; 
 }
@@ -0,0 +1,619 @@
+/**
+ * @file
+ * @brief Memory file system keeping file data in page allocator pages
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdint.h>
+
+#include <fs/dir_context.h>
+#include <fs/file_desc.h>
+#include <fs/fs_driver.h>
+#include <fs/inode.h>
+#include <fs/inode_operation.h>
+#include <fs/super_block.h>
+
+#include <kernel/thread/sync/mutex.h>
+#include <mem/misc/pool.h>
+#include <mem/page.h>
+#include <mem/phymem.h>
+
+#include <lib/libds/dlist.h>
+#include <lib/libds/indexator.h>
+#include <util/math.h>
+
+#include "tmpfs.h"
+
+#define TMPFS_PAGE_SZ      PAGE_SIZE()
+#define TMPFS_PTRS_PER_PG  (TMPFS_PAGE_SZ / sizeof(void *))
+#define TMPFS_MAX_PAGES    (TMPFS_PTRS_PER_PG * TMPFS_PTRS_PER_PG)
+
+/* Set in a page table entry once the page is mapped. munmap() does not
+ * reach the file system, so a mapped page is neither moved nor freed
+ * before the file itself goes away */
+#define TMPFS_PG_PINNED    ((uintptr_t) 1)
+
+/* Copy of a file range handed out to a private mapping */
+struct tmpfs_private_map {
+	struct dlist_head link;
+	void *pages;
+	size_t n;
+};
+
+static inline char *tmpfs_slot_page(void *slot_val) {
+	return (char *) ((uintptr_t) slot_val & ~TMPFS_PG_PINNED);
+}
+
+static inline int tmpfs_slot_pinned(void *slot_val) {
+	return (uintptr_t) slot_val & TMPFS_PG_PINNED;
+}
+
+struct tmpfs_file_info tmpfs_files[TMPFS_FILES];
+
+INDEX_DEF(tmpfs_file_idx, 0, TMPFS_FILES);
+
+static struct mutex tmpfs_files_lock = MUTEX_INIT(tmpfs_files_lock);
+
+/* tmpfs filesystem description pool */
+POOL_DEF(tmpfs_fs_pool, struct tmpfs_fs_info, TMPFS_DESCRIPTORS);
+
+POOL_DEF(tmpfs_private_pool, struct tmpfs_private_map, TMPFS_PRIVATE_MAPS);
+
+static void *tmpfs_pages_alloc(struct tmpfs_fs_info *fsi, size_t n) {
+	void *pages = NULL;
+
+	mutex_lock(&fsi->lock);
+	if (fsi->max_pages && fsi->used_pages + n > fsi->max_pages) {
+		goto out;
+	}
+
+	pages = phymem_alloc(n);
+	if (pages) {
+		fsi->used_pages += n;
+	}
+out:
+	mutex_unlock(&fsi->lock);
+
+	return pages;
+}
+
+static void tmpfs_pages_free(struct tmpfs_fs_info *fsi, void *pages, size_t n) {
+	mutex_lock(&fsi->lock);
+	phymem_free(pages, n);
+	fsi->used_pages -= n;
+	mutex_unlock(&fsi->lock);
+}
+
+static void *tmpfs_page_alloc_zero(struct tmpfs_fs_info *fsi) {
+	void *page;
+
+	page = tmpfs_pages_alloc(fsi, 1);
+	if (page) {
+		memset(page, 0, TMPFS_PAGE_SZ);
+	}
+
+	return page;
+}
+
+/* Returns the table entry for data page @pg, building the tables on demand */
+static void **tmpfs_page_slot(struct tmpfs_file_info *fi, size_t pg,
+		int alloc) {
+	size_t dir_i = pg / TMPFS_PTRS_PER_PG;
+
+	if (dir_i >= TMPFS_PTRS_PER_PG) {
+		return NULL;
+	}
+
+	if (!fi->pgdir) {
+		if (!alloc || !(fi->pgdir = tmpfs_page_alloc_zero(fi->fsi))) {
+			return NULL;
+		}
+	}
+
+	if (!fi->pgdir[dir_i]) {
+		if (!alloc || !(fi->pgdir[dir_i] = tmpfs_page_alloc_zero(fi->fsi))) {
+			return NULL;
+		}
+	}
+
+	return &fi->pgdir[dir_i][pg % TMPFS_PTRS_PER_PG];
+}
+
+static char *tmpfs_page_get(struct tmpfs_file_info *fi, size_t pg, int alloc) {
+	void **slot;
+
+	if (NULL == (slot = tmpfs_page_slot(fi, pg, alloc))) {
+		return NULL;
+	}
+
+	if (!*slot && alloc) {
+		*slot = tmpfs_page_alloc_zero(fi->fsi);
+	}
+
+	return tmpfs_slot_page(*slot);
+}
+
+/* Frees data pages starting from @first and tables which become unused.
+ * Pinned pages stay allocated and accounted to the mount unless @unpin */
+static void tmpfs_pages_release(struct tmpfs_file_info *fi, size_t first,
+		int unpin) {
+	size_t dir_i, i;
+	void **tbl;
+
+	if (!fi->pgdir) {
+		return;
+	}
+
+	for (dir_i = first / TMPFS_PTRS_PER_PG; dir_i < TMPFS_PTRS_PER_PG; dir_i++) {
+		if (NULL == (tbl = fi->pgdir[dir_i])) {
+			continue;
+		}
+
+		i = (dir_i == first / TMPFS_PTRS_PER_PG) ? first % TMPFS_PTRS_PER_PG : 0;
+		for (; i < TMPFS_PTRS_PER_PG; i++) {
+			if (tbl[i] && (unpin || !tmpfs_slot_pinned(tbl[i]))) {
+				tmpfs_pages_free(fi->fsi, tmpfs_slot_page(tbl[i]), 1);
+			}
+			tbl[i] = NULL;
+		}
+
+		if (dir_i * TMPFS_PTRS_PER_PG >= first) {
+			tmpfs_pages_free(fi->fsi, tbl, 1);
+			fi->pgdir[dir_i] = NULL;
+		}
+	}
+
+	if (first == 0) {
+		tmpfs_pages_free(fi->fsi, fi->pgdir, 1);
+		fi->pgdir = NULL;
+	}
+}
+
+static size_t tmpfs_read(struct file_desc *desc, void *buf, size_t size) {
+	struct tmpfs_file_info *fi;
+	size_t done, pg_off, n;
+	char *page;
+	off_t pos;
+
+	assert(desc);
+
+	fi = file_get_inode_data(desc);
+	assert(fi);
+
+	pos = file_get_pos(desc);
+
+	mutex_lock(&fi->lock);
+
+	if (pos >= fi->length) {
+		size = 0;
+	} else {
+		size = min(size, fi->length - pos);
+	}
+
+	for (done = 0; done < size; done += n, pos += n) {
+		pg_off = pos % TMPFS_PAGE_SZ;
+		n = min(TMPFS_PAGE_SZ - pg_off, size - done);
+
+		page = tmpfs_page_get(fi, pos / TMPFS_PAGE_SZ, 0);
+		if (page) {
+			memcpy(buf + done, page + pg_off, n);
+		} else {
+			/* Hole in sparse file */
+			memset(buf + done, 0, n);
+		}
+	}
+
+	mutex_unlock(&fi->lock);
+
+	return done;
+}
+
+static size_t tmpfs_write(struct file_desc *desc, void *buf, size_t size) {
+	struct tmpfs_file_info *fi;
+	size_t done, pg_off, n;
+	char *page;
+	off_t pos;
+
+	assert(desc);
+
+	fi = file_get_inode_data(desc);
+	assert(fi);
+
+	pos = file_get_pos(desc);
+
+	mutex_lock(&fi->lock);
+
+	for (done = 0; done < size; done += n, pos += n) {
+		pg_off = pos % TMPFS_PAGE_SZ;
+		n = min(TMPFS_PAGE_SZ - pg_off, size - done);
+
+		page = tmpfs_page_get(fi, pos / TMPFS_PAGE_SZ, 1);
+		if (!page) {
+			break;
+		}
+
+		memcpy(page + pg_off, buf + done, n);
+	}
+
+	if (fi->length < pos) {
+		fi->length = pos;
+		file_set_size(desc, pos);
+	}
+
+	mutex_unlock(&fi->lock);
+
+	if (done == 0 && size != 0) {
+		return -ENOSPC;
+	}
+
+	return done;
+}
+
+/* Private mappings get a copy of the range, nothing is written back.
+ * The copy is charged to the mount and lives as long as the file */
+static void *tmpfs_mmap_private(struct tmpfs_file_info *fi, size_t first,
+		size_t n) {
+	struct tmpfs_private_map *map;
+	char *copy, *page;
+	size_t i;
+
+	if (NULL == (map = pool_alloc(&tmpfs_private_pool))) {
+		return NULL;
+	}
+
+	if (NULL == (copy = tmpfs_pages_alloc(fi->fsi, n))) {
+		pool_free(&tmpfs_private_pool, map);
+		return NULL;
+	}
+
+	map->pages = copy;
+	map->n = n;
+	dlist_add_prev(dlist_head_init(&map->link), &fi->private_maps);
+
+	for (i = 0; i < n; i++) {
+		page = tmpfs_page_get(fi, first + i, 0);
+		if (page) {
+			memcpy(copy + i * TMPFS_PAGE_SZ, page, TMPFS_PAGE_SZ);
+		} else {
+			memset(copy + i * TMPFS_PAGE_SZ, 0, TMPFS_PAGE_SZ);
+		}
+	}
+
+	return copy;
+}
+
+static void tmpfs_mmap_private_release(struct tmpfs_file_info *fi) {
+	struct tmpfs_private_map *map;
+
+	dlist_foreach_entry(map, &fi->private_maps, link) {
+		dlist_del(&map->link);
+		tmpfs_pages_free(fi->fsi, map->pages, map->n);
+		pool_free(&tmpfs_private_pool, map);
+	}
+}
+
+/* Moves the range into a physically contiguous run unless it already is
+ * one. Returns NULL with @c err set if a page of a scattered range is
+ * mapped already */
+static char *tmpfs_mmap_run(struct tmpfs_file_info *fi, size_t first,
+		size_t n, int *err) {
+	char *run, *page;
+	void **slot;
+	size_t i;
+
+	run = tmpfs_page_get(fi, first, 0);
+	for (i = 1; run && i < n; i++) {
+		if (tmpfs_page_get(fi, first + i, 0) != run + i * TMPFS_PAGE_SZ) {
+			run = NULL;
+		}
+	}
+	if (run) {
+		return run;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (NULL == (slot = tmpfs_page_slot(fi, first + i, 1))) {
+			*err = ENOMEM;
+			return NULL;
+		}
+		if (tmpfs_slot_pinned(*slot)) {
+			*err = EINVAL;
+			return NULL;
+		}
+	}
+
+	if (NULL == (run = tmpfs_pages_alloc(fi->fsi, n))) {
+		*err = ENOMEM;
+		return NULL;
+	}
+
+	for (i = 0; i < n; i++) {
+		slot = tmpfs_page_slot(fi, first + i, 0);
+		page = run + i * TMPFS_PAGE_SZ;
+
+		if (*slot) {
+			memcpy(page, *slot, TMPFS_PAGE_SZ);
+			tmpfs_pages_free(fi->fsi, *slot, 1);
+		} else {
+			memset(page, 0, TMPFS_PAGE_SZ);
+		}
+		*slot = page;
+	}
+
+	return run;
+}
+
+/**
+ * Maps file pages directly. A shared mapping of a scattered range moves
+ * its pages once into a physically contiguous run, so later mappings of
+ * the same range and read/write calls share the very same memory. Mapped
+ * pages are pinned: they are not moved again and stay allocated after
+ * truncate, so a range partly mapped before can only be mapped again if
+ * it is contiguous already. Mappings must not outlive the file, its pages
+ * and private copies are freed on unlink and umount. There is no MMU protection, @c prot
+ * is only checked against the file access mode.
+ */
+static void *tmpfs_mmap(struct file_desc *desc, void *addr, size_t len,
+		int prot, int flags, off_t off) {
+	struct tmpfs_file_info *fi;
+	size_t first, n, i;
+	char *run;
+	int err = 0;
+
+	fi = file_get_inode_data(desc);
+	assert(fi);
+
+	if (len == 0 || off < 0 || (flags & MAP_FIXED)) {
+		return SET_ERRNO(EINVAL), NULL;
+	}
+	if ((flags & MAP_SHARED) && (prot & PROT_WRITE)
+			&& idesc_check_mode(&desc->f_idesc, O_RDONLY)) {
+		return SET_ERRNO(EACCES), NULL;
+	}
+
+	first = off / TMPFS_PAGE_SZ;
+	n = (off % TMPFS_PAGE_SZ + len + TMPFS_PAGE_SZ - 1) / TMPFS_PAGE_SZ;
+
+	mutex_lock(&fi->lock);
+
+	if (flags & MAP_PRIVATE) {
+		run = tmpfs_mmap_private(fi, first, n);
+		if (!run) {
+			err = ENOMEM;
+		}
+	} else {
+		run = tmpfs_mmap_run(fi, first, n, &err);
+		for (i = 0; run && i < n; i++) {
+			*tmpfs_page_slot(fi, first + i, 0) =
+					(void *) ((uintptr_t) (run + i * TMPFS_PAGE_SZ)
+							| TMPFS_PG_PINNED);
+		}
+	}
+
+	mutex_unlock(&fi->lock);
+
+	if (!run) {
+		return SET_ERRNO(err), NULL;
+	}
+
+	return run + off % TMPFS_PAGE_SZ;
+}
+
+struct file_operations tmpfs_fops = {
+	.write = tmpfs_write,
+	.read = tmpfs_read,
+	.mmap = tmpfs_mmap,
+};
+
+extern struct inode *tmpfs_ilookup(char const *name, struct inode const *dir);
+extern struct super_block_operations tmpfs_sbops;
+
+struct inode_operations tmpfs_iops = {
+	.ino_create   = tmpfs_create,
+	.ino_lookup   = tmpfs_ilookup,
+	.ino_remove   = tmpfs_delete,
+	.ino_iterate  = tmpfs_iterate,
+	.ino_truncate = tmpfs_truncate,
+};
+
+int tmpfs_iterate(struct inode *next, char *name, struct inode *parent,
+		struct dir_ctx *ctx) {
+	struct tmpfs_fs_info *fsi;
+	int cur_id;
+
+	assert(ctx);
+	assert(next);
+	assert(parent);
+	assert(parent->i_sb);
+
+	cur_id = (int) (uintptr_t)ctx->fs_ctx;
+	fsi = parent->i_sb->sb_data;
+
+	while (cur_id < TMPFS_FILES) {
+		if (tmpfs_files[cur_id].fsi != fsi) {
+			cur_id++;
+			continue;
+		}
+
+		inode_priv_set(next, &tmpfs_files[cur_id]);
+		next->i_no = cur_id;
+		next->i_size = tmpfs_files[cur_id].length;
+		next->i_mode = tmpfs_files[cur_id].mode & (S_IFMT | S_IRWXA);
+
+		ctx->fs_ctx = (void *) (uintptr_t)(cur_id + 1);
+		strncpy(name, (char *) tmpfs_files[cur_id].name, NAME_MAX);
+
+		return 0;
+	}
+
+	ctx->fs_ctx = NULL;
+	return -1;
+}
+
+static struct tmpfs_file_info *tmpfs_file_alloc(struct inode *node) {
+	struct tmpfs_file_info *fi;
+	size_t fi_index;
+
+	mutex_lock(&tmpfs_files_lock);
+	fi_index = index_alloc(&tmpfs_file_idx, INDEX_MIN);
+	mutex_unlock(&tmpfs_files_lock);
+
+	if (fi_index == INDEX_NONE) {
+		return NULL;
+	}
+
+	fi = &tmpfs_files[fi_index];
+	memset(fi, 0, sizeof(*fi));
+	mutex_init(&fi->lock);
+	dlist_init(&fi->private_maps);
+
+	fi->index = fi_index;
+	fi->fsi   = node->i_sb->sb_data;
+	fi->inode = node;
+
+	inode_size_set(node, 0);
+	inode_priv_set(node, fi);
+
+	return fi;
+}
+
+static void tmpfs_file_free(struct tmpfs_file_info *fi) {
+	mutex_lock(&fi->lock);
+	tmpfs_mmap_private_release(fi);
+	tmpfs_pages_release(fi, 0, 1);
+	mutex_unlock(&fi->lock);
+
+	mutex_lock(&tmpfs_files_lock);
+	index_free(&tmpfs_file_idx, fi->index);
+	memset(fi, 0, sizeof(*fi));
+	mutex_unlock(&tmpfs_files_lock);
+}
+
+int tmpfs_create(struct inode *i_new, struct inode *i_dir, int mode) {
+	struct tmpfs_file_info *fi;
+
+	assert(i_new);
+
+	if (S_ISREG(i_new->i_mode)) {
+		fi = tmpfs_file_alloc(i_new);
+		if (NULL == fi) {
+			return -ENOMEM;
+		}
+		fi->mode = i_new->i_mode;
+		strncpy(fi->name, inode_name(i_new), sizeof(fi->name) - 1);
+
+		i_new->i_no = fi->index;
+	}
+
+	return 0;
+}
+
+int tmpfs_delete(struct inode *node) {
+	struct tmpfs_file_info *fi;
+
+	fi = inode_priv(node);
+	if (fi) {
+		tmpfs_file_free(fi);
+	}
+
+	return 0;
+}
+
+int tmpfs_truncate(struct inode *node, off_t length) {
+	struct tmpfs_file_info *fi;
+	size_t pg_off;
+	char *page;
+
+	assert(node);
+
+	fi = inode_priv(node);
+	if (!fi) {
+		return -EISDIR;
+	}
+
+	if (length < 0) {
+		return -EINVAL;
+	}
+
+	if (length / TMPFS_PAGE_SZ >= TMPFS_MAX_PAGES) {
+		return -EFBIG;
+	}
+
+	mutex_lock(&fi->lock);
+
+	if (length < fi->length) {
+		tmpfs_pages_release(fi, (length + TMPFS_PAGE_SZ - 1) / TMPFS_PAGE_SZ, 0);
+
+		/* Keep bytes past EOF zeroed, they become visible on growth */
+		pg_off = length % TMPFS_PAGE_SZ;
+		page = tmpfs_page_get(fi, length / TMPFS_PAGE_SZ, 0);
+		if (pg_off && page) {
+			memset(page + pg_off, 0, TMPFS_PAGE_SZ - pg_off);
+		}
+	}
+
+	fi->length = length;
+	inode_size_set(node, length);
+
+	mutex_unlock(&fi->lock);
+
+	return 0;
+}
+
+int tmpfs_fill_sb(struct super_block *sb, const char *source) {
+	struct tmpfs_fs_info *fsi;
+
+	assert(sb);
+
+	if (NULL == (fsi = pool_alloc(&tmpfs_fs_pool))) {
+		return -ENOMEM;
+	}
+
+	memset(fsi, 0, sizeof(struct tmpfs_fs_info));
+	mutex_init(&fsi->lock);
+	fsi->max_pages = TMPFS_SIZE_LIMIT / TMPFS_PAGE_SZ;
+
+	sb->sb_data = fsi;
+	sb->sb_iops = &tmpfs_iops;
+	sb->sb_fops = &tmpfs_fops;
+	sb->sb_ops  = &tmpfs_sbops;
+
+	return 0;
+}
+
+int tmpfs_clean_sb(struct super_block *sb) {
+	struct tmpfs_fs_info *fsi;
+
+	assert(sb);
+
+	fsi = sb->sb_data;
+
+	for (int i = 0; i < TMPFS_FILES; i++) {
+		if (tmpfs_files[i].fsi == fsi) {
+			tmpfs_file_free(&tmpfs_files[i]);
+		}
+	}
+
+	pool_free(&tmpfs_fs_pool, fsi);
+
+	return 0;
+}
+
+int tmpfs_destroy_inode(struct inode *inode) {
+	assert(inode);
+	return 0;
+}
+
+static struct fs_driver tmpfs_driver = {
+	.name     = "tmpfs",
+	.fill_sb  = tmpfs_fill_sb,
+	.clean_sb = tmpfs_clean_sb,
+};
+
+DECLARE_FILE_SYSTEM_DRIVER(tmpfs_driver);
@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @brief Memory file system keeping file data in page allocator pages
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef TMPFS_H_
+#define TMPFS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <fs/file_desc.h>
+#include <framework/mod/options.h>
+#include <kernel/thread/sync/mutex.h>
+#include <lib/libds/dlist.h>
+#include <module/embox/fs/driver/tmpfs.h>
+
+#define TMPFS_FILES       OPTION_MODULE_GET(embox__fs__driver__tmpfs, NUMBER, inode_quantity)
+#define TMPFS_DESCRIPTORS OPTION_MODULE_GET(embox__fs__driver__tmpfs, NUMBER, tmpfs_quantity)
+/* Per-mount limit in bytes, 0 means limited by free pages only */
+#define TMPFS_SIZE_LIMIT  OPTION_MODULE_GET(embox__fs__driver__tmpfs, NUMBER, size_limit)
+#define TMPFS_PRIVATE_MAPS \
+	OPTION_MODULE_GET(embox__fs__driver__tmpfs, NUMBER, private_map_quantity)
+
+#define TMPFS_NAME_LEN    32
+
+struct dir_ctx;
+struct inode;
+struct super_block;
+
+struct tmpfs_fs_info {
+	struct mutex lock;      /* protects page accounting */
+	size_t max_pages;       /* 0 - no quota */
+	size_t used_pages;      /* data and page table pages */
+};
+
+/**
+ * File data is addressed through a two-level table of page pointers.
+ * Both levels are pages themselves, so the only limit for file growth
+ * is the mount quota. Missing entries are holes and read as zeroes.
+ */
+struct tmpfs_file_info {
+	struct mutex lock;
+	size_t  length;
+	int     index;                 /* number of file in FS*/
+	int     mode;
+	char    name[TMPFS_NAME_LEN];
+	void   *inode;
+	void ***pgdir;
+	struct dlist_head private_maps; /* copies for MAP_PRIVATE */
+	struct tmpfs_fs_info *fsi;
+};
+
+extern struct file_operations tmpfs_fops;
+extern struct tmpfs_file_info tmpfs_files[TMPFS_FILES];
+
+extern int tmpfs_fill_sb(struct super_block *sb, const char *source);
+extern int tmpfs_clean_sb(struct super_block *sb);
+extern int tmpfs_delete(struct inode *node);
+extern int tmpfs_truncate(struct inode *node, off_t length);
+extern int tmpfs_create(struct inode *i_new, struct inode *i_dir, int mode);
+extern int tmpfs_iterate(struct inode *next, char *name, struct inode *parent,
+		struct dir_ctx *ctx);
+
+extern int tmpfs_destroy_inode(struct inode *inode);
+
+#endif /* TMPFS_H_ */
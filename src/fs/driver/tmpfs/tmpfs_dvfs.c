@@ -0,0 +1,56 @@
+/**
+ * @file
+ * @brief Memory file system, DVFS part
+ *
+ * @date 19.10.2026
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <fs/inode.h>
+#include <fs/super_block.h>
+
+#include "tmpfs.h"
+
+struct inode *tmpfs_ilookup(char const *name, struct inode const *dir) {
+	struct inode *node;
+	struct super_block *sb;
+
+	assert(dir);
+	assert(dir->i_sb);
+	assert(dir->i_sb->sb_data);
+
+	sb = dir->i_sb;
+
+	for (int i = 0; i < TMPFS_FILES; i++) {
+		if (tmpfs_files[i].fsi != sb->sb_data) {
+			continue;
+		}
+
+		if (strcmp(name, tmpfs_files[i].name)) {
+			continue;
+		}
+
+		if (NULL == (node = dvfs_alloc_inode(sb))) {
+			return NULL;
+		}
+
+		node->i_privdata = &tmpfs_files[i];
+		node->i_no = tmpfs_files[i].index;
+		node->i_size = tmpfs_files[i].length;
+		node->i_mode = tmpfs_files[i].mode & (S_IFMT | S_IRWXA);
+
+		return node;
+	}
+
+	return NULL;
+}
+
+extern struct idesc *dvfs_file_open_idesc(struct lookup *lookup, int __oflag);
+
+struct super_block_operations tmpfs_sbops = {
+	.open_idesc    = dvfs_file_open_idesc,
+	.destroy_inode = tmpfs_destroy_inode,
+};
@@ -0,0 +1,21 @@
+/**
+ * @file
+ * @brief Memory file system, old VFS part
+ *
+ * @date 19.10.2026
+ */
+
+#include <stddef.h>
+
+#include <fs/inode.h>
+#include <fs/super_block.h>
+
+#include "tmpfs.h"
+
+struct inode *tmpfs_ilookup(char const *name, struct inode const *dir) {
+	return NULL;
+}
+
+struct super_block_operations tmpfs_sbops = {
+	.destroy_inode = tmpfs_destroy_inode,
+};
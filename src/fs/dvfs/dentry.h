@@ -25,9 +25,13 @@ struct dentry {
 
 	struct dentry     *parent;
 	struct dlist_head children; /* Sub-elements of directory */
-	struct dlist_head children_lnk;
+	struct dlist_head children_lnk; /* Link in parent's children or negatives */
+	struct dlist_head negatives; /* Negative dentries of directory */
 
 	struct dlist_head d_lnk;   /* List for all dentries in system */
+
+	struct dlist_head d_hash;  /* Link in dentry cache hash chain */
+	unsigned int d_hash_val;
 };
 
 struct lookup {
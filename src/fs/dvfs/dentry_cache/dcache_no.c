@@ -6,26 +6,12 @@
  * @date 2015-06-09
  */
 
-#include <string.h>
-#include <fs/dvfs.h>
-
-struct dentry *dvfs_cache_lookup(const char *path, struct dentry *base) {
-	return NULL;
-}
+#include <errno.h>
 
-struct dentry *dvfs_cache_get(char *path, struct lookup *lookup) {
-	struct dentry *d;
-	struct dlist_head *l;
-	dlist_foreach(l, &lookup->parent->children) {
-		if (l == &lookup->parent->children)
-			continue;
-		d = mcast_out(l, struct dentry, children_lnk);
-
-		if (d != lookup->item && !strcmp(d->name, lookup->item->name))
-			return d;
-	}
+#include <fs/dvfs.h>
 
-	return NULL;
+struct dentry *dvfs_cache_get(struct dentry *parent, const char *name) {
+	return local_lookup(parent, name);
 }
 
 int dvfs_cache_del(struct dentry *dentry) {
@@ -33,5 +19,6 @@ int dvfs_cache_del(struct dentry *dentry) {
 }
 
 int dvfs_cache_add(struct dentry *dentry) {
-	return 0;
+	/* Negative dentries are not children, a lookup would never find them */
+	return (dentry->flags & DVFS_NEGATIVE) ? -ENOTSUP : 0;
 }
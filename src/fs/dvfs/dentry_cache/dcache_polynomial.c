@@ -6,58 +6,80 @@
  * @date 2015-06-09
  */
 
+#include <stdint.h>
 #include <string.h>
-#include <limits.h>
 
 #include <fs/dvfs.h>
-#include <kernel/printk.h>
-#include <mem/misc/pool.h>
-#include <lib/libds/hashtable.h>
-
-/* TODO remove this */
-#define DENTRY_POOL_SIZE 64
-
-static const unsigned long long prime = 19, module = 1023;
-static unsigned long long pows[PATH_MAX];
+#include <framework/mod/options.h>
+#include <lib/libds/dlist.h>
+#include <mem/sysmalloc.h>
+
+#define DCACHE_HASH_MIN OPTION_GET(NUMBER, hash_size_min)
+#define DCACHE_HASH_MAX OPTION_GET(NUMBER, hash_size_max)
+
+/* Dentries are hashed by parent pointer and name, so resolving a path
+ * component costs one hash of the component name regardless of directory
+ * size and depth. Table doubles when there are more than two entries per
+ * bucket on average. */
+static struct dlist_head dcache_initial[DCACHE_HASH_MIN];
+static struct dlist_head *dcache_table;
+static unsigned int dcache_size;
+static unsigned int dcache_count;
+
+static unsigned int dcache_hash(const struct dentry *parent, const char *name) {
+	uint32_t h;
+
+	h = (uint32_t) (uintptr_t) parent * 0x9e3779b1;
+	while (*name) {
+		h = h * 31 + (unsigned char) *name++;
+	}
 
-static void hash_init(void) {
-	/* TODO precount in runtime or even in compiletime */
-	int i;
-	pows[0] = 1;
-	for (i = 1; i < PATH_MAX; i++)
-		pows[i] = (pows[i - 1] * prime) % module;
+	return h ^ (h >> 16);
 }
 
-static unsigned long long poly_hash(const char *str) {
-	unsigned long long res = 0;
-	const char *pos = str;
-
-	hash_init();
+static void dcache_init(void) {
+	int i;
 
-	while (*pos) {
-		res += ((int) *str) * pows[pos - str];
-		res %= module;
-		pos++;
+	for (i = 0; i < DCACHE_HASH_MIN; i++) {
+		dlist_init(&dcache_initial[i]);
 	}
-	return res;
+	dcache_table = dcache_initial;
+	dcache_size = DCACHE_HASH_MIN;
 }
 
-static size_t get_dentry_hash(void *key) {
-	return (size_t) key;
+static struct dlist_head *dcache_bucket(unsigned int hash) {
+	return &dcache_table[hash & (dcache_size - 1)];
 }
 
-static int cmp_dentries(void *key1, void *key2) {
-	return !(key1 == key2);
-}
+static void dcache_grow(void) {
+	struct dlist_head *old_table = dcache_table, *new_table;
+	unsigned int old_size = dcache_size, new_size = dcache_size * 2;
+	struct dentry *d;
+	unsigned int i;
 
-HASHTABLE_DEF(dentry_ht,
-		DENTRY_POOL_SIZE * sizeof(struct dentry *),
-		get_dentry_hash,
-		cmp_dentries);
+	new_table = sysmalloc(new_size * sizeof(*new_table));
+	if (!new_table) {
+		/* Keep going with longer chains */
+		return;
+	}
+	for (i = 0; i < new_size; i++) {
+		dlist_init(&new_table[i]);
+	}
+
+	dcache_table = new_table;
+	dcache_size = new_size;
 
-POOL_DEF(dentry_ht_pool, struct hashtable_item, DENTRY_POOL_SIZE);
+	for (i = 0; i < old_size; i++) {
+		dlist_foreach_entry(d, &old_table[i], d_hash) {
+			dlist_del_init(&d->d_hash);
+			dlist_add_next(&d->d_hash, dcache_bucket(d->d_hash_val));
+		}
+	}
 
-extern int dentry_full_path(struct dentry *dentry, char *buf);
+	if (old_table != dcache_initial) {
+		sysfree(old_table);
+	}
+}
 
 /**
  * @brief Add dentry to cache
@@ -66,14 +88,22 @@ extern int dentry_full_path(struct dentry *dentry, char *buf);
  * @return Negative error code
  */
 int dvfs_cache_add(struct dentry *dentry) {
-	char pathname[PATH_MAX];
-	unsigned long long hash;
-	struct hashtable_item *ht_item = pool_alloc(&dentry_ht_pool);
-	assert(ht_item);
-	dentry_full_path(dentry, pathname);
-	hash = poly_hash(pathname);
-	ht_item = hashtable_item_init(ht_item, (void *) *((size_t *) &hash), dentry);
-	hashtable_put(&dentry_ht, ht_item);
+	if (!dcache_table) {
+		dcache_init();
+	}
+
+	if (!dentry->parent || !dlist_empty(&dentry->d_hash)) {
+		return 0;
+	}
+
+	if (dcache_count >= 2 * dcache_size && dcache_size < DCACHE_HASH_MAX) {
+		dcache_grow();
+	}
+
+	dentry->d_hash_val = dcache_hash(dentry->parent, dentry->name);
+	dlist_add_next(&dentry->d_hash, dcache_bucket(dentry->d_hash_val));
+	dcache_count++;
+
 	return 0;
 }
 
@@ -86,47 +116,40 @@ int dvfs_cache_add(struct dentry *dentry) {
  * @return Negative error code
  */
 int dvfs_cache_del(struct dentry *dentry) {
-	char pathname[PATH_MAX];
-	unsigned long long hash;
-	struct hashtable_item *ht_item;
-	if (dentry->name[0] == '\0')
+	if (dlist_empty(&dentry->d_hash)) {
 		return -1;
-	dentry_full_path(dentry, pathname);
-	hash = poly_hash(pathname);
-	if (!(ht_item = hashtable_del(&dentry_ht, (void *) *((size_t *) &hash)))) {
-		printk("Remove empty dentry\n");
 	}
-	pool_free(&dentry_ht_pool, ht_item);
+
+	dlist_del_init(&dentry->d_hash);
+	dcache_count--;
+
 	return 0;
 }
 
 /**
- * @brief Try to get dentry with given path from cache
+ * @brief Try to get child of the directory from cache
  *
- * @param path
+ * @param parent Directory dentry
+ * @param name   Name of the child
  *
- * @return
+ * @return Pointer to the dentry or NULL if it is not cached
  */
-struct dentry *dvfs_cache_get(char *path, struct lookup *lookup) {
-	unsigned long long hash = poly_hash(path);
-	struct dentry *res;
-	/* TODO local path hash offset */
-	res = hashtable_get(&dentry_ht, (void *) *((size_t *) &hash));
-	return res;
-}
+struct dentry *dvfs_cache_get(struct dentry *parent, const char *name) {
+	unsigned int hash;
+	struct dentry *d;
 
-struct dentry *dvfs_cache_lookup(const char *path,
-	struct dentry *base) {
-	char full_path[PATH_MAX];
-	struct dentry *ret;
-
-	dentry_full_path(base, full_path);
-	strncat(full_path, path, PATH_MAX - strlen(path));
+	if (!dcache_table) {
+		return NULL;
+	}
 
-	/* TODO check path from root */
+	hash = dcache_hash(parent, name);
 
-	ret = dvfs_cache_get(full_path, NULL);
-	dentry_ref_inc(ret);
+	dlist_foreach_entry(d, dcache_bucket(hash), d_hash) {
+		if (d->d_hash_val == hash && d->parent == parent &&
+				!strcmp(d->name, name)) {
+			return d;
+		}
+	}
 
-	return ret;
+	return NULL;
 }
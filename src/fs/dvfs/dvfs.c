@@ -69,6 +69,8 @@ int dvfs_create_new(const char *name, struct lookup *lookup, int flags) {
 		*slash = '\0';
 	}
 
+	dentry_negative_drop(lookup->parent, d->name);
+
 	inode_fill(sb, new_inode, d);
 
 	d->flags |= flags;
@@ -104,6 +106,8 @@ int dvfs_create_new(const char *name, struct lookup *lookup, int flags) {
 	if (res) {
 		dentry_ref_dec(d);
 		dvfs_destroy_dentry(d);
+	} else {
+		dvfs_cache_add(d);
 	}
 
 	return res;
@@ -275,6 +279,7 @@ int dvfs_mount(const char *source, const char *dest, const char *fs_type,
 		d->flags |= VFS_DIR_VIRTUAL;
 		dentry_fill(sb, sb->sb_root, d, lookup.parent);
 		strcpy(d->name, lookup.item->name);
+		dvfs_cache_add(d);
 
 		d->flags |= S_IFDIR | DVFS_MOUNT_POINT;
 
@@ -447,7 +452,14 @@ int dvfs_iterate(struct lookup *lookup, struct dir_ctx *ctx) {
 		return 0;
 	}
 
-	if ((cached = dvfs_cache_get(next_dentry->name, lookup))) {
+	cached = dvfs_cache_get(lookup->parent, next_dentry->name);
+	if (cached && (cached->flags & DVFS_NEGATIVE)) {
+		/* File appeared behind our back, forget failed lookup */
+		dvfs_destroy_dentry(cached);
+		cached = NULL;
+	}
+
+	if (cached) {
 		/* This node is already in the VFS tree */
 		dentry_ref_dec(next_dentry);
 		dvfs_destroy_dentry(next_dentry);
@@ -32,6 +32,7 @@
 #define DVFS_MOUNT_POINT   0x04000000
 #define DVFS_NO_LSEEK      0x08000000
 #define DVFS_DISCONNECTED  0x10000000
+#define DVFS_NEGATIVE      0x20000000 /* Cached failed lookup, no inode */
 
 struct dentry;
 struct file_desc;
@@ -55,8 +56,7 @@ extern int dvfs_create_new(const char *name, struct lookup *lookup, int flags);
 extern int dvfs_rename(struct dentry *from, struct dentry *to);
 
 /* dcache-related stuff */
-extern struct dentry *dvfs_cache_lookup(const char *path, struct dentry *base);
-extern struct dentry *dvfs_cache_get(char *path, struct lookup *lookup);
+extern struct dentry *dvfs_cache_get(struct dentry *parent, const char *name);
 extern int dvfs_cache_del(struct dentry *dentry);
 extern int dvfs_cache_add(struct dentry *dentry);
 
@@ -72,5 +72,10 @@ extern int dentry_ref_inc(struct dentry *dentry);
 extern int dentry_ref_dec(struct dentry *dentry);
 extern int dentry_disconnect(struct dentry *dentry);
 extern int dentry_reconnect(struct dentry *parent, const char *name);
+extern struct dentry *local_lookup(struct dentry *parent, const char *name);
+extern struct dentry *dentry_negative_add(struct dentry *parent,
+                                          const char *name);
+extern void dentry_negative_drop(struct dentry *parent, const char *name);
+extern void dentry_negative_purge(struct dentry *parent);
 
 #endif
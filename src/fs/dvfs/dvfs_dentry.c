@@ -58,8 +58,6 @@ int dentry_full_path(struct dentry *dentry, char *buf) {
 	return 0;
 }
 
-extern struct dentry *local_lookup(struct dentry *parent, char *name);
-
 /**
  * @brief Resolve one more element in the path
  * @param segment Segment of a path
@@ -107,16 +105,23 @@ int dvfs_path_walk(struct cwk_segment *segment, struct dentry *parent,
 		memcpy(buff, segment->begin, segment->size);
 		buff[segment->size] = '\0';
 
-		if ((d = local_lookup(parent, buff))) {
+		if ((d = dvfs_cache_get(parent, buff))) {
+			if (d->flags & DVFS_NEGATIVE) {
+				return -ENOENT;
+			}
 			break;
 		}
 
 		inode = parent->d_sb->sb_iops->ino_lookup(buff, parent->d_inode);
 		if (!inode) {
+			dentry_negative_add(parent, buff);
 			return -ENOENT;
 		}
 
+		/* Keep parent from being reclaimed while allocating */
+		dentry_ref_inc(parent);
 		d = dvfs_alloc_dentry();
+		dentry_ref_dec(parent);
 		if (!d) {
 			return -ENOMEM;
 		}
@@ -124,6 +129,7 @@ int dvfs_path_walk(struct cwk_segment *segment, struct dentry *parent,
 		dentry_fill(parent->d_sb, inode, d, parent);
 		strcpy(d->name, buff);
 		d->flags = inode->i_mode;
+		dvfs_cache_add(d);
 	}
 
 	if (dentry) {
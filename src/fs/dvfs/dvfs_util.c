@@ -12,7 +12,7 @@
 #include <drivers/device.h>
 #include <fs/dvfs.h>
 #include <framework/mod/options.h>
-#include <mem/misc/pool.h>
+#include <mem/objalloc.h>
 #include <lib/libds/dlist.h>
 #include <util/log.h>
 
@@ -20,9 +20,9 @@
 #define DENTRY_POOL_SIZE OPTION_GET(NUMBER, dentry_pool_size)
 #define FILE_POOL_SIZE OPTION_GET(NUMBER, file_pool_size)
 
-POOL_DEF(inode_pool, struct inode, INODE_POOL_SIZE);
-POOL_DEF(dentry_pool, struct dentry, DENTRY_POOL_SIZE);
-POOL_DEF(file_pool, struct file_desc, FILE_POOL_SIZE);
+OBJALLOC_DEF(inode_pool, struct inode, INODE_POOL_SIZE);
+OBJALLOC_DEF(dentry_pool, struct dentry, DENTRY_POOL_SIZE);
+OBJALLOC_DEF(file_pool, struct file_desc, FILE_POOL_SIZE);
 
 #define FREE_DENTRY_ANY    0
 #define FREE_DENTRY_INODE  1
@@ -40,10 +40,10 @@ struct inode *dvfs_alloc_inode(struct super_block *sb) {
 	if (!sb)
 		return NULL;
 
-	inode = pool_alloc(&inode_pool);
+	inode = objalloc(&inode_pool);
 	if (!inode) {
 		if (!dvfs_free_dentry(FREE_DENTRY_INODE)) {
-			inode = pool_alloc(&inode_pool);
+			inode = objalloc(&inode_pool);
 		} else {
 			return NULL;
 		}
@@ -66,7 +66,7 @@ struct inode *dvfs_alloc_inode(struct super_block *sb) {
  * @retval 0 Ok
  */
 int dvfs_default_destroy_inode(struct inode *inode) {
-	pool_free(&inode_pool, inode);
+	objfree(&inode_pool, inode);
 	return 0;
 }
 
@@ -141,10 +141,10 @@ static int dvfs_free_dentry(int mode) {
  * @retval NULL Pool is full
  */
 struct dentry *dvfs_alloc_dentry(void) {
-	struct dentry *dentry = pool_alloc(&dentry_pool);
+	struct dentry *dentry = objalloc(&dentry_pool);
 	if (!dentry) {
 		if (!dvfs_free_dentry(0)) {
-			dentry = pool_alloc(&dentry_pool);
+			dentry = objalloc(&dentry_pool);
 		} else {
 			return NULL;
 		}
@@ -155,6 +155,8 @@ struct dentry *dvfs_alloc_dentry(void) {
 	dlist_head_init(&dentry->d_lnk);
 	dlist_add_next(&dentry->d_lnk, &dentry_dlist);
 	dlist_init(&dentry->children);
+	dlist_init(&dentry->negatives);
+	dlist_head_init(&dentry->d_hash);
 
 	return dentry;
 }
@@ -171,7 +173,13 @@ int dvfs_destroy_dentry(struct dentry *dentry) {
 			dvfs_destroy_inode(dentry->d_inode);
 		}
 
-		if (dentry->parent) {
+		dentry_negative_purge(dentry);
+
+		if (dentry->flags & DVFS_NEGATIVE) {
+			/* Not a child, see dentry_negative_add() */
+			dlist_del(&dentry->children_lnk);
+			dvfs_cache_del(dentry);
+		} else if (dentry->parent) {
 			/* Dentry was integrated to VFS tree */
 			dentry_ref_dec(dentry->parent);
 			dlist_del(&dentry->children_lnk);
@@ -180,7 +188,7 @@ int dvfs_destroy_dentry(struct dentry *dentry) {
 
 		dlist_del(&dentry->d_lnk);
 
-		pool_free(&dentry_pool, dentry);
+		objfree(&dentry_pool, dentry);
 		return 0;
 	} else {
 		return -EBUSY;
@@ -224,13 +232,13 @@ void dentry_upd_flags(struct dentry *dentry) {
  * @retval NULL Pool is full
  */
 struct file_desc *dvfs_alloc_file(void) {
-	return pool_alloc(&file_pool);
+	return objalloc(&file_pool);
 }
 
 /* @brief Remove file descriptor from pool
  */
 int dvfs_destroy_file(struct file_desc *desc) {
-	pool_free(&file_pool, desc);
+	objfree(&file_pool, desc);
 	return 0;
 }
 
@@ -332,6 +340,8 @@ int dvfs_update_root(void) {
 
 	dlist_init(&global_root->children);
 	dlist_init(&global_root->children_lnk);
+	dlist_init(&global_root->negatives);
+	dlist_head_init(&global_root->d_hash);
 
 	return 0;
 }
@@ -356,7 +366,7 @@ struct dentry *dvfs_root(void) {
 *
 * @return Pointer to dentry if found or NULL if not
 */
-struct dentry *local_lookup(struct dentry *parent, char *name) {
+struct dentry *local_lookup(struct dentry *parent, const char *name) {
 	struct dentry *d;
 	struct dlist_head *l;
 
@@ -398,7 +408,73 @@ int dentry_reconnect(struct dentry *parent, const char *name) {
 		if (dentry->parent == parent && !strcmp(dentry->name, name)) {
 			dlist_head_init(&dentry->children_lnk);
 			dlist_add_prev(&dentry->children_lnk, &parent->children);
+			dvfs_cache_add(dentry);
 		}
 	}
 	return 0;
 }
+
+/**
+ * @brief Remember that @name does not exist in @parent directory, so
+ * next lookups of it fail without asking the file system
+ *
+ * A negative dentry is put to the dentry cache and to the negatives list
+ * of @parent. It is not a child of @parent and does not hold a reference
+ * to it, so it neither keeps the directory busy nor shows up when walking
+ * its children. The directory destroys its negative dentries when it is
+ * destroyed itself.
+ *
+ * @return Pointer to negative dentry or NULL if it was not created
+ */
+struct dentry *dentry_negative_add(struct dentry *parent, const char *name) {
+	struct dentry *d;
+
+	if (!parent->d_sb || (parent->d_sb->sb_flags & SB_NO_NEGATIVE_DENTRY)) {
+		return NULL;
+	}
+
+	/* Keep parent from being reclaimed while allocating */
+	dentry_ref_inc(parent);
+	d = dvfs_alloc_dentry();
+	dentry_ref_dec(parent);
+	if (!d) {
+		return NULL;
+	}
+
+	d->d_sb = parent->d_sb;
+	d->parent = parent;
+	dlist_head_init(&d->children_lnk);
+	dlist_add_prev(&d->children_lnk, &parent->negatives);
+	strncpy(d->name, name, NAME_MAX - 1);
+	d->flags = DVFS_NEGATIVE;
+
+	if (dvfs_cache_add(d)) {
+		dvfs_destroy_dentry(d);
+		return NULL;
+	}
+
+	return d;
+}
+
+/**
+ * @brief Forget all negative dentries of @parent directory
+ */
+void dentry_negative_purge(struct dentry *parent) {
+	struct dentry *d;
+
+	dlist_foreach_entry(d, &parent->negatives, children_lnk) {
+		dvfs_destroy_dentry(d);
+	}
+}
+
+/**
+ * @brief Forget negative dentry for @name in @parent directory, if any
+ */
+void dentry_negative_drop(struct dentry *parent, const char *name) {
+	struct dentry *d;
+
+	d = dvfs_cache_get(parent, name);
+	if (d && (d->flags & DVFS_NEGATIVE)) {
+		dvfs_destroy_dentry(d);
+	}
+}
@@ -33,6 +33,8 @@ struct file_operations {
 	size_t (*read)(struct file_desc *desc, void *buf, size_t size);
 	size_t (*write)(struct file_desc *desc, void *buf, size_t size);
 	int (*ioctl)(struct file_desc *desc, int request, void *data);
+	void *(*mmap)(struct file_desc *desc, void *addr, size_t len, int prot,
+	    int flags, off_t off);
 };
 
 struct file_desc {
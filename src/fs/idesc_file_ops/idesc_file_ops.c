@@ -14,6 +14,7 @@
 #include <sys/types.h>
 #include <sys/uio.h>
 
+#include <fs/file_desc.h>
 #include <fs/kfile.h>
 #include <kernel/task/resource/idesc.h>
 
@@ -80,6 +81,21 @@ static int idesc_file_ops_status(struct idesc *idesc, int mask) {
 	return 1;
 }
 
+static void *idesc_file_ops_mmap(struct idesc *idesc, void *addr, size_t len,
+    int prot, int flags, int fd, off_t off) {
+	struct file_desc *desc;
+
+	assert(idesc);
+	assert(idesc->idesc_ops == &idesc_file_ops);
+
+	desc = (struct file_desc *)idesc;
+	if (NULL == desc->f_ops->mmap) {
+		return SET_ERRNO(ENODEV), NULL;
+	}
+
+	return desc->f_ops->mmap(desc, addr, len, prot, flags, off);
+}
+
 const struct idesc_ops idesc_file_ops = {
     .close = idesc_file_ops_close,
     .id_readv = idesc_file_ops_read,
@@ -87,4 +103,5 @@ const struct idesc_ops idesc_file_ops = {
     .ioctl = idesc_file_ops_ioctl,
     .fstat = idesc_file_ops_stat,
     .status = idesc_file_ops_status,
+    .idesc_mmap = idesc_file_ops_mmap,
 };
@@ -11,11 +11,22 @@
 #include <stdlib.h>
 #include <string.h>
 #include <arpa/inet.h>
+#include <util/err.h>
 #include <mem/misc/slab.h>
 #include <mem/sysmalloc.h>
+#include <kernel/task.h>
+#include <kernel/task/kernel_task.h>
+#include <kernel/thread.h>
+#include <kernel/thread/waitq.h>
 #include <fs/journal.h>
 #include <fs/bcache.h>
 
+#include <framework/mod/options.h>
+
+#define JOURNAL_COMMIT_INTERVAL OPTION_GET(NUMBER, commit_interval)
+#define JOURNAL_COMMIT_BLOCKS   OPTION_GET(NUMBER, commit_blocks)
+#define JOURNAL_CP_WATERMARK    OPTION_GET(NUMBER, checkpoint_watermark)
+
 /**
  * Slab allocator is used here because we don't want to preallocate a memory
  * for journal's internal structures because it is needed only if some device mounted with
@@ -26,6 +37,8 @@ CACHE_DEF(journal_block_cache, journal_block_t, 0);
 CACHE_DEF(trans_cache, transaction_t, 0);
 CACHE_DEF(handle_cache, journal_handle_t, 0);
 
+static int journal_commit(journal_t *jp);
+
 journal_t *journal_create(journal_fs_specific_t *spec) {
     journal_t *jp;
 
@@ -35,16 +48,112 @@ journal_t *journal_create(journal_fs_specific_t *spec) {
 
     memset(jp, 0, sizeof(journal_t));
     jp->j_fs_specific = *spec;
+    mutex_init(&jp->j_lock);
+    mutex_init(&jp->j_io_lock);
+    waitq_init(&jp->j_wait_commit);
+    waitq_init(&jp->j_wait_transaction);
 
     return jp;
 }
 
+static int journal_need_checkpoint(journal_t *jp) {
+	return jp->j_free * 100 < (jp->j_last - jp->j_first) * JOURNAL_CP_WATERMARK;
+}
+
+/**
+ * Commit thread. Handles only reserve space and dirty buffers of the running
+ * transaction, so all updates made during one commit interval (or until
+ * the transaction grows to JOURNAL_COMMIT_BLOCKS) go to the log with
+ * a single descriptor/commit pair. The interval starts when the first
+ * buffer is dirtied, an idle journal doesn't wake the thread up.
+ * Checkpointing is done here as well: when the log is filling up or when
+ * there is nothing else to do.
+ */
+static void *journal_thread(void *arg) {
+	journal_t *jp = arg;
+	transaction_t *t;
+	int idle, checkpoint;
+
+	while (1) {
+		WAITQ_WAIT(&jp->j_wait_commit, jp->j_commit_armed
+				|| !dlist_empty(&jp->j_checkpoint_transactions)
+				|| jp->j_commit_request || jp->j_stop);
+		WAITQ_WAIT_TIMEOUT(&jp->j_wait_commit,
+				jp->j_commit_request || jp->j_stop, JOURNAL_COMMIT_INTERVAL);
+
+		mutex_lock(&jp->j_lock);
+		if (jp->j_stop) {
+			mutex_unlock(&jp->j_lock);
+			break;
+		}
+		jp->j_commit_request = 0;
+
+		t = jp->j_running_transaction;
+		idle = (t->t_ref == 0 && t->t_nr_buffers == 0);
+		mutex_unlock(&jp->j_lock);
+
+		if (!idle) {
+			journal_commit(jp);
+		}
+
+		mutex_lock(&jp->j_lock);
+		checkpoint = journal_need_checkpoint(jp)
+				|| (idle && !dlist_empty(&jp->j_checkpoint_transactions));
+		mutex_unlock(&jp->j_lock);
+
+		if (checkpoint) {
+			journal_checkpoint_transactions(jp);
+		}
+	}
+
+	return NULL;
+}
+
+int journal_start_thread(journal_t *jp) {
+	struct thread *t;
+
+	assert(jp);
+
+	if (JOURNAL_COMMIT_INTERVAL == 0) {
+		return 0;
+	}
+
+	/* The mount command exits long before the last commit, so the thread
+	 * goes to the kernel task. journal_delete() joins it */
+	t = thread_create(THREAD_FLAG_NOTASK | THREAD_FLAG_SUSPENDED,
+			journal_thread, jp);
+	if (ptr2err(t)) {
+		return ptr2err(t);
+	}
+	task_thread_register(task_kernel_task(), t);
+	jp->j_task = t;
+
+	return thread_launch(t);
+}
+
 int journal_delete(journal_t *jp) {
+	int res = 0;
+
 	assert(jp);
 
+	if (jp->j_task) {
+		mutex_lock(&jp->j_lock);
+		jp->j_stop = 1;
+		mutex_unlock(&jp->j_lock);
+		waitq_wakeup_all(&jp->j_wait_commit);
+		thread_join(jp->j_task, NULL);
+		jp->j_task = NULL;
+	}
+
 	/* Force commit and checkpoint */
-	if (jp->j_fs_specific.commit(jp) != 0
-			|| journal_checkpoint_transactions(jp) != 0) {
+	if (jp->j_running_transaction->t_nr_buffers > 0) {
+		res = journal_commit(jp);
+	}
+	if (res == 0) {
+		res = journal_checkpoint_transactions(jp);
+	}
+
+	if (res != 0) {
 		return -1;
 	}
 
@@ -61,59 +170,187 @@ int journal_delete(journal_t *jp) {
 	return 0;
 }
 
+/**
+ * Commits the running transaction. If handles are still open on it, it
+ * is locked instead and the last handle commits it. The transaction is
+ * replaced under j_lock and written to the log without it, so handles go
+ * on with the new one meanwhile. The part of handles' reservation which
+ * was not used by the log is given back to the journal here, the rest is
+ * freed by checkpoint. Called without j_lock.
+ */
+static int journal_commit(journal_t *jp) {
+	transaction_t *t;
+	int res = 0;
+
+	mutex_lock(&jp->j_io_lock);
+	mutex_lock(&jp->j_lock);
+
+	t = jp->j_running_transaction;
+
+	if (t->t_ref > 0) {
+		/* Don't let new handles in, the last one will commit */
+		t->t_state = T_LOCKED;
+		goto out;
+	}
+
+	if (t->t_nr_buffers == 0) {
+		/* Nothing was dirtied, reuse the transaction */
+		jp->j_free += t->t_outstanding_credits;
+		t->t_outstanding_credits = 0;
+		t->t_tid   = jp->j_transaction_sequence++;
+		t->t_state = T_RUNNING;
+		goto wakeup;
+	}
+
+	if (!(jp->j_running_transaction = journal_new_trans(jp))) {
+		jp->j_running_transaction = t;
+		res = -ENOMEM;
+		goto out;
+	}
+	jp->j_committing_transaction = t;
+	jp->j_commit_armed = 0;
+	waitq_wakeup_all(&jp->j_wait_transaction);
+	mutex_unlock(&jp->j_lock);
+
+	res = jp->j_fs_specific.commit(jp);
+
+	mutex_lock(&jp->j_lock);
+	jp->j_committing_transaction = NULL;
+	/* If the log failed, checkpoint still writes the blocks home */
+	dlist_add_prev(&t->t_next, &jp->j_checkpoint_transactions);
+	jp->j_free += t->t_outstanding_credits;
+	jp->j_free -= t->t_log_blocks;
+	if (res == 0) {
+		jp->j_stat_commits++;
+	}
+
+wakeup:
+	waitq_wakeup_all(&jp->j_wait_transaction);
+out:
+	mutex_unlock(&jp->j_lock);
+	mutex_unlock(&jp->j_io_lock);
+
+	return res;
+}
+
+/* Sleeps until the transaction @a tid is replaced. Called with j_lock held. */
+static void journal_wait_transaction(journal_t *jp, uint32_t tid) {
+	mutex_unlock(&jp->j_lock);
+	WAITQ_WAIT(&jp->j_wait_transaction,
+			jp->j_running_transaction->t_tid != tid);
+	mutex_lock(&jp->j_lock);
+}
+
 journal_handle_t *journal_start(journal_t *jp, size_t nblocks) {
 	journal_handle_t *h;
+	transaction_t *t;
 
 	assert(jp);
 	assert(jp->j_running_transaction);
 
-	if (jp->j_fs_specific.trans_freespace(jp, nblocks) < 0) {
+	if ((h = cache_alloc(&handle_cache)) == NULL) {
 		return NULL;
 	}
 
-    if ((h = cache_alloc(&handle_cache)) == NULL) {
-    	return NULL;
-    }
+	mutex_lock(&jp->j_lock);
+
+	while (1) {
+		t = jp->j_running_transaction;
+
+		if (t->t_state == T_LOCKED) {
+			journal_wait_transaction(jp, t->t_tid);
+			continue;
+		}
 
-    memset(h, 0, sizeof(*h));
-    h->h_transaction    = jp->j_running_transaction;
-    h->h_transaction->t_outstanding_credits += nblocks;
-    h->h_buffer_credits = nblocks;
-    jp->j_free -= nblocks;
+		if (jp->j_fs_specific.trans_freespace(jp, nblocks) == 0) {
+			break;
+		}
+
+		if (t->t_outstanding_credits == 0 && !jp->j_committing_transaction
+				&& dlist_empty(&jp->j_checkpoint_transactions)) {
+			/* Does not fit even into an empty log */
+			mutex_unlock(&jp->j_lock);
+			cache_free(&handle_cache, h);
+			return NULL;
+		}
+
+		/* Close the running transaction to make room for this handle */
+		if (t->t_ref == 0) {
+			mutex_unlock(&jp->j_lock);
+			journal_commit(jp);
+			journal_checkpoint_transactions(jp);
+			mutex_lock(&jp->j_lock);
+		} else {
+			t->t_state = T_LOCKED;
+			journal_wait_transaction(jp, t->t_tid);
+		}
+	}
 
-    h->h_transaction->t_ref++;
+	memset(h, 0, sizeof(*h));
+	h->h_transaction    = t;
+	h->h_transaction->t_outstanding_credits += nblocks;
+	h->h_transaction->t_reserved_credits += nblocks;
+	h->h_buffer_credits = nblocks;
+	jp->j_free -= nblocks;
 
-    return h;
+	h->h_transaction->t_ref++;
+
+	mutex_unlock(&jp->j_lock);
+
+	return h;
 }
 
 int journal_stop(journal_handle_t *handle) {
-    transaction_t *t;
-    journal_t *jp;
-    int res = 0;
-
-    assert(handle);
-    assert(handle->h_transaction);
+	transaction_t *t;
+	journal_t *jp;
+	int credits, commit;
+	int res = 0;
+
+	assert(handle);
+	assert(handle->h_transaction);
+
+	t  = handle->h_transaction;
+	jp = t->t_journal;
+
+	mutex_lock(&jp->j_lock);
+	{
+		jp->j_stat_handles++;
+
+		/* The handle can't dirty anything anymore, so the transaction needs
+		 * log space only for its buffers and for the handles still open. */
+		t->t_reserved_credits -= handle->h_buffer_credits;
+		credits = t->t_nr_buffers + t->t_reserved_credits;
+		if (credits < t->t_outstanding_credits) {
+			jp->j_free += t->t_outstanding_credits - credits;
+			t->t_outstanding_credits = credits;
+		}
 
-    t  = handle->h_transaction;
-    jp = t->t_journal;
+		commit = (0 == --t->t_ref && (!jp->j_task || t->t_state == T_LOCKED));
+		if (!commit && t->t_nr_buffers >= JOURNAL_COMMIT_BLOCKS
+				&& !jp->j_commit_request) {
+			jp->j_commit_request = 1;
+			waitq_wakeup_all(&jp->j_wait_commit);
+		}
+	}
+	mutex_unlock(&jp->j_lock);
+
+	if (commit) {
+		res = journal_commit(jp);
+		/* XXX Ponder on how to handle situation when transaction was uncommitted. */
+		assert(res == 0);
+		if (!jp->j_task && journal_need_checkpoint(jp)) {
+			journal_checkpoint_transactions(jp);
+		}
+	}
 
-    if (0 == --t->t_ref) {
-    	res = jp->j_fs_specific.commit(jp);
-    	/* XXX Ponder on how to handle situation when transaction was uncommitted. */
-    	assert(res == 0);
-    	journal_checkpoint_transactions(jp);
-    }
-    /* XXX See the comment in the header to journal_dirty_block.
-     *  jp->j_free += handle->h_buffer_credits;
-     */
-    cache_free(&handle_cache, handle);
+	cache_free(&handle_cache, handle);
 
-    return res;
+	return res;
 }
 
 int journal_checkpoint_transactions(journal_t *jp) {
     transaction_t *t;
-    journal_block_t *b;
+    journal_block_t *b, *last;
     struct buffer_head *bh;
     int blkcount, i;
 
@@ -121,8 +358,13 @@ int journal_checkpoint_transactions(journal_t *jp) {
 
     blkcount = jp->j_blocksize / jp->j_disk_sectorsize;
 
+    /* The list changes only under j_io_lock, so the blocks are written
+     * without j_lock */
+    mutex_lock(&jp->j_io_lock);
+
     dlist_foreach_entry(t, &jp->j_checkpoint_transactions, t_next) {
     	dlist_foreach_entry(b, &t->t_buffers, b_next) {
+    		last = b;
     		for (i = 0; i < blkcount; i++) {
     			bh = b->bh[i];
 
@@ -130,6 +372,7 @@ int journal_checkpoint_transactions(journal_t *jp) {
     			{
 					/* That means - if @a b is not up-to-date, than go to next journal block */
 					if (bh->journal_block != b) {
+						last = bh->journal_block;
 						bcache_buffer_unlock(bh);
 						break;
 					}
@@ -137,41 +380,56 @@ int journal_checkpoint_transactions(journal_t *jp) {
 	    			 * than unlock corresponding @a bh */
 					buffer_clear_flag(bh, BH_JOURNAL);
 					buffer_clear_flag(bh, BH_DIRTY);
+					bh->journal_block = NULL;
     			}
     			bcache_buffer_unlock(bh);
     		}
+
+    		/* A newer copy from a committed transaction is going to be
+    		 * checkpointed later, so don't write the same block twice */
+    		if (last != b && last && last->b_transaction->t_state == T_FINISHED) {
+    			continue;
+    		}
     		journal_write_block(jp, b->data, 1, b->blocknr);
     	}
 
-    	jp->j_tail += t->t_log_blocks;
-    	jp->j_tail = journal_wrap(jp, jp->j_tail);
+    	mutex_lock(&jp->j_lock);
+    	{
+    		jp->j_tail += t->t_log_blocks;
+    		jp->j_tail = journal_wrap(jp, jp->j_tail);
 
-    	jp->j_tail_sequence++;
+    		jp->j_tail_sequence++;
 
-    	/**
-    	 * XXX See the comment in the header to journal_dirty_block.
-    	 * the t_outstanding_credits is a reserve space and the t_log_blocks is actually
-    	 * used space, so we should use jp->j_free += t->t_log_blocks;
-    	 */
-    	jp->j_free += t->t_outstanding_credits;
-    	//jp->j_free += t->t_log_blocks;
+    		/* Unused part of the reservation was returned on commit */
+    		jp->j_free += t->t_log_blocks;
+
+    		dlist_del(&t->t_next);
+    		jp->j_stat_checkpoints++;
+    	}
+    	mutex_unlock(&jp->j_lock);
 
-    	dlist_del(&t->t_next);
     	journal_free_trans(jp, t);
     }
 
     jp->j_fs_specific.update(jp);
 
+    mutex_unlock(&jp->j_io_lock);
+
     return 0;
 }
 
 int journal_dirty_block(journal_t *jp, journal_block_t *block) {
 	struct buffer_head *bh;
+	journal_block_t *prev = NULL;
 	int i, blkcount;
-	transaction_t *t = jp->j_running_transaction;
+	transaction_t *t;
 
-	assert(t);
 	assert(block);
+
+	mutex_lock(&jp->j_lock);
+
+	t = jp->j_running_transaction;
+	assert(t);
 	assert(t->t_nr_buffers < t->t_outstanding_credits);
 
 	/* See the comment in the header to journal_dirty_block */
@@ -188,6 +446,14 @@ int journal_dirty_block(journal_t *jp, journal_block_t *block) {
 	for (i = 0; i < blkcount; i++) {
 		bh = bcache_getblk_locked(jp->j_dev, journal_jb2db(jp, block->blocknr) + i, jp->j_disk_sectorsize);
 		{
+			/* Block is already logged by the running transaction: bitmaps,
+			 * group descriptors and the superblock are updated by almost
+			 * every operation, keep only the latest copy of them. */
+			if (i == 0 && bh->journal_block
+					&& bh->journal_block->b_transaction == t) {
+				prev = bh->journal_block;
+			}
+
 			if (buffer_new(bh)) {
 				buffer_clear_flag(bh, BH_NEW);
 			}
@@ -197,8 +463,12 @@ int journal_dirty_block(journal_t *jp, journal_block_t *block) {
 			 * that modified this block, will be checkpointed */
 			buffer_set_flag(bh, BH_JOURNAL);
 
-			bh->journal_block = block;
-			block->bh[i] = bh;
+			if (prev) {
+				assert(prev->bh[i] == bh);
+			} else {
+				bh->journal_block = block;
+				block->bh[i] = bh;
+			}
 
 			/*
 			 * TODO
@@ -212,8 +482,22 @@ int journal_dirty_block(journal_t *jp, journal_block_t *block) {
 		bcache_buffer_unlock(bh);
 	}
 
-	dlist_add_prev(&block->b_next, &t->t_buffers);
-	t->t_nr_buffers++;
+	if (prev) {
+		memcpy(prev->data, block->data, jp->j_blocksize);
+		journal_free_block(jp, block);
+	} else {
+		block->b_transaction = t;
+		dlist_add_prev(&block->b_next, &t->t_buffers);
+		t->t_nr_buffers++;
+
+		if (!jp->j_commit_armed) {
+			/* Starts the commit interval */
+			jp->j_commit_armed = 1;
+			waitq_wakeup_all(&jp->j_wait_commit);
+		}
+	}
+
+	mutex_unlock(&jp->j_lock);
 
 	return 0;
 }
@@ -234,6 +518,7 @@ journal_block_t *journal_new_block(journal_t *jp, block_t nr) {
     }
     dlist_head_init(&jb->b_next);
     jb->blocknr = nr;
+    jb->b_transaction = NULL;
 
     return jb;
 }
@@ -289,13 +574,13 @@ int journal_write_blocks_list(journal_t *jp, struct dlist_head *blocks, size_t c
 
 	/* XXX Increase speed up of below writing on hd by grouping blocks */
 	dlist_foreach_entry(b, blocks, b_next) {
-		jp->j_head = journal_wrap(jp, jp->j_head++);
 		ret = journal_write_block(jp, b->data, 1,
 				jp->j_fs_specific.bmap(jp, jp->j_head));
 		if (ret < 0) {
 			jp->j_head = j_head;
 			return ret;
 		}
+		jp->j_head = journal_wrap(jp, jp->j_head + 1);
 	}
 
 	return 0;
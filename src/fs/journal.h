@@ -11,6 +11,8 @@
 
 #include <lib/libds/dlist.h>
 #include <drivers/block_dev.h>
+#include <kernel/sched/waitq.h>
+#include <kernel/thread/sync/mutex.h>
 #include <stdint.h>
 
 typedef unsigned int block_t;
@@ -66,6 +68,7 @@ typedef struct journal_block_s {
 	struct buffer_head *bh[8]; /** Corresponding buffer_heads (up to 8) */
     block_t blocknr;	 /** Block number. */
     char *data;		 /** Pointer to in-memory data. */
+    transaction_t *b_transaction; /** Transaction owning the block. */
     struct dlist_head b_next; /** Linked list entry. */
 } journal_block_t;
 
@@ -87,7 +90,9 @@ typedef struct journal_block_s {
 typedef uint32_t (*journal_bmap_t)(journal_t *jp, block_t block);
 
 /**
- * Commit current running transaction.
+ * Writes jp->j_committing_transaction to the log. Called with j_io_lock
+ * held and without j_lock, the journal already replaced the running
+ * transaction and queues this one for checkpoint afterwards.
  *
  * @param jp    - journal
  *
@@ -194,6 +199,9 @@ struct transaction_s {
      */
     int t_outstanding_credits;
 
+    /* Credits of the handles which are still open on this transaction */
+    int t_reserved_credits;
+
     /* Reference count of handlers [j_list_lock] */
     int t_ref;
 
@@ -204,6 +212,8 @@ struct transaction_s {
     struct dlist_head t_next;
 };
 
+struct thread;
+
 /**
  * struct journal_s - The journal_s type is the concrete type
  *                    associated with journal_t.
@@ -278,9 +288,46 @@ struct journal_s {
      * Sequence number of the next transaction to grant [j_state_lock]
      */
     uint32_t j_transaction_sequence;
+
+    /*
+     * Protects all of the above. Handles take it only for a short time,
+     * nobody holds it across disk I/O.
+     */
+    struct mutex j_lock;
+
+    /*
+     * Serializes writers of the log: commit, checkpoint and the superblock
+     * update. Taken before j_lock. j_head and j_checkpoint_transactions are
+     * changed only under both locks.
+     */
+    struct mutex j_io_lock;
+
+    /* Commit thread waits here for a commit request or a timeout */
+    struct waitq j_wait_commit;
+
+    /* The running transaction has dirty buffers, the commit interval runs */
+    int j_commit_armed;
+
+    /* Handles wait here for the locked running transaction to be replaced */
+    struct waitq j_wait_transaction;
+
+    /* Commit thread, NULL if every transaction is committed in journal_stop() */
+    struct thread *j_task;
+    int j_commit_request;
+    int j_stop;
+
+    /* Statistics */
+    unsigned long j_stat_handles;
+    unsigned long j_stat_commits;
+    unsigned long j_stat_checkpoints;
 };
 
 extern journal_t *journal_create(journal_fs_specific_t *spec);
+/**
+ * Starts the commit thread. Must be called after the journal was loaded,
+ * i.e. when the running transaction and log geometry are set up.
+ */
+extern int journal_start_thread(journal_t *jp);
 extern int journal_delete(journal_t *jp);
 extern journal_handle_t * journal_start(journal_t *jp, size_t nblocks);
 extern int journal_stop(journal_handle_t *handle);
@@ -293,13 +340,15 @@ extern void journal_free_trans(journal_t *journal, transaction_t *t);
 extern int journal_checkpoint_transactions(journal_t *jp);
 
 /**
- * TODO
  * When an atomic handler starts by the call of journal_start(jp, nblocks), journal
  * reserves nblocks for the current running transaction. nblocks - is the lower upper limit
  * of blocks that an atomic handler is going to modify. Actually nblocks does'nt correspond
  * to real count of blocks that an atomic handler will modify (real one is lower).
- * Therefore we should keep track of really modified blocks to prevent themselves from
- * waste the journal space. So signature of this function should be
+ * Therefore journal_stop() shrinks the transaction's reservation to the blocks really
+ * dirtied plus the credits of handles still open, and commit returns what was not used
+ * by the log. Blocks dirtied twice by one transaction are kept in the log only once.
+ *
+ * TODO per-handle accounting needs the signature
  * int journal_dirty_block(journal_handle_t *handle, journal_block_t *block)
  */
 extern int journal_dirty_block(journal_t *jp, journal_block_t *block);
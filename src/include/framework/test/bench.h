@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @brief Microbenchmarks registered next to the tests.
+ * @details
+ *   A benchmark body runs the measured operation @c iters times:
+ *
+ *   @code
+ *   EMBOX_BENCH("mem.memcpy_64", iters) {
+ *       while (iters--)
+ *           memcpy(dst, src, 64);
+ *   }
+ *   @endcode
+ *
+ *   The runner warms the benchmark up, doubles @c iters until a call takes
+ *   long enough to be timed with the CPU cycle counter, and then takes a
+ *   number of such timed calls as samples. The result is the minimum,
+ *   median and 99th percentile of the cost of one iteration.
+ *
+ *   Setup and teardown of #EMBOX_BENCH_FIXTURE() are called once around all
+ *   the calls of the body.
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef FRAMEWORK_TEST_BENCH_H_
+#define FRAMEWORK_TEST_BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lib/libds/array.h>
+#include <util/macro.h>
+
+typedef void (*bench_run_t)(unsigned long iters);
+
+struct bench {
+	const char *name;
+	bench_run_t run;
+	int (*setup)(void);
+	int (*teardown)(void);
+};
+
+/* Per iteration costs are in hundredths of a cycle */
+struct bench_result {
+	unsigned long iters;    /* iterations in a sample */
+	int samples;
+	uint64_t hz;            /* cycle counter frequency */
+	uint64_t min;
+	uint64_t median;
+	uint64_t p99;
+};
+
+#define EMBOX_BENCH(name, iters) \
+	EMBOX_BENCH_FIXTURE(name, iters, NULL, NULL)
+
+#define EMBOX_BENCH_FIXTURE(name, iters, setup, teardown) \
+	__EMBOX_BENCH_NM(name, iters, setup, teardown, \
+			MACRO_GUARD(__bench_struct), MACRO_GUARD(__bench_run))
+
+#define __EMBOX_BENCH_NM(_name, iters, _setup, _teardown, bench_nm, run_nm) \
+	static void run_nm(unsigned long iters);                 \
+	static const struct bench bench_nm = {                   \
+		.name     = _name,                                   \
+		.run      = run_nm,                                  \
+		.setup    = _setup,                                  \
+		.teardown = _teardown,                               \
+	};                                                       \
+	ARRAY_SPREAD_ADD(__bench_registry, &bench_nm);           \
+	static void run_nm(unsigned long iters)
+
+ARRAY_SPREAD_DECLARE(const struct bench *const, __bench_registry);
+
+#define bench_foreach(bench_ptr) \
+	array_spread_foreach(bench_ptr, __bench_registry)
+
+extern const struct bench *bench_lookup(const char *name);
+
+/**
+ * Runs the benchmark, @c samples is capped by the max_samples option.
+ * @return 0 or the error returned by the setup or the teardown
+ */
+extern int bench_run(const struct bench *bench, int samples,
+		struct bench_result *res);
+
+/** Prints the result as one line of JSON */
+extern void bench_print_json(const struct bench *bench,
+		const struct bench_result *res);
+
+#endif /* FRAMEWORK_TEST_BENCH_H_ */
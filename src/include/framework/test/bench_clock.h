@@ -0,0 +1,30 @@
+/**
+ * @file
+ * @brief System clock helpers for benchmark commands.
+ * @details
+ *   For benchmark commands which time whole runs themselves.
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef FRAMEWORK_TEST_BENCH_CLOCK_H_
+#define FRAMEWORK_TEST_BENCH_CLOCK_H_
+
+#include <stdint.h>
+#include <time.h>
+
+/** Monotonic system time in nanoseconds */
+static inline uint64_t bench_time_ns(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/** Number of events per second if @c n events took @c ns */
+static inline uint64_t bench_per_sec(uint64_t n, uint64_t ns) {
+	return n * 1000000000ULL / (ns ? ns : 1);
+}
+
+#endif /* FRAMEWORK_TEST_BENCH_CLOCK_H_ */
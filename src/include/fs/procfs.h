@@ -0,0 +1,34 @@
+/**
+ * @file
+ * @brief Files in the root of procfs filled by other subsystems
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef FS_PROCFS_H_
+#define FS_PROCFS_H_
+
+#include <stddef.h>
+
+#include <lib/libds/array.h>
+
+struct procfs_file {
+	const char *name;
+	/* Prints the whole file into @c buf, returns the length as snprintf()
+	 * does, that is possibly more than @c size */
+	int (*print)(char *buf, size_t size);
+};
+
+ARRAY_SPREAD_DECLARE(const struct procfs_file, __procfs_file_registry);
+
+#define procfs_file_foreach(pf) \
+	array_spread_foreach_ptr(pf, __procfs_file_registry)
+
+/* The file shows up only if procfs is mounted */
+#define PROCFS_FILE_DEF(_name, _print)                               \
+	ARRAY_SPREAD_ADD(__procfs_file_registry, {                       \
+				.name = _name,                                       \
+				.print = _print                                      \
+			})
+
+#endif /* FS_PROCFS_H_ */
@@ -36,8 +36,14 @@ struct super_block {
 
 	struct inode           *sb_root;
 	void                   *sb_data;
+
+	unsigned int            sb_flags;
 };
 
+/* Directory content may change behind VFS back, so a failed lookup
+ * must not be remembered */
+#define SB_NO_NEGATIVE_DENTRY 0x1
+
 extern struct super_block *super_block_alloc(const char *fs_driver, const char *source);
 extern int super_block_free(struct super_block *sb);
 
@@ -90,6 +90,32 @@ typedef irq_return_t (*irq_handler_t)(unsigned int irq_nr, void *data);
 extern int irq_attach(unsigned int irq_nr, irq_handler_t handler,
 		unsigned int flags, void *data, const char *dev_name);
 
+/**
+ * Attaches a handler split into a primary part run in the interrupt
+ * context and a bottom half run by a light thread.
+ *
+ * If the primary @a handler returns #IRQ_HANDLED the IRQ is masked and
+ * @a thread_fn is run by the light thread at @a priority. The IRQ is
+ * unmasked when it returns, so the primary handler should only ack the
+ * device. While the IRQ is masked, other devices that share it are not
+ * served either.
+ *
+ * @param handler
+ *   The primary handler, if @c NULL the bottom half runs on every
+ *   interrupt.
+ * @param thread_fn
+ *   The bottom half. It runs in a light thread without a stack of its own
+ *   and must not block. Its return value is ignored.
+ * @param priority
+ *   Scheduling priority of the light thread.
+ *
+ * The other parameters and the return values are the same as for
+ * #irq_attach(). If no light thread is left, -ENOMEM is returned.
+ */
+extern int irq_attach_threaded(unsigned int irq_nr, irq_handler_t handler,
+		irq_handler_t thread_fn, unsigned int flags, int priority,
+		void *data, const char *dev_name);
+
 /**
  * Detaches ISR from the specified IRQ.
  *
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @brief Interrupt handling statistics
+ * @details
+ *    Every dispatch of an IRQ line is counted together with the cycles
+ *    it took and whether any handler claimed it. Every handler counts its
+ *    calls, the calls it returned IRQ_HANDLED from and its own cycles. A
+ *    handler also keeps a histogram of its latency, the cycles from the
+ *    entry to irq_dispatch() to the handler call, which grows with the
+ *    handlers called before it on a shared line.
+ *
+ *    With the default irq_stat implementation everything compiles out.
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef KERNEL_IRQ_STAT_H_
+#define KERNEL_IRQ_STAT_H_
+
+#include <stdint.h>
+
+#include <kernel/irq.h>
+
+/** Latency bucket @c b counts latencies below 2^(IRQ_STAT_LAT_SHIFT + b)
+ * cycles which are not counted by the previous one, the last bucket counts
+ * the rest */
+#define IRQ_STAT_LAT_SHIFT   7
+#define IRQ_STAT_LAT_BUCKETS 12
+
+#include <module/embox/kernel/irq_stat/irq_stat.h>
+
+struct irq_stat_line_info {
+	unsigned int irq_nr;
+	unsigned long count;
+	unsigned long unhandled;   /* dispatches no handler claimed */
+	uint64_t cycles_total;
+	uint64_t cycles_max;
+};
+
+struct irq_stat_handler_info {
+	unsigned int irq_nr;
+	irq_handler_t handler;
+	void *dev_id;
+	const char *dev_name;      /* as passed to irq_attach(), may be NULL */
+	unsigned long calls;
+	unsigned long handled;
+	uint64_t cycles_total;
+	uint64_t cycles_max;
+	unsigned long lat_hist[IRQ_STAT_LAT_BUCKETS];
+};
+
+/** Copy up to @c max lines dispatched at least once to @c info, returns
+ * the number of such lines */
+extern int irq_stat_lines(struct irq_stat_line_info *info, int max);
+/** Copy up to @c max attached handlers to @c info, returns the number of
+ * handlers */
+extern int irq_stat_handlers(struct irq_stat_handler_info *info, int max);
+/** Zero all counters */
+extern void irq_stat_reset(void);
+
+#endif /* KERNEL_IRQ_STAT_H_ */
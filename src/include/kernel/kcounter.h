@@ -0,0 +1,20 @@
+/**
+ * @file
+ * @brief Per-CPU event counters
+ * @details
+ *    A counter is defined once with KCOUNTER_DEF(id, "subsystem.event")
+ *    and bumped with kcounter_inc(id), which is a plain increment of the
+ *    copy of the current CPU. Readers sum up the copies. Other files which
+ *    bump the counter use KCOUNTER_DECLARE(id).
+ *
+ *    With the default kcounter implementation everything compiles out.
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef KERNEL_KCOUNTER_H_
+#define KERNEL_KCOUNTER_H_
+
+#include <module/embox/kernel/kcounter/kcounter.h>
+
+#endif /* KERNEL_KCOUNTER_H_ */
@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief Lock contention statistics
+ * @details
+ *    Locks are grouped into classes by the place they are defined at: the
+ *    static initializer or the call which initialized the lock at run
+ *    time. A class counts acquisitions, acquisitions which had to wait
+ *    and the time spent waiting for and holding its locks. The outermost
+ *    sched_lock() sections are accounted as classes of their call sites.
+ *
+ *    With the default lockstat implementation everything compiles out
+ *    and the locks keep their size.
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef KERNEL_LOCKSTAT_H_
+#define KERNEL_LOCKSTAT_H_
+
+#include <stdint.h>
+
+#define LOCKSTAT_SPIN   0
+#define LOCKSTAT_MUTEX  1
+#define LOCKSTAT_RWLOCK 2
+#define LOCKSTAT_SCHED  3
+
+#include <module/embox/kernel/lockstat/lockstat.h>
+
+struct lockstat_class_info {
+	const char *site;   /* NULL if the class is not named by its site */
+	void *pc;           /* init call return address, if not NULL */
+	const void *lock;   /* the lock itself, if neither is known */
+	int type;
+	unsigned long acquired;
+	unsigned long contended;
+	uint64_t wait_total;
+	uint64_t wait_max;
+	uint64_t hold_total;
+	uint64_t hold_max;
+};
+
+/** Start or stop collecting statistics */
+extern void lockstat_enable(int enable);
+/** Forget all classes */
+extern void lockstat_reset(void);
+/** Copy up to @c max classes to @c info, returns the number of classes */
+extern int lockstat_classes(struct lockstat_class_info *info, int max);
+/** Acquisitions not accounted because the class table was full */
+extern unsigned long lockstat_dropped(void);
+
+#endif /* KERNEL_LOCKSTAT_H_ */
@@ -17,6 +17,7 @@
 #define panic(...)                              \
 	do {                                        \
 		ipl_disable();                          \
+		printk_flush();                         \
 		printk(__VA_ARGS__);                    \
 		whereami();                             \
 		platform_shutdown(SHUTDOWN_MODE_ABORT); \
@@ -15,4 +15,13 @@
 extern int printk(const char *format, ...) _PRINTF_FORMAT(1, 2);
 extern int vprintk(const char *format, va_list args) _PRINTF_FORMAT(1, 0);
 
+/**
+ * Put out everything printk() has deferred and make further calls write
+ * synchronously. Called on panic with interrupts disabled.
+ */
+extern void printk_flush(void);
+
+/** Number of messages lost because the deferred printk buffer was full */
+extern unsigned long printk_dropped(void);
+
 #endif /* KERNEL_PRINTK_H_ */
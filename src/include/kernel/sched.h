@@ -73,6 +73,7 @@ struct schedee {
 	unsigned int active;  /**< Running on a CPU. TODO SMP-only. */
 	unsigned int ready;   /**< Managed by the scheduler. */
 	unsigned int waiting; /**< Waiting for an event. */
+	unsigned int last_cpu; /**< CPU it was switched to the last time. */
 
 	struct affinity         affinity;
 	struct sched_timing     sched_timing;
@@ -12,6 +12,14 @@
 #define KERNEL_SCHED_SCHED_LOCK_H_
 
 #include <kernel/critical.h>
+#include <kernel/lockstat.h>
+#include <util/macro.h>
+
+/* @a site names the section in the lock statistics */
+static inline void __sched_lock(const char *site) {
+	critical_enter(CRITICAL_SCHED_LOCK);
+	lockstat_sched_locked(site);
+}
 
 /**
  * Locks the scheduler which means disabling thread switch until
@@ -20,9 +28,8 @@
  *
  * @see sched_unlock()
  */
-static inline void sched_lock(void) {
-	critical_enter(CRITICAL_SCHED_LOCK);
-}
+#define sched_lock() \
+	__sched_lock(__FILE__ ":" MACRO_STRING(__LINE__))
 
 /**
  * Unlocks the scheduler after #sched_lock(). Must be called on the
@@ -32,6 +39,7 @@ static inline void sched_lock(void) {
  * @see sched_lock()
  */
 static inline void sched_unlock(void) {
+	lockstat_sched_unlocking();
 	critical_leave(CRITICAL_SCHED_LOCK);
 	critical_dispatch_pending();
 }
@@ -43,6 +51,7 @@ static inline void sched_unlock(void) {
  * @note This function is not intended for wide usage.
  */
 static inline void sched_unlock_noswitch(void) {
+	lockstat_sched_unlocking();
 	critical_leave(CRITICAL_SCHED_LOCK);
 }
 
@@ -0,0 +1,16 @@
+/**
+ * @file
+ * @brief Trace points of the scheduler and of the sleeping locks
+ * @details
+ *    With the sched_trace module implemented by tracebuf every trace point
+ *    records an event to the trace buffer. By default they are empty.
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef KERNEL_SCHED_SCHED_TRACE_H_
+#define KERNEL_SCHED_SCHED_TRACE_H_
+
+#include <module/embox/kernel/sched/trace/sched_trace.h>
+
+#endif /* KERNEL_SCHED_SCHED_TRACE_H_ */
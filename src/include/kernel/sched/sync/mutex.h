@@ -9,6 +9,7 @@
 #ifndef KERNEL_SCHEDEE_SYNC_MUTEX_H_
 #define KERNEL_SCHEDEE_SYNC_MUTEX_H_
 
+#include <kernel/lockstat.h>
 #include <kernel/sched/sync/mutexattr.h>
 #include <kernel/sched/waitq.h>
 
@@ -23,6 +24,7 @@ struct mutex {
 	struct mutexattr attr;
 
 	int lock_count;
+	__LOCKSTAT_FIELD(ls)
 };
 
 /**
@@ -19,6 +19,8 @@
 #include <hal/cpu.h>
 #include <hal/ipl.h>
 #include <kernel/critical.h>
+#include <kernel/kcounter.h>
+#include <kernel/lockstat.h>
 #include <module/embox/arch/libarch.h>
 
 #include <util/lang.h>
@@ -39,25 +41,34 @@
 # define __SPIN_CONTENTION_FIELD_INIT
 #endif /* SPIN_CONTENTION_LIMIT */
 
+KCOUNTER_DECLARE(spin_contended);
+
 typedef struct {
 	unsigned long l;
 	unsigned int owner;
 	__SPIN_CONTENTION_FIELD
+	__LOCKSTAT_FIELD(ls)
 } spinlock_t;
 
 /* XXX use 'field : value' instead of '.field = value' syntax because g++ does not support
  * the second one, but supports the first one in the trivial order --Alexander */
 #define SPIN_INIT(state) \
-  { l : state, owner : -1u, __SPIN_CONTENTION_FIELD_INIT }
+  { l : state, owner : -1u, __SPIN_CONTENTION_FIELD_INIT \
+	__LOCKSTAT_FIELD_INIT(ls) }
 
-static inline void spin_init(spinlock_t *lock, unsigned int state) {
+static inline void __spin_init(spinlock_t *lock, unsigned int state,
+		const char *site) {
 	lock->l = state;
 #ifdef SPIN_CONTENTION_LIMIT
 	lock->contention_count = SPIN_CONTENTION_LIMIT;
 #endif
 	lock->owner = -1u;
+	lockstat_init(&lock->ls, site, NULL);
 }
 
+#define spin_init(lock, state) \
+	__spin_init(lock, state, __FILE__ ":" MACRO_STRING(__LINE__))
+
 #define SPIN_STATIC_UNLOCKED SPIN_INIT(__SPIN_UNLOCKED)
 #define SPIN_STATIC_LOCKED   SPIN_INIT(__SPIN_LOCKED)
 
@@ -99,9 +110,13 @@ static inline int __spin_trylock(spinlock_t *lock) {
 		lock->owner = cpu_id;
 	}
 #ifdef SPIN_CONTENTION_LIMIT
-	if (ret)
+	if (ret) {
+		if (lock->contention_count != SPIN_CONTENTION_LIMIT) {
+			/* Somebody failed to take it since it was taken last time */
+			kcounter_inc(spin_contended);
+		}
 		lock->contention_count = SPIN_CONTENTION_LIMIT;
-	else {
+	} else {
 		// TODO this must be atomic dec
 		lock->contention_count--;
 		assertf(lock->contention_count, "Possible spin deadlock");
@@ -138,6 +153,21 @@ static inline void __spin_preempt_enable(void) {
 	critical_dispatch_pending();
 }
 
+static inline int __spin_trylock_preempt(spinlock_t *lock) {
+	int ret;
+	__spin_preempt_disable();
+	ret = __spin_trylock(lock);
+	if (!ret)
+		__spin_preempt_enable();
+	return ret;
+}
+
+/* @a t0 is when the first try failed or 0 if it did not */
+static inline void __spin_lockstat_acquired(spinlock_t *lock, uint64_t t0) {
+	lockstat_contended(&lock->ls, lock, LOCKSTAT_SPIN, t0);
+	lockstat_acquired(&lock->ls, lock, LOCKSTAT_SPIN);
+}
+
 /**
  * spin_trylock -- try to lock object without waiting
  * @param lock  object to lock
@@ -145,10 +175,9 @@ static inline void __spin_preempt_enable(void) {
  */
 static inline int spin_trylock(spinlock_t *lock) {
 	int ret;
-	__spin_preempt_disable();
-	ret = __spin_trylock(lock);
-	if (!ret)
-		__spin_preempt_enable();
+	ret = __spin_trylock_preempt(lock);
+	if (ret)
+		__spin_lockstat_acquired(lock, 0);
 	return ret;
 }
 
@@ -157,8 +186,13 @@ static inline int spin_trylock(spinlock_t *lock) {
  * @param lock  object to lock
  */
 static inline void spin_lock(spinlock_t *lock) {
-	while (!spin_trylock(lock))
-		;
+	uint64_t t0 = 0;
+
+	while (!__spin_trylock_preempt(lock)) {
+		if (!t0)
+			t0 = lockstat_now();
+	}
+	__spin_lockstat_acquired(lock, t0);
 }
 
 /**
@@ -166,24 +200,30 @@ static inline void spin_lock(spinlock_t *lock) {
  * @param lock  object to unlock
  */
 static inline void spin_unlock(spinlock_t *lock) {
+	lockstat_released(&lock->ls, lock, LOCKSTAT_SPIN);
 	__spin_unlock(lock);
 	__spin_preempt_enable();
 }
 
 static inline ipl_t spin_lock_ipl(spinlock_t *lock) {
 	ipl_t ipl = 0;
+	uint64_t t0 = 0;
 
 	while (1) {
 		ipl = ipl_save();
-		if (spin_trylock(lock))
+		if (__spin_trylock_preempt(lock))
 			break;
 		ipl_restore(ipl);
+		if (!t0)
+			t0 = lockstat_now();
 	}
+	__spin_lockstat_acquired(lock, t0);
 
 	return ipl;
 }
 
 static inline void spin_unlock_ipl(spinlock_t *lock, ipl_t ipl) {
+	lockstat_released(&lock->ls, lock, LOCKSTAT_SPIN);
 	__spin_unlock(lock);
 	ipl_restore(ipl);  /* implies optimization barrier */
 	__spin_preempt_enable();
@@ -191,16 +231,21 @@ static inline void spin_unlock_ipl(spinlock_t *lock, ipl_t ipl) {
 
 static inline void spin_lock_ipl_disable(spinlock_t *lock) {
 	ipl_t ipl = 0;
+	uint64_t t0 = 0;
 
 	while (1) {
 		ipl = ipl_save();
-		if (spin_trylock(lock))
+		if (__spin_trylock_preempt(lock))
 			break;
 		ipl_restore(ipl);
+		if (!t0)
+			t0 = lockstat_now();
 	}
+	__spin_lockstat_acquired(lock, t0);
 }
 
 static inline void spin_unlock_ipl_enable(spinlock_t *lock) {
+	lockstat_released(&lock->ls, lock, LOCKSTAT_SPIN);
 	__spin_unlock(lock);
 	ipl_enable();  /* implies optimization barrier */
 	__spin_preempt_enable();
@@ -35,7 +35,8 @@ struct timespec;
 		{ /*mutexattr init */                          \
 			/* type */ MUTEX_DEFAULT,                  \
 		},                                             \
-		/* lock_count */ 0                             \
+		/* lock_count */ 0,                            \
+		__LOCKSTAT_FIELD_INIT(ls)                      \
 	}
 
 #define RMUTEX_INIT_STATIC \
@@ -52,10 +53,12 @@ struct timespec;
 		{ /*mutexattr init */ \
 			/* type */ MUTEX_RECURSIVE, \
 			}, \
-		/* lock_couunt */ 0 \
+		/* lock_couunt */ 0, \
+		__LOCKSTAT_FIELD_INIT(ls) \
 	}
 
-#define MUTEX_INIT(m)  {.wq=WAITQ_INIT(m.wq), .holder=NULL, .lock_count=0}
+#define MUTEX_INIT(m)  {.wq=WAITQ_INIT(m.wq), .holder=NULL, .lock_count=0, \
+	__LOCKSTAT_FIELD_INIT(ls) }
 
 __BEGIN_DECLS
 
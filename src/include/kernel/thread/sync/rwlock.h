@@ -9,12 +9,14 @@
 #ifndef KERNEL_THREAD_SYNC_RWLOCK_H_
 #define KERNEL_THREAD_SYNC_RWLOCK_H_
 
+#include <kernel/lockstat.h>
 #include <kernel/sched/waitq.h>
 
 struct rwlock {
 	struct waitq wq;
 	int status;
 	int count;
+	__LOCKSTAT_FIELD(ls)
 };
 
 typedef struct rwlock rwlock_t;
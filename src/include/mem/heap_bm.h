@@ -14,6 +14,10 @@
 extern void bm_init(void *heap, size_t size);
 extern void *bm_memalign(void *heap, size_t boundary, size_t size);
 extern void bm_free(void *heap, void *ptr);
+extern size_t bm_block_size(void *ptr);
 extern int bm_heap_is_empty(void *heap);
+/* Add free bytes of @c heap to @c free_bytes,
+ * raise @c largest to its largest free block */
+extern void bm_free_stats(void *heap, size_t *free_bytes, size_t *largest);
 
 #endif /* MEM_HEAP_BM_H_ */
@@ -0,0 +1,43 @@
+/**
+ * @file
+ * @brief Two-Level Segregated Fit memory allocation algorithm
+ *
+ * @details All operations are O(1) and take no locks: the caller
+ *    serializes access to a heap.
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef MEM_HEAP_TLSF_H_
+#define MEM_HEAP_TLSF_H_
+
+#include <sys/types.h>
+
+/** Alignment of every returned block and of every pool */
+#define TLSF_ALIGN 8
+
+/** Size of the heap control structure placed at the start of a heap */
+extern size_t tlsf_control_size(void);
+/** Bytes a fresh pool needs to satisfy tlsf_memalign(boundary, size) */
+extern size_t tlsf_pool_size(size_t boundary, size_t size);
+
+/** Place heap control at @c heap and make the rest of @c size a pool */
+extern void tlsf_init(void *heap, size_t size);
+extern void tlsf_add_pool(void *heap, void *mem, size_t size);
+/** Pool at @c mem has no allocated blocks */
+extern int tlsf_pool_is_free(void *mem);
+/** Forget a pool which has no allocated blocks */
+extern void tlsf_remove_pool(void *heap, void *mem);
+
+extern void *tlsf_memalign(void *heap, size_t boundary, size_t size);
+extern void tlsf_free(void *heap, void *ptr);
+/** Resize in place if possible, otherwise move. NULL if out of memory,
+ * in which case @c ptr is left untouched */
+extern void *tlsf_realloc(void *heap, void *ptr, size_t size);
+extern size_t tlsf_block_size(void *ptr);
+extern int tlsf_heap_is_empty(void *heap);
+/** Add free bytes of @c heap to @c free_bytes, raise @c largest to its largest
+ * free block */
+extern void tlsf_free_stats(void *heap, size_t *free_bytes, size_t *largest);
+
+#endif /* MEM_HEAP_TLSF_H_ */
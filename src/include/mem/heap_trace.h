@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief Heap allocation tracing with call site attribution
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef MEM_HEAP_TRACE_H_
+#define MEM_HEAP_TRACE_H_
+
+#include <stddef.h>
+#include <time.h>
+
+/** Number of return addresses kept for a call site */
+#define HEAP_TRACE_DEPTH 4
+
+/** Called by malloc() and friends. @c caller is the return address into
+ * the code which called the allocator */
+extern void heap_trace_alloc(void *ptr, size_t size, void *caller);
+extern void heap_trace_free(void *ptr);
+
+struct heap_trace_site {
+	void *pc[HEAP_TRACE_DEPTH];  /* innermost first, NULL terminated */
+	unsigned long allocs;        /* allocations sampled at the site */
+	unsigned long frees;
+	unsigned long long alloc_bytes;
+	size_t live_bytes;           /* requested bytes still allocated */
+	size_t live_slack;           /* usable minus requested bytes of them */
+	unsigned int live_blocks;
+	clock_t oldest;              /* ticks when the oldest live block was
+	                                allocated */
+};
+
+struct heap_trace_stats {
+	int enabled;
+	unsigned int sample_period;  /* one of so many allocations is traced */
+	unsigned int sites;
+	unsigned int live_blocks;
+	unsigned long dropped;       /* sampled allocations not traced because
+	                                the tables were full */
+};
+
+extern void heap_trace_enable(int enable);
+extern void heap_trace_set_period(unsigned int period);
+/** Forget all traced blocks and sites */
+extern void heap_trace_reset(void);
+extern void heap_trace_stats(struct heap_trace_stats *st);
+/** Copy up to @c max sites to @c sites, returns the number of sites */
+extern int heap_trace_sites(struct heap_trace_site *sites, int max);
+
+#endif /* MEM_HEAP_TRACE_H_ */
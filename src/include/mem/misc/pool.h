@@ -11,6 +11,7 @@
 #define MEM_MISC_UTIL_POOL_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <lib/libds/bitmap.h>
 #include <lib/libds/slist.h>
@@ -35,6 +36,12 @@ struct pool {
 #ifdef POOL_DEBUG
 	BITMAP_DECL(blocks, POOL_MAX_OBJECTS);
 #endif
+#ifdef POOL_LOCKFREE
+	/* Top of the stack of free blocks used instead of free_blocks:
+	 * index of the block in the low half, generation tag in the high one.
+	 * Double word on 32-bit targets, so the tag does not wrap too soon */
+	uint64_t free_top;
+#endif
 };
 
 #ifdef POOL_DEBUG
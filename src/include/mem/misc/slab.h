@@ -95,4 +95,50 @@ static inline void cache_growing_off(cache_t *cache) {
 	cache->growing = false;
 }
 
+/** Statistics of a cache, see cache_stats_get() */
+struct cache_stats {
+	char name[__CACHE_NAMELEN];
+	size_t obj_size;
+	/** objects per slab */
+	unsigned int num;
+	unsigned int slab_order;
+	unsigned int slabs;
+	/** objects in slabs which are handed out or held in magazines */
+	unsigned int objs_inuse;
+	/** objects held in magazines */
+	unsigned int objs_cached;
+	unsigned long allocs;
+	unsigned long frees;
+	/** allocations and frees served by magazines */
+	unsigned long hits;
+	unsigned long alloc_failed;
+};
+
+/**
+ * Fill statistics of all caches
+ * @param stats is array of @a max entries
+ * @return number of caches, it can be greater than @a max
+ */
+extern int cache_stats_get(struct cache_stats *stats, int max);
+
+/**
+ * Print a table of all caches into @a buf, also shown as /proc/slabinfo.
+ *
+ * @return the length of the whole table as snprintf() does
+ */
+extern int cache_stats_print(char *buf, size_t size);
+
+/**
+ * Allocate @a size bytes from the power of two sized generic caches,
+ * or directly from pages if @a size is above the largest one.
+ * It is safe to call with interrupts disabled.
+ */
+extern void *kmem_alloc(size_t size);
+
+/** Same as kmem_alloc() but zero the memory */
+extern void *kmem_zalloc(size_t size);
+
+/** Free memory allocated by kmem_alloc() or kmem_zalloc() */
+extern void kmem_free(void *ptr);
+
 #endif /* MEM_MISC_SLAB_H_ */
@@ -17,6 +17,12 @@
 
 #include <module/embox/mem/page_api.h>
 
+/* Implementations may keep their own state in the allocator */
+#ifndef PAGE_ALLOCATOR_PRIVATE
+#define PAGE_ALLOCATOR_PRIVATE
+#define PAGE_ALLOCATOR_PRIVATE_INIT
+#endif
+
 struct page_allocator {
 	void *pages_start;
 	unsigned int pages_n;
@@ -26,6 +32,8 @@ struct page_allocator {
 
 	size_t bitmap_len;
 	unsigned long *bitmap;
+
+	PAGE_ALLOCATOR_PRIVATE
 };
 
 extern struct page_allocator *page_allocator_init(char *start, size_t len, size_t page_size);
@@ -46,7 +54,8 @@ extern int page_belong(struct page_allocator *allocator, void *page);
 			page_size, \
 			page_size * page_number, \
 			(sizeof(unsigned long) * page_number/32), \
-			ctrl_space_##name \
+			ctrl_space_##name, \
+			PAGE_ALLOCATOR_PRIVATE_INIT \
 	}
 
 #endif /* MEM_PAGE_H_ */
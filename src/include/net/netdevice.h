@@ -32,6 +32,9 @@ struct sk_buff;
 /** Largest hardware address length */
 #define MAX_ADDR_LEN   16
 
+/* Features of net device */
+#define NETIF_F_SG     0x1 /* Transmits sk_buff fragments itself */
+
 /**
  * Network device statistics structure.
  */
@@ -117,6 +120,7 @@ typedef struct net_device {
 	unsigned char hdr_len;                 /**< hardware header length      */
 	unsigned char addr_len;                /**< hardware address length      */
 	unsigned int flags;                    /**< interface flags (a la BSD)   */
+	unsigned int features;                 /**< NETIF_F_* set by the driver  */
 	unsigned int mtu;                      /**< interface MTU value          */
 	uintptr_t base_addr;                   /**< device I/O address           */
 	unsigned int irq;                      /**< device IRQ number            */
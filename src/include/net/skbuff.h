@@ -29,6 +29,27 @@ struct arphdr;
 struct ethhdr;
 struct iovec;
 
+/* Maximal number of fragments of a sk_buff */
+#define SKB_FRAGS_MAX 8
+
+/**
+ * Data of a packet kept out of the sk_buff data, e.g. in a user buffer or
+ * in a page fragment. Fragments follow the linear data on the wire.
+ */
+struct sk_buff_frag {
+	void *data;
+	size_t len;
+	void (*release)(void *data); /* Called when the last sk_buff using the
+	                                fragment is freed, may be NULL */
+};
+
+struct sk_buff_frags {
+	int links;                   /* sk_buffs sharing the list */
+	int nr;
+	size_t len;                  /* bytes in all fragments */
+	struct sk_buff_frag frag[SKB_FRAGS_MAX];
+};
+
 typedef struct sk_buff_head {
 	struct sk_buff *next;       /* Next buffer in list */
 	struct sk_buff *prev;       /* Previous buffer in list */
@@ -79,6 +100,10 @@ typedef struct sk_buff {        /* Socket buffer */
 		 */
 	struct sk_buff_data *data;
 
+		/* Fragments following the data, NULL if the skb is linear.
+		 * They are not counted in len */
+	struct sk_buff_frags *frags;
+
 		/* After processing by (incoming) stack packet is used by
 		 * socket structures. Socket (== User) may consume only a part
 		 * of data. Taken data ends with p_data
@@ -107,6 +132,10 @@ extern struct sk_buff_data * skb_data_clone(struct sk_buff_data *skb_data);
 extern int skb_data_cloned(const struct sk_buff_data *skb_data);
 extern void skb_data_free(struct sk_buff_data *skb_data);
 extern void *skb_get_data_pointner(struct sk_buff_data *skb_data);
+/**
+ * Usable size of @a skb_data, at least the size it was allocated with
+ */
+extern size_t skb_data_size(const struct sk_buff_data *skb_data);
 
 extern struct sk_buff_extra * skb_extra_alloc(void);
 extern void skb_extra_free(struct sk_buff_extra *skb_extra);
@@ -159,6 +188,40 @@ extern struct sk_buff * skb_clone(const struct sk_buff *skb);
  */
 extern struct sk_buff * skb_declone(struct sk_buff *skb);
 
+/**
+ * Append @a len bytes at @a data to @a skb as a fragment without copying
+ *
+ * @param release called with @a data when it is not used anymore, may be NULL
+ *
+ * @return 0 on success, -ENOMEM or -ENOSPC if the fragment was not added
+ * and @a data still belongs to the caller
+ */
+extern int skb_add_frag(struct sk_buff *skb, void *data, size_t len,
+		void (*release)(void *data));
+
+/**
+ * Bytes of @a skb in fragments
+ */
+static inline size_t skb_frags_len(const struct sk_buff *skb) {
+	return skb->frags ? skb->frags->len : 0;
+}
+
+/**
+ * Copy fragments to the data of @a skb, reallocating it if needed
+ *
+ * @return 0 on success, -ENOMEM if @a skb is left untouched
+ */
+extern int skb_linearize(struct sk_buff *skb);
+
+/**
+ * Allocate @a size bytes in a shared page, the page is freed when all its
+ * fragments are freed. Intended as fragment data, skb_page_frag_free() is
+ * the release function.
+ */
+extern void *skb_page_frag_alloc(size_t size);
+extern void skb_page_frag_get(void *data);
+extern void skb_page_frag_free(void *data);
+
 /**
  * Write buffer from iovec
  *
@@ -20,22 +20,40 @@
 #include <errno.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <lib/libds/dlist.h>
+#include <util/member.h>
 
 #include <kernel/irq.h>
 #include <kernel/irq_lock.h>
 #include <kernel/irq_stack.h>
+#include <kernel/irq_stat.h>
 #include <kernel/critical.h>
+#include <kernel/lthread/lthread.h>
+#include <kernel/sched/schedee_priority.h>
+#include <kernel/sched/sched_trace.h>
 #include <drivers/irqctrl.h>
 #include <hal/ipl.h>
 #include <mem/objalloc.h>
 
 
+/* The bottom half of a threaded handler */
+struct irq_thread {
+	struct lthread lt;
+	irq_handler_t thread_fn;
+	unsigned int irq_nr;
+	void *dev_id;
+	int pending;   /* woken up and not yet completed */
+	int rerun;     /* woken up again while pending */
+};
+
 struct irq_entry {
 	irq_handler_t handler;
 	void *dev_id;
+	struct irq_thread *thread;  /* NULL if not threaded */
 	struct dlist_head action_link;
+	__IRQ_STAT_FIELD(stat)
 };
 
 struct irq_action {
@@ -58,11 +76,17 @@ struct irq_action {
 
 OBJALLOC_DEF(irq_actions, struct irq_action, IRQ_ACTION_N);
 OBJALLOC_DEF(irq_entries, struct irq_entry, IRQ_ENTRY_N);
+OBJALLOC_DEF(irq_threads, struct irq_thread, OPTION_GET(NUMBER, thread_n));
 
 static struct irq_action *irq_table[IRQ_NRS_TOTAL];
 
-int irq_attach(unsigned int irq_nr, irq_handler_t handler, unsigned int flags,
-		void *dev_id, const char *dev_name) {
+/* Threaded handlers woken up and not yet completed, the line is masked
+ * while there are any */
+static unsigned int irq_thread_pending[IRQ_NRS_TOTAL];
+
+static int irq_attach_entry(unsigned int irq_nr, irq_handler_t handler,
+		unsigned int flags, void *dev_id, const char *dev_name,
+		struct irq_thread *thread) {
 	struct irq_action *action;
 	int ret = ENOERR;
 
@@ -99,6 +123,8 @@ int irq_attach(unsigned int irq_nr, irq_handler_t handler, unsigned int flags,
 	action->entry->handler = handler;
 	action->sharing_supported = (flags & IF_SHARESUP) ? 1 : 0;
 	action->entry->dev_id = dev_id;
+	action->entry->thread = thread;
+	irq_stat_attach(&action->entry->stat, irq_nr, handler, dev_id, dev_name);
 
 	if (irq_table[irq_nr]) {
 		/* Add new device to list */
@@ -117,9 +143,97 @@ int irq_attach(unsigned int irq_nr, irq_handler_t handler, unsigned int flags,
 	return ret;
 }
 
+int irq_attach(unsigned int irq_nr, irq_handler_t handler, unsigned int flags,
+		void *dev_id, const char *dev_name) {
+	return irq_attach_entry(irq_nr, handler, flags, dev_id, dev_name, NULL);
+}
+
+static irq_return_t irq_thread_wake_always(unsigned int irq_nr, void *dev_id) {
+	return IRQ_HANDLED;
+}
+
+static int irq_thread_run(struct lthread *self) {
+	struct irq_thread *thread;
+	unsigned int irq_nr;
+
+	thread = member_cast_out(self, struct irq_thread, lt);
+	irq_nr = thread->irq_nr;
+
+	irq_lock();
+	do {
+		thread->rerun = 0;
+		irq_unlock();
+
+		thread->thread_fn(irq_nr, thread->dev_id);
+
+		irq_lock();
+	} while (thread->rerun);
+
+	thread->pending = 0;
+	if (!--irq_thread_pending[irq_nr] && irq_table[irq_nr]) {
+		irqctrl_enable(irq_nr);
+	}
+	irq_unlock();
+
+	return 0;
+}
+
+/* Called from irq_dispatch() with interrupts disabled */
+static void irq_thread_wake(unsigned int irq_nr, struct irq_thread *thread) {
+	if (thread->pending) {
+		/* Latched before the line was masked. Launching again is a no-op
+		 * if the thread is scheduled, so ask it to run once more */
+		thread->rerun = 1;
+		return;
+	}
+
+	thread->pending = 1;
+	if (!irq_thread_pending[irq_nr]++) {
+		irqctrl_disable(irq_nr);
+	}
+	lthread_launch(&thread->lt);
+}
+
+int irq_attach_threaded(unsigned int irq_nr, irq_handler_t handler,
+		irq_handler_t thread_fn, unsigned int flags, int priority,
+		void *dev_id, const char *dev_name) {
+	struct irq_thread *thread;
+	int ret;
+
+	if (!irq_nr_valid(irq_nr) || !thread_fn) {
+		return -EINVAL;
+	}
+
+	irq_lock();
+	thread = objalloc(&irq_threads);
+	irq_unlock();
+	if (!thread) {
+		return -ENOMEM;
+	}
+
+	lthread_init(&thread->lt, irq_thread_run);
+	schedee_priority_set(&thread->lt.schedee, priority);
+	thread->thread_fn = thread_fn;
+	thread->irq_nr = irq_nr;
+	thread->dev_id = dev_id;
+	thread->pending = 0;
+	thread->rerun = 0;
+
+	ret = irq_attach_entry(irq_nr, handler ? handler : irq_thread_wake_always,
+			flags, dev_id, dev_name, thread);
+	if (ret) {
+		irq_lock();
+		objfree(&irq_threads, thread);
+		irq_unlock();
+	}
+
+	return ret;
+}
+
 int irq_detach(unsigned int irq_nr, void *dev_id) {
 	struct irq_action *action;
 	struct irq_entry *entry;
+	struct irq_thread *thread = NULL;
 	int ret = ENOERR;
 
 	if (!irq_nr_valid(irq_nr)) {
@@ -137,6 +251,8 @@ int irq_detach(unsigned int irq_nr, void *dev_id) {
 	dlist_foreach_entry(entry, &(irq_table[irq_nr]->entry_list), action_link) {
 		if (entry->dev_id == dev_id) {
 			dlist_del(&(entry->action_link));
+			irq_stat_detach(&entry->stat);
+			thread = entry->thread;
 			objfree(&irq_entries, entry);
 
 			if (dlist_empty(&(irq_table[irq_nr]->entry_list))) {
@@ -149,6 +265,16 @@ int irq_detach(unsigned int irq_nr, void *dev_id) {
 	}
 
 	out_unlock: irq_unlock();
+
+	if (thread) {
+		/* Let a woken up bottom half complete and unmask the line */
+		lthread_join(&thread->lt);
+
+		irq_lock();
+		objfree(&irq_threads, thread);
+		irq_unlock();
+	}
+
 	return ret;
 }
 
@@ -156,6 +282,9 @@ void irq_dispatch(unsigned int irq_nr) {
 	struct irq_entry *entry = NULL;
 	irq_handler_t handler = NULL;
 	void *dev_id = NULL;
+	irq_return_t ret;
+	int handled = 0;
+	uint64_t t_entry, t_start;
 	ipl_t ipl;
 
 	assert(irq_nr_valid(irq_nr));
@@ -163,6 +292,10 @@ void irq_dispatch(unsigned int irq_nr) {
 	assertf(irq_stack_protection() == 0,
 			"Stack overflow detected on irq dispatch");
 
+	t_entry = irq_stat_now();
+
+	sched_trace_irq_enter(irq_nr);
+
 	if (irq_table[irq_nr]) {
 		ipl = ipl_save();
 		dlist_foreach_entry(entry, &(irq_table[irq_nr]->entry_list),
@@ -175,9 +308,20 @@ void irq_dispatch(unsigned int irq_nr) {
 			dev_id = entry->dev_id;
 
 			ipl_restore(ipl);
-			handler(irq_nr, dev_id);
+			t_start = irq_stat_now();
+			ret = handler(irq_nr, dev_id);
 			ipl = ipl_save();
+
+			irq_stat_handler(&entry->stat, ret, t_entry, t_start);
+			if (ret == IRQ_HANDLED && entry->thread) {
+				irq_thread_wake(irq_nr, entry->thread);
+			}
+			handled |= (ret == IRQ_HANDLED);
 		}
 		ipl_restore(ipl);
 	}
+
+	irq_stat_dispatch(irq_nr, handled, t_entry);
+
+	sched_trace_irq_exit(irq_nr);
 }
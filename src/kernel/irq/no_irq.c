@@ -12,6 +12,12 @@ int irq_attach(unsigned int irq_nr, irq_handler_t handler,
 	return 0;
 }
 
+int irq_attach_threaded(unsigned int irq_nr, irq_handler_t handler,
+		irq_handler_t thread_fn, unsigned int flags, int priority,
+		void *data, const char *dev_name) {
+	return 0;
+}
+
 int irq_detach(unsigned int irq_nr, void *data) {
 	return 0;
 }
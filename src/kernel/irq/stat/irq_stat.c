@@ -0,0 +1,237 @@
+/**
+ * @file
+ * @brief Interrupt handling statistics
+ * @details
+ *    Counters are updated by irq_dispatch() without a lock: a line is not
+ *    dispatched again before its handlers return, and a rare lost update
+ *    from a nested interrupt is fine for statistics. Readers and the
+ *    handler list take irq_lock().
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <fs/procfs.h>
+#include <kernel/irq.h>
+#include <kernel/irq_lock.h>
+#include <kernel/irq_stat.h>
+#include <lib/libcpu_info.h>
+#include <lib/libds/dlist.h>
+
+struct irq_stat_line {
+	unsigned long count;
+	unsigned long unhandled;
+	uint64_t cycles_total;
+	uint64_t cycles_max;
+};
+
+static struct irq_stat_line irq_stat_lines_tab[IRQ_NRS_TOTAL];
+static DLIST_DEFINE(irq_stat_handler_list);
+
+static inline int lat_bucket(uint64_t lat) {
+	int b = 0;
+
+	while (b < IRQ_STAT_LAT_BUCKETS - 1
+			&& lat >= ((uint64_t) 1 << (IRQ_STAT_LAT_SHIFT + b))) {
+		b++;
+	}
+
+	return b;
+}
+
+uint64_t __irq_stat_now(void) {
+	return get_cpu_counter();
+}
+
+void __irq_stat_attach(struct irq_stat_handler *st, unsigned int irq_nr,
+		irq_handler_t handler, void *dev_id, const char *dev_name) {
+	memset(st, 0, sizeof(*st));
+	st->irq_nr = irq_nr;
+	st->handler = handler;
+	st->dev_id = dev_id;
+	st->dev_name = dev_name;
+
+	dlist_add_prev(dlist_head_init(&st->link), &irq_stat_handler_list);
+}
+
+void __irq_stat_detach(struct irq_stat_handler *st) {
+	dlist_del(&st->link);
+}
+
+void __irq_stat_handler(struct irq_stat_handler *st, irq_return_t ret,
+		uint64_t t_entry, uint64_t t_start) {
+	uint64_t cycles;
+
+	cycles = get_cpu_counter() - t_start;
+
+	st->calls++;
+	if (ret == IRQ_HANDLED) {
+		st->handled++;
+	}
+	st->cycles_total += cycles;
+	if (cycles > st->cycles_max) {
+		st->cycles_max = cycles;
+	}
+	st->lat_hist[lat_bucket(t_start - t_entry)]++;
+}
+
+void __irq_stat_dispatch(unsigned int irq_nr, int handled, uint64_t t_entry) {
+	struct irq_stat_line *line = &irq_stat_lines_tab[irq_nr];
+	uint64_t cycles;
+
+	cycles = get_cpu_counter() - t_entry;
+
+	line->count++;
+	if (!handled) {
+		line->unhandled++;
+	}
+	line->cycles_total += cycles;
+	if (cycles > line->cycles_max) {
+		line->cycles_max = cycles;
+	}
+}
+
+int irq_stat_lines(struct irq_stat_line_info *info, int max) {
+	struct irq_stat_line *line;
+	unsigned int irq_nr;
+	int n = 0;
+
+	irq_lock();
+
+	for (irq_nr = 0; irq_nr < IRQ_NRS_TOTAL; irq_nr++) {
+		line = &irq_stat_lines_tab[irq_nr];
+		if (!line->count) {
+			continue;
+		}
+		if (n < max) {
+			info[n].irq_nr = irq_nr;
+			info[n].count = line->count;
+			info[n].unhandled = line->unhandled;
+			info[n].cycles_total = line->cycles_total;
+			info[n].cycles_max = line->cycles_max;
+		}
+		n++;
+	}
+
+	irq_unlock();
+
+	return n;
+}
+
+static void handler_info_fill(struct irq_stat_handler_info *info,
+		const struct irq_stat_handler *st) {
+	info->irq_nr = st->irq_nr;
+	info->handler = st->handler;
+	info->dev_id = st->dev_id;
+	info->dev_name = st->dev_name;
+	info->calls = st->calls;
+	info->handled = st->handled;
+	info->cycles_total = st->cycles_total;
+	info->cycles_max = st->cycles_max;
+	memcpy(info->lat_hist, st->lat_hist, sizeof(info->lat_hist));
+}
+
+int irq_stat_handlers(struct irq_stat_handler_info *info, int max) {
+	struct irq_stat_handler *st;
+	int n = 0;
+
+	irq_lock();
+
+	dlist_foreach_entry(st, &irq_stat_handler_list, link) {
+		if (n < max) {
+			handler_info_fill(&info[n], st);
+		}
+		n++;
+	}
+
+	irq_unlock();
+
+	return n;
+}
+
+void irq_stat_reset(void) {
+	struct irq_stat_handler *st;
+
+	irq_lock();
+
+	memset(irq_stat_lines_tab, 0, sizeof(irq_stat_lines_tab));
+	dlist_foreach_entry(st, &irq_stat_handler_list, link) {
+		st->calls = 0;
+		st->handled = 0;
+		st->cycles_total = 0;
+		st->cycles_max = 0;
+		memset(st->lat_hist, 0, sizeof(st->lat_hist));
+	}
+
+	irq_unlock();
+}
+
+/* Appends to @c buf as long as it fits, returns the length as snprintf()
+ * does */
+static int print_append(char *buf, size_t size, int len,
+		const char *format, ...) {
+	va_list args;
+	int n;
+
+	va_start(args, format);
+	if ((size_t) len < size) {
+		n = vsnprintf(buf + len, size - len, format, args);
+	} else {
+		n = vsnprintf(NULL, 0, format, args);
+	}
+	va_end(args);
+
+	return n < 0 ? n : len + n;
+}
+
+static int irq_stat_print(char *buf, size_t size) {
+	struct irq_stat_handler *st;
+	struct irq_stat_line *line;
+	unsigned int irq_nr;
+	int len, b;
+
+	len = print_append(buf, size, 0, "%4s %10s %10s %14s %10s\n",
+			"irq", "count", "unhandled", "cycles", "max");
+
+	irq_lock();
+
+	for (irq_nr = 0; irq_nr < IRQ_NRS_TOTAL && len >= 0; irq_nr++) {
+		line = &irq_stat_lines_tab[irq_nr];
+		if (!line->count) {
+			continue;
+		}
+		len = print_append(buf, size, len, "%4u %10lu %10lu %14llu %10llu\n",
+				irq_nr, line->count, line->unhandled,
+				(unsigned long long) line->cycles_total,
+				(unsigned long long) line->cycles_max);
+
+		dlist_foreach_entry(st, &irq_stat_handler_list, link) {
+			if (st->irq_nr != irq_nr || len < 0) {
+				continue;
+			}
+			len = print_append(buf, size, len,
+					"  %p %-12s calls %lu handled %lu cycles %llu max %llu"
+					" lat",
+					st->handler, st->dev_name ? st->dev_name : "-",
+					st->calls, st->handled,
+					(unsigned long long) st->cycles_total,
+					(unsigned long long) st->cycles_max);
+			for (b = 0; b < IRQ_STAT_LAT_BUCKETS && len >= 0; b++) {
+				len = print_append(buf, size, len, " %lu", st->lat_hist[b]);
+			}
+			if (len >= 0) {
+				len = print_append(buf, size, len, "\n");
+			}
+		}
+	}
+
+	irq_unlock();
+
+	return len;
+}
+
+PROCFS_FILE_DEF("interrupts", irq_stat_print);
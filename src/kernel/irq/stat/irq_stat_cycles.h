@@ -0,0 +1,56 @@
+/**
+ * @file
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef IRQ_STAT_CYCLES_H_
+#define IRQ_STAT_CYCLES_H_
+
+#include <stdint.h>
+
+#include <lib/libds/dlist.h>
+
+struct irq_stat_handler {
+	struct dlist_head link;
+	unsigned int irq_nr;
+	irq_handler_t handler;
+	void *dev_id;
+	const char *dev_name;
+	unsigned long calls;
+	unsigned long handled;
+	uint64_t cycles_total;
+	uint64_t cycles_max;
+	unsigned long lat_hist[IRQ_STAT_LAT_BUCKETS];
+};
+
+#define __IRQ_STAT_FIELD(name) \
+	struct irq_stat_handler name;
+
+extern uint64_t __irq_stat_now(void);
+extern void __irq_stat_attach(struct irq_stat_handler *st,
+		unsigned int irq_nr, irq_handler_t handler, void *dev_id,
+		const char *dev_name);
+extern void __irq_stat_detach(struct irq_stat_handler *st);
+extern void __irq_stat_handler(struct irq_stat_handler *st,
+		irq_return_t ret, uint64_t t_entry, uint64_t t_start);
+extern void __irq_stat_dispatch(unsigned int irq_nr, int handled,
+		uint64_t t_entry);
+
+/* Attach and detach are called with irq_lock() held */
+#define irq_stat_attach(st, irq_nr, handler, dev_id, dev_name) \
+	__irq_stat_attach(st, irq_nr, handler, dev_id, dev_name)
+
+#define irq_stat_detach(st) \
+	__irq_stat_detach(st)
+
+#define irq_stat_now() \
+	__irq_stat_now()
+
+#define irq_stat_handler(st, ret, t_entry, t_start) \
+	__irq_stat_handler(st, ret, t_entry, t_start)
+
+#define irq_stat_dispatch(irq_nr, handled, t_entry) \
+	__irq_stat_dispatch(irq_nr, handled, t_entry)
+
+#endif /* IRQ_STAT_CYCLES_H_ */
@@ -0,0 +1,27 @@
+/**
+ * @file
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef IRQ_STAT_NONE_H_
+#define IRQ_STAT_NONE_H_
+
+#define __IRQ_STAT_FIELD(name)
+
+#define irq_stat_attach(st, irq_nr, handler, dev_id, dev_name) \
+	do { } while (0)
+
+#define irq_stat_detach(st) \
+	do { } while (0)
+
+#define irq_stat_now() \
+	0
+
+#define irq_stat_handler(st, ret, t_entry, t_start) \
+	do { (void) (ret); (void) (t_start); } while (0)
+
+#define irq_stat_dispatch(irq_nr, handled, t_entry) \
+	do { (void) (handled); (void) (t_entry); } while (0)
+
+#endif /* IRQ_STAT_NONE_H_ */
@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @brief Per-CPU event counters
+ *
+ * @date 19.10.2026
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include <fs/procfs.h>
+#include <hal/cpu.h>
+#include <kernel/cpu/cpudata.h>
+#include <kernel/kcounter.h>
+#include <lib/libds/array.h>
+
+ARRAY_SPREAD_DEF(const struct kcounter, __kcounter_registry);
+
+/* Bumped from <kernel/spinlock.h> which has no source of its own */
+KCOUNTER_DEF(spin_contended, "lock.spin_contended");
+
+int kcounter_count(void) {
+	return ARRAY_SPREAD_SIZE(__kcounter_registry);
+}
+
+unsigned long kcounter_read_cpu(const struct kcounter *kc, unsigned int cpu) {
+	return *cpudata_cpu_ptr(cpu, kc->val);
+}
+
+unsigned long kcounter_read(const struct kcounter *kc) {
+	unsigned long sum = 0;
+	unsigned int cpu;
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		sum += kcounter_read_cpu(kc, cpu);
+	}
+
+	return sum;
+}
+
+int kcounter_print(char *buf, size_t size) {
+	const struct kcounter *kc;
+	int len, n;
+
+	len = 0;
+	kcounter_foreach(kc) {
+		if ((size_t) len < size) {
+			n = snprintf(buf + len, size - len, "%s %lu\n", kc->name,
+					kcounter_read(kc));
+		} else {
+			n = snprintf(NULL, 0, "%s %lu\n", kc->name, kcounter_read(kc));
+		}
+		if (n < 0) {
+			return n;
+		}
+		len += n;
+	}
+
+	return len;
+}
+
+PROCFS_FILE_DEF("kcounters", kcounter_print);
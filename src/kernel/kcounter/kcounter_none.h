@@ -0,0 +1,22 @@
+/**
+ * @file
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef KCOUNTER_NONE_H_
+#define KCOUNTER_NONE_H_
+
+#define KCOUNTER_DECLARE(id) \
+	extern int __kcounter_none_##id
+
+#define KCOUNTER_DEF(id, name) \
+	extern int __kcounter_none_##id
+
+#define kcounter_add(id, n) \
+	do { } while (0)
+
+#define kcounter_inc(id) \
+	do { } while (0)
+
+#endif /* KCOUNTER_NONE_H_ */
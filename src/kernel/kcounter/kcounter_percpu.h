@@ -0,0 +1,56 @@
+/**
+ * @file
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef KCOUNTER_PERCPU_H_
+#define KCOUNTER_PERCPU_H_
+
+#include <stddef.h>
+
+#include <kernel/cpu/cpudata.h>
+#include <lib/libds/array.h>
+
+struct kcounter {
+	const char *name;
+	unsigned long *val;   /* CPU 0 copy, see cpudata_cpu_ptr() */
+};
+
+ARRAY_SPREAD_DECLARE(const struct kcounter, __kcounter_registry);
+
+#define kcounter_foreach(kc) \
+	array_spread_foreach_ptr(kc, __kcounter_registry)
+
+#define KCOUNTER_DECLARE(id) \
+	extern unsigned long __kcounter_##id __cpudata__
+
+#define KCOUNTER_DEF(id, _name)                                \
+	unsigned long __kcounter_##id __cpudata__;                 \
+	ARRAY_SPREAD_ADD_NAMED(__kcounter_registry, __kcounter_desc_##id, { \
+		.name = _name,                                         \
+		.val = &__kcounter_##id                                \
+	})
+
+/* Not atomic. An increment may be lost if the thread is preempted in the
+ * middle of it or migrates to another CPU, which is fine for statistics */
+#define kcounter_add(id, n) \
+	(cpudata_var(__kcounter_##id) += (n))
+
+#define kcounter_inc(id) \
+	kcounter_add(id, 1)
+
+/** Number of defined counters */
+extern int kcounter_count(void);
+
+/** Sum of the counter over all CPUs */
+extern unsigned long kcounter_read(const struct kcounter *kc);
+
+extern unsigned long kcounter_read_cpu(const struct kcounter *kc,
+		unsigned int cpu);
+
+/** Print all counters as "name value" lines, returns the length printed
+ * as snprintf() does */
+extern int kcounter_print(char *buf, size_t size);
+
+#endif /* KCOUNTER_PERCPU_H_ */
@@ -7,23 +7,52 @@
  */
 #include <stdarg.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #include <framework/mod/options.h>
 #include <kernel/printk.h>
 #include <util/log.h>
 
 #define PRINT_MOD_NAME OPTION_GET(BOOLEAN, print_mod_name)
+#define KLOG_LINE_MAX  OPTION_GET(NUMBER, line_max)
 
+/* The line is formatted once and handed to printk as a whole, so it is not
+ * split if printk is deferred. Lines which do not fit go piece by piece */
 static void klog_handler(struct logger *logger, uint16_t flags, const char *fmt,
     va_list args) {
+	char line[KLOG_LINE_MAX];
+	va_list copy;
+	int n, len;
+
+	n = 0;
 	if (flags & LOG_BEG) {
-		printk("[%s] ", log_prio2str(LOG_PRIO(flags)));
+		n = snprintf(line, sizeof(line), "[%s] ", log_prio2str(LOG_PRIO(flags)));
 #if PRINT_MOD_NAME
-		if (logger) {
-			printk("{%s} ", logger->mod->build_info->mod_name);
+		if (logger && n < (int) sizeof(line)) {
+			n += snprintf(line + n, sizeof(line) - n, "{%s} ",
+			    logger->mod->build_info->mod_name);
 		}
 #endif
+		if (n >= (int) sizeof(line)) {
+			n = sizeof(line) - 1;
+		}
 	}
+
+	va_copy(copy, args);
+	len = vsnprintf(line + n, sizeof(line) - n, fmt, copy);
+	va_end(copy);
+
+	if (len >= 0 && n + len + 1 < (int) sizeof(line)) {
+		if (flags & LOG_END) {
+			line[n + len] = '\n';
+			line[n + len + 1] = '\0';
+		}
+		printk("%s", line);
+		return;
+	}
+
+	line[n] = '\0';
+	printk("%s", line);
 	vprintk(fmt, args);
 	if (flags & LOG_END) {
 		printk("\n");
@@ -0,0 +1,266 @@
+/**
+ * @file
+ * @brief Lock contention statistics by lock class
+ * @details
+ *    Classes are kept in an open addressing table keyed by the definition
+ *    site string, the init call address or the lock address, whichever
+ *    the lock has. A lock remembers its class after the first lookup.
+ *
+ *    The statistics are updated under a raw spin with interrupts
+ *    disabled. It must not be a spinlock_t taken with spin_lock(), which
+ *    would account itself.
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <framework/mod/options.h>
+#include <hal/ipl.h>
+#include <kernel/cpu/cpudata.h>
+#include <kernel/lockstat.h>
+#include <kernel/spinlock.h>
+#include <lib/libcpu_info.h>
+
+#define CLASSES_MAX   OPTION_GET(NUMBER, max_classes)
+#define CLASSES_LIMIT (CLASSES_MAX / 4 * 3)
+
+struct lockstat_class {
+	const void *key;   /* NULL if the entry is empty */
+	struct lockstat_class_info info;
+};
+
+struct lockstat_sched {
+	const char *site;  /* NULL if the section is not accounted */
+	uint64_t stamp;
+};
+
+int lockstat_enabled = OPTION_GET(BOOLEAN, enabled);
+
+static struct lockstat_class lockstat_classes_tab[CLASSES_MAX];
+static unsigned int lockstat_classes_n;
+static unsigned int lockstat_gen;
+static unsigned long lockstat_dropped_n;
+
+static struct lockstat_sched lockstat_sched __cpudata__;
+
+static spinlock_t lockstat_lock = SPIN_STATIC_UNLOCKED;
+
+static ipl_t lockstat_lock_raw(void) {
+	ipl_t ipl;
+
+	ipl = ipl_save();
+	while (!__spin_trylock_smp(&lockstat_lock)) {
+	}
+
+	return ipl;
+}
+
+static void lockstat_unlock_raw(ipl_t ipl) {
+	__barrier();
+	lockstat_lock.l = __SPIN_UNLOCKED;
+	__barrier();
+	ipl_restore(ipl);
+}
+
+static inline unsigned int hash_key(const void *key) {
+	return (((uintptr_t) key >> 2) * 2654435761u) % CLASSES_MAX;
+}
+
+/* Called with lockstat_lock held, returns NULL if the table is full */
+static struct lockstat_class *class_get(const char *site, void *pc,
+		const void *lock, int type) {
+	struct lockstat_class *c;
+	const void *key;
+	unsigned int i;
+
+	key = site ? (const void *) site : pc ? (const void *) pc : lock;
+
+	for (i = hash_key(key); lockstat_classes_tab[i].key;
+			i = (i + 1) % CLASSES_MAX) {
+		if (lockstat_classes_tab[i].key == key) {
+			return &lockstat_classes_tab[i];
+		}
+	}
+
+	if (lockstat_classes_n == CLASSES_LIMIT) {
+		lockstat_dropped_n++;
+		return NULL;
+	}
+
+	c = &lockstat_classes_tab[i];
+	c->key = key;
+	c->info.site = site;
+	c->info.pc = pc;
+	c->info.lock = lock;
+	c->info.type = type;
+	lockstat_classes_n++;
+
+	return c;
+}
+
+/* Called with lockstat_lock held */
+static struct lockstat_class *lock_class(struct lockstat_lock *ls,
+		const void *lock, int type) {
+	if (!ls->cls || ls->gen != lockstat_gen) {
+		ls->cls = class_get(ls->site, ls->pc, lock, type);
+		ls->gen = lockstat_gen;
+	}
+
+	return ls->cls;
+}
+
+static void class_hold(struct lockstat_class *c, uint64_t hold) {
+	c->info.hold_total += hold;
+	if (hold > c->info.hold_max) {
+		c->info.hold_max = hold;
+	}
+}
+
+uint64_t __lockstat_now(void) {
+	return get_cpu_counter();
+}
+
+void __lockstat_acquired(struct lockstat_lock *ls, const void *lock,
+		int type) {
+	struct lockstat_class *c;
+	ipl_t ipl;
+
+	ipl = lockstat_lock_raw();
+
+	c = lock_class(ls, lock, type);
+	if (c) {
+		c->info.acquired++;
+	}
+	if (ls->held++ == 0) {
+		ls->stamp = get_cpu_counter();
+	}
+
+	lockstat_unlock_raw(ipl);
+}
+
+void __lockstat_contended(struct lockstat_lock *ls, const void *lock,
+		int type, uint64_t t0) {
+	struct lockstat_class *c;
+	uint64_t wait;
+	ipl_t ipl;
+
+	wait = get_cpu_counter() - t0;
+
+	ipl = lockstat_lock_raw();
+
+	c = lock_class(ls, lock, type);
+	if (c) {
+		c->info.contended++;
+		c->info.wait_total += wait;
+		if (wait > c->info.wait_max) {
+			c->info.wait_max = wait;
+		}
+	}
+
+	lockstat_unlock_raw(ipl);
+}
+
+void __lockstat_released(struct lockstat_lock *ls, const void *lock,
+		int type) {
+	struct lockstat_class *c;
+	uint64_t now;
+	ipl_t ipl;
+
+	now = get_cpu_counter();
+
+	ipl = lockstat_lock_raw();
+
+	/* Not held if it was taken before the statistics were enabled */
+	if (ls->held && --ls->held == 0) {
+		c = lock_class(ls, lock, type);
+		if (c) {
+			class_hold(c, now - ls->stamp);
+		}
+	}
+
+	lockstat_unlock_raw(ipl);
+}
+
+void __lockstat_sched_locked(const char *site) {
+	struct lockstat_sched *s;
+	struct lockstat_class *c;
+	ipl_t ipl;
+
+	ipl = lockstat_lock_raw();
+
+	s = cpudata_ptr(&lockstat_sched);
+	c = class_get(site, NULL, NULL, LOCKSTAT_SCHED);
+	if (c) {
+		c->info.acquired++;
+	}
+	s->site = site;
+	s->stamp = get_cpu_counter();
+
+	lockstat_unlock_raw(ipl);
+}
+
+void __lockstat_sched_unlocking(void) {
+	struct lockstat_sched *s;
+	struct lockstat_class *c;
+	uint64_t now;
+	ipl_t ipl;
+
+	now = get_cpu_counter();
+
+	ipl = lockstat_lock_raw();
+
+	s = cpudata_ptr(&lockstat_sched);
+	if (s->site) {
+		c = class_get(s->site, NULL, NULL, LOCKSTAT_SCHED);
+		if (c) {
+			class_hold(c, now - s->stamp);
+		}
+		s->site = NULL;
+	}
+
+	lockstat_unlock_raw(ipl);
+}
+
+void lockstat_enable(int enable) {
+	lockstat_enabled = enable;
+}
+
+void lockstat_reset(void) {
+	ipl_t ipl;
+
+	ipl = lockstat_lock_raw();
+
+	memset(lockstat_classes_tab, 0, sizeof(lockstat_classes_tab));
+	lockstat_classes_n = 0;
+	lockstat_dropped_n = 0;
+	lockstat_gen++;
+
+	lockstat_unlock_raw(ipl);
+}
+
+int lockstat_classes(struct lockstat_class_info *info, int max) {
+	ipl_t ipl;
+	int i, n;
+
+	ipl = lockstat_lock_raw();
+
+	for (i = 0, n = 0; i < CLASSES_MAX; i++) {
+		if (!lockstat_classes_tab[i].key) {
+			continue;
+		}
+		if (n < max) {
+			info[n] = lockstat_classes_tab[i].info;
+		}
+		n++;
+	}
+
+	lockstat_unlock_raw(ipl);
+
+	return n;
+}
+
+unsigned long lockstat_dropped(void) {
+	return lockstat_dropped_n;
+}
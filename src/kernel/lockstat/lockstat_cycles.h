@@ -0,0 +1,92 @@
+/**
+ * @file
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef LOCKSTAT_CYCLES_H_
+#define LOCKSTAT_CYCLES_H_
+
+#include <stdint.h>
+
+#include <kernel/critical.h>
+#include <util/macro.h>
+
+struct lockstat_class;
+
+struct lockstat_lock {
+	const char *site;            /* definition site, "file:line" */
+	void *pc;                    /* return address into the code which
+	                                initialized the lock at run time */
+	struct lockstat_class *cls;  /* looked up on the first acquisition */
+	unsigned int gen;            /* reset generation @c cls belongs to */
+	unsigned int held;           /* owners, readers of a rwlock included */
+	uint64_t stamp;              /* when it was taken by the first owner */
+};
+
+#define __LOCKSTAT_FIELD(name) \
+	struct lockstat_lock name;
+
+#define __LOCKSTAT_FIELD_INIT(name) \
+	name : { site : __FILE__ ":" MACRO_STRING(__LINE__) },
+
+#define lockstat_init(ls, _site, _pc) \
+	do { \
+		struct lockstat_lock *__ls = (ls); \
+		__ls->site = _site; \
+		__ls->pc = _pc; \
+		__ls->cls = NULL; \
+		__ls->held = 0; \
+	} while (0)
+
+extern int lockstat_enabled;
+
+extern uint64_t __lockstat_now(void);
+extern void __lockstat_acquired(struct lockstat_lock *ls, const void *lock,
+		int type);
+extern void __lockstat_contended(struct lockstat_lock *ls, const void *lock,
+		int type, uint64_t t0);
+extern void __lockstat_released(struct lockstat_lock *ls, const void *lock,
+		int type);
+extern void __lockstat_sched_locked(const char *site);
+extern void __lockstat_sched_unlocking(void);
+
+#define lockstat_now() \
+	(lockstat_enabled ? __lockstat_now() : 0)
+
+#define lockstat_acquired(ls, lock, type) \
+	do { \
+		if (lockstat_enabled) \
+			__lockstat_acquired(ls, lock, type); \
+	} while (0)
+
+#define lockstat_contended(ls, lock, type, t0) \
+	do { \
+		if (lockstat_enabled && (t0)) \
+			__lockstat_contended(ls, lock, type, t0); \
+	} while (0)
+
+#define lockstat_released(ls, lock, type) \
+	do { \
+		if (lockstat_enabled) \
+			__lockstat_released(ls, lock, type); \
+	} while (0)
+
+/* Only the outermost sched_lock() section is accounted */
+#define __lockstat_sched_outermost() \
+	((critical_count() & CRITICAL_SCHED_LOCK) \
+			== __CRITICAL_COUNT(CRITICAL_SCHED_LOCK))
+
+#define lockstat_sched_locked(site) \
+	do { \
+		if (lockstat_enabled && __lockstat_sched_outermost()) \
+			__lockstat_sched_locked(site); \
+	} while (0)
+
+#define lockstat_sched_unlocking() \
+	do { \
+		if (lockstat_enabled && __lockstat_sched_outermost()) \
+			__lockstat_sched_unlocking(); \
+	} while (0)
+
+#endif /* LOCKSTAT_CYCLES_H_ */
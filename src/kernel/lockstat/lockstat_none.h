@@ -0,0 +1,34 @@
+/**
+ * @file
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef LOCKSTAT_NONE_H_
+#define LOCKSTAT_NONE_H_
+
+#define __LOCKSTAT_FIELD(name)
+#define __LOCKSTAT_FIELD_INIT(name)
+
+#define lockstat_init(ls, site, pc) \
+	do { } while (0)
+
+#define lockstat_now() \
+	0
+
+#define lockstat_acquired(ls, lock, type) \
+	do { } while (0)
+
+#define lockstat_contended(ls, lock, type, t0) \
+	do { } while (0)
+
+#define lockstat_released(ls, lock, type) \
+	do { } while (0)
+
+#define lockstat_sched_locked(site) \
+	do { } while (0)
+
+#define lockstat_sched_unlocking() \
+	do { } while (0)
+
+#endif /* LOCKSTAT_NONE_H_ */
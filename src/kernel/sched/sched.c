@@ -29,10 +29,16 @@
 #include <hal/ipl.h>
 
 #include <kernel/critical.h>
+#include <kernel/kcounter.h>
 #include <kernel/spinlock.h>
 #include <kernel/sched/sched_strategy.h>
+#include <kernel/sched/sched_trace.h>
 #include <kernel/sched/current.h>
 
+KCOUNTER_DEF(sched_switch, "sched.switch");
+KCOUNTER_DEF(sched_wakeup, "sched.wakeup");
+KCOUNTER_DEF(sched_migrate, "sched.migrate");
+
 // XXX
 #ifndef __barrier
 #define __barrier() __asm__ __volatile__("" : : : "memory")
@@ -104,6 +110,7 @@ int schedee_init(struct schedee *schedee, int priority,
 	schedee_priority_init(schedee, priority);
 	sched_affinity_init(&schedee->affinity);
 	sched_timing_init(schedee);
+	schedee->last_cpu = cpu_get_id();
 
 	return 0;
 }
@@ -351,7 +358,10 @@ int __sched_wakeup(struct schedee *s) {
 
 	log_debug("schedee #%x", s);
 
-	if (was_waiting)
+	if (was_waiting) {
+		sched_trace_wakeup(s);
+		kcounter_inc(sched_wakeup);
+
 		/* Check if t->ready state is still set, and we can do
 		 * a fast-path wake up, that just clears t->waiting state.  */
 		if (!__sched_wakeup_ready(s))
@@ -360,6 +370,7 @@ int __sched_wakeup(struct schedee *s) {
 			 * 'schedule'). In such case the real wake up is performed on that
 			 * CPU itself upon reaching the end of 'schedule'. */
 			__sched_wakeup_smp_inactive(s);
+	}
 
 	return was_waiting;
 }
@@ -471,6 +482,15 @@ static void __schedule(int preempt) {
 		schedee_set_current(next);
 		log_debug("prev: %#x, next: %#x", prev, next);
 
+		if (next != prev) {
+			sched_trace_switch(prev, next);
+			kcounter_inc(sched_switch);
+		}
+		if (next->last_cpu != cpu_get_id()) {
+			next->last_cpu = cpu_get_id();
+			kcounter_inc(sched_migrate);
+		}
+
 		/* next->process has to enable ipl. */
 		next = next->process(prev, next);
 
@@ -0,0 +1,32 @@
+/**
+ * @file
+ * @brief Scheduler trace points compiled out
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef SCHED_TRACE_NONE_H_
+#define SCHED_TRACE_NONE_H_
+
+struct schedee;
+struct mutex;
+struct waitq;
+
+static inline void sched_trace_switch(struct schedee *prev,
+		struct schedee *next) { }
+
+static inline void sched_trace_wakeup(struct schedee *s) { }
+
+static inline void sched_trace_waitq_wakeup(struct waitq *wq, int nr) { }
+
+static inline void sched_trace_mutex_block(struct mutex *m) { }
+
+static inline void sched_trace_mutex_acquire(struct mutex *m) { }
+
+static inline void sched_trace_mutex_release(struct mutex *m) { }
+
+static inline void sched_trace_irq_enter(unsigned int irq_nr) { }
+
+static inline void sched_trace_irq_exit(unsigned int irq_nr) { }
+
+#endif /* SCHED_TRACE_NONE_H_ */
@@ -0,0 +1,41 @@
+/**
+ * @file
+ * @brief Scheduler trace points recorded to the trace buffer
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdint.h>
+
+#include <kernel/critical.h>
+#include <kernel/sched.h>
+#include <kernel/sched/current.h>
+#include <kernel/sched/sched_trace.h>
+#include <kernel/thread.h>
+#include <kernel/thread/sync/mutex.h>
+
+#include <profiler/tracing/tracebuf.h>
+
+static uintptr_t schedee_trace_id(struct schedee *s) {
+	if (s == NULL || !schedee_is_thread(s)) {
+		return TRACEBUF_ID_NONE;
+	}
+
+	return mcast_out(s, struct thread, schedee)->id;
+}
+
+void __sched_trace_switch(struct schedee *prev, struct schedee *next) {
+	tracebuf_write(TRACEBUF_SCHED_SWITCH, !prev->waiting,
+			schedee_trace_id(prev), schedee_trace_id(next));
+}
+
+void __sched_trace_wakeup(struct schedee *s) {
+	tracebuf_write(TRACEBUF_SCHED_WAKEUP,
+			critical_inside(CRITICAL_IRQ_HANDLER),
+			schedee_trace_id(s), schedee_trace_id(schedee_get_current()));
+}
+
+void __sched_trace_mutex_block(struct mutex *m) {
+	tracebuf_write(TRACEBUF_MUTEX_BLOCK, 0, (uintptr_t) m,
+			schedee_trace_id(m->holder));
+}
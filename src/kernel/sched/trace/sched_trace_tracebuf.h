@@ -0,0 +1,74 @@
+/**
+ * @file
+ * @brief Scheduler trace points recorded to the trace buffer
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef SCHED_TRACE_TRACEBUF_H_
+#define SCHED_TRACE_TRACEBUF_H_
+
+#include <stdint.h>
+
+#include <profiler/tracing/tracebuf.h>
+
+struct schedee;
+struct mutex;
+struct waitq;
+
+extern void __sched_trace_switch(struct schedee *prev, struct schedee *next);
+extern void __sched_trace_wakeup(struct schedee *s);
+extern void __sched_trace_mutex_block(struct mutex *m);
+
+/* Only a load and a branch while tracing is disabled */
+
+static inline void sched_trace_switch(struct schedee *prev,
+		struct schedee *next) {
+	if (tracebuf_enabled()) {
+		__sched_trace_switch(prev, next);
+	}
+}
+
+static inline void sched_trace_wakeup(struct schedee *s) {
+	if (tracebuf_enabled()) {
+		__sched_trace_wakeup(s);
+	}
+}
+
+static inline void sched_trace_waitq_wakeup(struct waitq *wq, int nr) {
+	if (tracebuf_enabled()) {
+		tracebuf_write(TRACEBUF_WAITQ_WAKEUP, nr, (uintptr_t) wq, 0);
+	}
+}
+
+static inline void sched_trace_mutex_block(struct mutex *m) {
+	if (tracebuf_enabled()) {
+		__sched_trace_mutex_block(m);
+	}
+}
+
+static inline void sched_trace_mutex_acquire(struct mutex *m) {
+	if (tracebuf_enabled()) {
+		tracebuf_write(TRACEBUF_MUTEX_ACQUIRE, 0, (uintptr_t) m, 0);
+	}
+}
+
+static inline void sched_trace_mutex_release(struct mutex *m) {
+	if (tracebuf_enabled()) {
+		tracebuf_write(TRACEBUF_MUTEX_RELEASE, 0, (uintptr_t) m, 0);
+	}
+}
+
+static inline void sched_trace_irq_enter(unsigned int irq_nr) {
+	if (tracebuf_enabled()) {
+		tracebuf_write(TRACEBUF_IRQ_ENTER, irq_nr, 0, 0);
+	}
+}
+
+static inline void sched_trace_irq_exit(unsigned int irq_nr) {
+	if (tracebuf_enabled()) {
+		tracebuf_write(TRACEBUF_IRQ_EXIT, irq_nr, 0, 0);
+	}
+}
+
+#endif /* SCHED_TRACE_TRACEBUF_H_ */
@@ -14,6 +14,7 @@
 #include <kernel/sched.h>
 #include <kernel/sched/waitq.h>
 #include <kernel/sched/current.h>
+#include <kernel/sched/sched_trace.h>
 
 #include <kernel/sched/waitq_protect_link.h>
 
@@ -96,5 +97,6 @@ static void __waitq_wakeup(struct waitq *wq, int nr) {
 
 void waitq_wakeup(struct waitq *wq, int nr) {
 	assert(wq);
+	sched_trace_waitq_wakeup(wq, nr);
 	SPIN_IPL_PROTECTED_DO(&wq->lock, __waitq_wakeup(wq, nr));
 }
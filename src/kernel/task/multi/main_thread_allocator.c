@@ -55,7 +55,9 @@ struct thread *main_thread_alloc(void) {
 	if (!(block = (thread_pool_entry_t *) pool_alloc(&main_thread_pool))) {
 		return NULL;
 	}
+#ifndef NDEBUG
 	memset(block, 0x53, sizeof(*block));
+#endif
 
 	t = &block->thread;
 
@@ -76,7 +78,9 @@ void main_thread_free(struct thread *t) {
 
     stack_protect_release(t);
 
+#ifndef NDEBUG
 	memset(block, 0xa5, sizeof(*block));
+#endif
 
 	pool_free(&main_thread_pool, block);
 }
@@ -13,9 +13,15 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdint.h>
 
 #include <kernel/thread/sync/mutex.h>
 #include <kernel/thread/waitq.h>
+#include <kernel/sched/sched_trace.h>
+#include <kernel/kcounter.h>
+#include <kernel/lockstat.h>
+
+KCOUNTER_DEF(mutex_sleep, "lock.mutex_sleep");
 
 static inline int mutex_is_static_inited(struct mutex *m) {
 	/* Static initializer can't really init list now, so if this condition's
@@ -37,11 +43,15 @@ void mutex_init_default(struct mutex *m, const struct mutexattr *attr) {
 	} else {
 		mutexattr_init(&m->attr);
 	}
+
+	lockstat_init(&m->ls, NULL, __builtin_return_address(0));
 }
 
 void mutex_init(struct mutex *m) {
 	mutex_init_default(m, NULL);
 	mutexattr_settype(&m->attr, MUTEX_RECURSIVE);
+
+	lockstat_init(&m->ls, NULL, __builtin_return_address(0));
 }
 
 int mutex_lock_common(struct mutex *m,
@@ -50,6 +60,7 @@ int mutex_lock_common(struct mutex *m,
 	int errcheck;
 	int ret, wait_ret;
 	int timeout;
+	uint64_t t0 = 0;
 
 	assert(m);
 	assert(!critical_inside(__CRITICAL_HARDER(CRITICAL_SCHED_LOCK)));
@@ -73,14 +84,22 @@ int mutex_lock_common(struct mutex *m,
 		sched_lock();
 		ret = mutex_trylock(m);
 		done = (ret == 0) || (errcheck && ret == -EDEADLK);
-		if (!done)
+		if (!done) {
 			mutex_priority_inherit(current, m);
+			sched_trace_mutex_block(m);
+			kcounter_inc(mutex_sleep);
+			if (!t0) {
+				t0 = lockstat_now();
+			}
+		}
 		sched_unlock();
 		done;
 	}), timeout);
 
 	if (wait_ret != 0) {
 		ret = wait_ret;
+	} else if (ret == 0) {
+		lockstat_contended(&m->ls, m, LOCKSTAT_MUTEX, t0);
 	}
 
 	return ret;
@@ -128,6 +147,10 @@ int mutex_trylock(struct mutex *m) {
 		} else {
 			res = mutex_trylock_schedee(current, m);
 		}
+		if (res == 0) {
+			sched_trace_mutex_acquire(m);
+			lockstat_acquired(&m->ls, m, LOCKSTAT_MUTEX);
+		}
 	}
 	sched_unlock();
 	assert(!critical_inside(__CRITICAL_HARDER(CRITICAL_SCHED_LOCK)));
@@ -162,6 +185,11 @@ int mutex_unlock(struct mutex *m) {
 		} else {
 			mutex_unlock_schedee(current, m);
 		}
+
+		if (res == 0) {
+			sched_trace_mutex_release(m);
+			lockstat_released(&m->ls, m, LOCKSTAT_MUTEX);
+		}
 	}
 	sched_unlock();
 	assert(!critical_inside(__CRITICAL_HARDER(CRITICAL_SCHED_LOCK)));
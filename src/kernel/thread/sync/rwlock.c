@@ -8,6 +8,8 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdint.h>
+#include <kernel/lockstat.h>
 #include <kernel/thread/sync/rwlock.h>
 #include <kernel/sched.h>
 #include <kernel/thread/waitq.h>
@@ -23,6 +25,7 @@ void rwlock_init(rwlock_t *r) {
 	waitq_init(&r->wq);
 	r->status = RWLOCK_STATUS_NONE;
 	r->count = 0;
+	lockstat_init(&r->ls, NULL, __builtin_return_address(0));
 }
 
 void rwlock_read_up(rwlock_t *r) {
@@ -34,12 +37,22 @@ void rwlock_write_up(rwlock_t *r) {
 }
 
 static void do_up(rwlock_t *r, int status) {
+	uint64_t t0 = 0;
+
 	assert(r);
 	assert(critical_allows(CRITICAL_SCHED_LOCK));
 
 	sched_lock();
 	{
-		WAITQ_WAIT(&r->wq, !tryenter_sched_lock(r, status));
+		WAITQ_WAIT(&r->wq, ({
+			int done = !tryenter_sched_lock(r, status);
+			if (!done && !t0) {
+				t0 = lockstat_now();
+			}
+			done;
+		}));
+		lockstat_contended(&r->ls, r, LOCKSTAT_RWLOCK, t0);
+		lockstat_acquired(&r->ls, r, LOCKSTAT_RWLOCK);
 	}
 	sched_unlock();
 }
@@ -76,6 +89,7 @@ void rwlock_any_down(rwlock_t *r) {
 
 	sched_lock();
 	{
+		lockstat_released(&r->ls, r, LOCKSTAT_RWLOCK);
 		r->count--;
 		if (r->count == 0) {
 			r->status = RWLOCK_STATUS_NONE;
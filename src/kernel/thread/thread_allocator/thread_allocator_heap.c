@@ -55,7 +55,9 @@ void *thread_user_stack_alloc(struct thread *t, size_t stack_sz) {
 		pool_free(&thread_info_pool, ti);
 		return NULL;
 	}
+#ifndef NDEBUG
 	memset(stack, 0x53, stack_sz);
+#endif
 
 	ti->stack = stack;
 	ti->pages = pages;
@@ -74,8 +76,10 @@ void thread_user_stack_free(void *t) {
 	all_stacks_sz -= ti->pages * PAGE_SIZE();
 	log_debug("stack_sz=%d, all_stacks=%d", ti->pages * PAGE_SIZE(), all_stacks_sz);
 
-	page_free(thread_heap_allocator, ti->stack, ti->pages);
+#ifndef NDEBUG
 	memset(ti->stack, 0xa5, ti->pages * PAGE_SIZE());
+#endif
+	page_free(thread_heap_allocator, ti->stack, ti->pages);
 
 	pool_free(&thread_info_pool, ti);
 }
@@ -0,0 +1,179 @@
+/**
+ * @file
+ * @brief Thread stacks allocated from the heap page allocator
+ * @details
+ *    Every thread gets a block of pages sized by its requested stack:
+ *    | guard page | *** stack *** | struct thread |
+ *    The stack grows down from the thread structure toward the guard page,
+ *    which is present only if MMU stack protection is enabled.
+ *
+ *    A few recently freed blocks are kept in a cache and handed to the
+ *    next thread which asks for the same number of pages, so threads which
+ *    are created and joined in a loop do not go to the page allocator.
+ *
+ * @date 19.10.2026
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include <util/binalign.h>
+#include <util/log.h>
+#include <framework/mod/options.h>
+
+#include <kernel/thread.h>
+#include <kernel/thread/thread_alloc.h>
+#include <kernel/thread/thread_stack.h>
+#include <kernel/thread/stack_protect.h>
+#include <kernel/sched/sched_lock.h>
+
+#include <mem/page.h>
+
+#ifdef STACK_PROTECT_MMU
+#include <sys/mman.h>
+#include <mem/vmem.h>
+#endif
+
+#define CACHE_SZ     OPTION_GET(NUMBER, stack_cache_size)
+
+#define THREAD_SZ    binalign_bound(sizeof(struct thread), THREAD_STACK_ALIGN)
+#define HDR_SZ \
+	binalign_bound(sizeof(struct thread_stack_block), THREAD_STACK_ALIGN)
+
+/* Kept right below struct thread, the stack top is just under it */
+struct thread_stack_block {
+	void *base;
+	size_t pages;
+	int guarded;
+};
+
+extern struct page_allocator *__heap_pgallocator;
+
+#if CACHE_SZ
+static struct thread_stack_block stack_cache[CACHE_SZ];
+static int stack_cache_n;
+#endif
+
+static inline int guard_enabled(void) {
+#ifdef STACK_PROTECT_MMU
+	return stack_protect_enabled();
+#else
+	return 0;
+#endif
+}
+
+static void guard_set(void *base, int on) {
+#ifdef STACK_PROTECT_MMU
+	mmu_ctx_t ctx;
+
+	ctx = vmem_current_context();
+	vmem_set_flags(ctx, (mmu_vaddr_t) base, VMEM_PAGE_SIZE,
+			on ? 0 : PROT_WRITE | PROT_READ | PROT_NOCACHE);
+	mmu_flush_tlb();
+#endif
+}
+
+static void stack_block_release(struct thread_stack_block *b) {
+	if (b->guarded) {
+		guard_set(b->base, 0);
+	}
+	page_free(__heap_pgallocator, b->base, b->pages);
+}
+
+/* Called with the scheduler locked */
+static int stack_block_get(struct thread_stack_block *b) {
+#if CACHE_SZ
+	int i;
+
+	for (i = stack_cache_n - 1; i >= 0; i--) {
+		if (stack_cache[i].pages == b->pages
+				&& stack_cache[i].guarded == b->guarded) {
+			*b = stack_cache[i];
+			stack_cache_n--;
+			memmove(&stack_cache[i], &stack_cache[i + 1],
+					(stack_cache_n - i) * sizeof(stack_cache[0]));
+			return 0;
+		}
+	}
+#endif
+
+	b->base = page_alloc(__heap_pgallocator, b->pages);
+	if (!b->base) {
+		return -1;
+	}
+	if (b->guarded) {
+		guard_set(b->base, 1);
+	}
+
+	return 0;
+}
+
+/* Called with the scheduler locked */
+static void stack_block_put(struct thread_stack_block *b) {
+#if CACHE_SZ
+	if (stack_cache_n == CACHE_SZ) {
+		/* Evict the oldest block, the newer ones are more likely hot */
+		stack_block_release(&stack_cache[0]);
+		stack_cache_n--;
+		memmove(&stack_cache[0], &stack_cache[1],
+				stack_cache_n * sizeof(stack_cache[0]));
+	}
+	stack_cache[stack_cache_n++] = *b;
+#else
+	stack_block_release(b);
+#endif
+}
+
+struct thread *thread_alloc(size_t stack_sz) {
+	struct thread_stack_block b, *hdr;
+	struct thread *t;
+	size_t guard_sz, block_sz;
+
+	b.guarded = guard_enabled();
+	guard_sz = b.guarded ? PAGE_SIZE() : 0;
+	b.pages = (guard_sz + stack_sz + HDR_SZ + THREAD_SZ + PAGE_SIZE() - 1)
+			/ PAGE_SIZE();
+	block_sz = b.pages * PAGE_SIZE();
+
+	sched_lock();
+	if (stack_block_get(&b)) {
+		sched_unlock();
+		log_error("stack allocation of %zu pages failed", b.pages);
+		return NULL;
+	}
+	sched_unlock();
+
+#ifndef NDEBUG
+	memset(b.base + guard_sz, 0x53, block_sz - guard_sz);
+#endif
+
+	t = b.base + block_sz - THREAD_SZ;
+	hdr = (void *) t - HDR_SZ;
+	*hdr = b;
+
+	thread_stack_set(t, b.base + guard_sz);
+	thread_stack_set_size(t, block_sz - guard_sz - HDR_SZ - THREAD_SZ);
+
+	return t;
+}
+
+void thread_free(struct thread *t) {
+	struct thread_stack_block b;
+
+	assert(t != NULL);
+
+	b = *(struct thread_stack_block *) ((void *) t - HDR_SZ);
+	assert(b.base + b.pages * PAGE_SIZE() == (void *) t + THREAD_SZ);
+
+#ifndef NDEBUG
+	if (b.guarded) {
+		memset(b.base + PAGE_SIZE(), 0xa5, (b.pages - 1) * PAGE_SIZE());
+	} else {
+		memset(b.base, 0xa5, b.pages * PAGE_SIZE());
+	}
+#endif
+
+	sched_lock();
+	stack_block_put(&b);
+	sched_unlock();
+}
@@ -70,7 +70,9 @@ struct thread *thread_alloc(size_t stack_sz) {
 	if (!(block = pool_alloc(&thread_pool))) {
 		return NULL;
 	}
+#ifndef NDEBUG
 	memset(block, 0x53, sizeof(*block));
+#endif
 
 	t = &block->thread;
 #if (USE_USER_STACK == 0)
@@ -100,7 +102,9 @@ void thread_free(struct thread *t) {
 	thread_user_stack_free(block->user_stack);
 #endif
 
+#ifndef NDEBUG
 	memset(block, 0xa5, sizeof(*block));
+#endif
 
 	pool_free(&thread_pool, block);
 }
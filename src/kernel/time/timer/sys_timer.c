@@ -9,14 +9,14 @@
 #include <errno.h>
 
 #include <embox/unit.h>
-#include <mem/misc/pool.h>
+#include <mem/objalloc.h>
 
 #include <kernel/time/timer.h>
 #include <kernel/time/time.h>
 #include <kernel/sched/sched_lock.h>
 #include <hal/clock.h>
 
-POOL_DEF(timer_pool, sys_timer_t, OPTION_GET(NUMBER,timer_quantity));
+OBJALLOC_DEF(timer_pool, sys_timer_t, OPTION_GET(NUMBER,timer_quantity));
 
 int timer_init(struct sys_timer *tmr, unsigned int flags,
 		sys_timer_handler_t handler, void *param) {
@@ -83,12 +83,12 @@ int timer_set(struct sys_timer **ptimer, unsigned int flags, uint32_t msec,
 		return -EINVAL;
 	}
 
-	if (NULL == (tmr = (sys_timer_t*) pool_alloc(&timer_pool))) {
+	if (NULL == (tmr = (sys_timer_t*) objalloc(&timer_pool))) {
 		return -ENOMEM;
 	}
 
 	if ((err = timer_init_start_msec(tmr, flags, msec, handler, param))) {
-		pool_free(&timer_pool, tmr);
+		objfree(&timer_pool, tmr);
 		return err;
 	}
 
@@ -107,7 +107,7 @@ int timer_close(struct sys_timer *tmr) {
 
 	if (timer_is_preallocated(tmr)) {
 		timer_clear_preallocated(tmr);
-		pool_free(&timer_pool, tmr);
+		objfree(&timer_pool, tmr);
 	}
 
 	return ENOERR;
@@ -0,0 +1,35 @@
+/**
+ * @file
+ * @brief Frequency of the CPU cycle counter
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdint.h>
+
+#include <kernel/time/ktime.h>
+#include <lib/libcpu_info.h>
+
+/* Long enough for the system clock resolution not to matter */
+#define CALIBRATE_NS 10000000
+
+uint64_t cpu_counter_hz(void) {
+	static uint64_t hz;
+	uint64_t c0, c1;
+	time64_t t0, t1;
+
+	if (hz) {
+		return hz;
+	}
+
+	t0 = ktime_get_ns();
+	c0 = get_cpu_counter();
+	do {
+		t1 = ktime_get_ns();
+	} while (t1 - t0 < CALIBRATE_NS);
+	c1 = get_cpu_counter();
+
+	hz = (c1 - c0) * 1000000000ULL / (t1 - t0);
+
+	return hz;
+}
@@ -30,5 +30,10 @@ struct cpu_info {
 extern void set_feature_val(struct cpu_info *info, const char *name, unsigned int val);
 extern struct cpu_info *get_cpu_info(void);
 extern uint64_t get_cpu_counter(void);
+/**
+ * Ticks of get_cpu_counter() per second, measured against the system clock
+ * on the first call, which takes about 10 ms.
+ */
+extern uint64_t cpu_counter_hz(void);
 
 #endif /* LIB_CPU_INFO_H_ */
@@ -0,0 +1,167 @@
+/**
+ * @file
+ * @brief Lock-free ring with a single producer and a single consumer.
+ * @details
+ *    Meant for per-CPU buffers filled from any context: every CPU is the
+ *    only producer of its ring and writes it with interrupts disabled, a
+ *    reader drains the rings of all CPUs under a lock of its own. Nobody
+ *    waits for anybody, the producer moves the head only and the consumer
+ *    moves the tail only.
+ *
+ *    Positions are free-running counters of units, records or bytes, the
+ *    storage itself is up to the client. The producer writes at the head
+ *    and then publishes the data, the consumer copies the data before the
+ *    head and then releases it.
+ *
+ *    A full ring either drops new data (the producer checks the room), or
+ *    overwrites the oldest data. In the latter case the producer never
+ *    looks at the tail and the consumer has to use
+ *    #spsc_ring_read_overwrite() which discards what was overwritten.
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef UTIL_SPSC_RING_H_
+#define UTIL_SPSC_RING_H_
+
+#include <stddef.h>
+#include <string.h>
+
+struct spsc_ring {
+	unsigned int head; /* advanced by the producer only */
+	unsigned int tail; /* advanced by the consumer only */
+};
+
+static inline void spsc_ring_init(struct spsc_ring *r) {
+	r->head = r->tail = 0;
+}
+
+/** Producer: units which can be written without overwriting */
+static inline unsigned int spsc_ring_room(struct spsc_ring *r,
+		unsigned int size) {
+	return size - (r->head - r->tail);
+}
+
+/** Producer: makes @a n units written at the head visible to the consumer */
+static inline void spsc_ring_publish(struct spsc_ring *r, unsigned int n) {
+	/* The data must be complete before the consumer can see it */
+	__sync_synchronize();
+	r->head += n;
+}
+
+/** Consumer: the head, everything before it may be read */
+static inline unsigned int spsc_ring_head(struct spsc_ring *r) {
+	unsigned int head = r->head;
+
+	__sync_synchronize();
+	return head;
+}
+
+/** Consumer: gives everything before @a tail back to the producer */
+static inline void spsc_ring_release(struct spsc_ring *r, unsigned int tail) {
+	/* The data must be copied before the producer may reuse it */
+	__sync_synchronize();
+	r->tail = tail;
+}
+
+/** Copies @a len bytes to a byte ring of @a size at position @a pos */
+static inline void spsc_ring_copy_in(void *ring_buf, unsigned int size,
+		unsigned int pos, const void *src, size_t len) {
+	unsigned int off = pos % size;
+	size_t part = size - off;
+
+	if (part >= len) {
+		memcpy(ring_buf + off, src, len);
+	} else {
+		memcpy(ring_buf + off, src, part);
+		memcpy(ring_buf, src + part, len - part);
+	}
+}
+
+/** Copies @a len bytes from a byte ring of @a size at position @a pos */
+static inline void spsc_ring_copy_out(const void *ring_buf, unsigned int size,
+		unsigned int pos, void *dst, size_t len) {
+	unsigned int off = pos % size;
+	size_t part = size - off;
+
+	if (part >= len) {
+		memcpy(dst, ring_buf + off, len);
+	} else {
+		memcpy(dst, ring_buf + off, part);
+		memcpy(dst + part, ring_buf, len - part);
+	}
+}
+
+/**
+ * Consumer: moves up to @a max records of @a rec_size bytes from a ring of
+ * @a size records stored at @a recs to @a buf.
+ *
+ * @return number of records moved
+ */
+static inline int spsc_ring_read(struct spsc_ring *r, const void *recs,
+		size_t rec_size, unsigned int size, void *buf, int max) {
+	unsigned int head, tail;
+	int n;
+
+	head = spsc_ring_head(r);
+
+	for (tail = r->tail, n = 0; tail != head && n < max; tail++, n++) {
+		memcpy(buf + n * rec_size, recs + (tail % size) * rec_size,
+				rec_size);
+	}
+
+	spsc_ring_release(r, tail);
+
+	return n;
+}
+
+/**
+ * Producer of an overwriting ring: call before writing the record at the
+ * head, the consumer must see the previous head before the slot is reused.
+ */
+static inline void spsc_ring_overwrite_begin(struct spsc_ring *r) {
+	__sync_synchronize();
+}
+
+/**
+ * Consumer of an overwriting ring: same as #spsc_ring_read() but skips the
+ * records overwritten before they were read, including those overwritten
+ * while they were being copied. Their number is added to @a lost.
+ */
+static inline int spsc_ring_read_overwrite(struct spsc_ring *r,
+		const void *recs, size_t rec_size, unsigned int size, void *buf,
+		int max, unsigned long *lost) {
+	unsigned int head, first, tail;
+	int n, gone;
+
+	head = spsc_ring_head(r);
+
+	first = r->tail;
+	if (head - first > size) {
+		*lost += head - first - size;
+		first = head - size;
+	}
+
+	for (tail = first, n = 0; tail != head && n < max; tail++, n++) {
+		memcpy(buf + n * rec_size, recs + (tail % size) * rec_size,
+				rec_size);
+	}
+
+	/* Copies are complete before the head is looked at again. The
+	 * producer may be writing the slot of the record at the head as well */
+	__sync_synchronize();
+	head = r->head;
+	gone = (int) (head - size + 1 - first);
+	if (gone > 0) {
+		gone = gone < n ? gone : n;
+		memmove(buf, buf + gone * rec_size, (n - gone) * rec_size);
+		n -= gone;
+		*lost += gone;
+	}
+
+	spsc_ring_release(r, tail);
+
+	return n;
+}
+
+#endif /* UTIL_SPSC_RING_H_ */
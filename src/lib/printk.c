@@ -33,3 +33,10 @@ int printk(const char *format, ...) {
 int vprintk(const char *format, va_list args) {
 	return __print(printk_printchar, NULL, format, args);
 }
+
+void printk_flush(void) {
+}
+
+unsigned long printk_dropped(void) {
+	return 0;
+}
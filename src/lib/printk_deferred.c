@@ -0,0 +1,312 @@
+/**
+ * @file
+ * @brief Deferred printk with per-CPU rings drained by a console thread
+ * @details
+ *    printk() renders the message into a small buffer on the stack and
+ *    copies it into the ring of the current CPU with interrupts disabled,
+ *    so the only writer of a ring is its CPU and no lock is taken. Each
+ *    record carries a global sequence number which the drain uses to put
+ *    out records of different CPUs in the order they were logged.
+ *
+ *    A message which does not fit into the ring is dropped and counted,
+ *    the drain reports the count before the next record of the CPU.
+ *
+ *    The drain thread sleeps on a wait queue while the rings are empty.
+ *    printk() may run under the scheduler or wait queue locks, so a message
+ *    put into an empty ring only marks the drain pending, and a periodic
+ *    timer wakes the drain up.
+ *
+ *    Until the drain thread is started and after printk_flush() printk
+ *    writes to diag synchronously.
+ *
+ * @date 19.10.2026
+ */
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <drivers/diag.h>
+#include <embox/unit.h>
+#include <framework/mod/options.h>
+#include <hal/cpu.h>
+#include <hal/ipl.h>
+#include <kernel/cpu/cpudata.h>
+#include <kernel/printk.h>
+#include <kernel/sched/schedee_priority.h>
+#include <kernel/sched/waitq.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread.h>
+#include <kernel/thread/waitq.h>
+#include <kernel/time/timer.h>
+#include <lib/libds/spsc_ring.h>
+#include <util/err.h>
+
+#include <module/embox/compat/libc/stdio/print_impl.h>
+
+#define RING_SZ       OPTION_GET(NUMBER, ring_size)
+#define MSG_MAX       OPTION_GET(NUMBER, msg_max)
+#define DRAIN_PRIO    OPTION_GET(NUMBER, drain_priority)
+#define WAKEUP_PERIOD OPTION_GET(NUMBER, wakeup_period)
+
+static_assert(!(RING_SZ & (RING_SZ - 1)), "ring_size must be a power of two");
+static_assert(MSG_MAX <= UINT16_MAX, "msg_max must fit in 16 bits");
+
+EMBOX_UNIT_INIT(printk_drain_init);
+
+struct printk_rec_hdr {
+	uint32_t seq;
+	uint16_t len;
+};
+
+struct printk_ring {
+	struct spsc_ring ring;
+	unsigned long dropped;
+	unsigned long reported; /* dropped count the drain has reported */
+	char buf[RING_SZ];
+};
+
+struct printchar_handler_data {
+	int deferred;
+	int n;
+	char buf[MSG_MAX];
+};
+
+static struct printk_ring printk_ring __cpudata__;
+static uint32_t printk_seq;
+static int printk_deferred;
+static spinlock_t printk_drain_lock = SPIN_STATIC_UNLOCKED;
+static struct waitq printk_drain_wq = WAITQ_INIT(printk_drain_wq);
+static struct sys_timer printk_wakeup_timer;
+static int printk_pending;
+
+static void printk_commit(const char *s, int len) {
+	struct printk_rec_hdr hdr;
+	struct printk_ring *r;
+	unsigned int head, room;
+	int was_empty;
+	ipl_t ipl;
+
+	if (!len) {
+		return;
+	}
+
+	ipl = ipl_save();
+
+	r = cpudata_ptr(&printk_ring);
+	room = spsc_ring_room(&r->ring, RING_SZ);
+	if (room < sizeof(hdr) + len) {
+		r->dropped++;
+		ipl_restore(ipl);
+		return;
+	}
+
+	hdr.seq = __sync_fetch_and_add(&printk_seq, 1);
+	hdr.len = len;
+	head = r->ring.head;
+	spsc_ring_copy_in(r->buf, RING_SZ, head, &hdr, sizeof(hdr));
+	spsc_ring_copy_in(r->buf, RING_SZ, head + sizeof(hdr), s, len);
+
+	was_empty = (room == RING_SZ);
+	spsc_ring_publish(&r->ring, sizeof(hdr) + len);
+
+	ipl_restore(ipl);
+
+	/* Otherwise the drain is busy with the ring and will get to the record */
+	if (was_empty) {
+		printk_pending = 1;
+	}
+}
+
+static int printk_printchar(struct printchar_handler_data *d, int c) {
+	if (!d->deferred) {
+		diag_putc(c);
+		return c;
+	}
+
+	if (d->n == MSG_MAX) {
+		printk_commit(d->buf, d->n);
+		d->n = 0;
+	}
+	d->buf[d->n++] = c;
+
+	return c;
+}
+
+int vprintk(const char *format, va_list args) {
+	struct printchar_handler_data d;
+	int ret;
+
+	d.deferred = printk_deferred;
+	d.n = 0;
+	ret = __print(printk_printchar, &d, format, args);
+	if (d.deferred) {
+		printk_commit(d.buf, d.n);
+	}
+
+	return ret;
+}
+
+int printk(const char *format, ...) {
+	int ret;
+	va_list args;
+
+	assert(format != NULL);
+
+	va_start(args, format);
+	ret = vprintk(format, args);
+	va_end(args);
+
+	return ret;
+}
+
+static void drain_puts(const char *s, int len) {
+	while (len--) {
+		diag_putc(*s++);
+	}
+}
+
+/* Called with printk_drain_lock held, but printk_flush() may go without
+ * it. Takes the oldest record of all CPUs out to @c buf and the note on
+ * messages dropped before it to @c note, returns the record length or -1
+ * if the rings are empty */
+static int printk_drain_one(char *buf, char *note, size_t note_sz) {
+	struct printk_rec_hdr hdr, best_hdr;
+	struct printk_ring *r, *best;
+	unsigned long dropped;
+	unsigned int cpu;
+
+	best = NULL;
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		r = cpudata_cpu_ptr(cpu, &printk_ring);
+		if (spsc_ring_head(&r->ring) == r->ring.tail) {
+			continue;
+		}
+		spsc_ring_copy_out(r->buf, RING_SZ, r->ring.tail, &hdr, sizeof(hdr));
+		if (!best || (int32_t) (hdr.seq - best_hdr.seq) < 0) {
+			best = r;
+			best_hdr = hdr;
+		}
+	}
+
+	if (!best) {
+		return -1;
+	}
+
+	note[0] = '\0';
+	dropped = best->dropped;
+	if (dropped != best->reported) {
+		snprintf(note, note_sz, "\nprintk: %lu messages dropped\n",
+				dropped - best->reported);
+		best->reported = dropped;
+	}
+
+	spsc_ring_copy_out(best->buf, RING_SZ, best->ring.tail + sizeof(hdr), buf,
+			best_hdr.len);
+	spsc_ring_release(&best->ring,
+			best->ring.tail + sizeof(hdr) + best_hdr.len);
+
+	return best_hdr.len;
+}
+
+static int printk_rings_empty(void) {
+	struct printk_ring *r;
+	unsigned int cpu;
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		r = cpudata_cpu_ptr(cpu, &printk_ring);
+		if (r->ring.head != r->ring.tail) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+void printk_flush(void) {
+	char buf[MSG_MAX];
+	char note[48];
+	int locked;
+	int n;
+
+	printk_deferred = 0;
+
+	/* The lock is held if the drain was interrupted on this CPU or runs on
+	 * another one. This is the last chance to see the messages, so they
+	 * are put out anyway: the worst the drain can do is to repeat some */
+	locked = spin_trylock(&printk_drain_lock);
+
+	while ((n = printk_drain_one(buf, note, sizeof(note))) >= 0) {
+		drain_puts(note, strlen(note));
+		drain_puts(buf, n);
+	}
+
+	if (locked) {
+		spin_unlock(&printk_drain_lock);
+	}
+}
+
+unsigned long printk_dropped(void) {
+	unsigned long dropped = 0;
+	unsigned int cpu;
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		dropped += cpudata_cpu_ptr(cpu, &printk_ring)->dropped;
+	}
+
+	return dropped;
+}
+
+static void *printk_drain_run(void *arg) {
+	char buf[MSG_MAX];
+	char note[48];
+	int n;
+
+	while (1) {
+		spin_lock(&printk_drain_lock);
+		n = printk_drain_one(buf, note, sizeof(note));
+		spin_unlock(&printk_drain_lock);
+
+		if (n < 0) {
+			WAITQ_WAIT(&printk_drain_wq, !printk_rings_empty());
+			continue;
+		}
+
+		/* Put out with the lock released, the thread stays preemptible */
+		drain_puts(note, strlen(note));
+		drain_puts(buf, n);
+	}
+
+	return NULL;
+}
+
+static void printk_wakeup_handler(struct sys_timer *timer, void *param) {
+	if (printk_pending) {
+		printk_pending = 0;
+		waitq_wakeup_all(&printk_drain_wq);
+	}
+}
+
+static int printk_drain_init(void) {
+	struct thread *t;
+	int err;
+
+	err = timer_init_start_msec(&printk_wakeup_timer, TIMER_PERIODIC,
+			WAKEUP_PERIOD, printk_wakeup_handler, NULL);
+	if (err) {
+		return err;
+	}
+
+	t = thread_create(THREAD_FLAG_SUSPENDED, printk_drain_run, NULL);
+	if (ptr2err(t)) {
+		return ptr2err(t);
+	}
+
+	schedee_priority_set(&t->schedee, DRAIN_PRIO);
+	printk_deferred = 1;
+	thread_launch(t);
+
+	return 0;
+}
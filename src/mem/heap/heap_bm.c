@@ -358,7 +358,32 @@ void bm_init(void *heap, size_t size) {
 	mark_block(block);
 }
 
+size_t bm_block_size(void *ptr) {
+	struct free_block *block;
+
+	block = (struct free_block *) ((uintptr_t *) ptr - 1);
+
+	return get_clear_size(block->size) - sizeof(block->size);
+}
+
 int bm_heap_is_empty(void *heap) {
 	struct heap_desc *heap_desc = (struct heap_desc *) heap;
 	return heap_desc->count == 0;
 }
+
+void bm_free_stats(void *heap, size_t *free_bytes, size_t *largest) {
+	struct free_block_link *free_blocks_list, *link;
+	struct free_block *block;
+	size_t size;
+
+	free_blocks_list = heap_get_free_blocks(heap);
+	for (link = free_blocks_list->next; link != free_blocks_list;
+			link = link->next) {
+		block = (struct free_block *) ((uintptr_t *) link - 1);
+		size = get_clear_size(block->size) - sizeof(block->size);
+		*free_bytes += size;
+		if (size > *largest) {
+			*largest = size;
+		}
+	}
+}
@@ -0,0 +1,559 @@
+/**
+ * @file
+ * @brief Two-Level Segregated Fit memory allocator
+ *
+ * @details
+ *    Free blocks are kept in FL_COUNT x SL_COUNT segregated lists. The first
+ *    level splits sizes by powers of two, the second level splits every power
+ *    of two range linearly. Two levels of bitmaps record which lists are not
+ *    empty, so a fitting list is found with two find-first-set operations and
+ *    neither malloc nor free walks a list.
+ *
+ *    Block structure:
+ *    |prev_phys|size and flags|*** payload ***|
+ *    prev_phys is kept in the last word of the previous block and is only
+ *    valid while that block is free.
+ *
+ *    Pool structure:
+ *    |first block ... |sentinel block of zero size|
+ *
+ * @date 19.10.2026
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <lib/libds/bit.h>
+#include <kernel/printk.h>
+#include <mem/heap_afterfree.h>
+#include <mem/heap_tlsf.h>
+
+#define ALIGN_LOG2        3
+#define SL_COUNT_LOG2     4
+#define SL_COUNT          (1 << SL_COUNT_LOG2)
+#define FL_SHIFT          (SL_COUNT_LOG2 + ALIGN_LOG2)
+#define FL_MAX            30
+#define FL_COUNT          (FL_MAX - FL_SHIFT + 1)
+#define SMALL_BLOCK_SIZE  (1 << FL_SHIFT)
+
+#define align_up(x, a)    (((x) + ((a) - 1)) & ~((a) - 1))
+#define align_down(x, a)  ((x) & ~((a) - 1))
+
+struct tlsf_block {
+	/* Last word of the previous block, valid only if it is free */
+	struct tlsf_block *prev_phys;
+	/* Payload size and BLOCK_* flags, padded to keep payload aligned */
+	union {
+		size_t size;
+		char size_pad[TLSF_ALIGN];
+	};
+	/* Free blocks only */
+	struct tlsf_block *next_free;
+	struct tlsf_block *prev_free;
+};
+
+#define BLOCK_FREE        0x1
+#define BLOCK_PREV_FREE   0x2
+
+#define BLOCK_OVERHEAD    TLSF_ALIGN
+#define BLOCK_START       offsetof(struct tlsf_block, next_free)
+/* Free block must hold its list links and next block's prev_phys */
+#define BLOCK_SIZE_MIN    align_up(3 * sizeof(void *), TLSF_ALIGN)
+#define BLOCK_SIZE_MAX    ((size_t) 1 << FL_MAX)
+#define GAP_MIN           (BLOCK_OVERHEAD + BLOCK_SIZE_MIN)
+
+struct tlsf_heap {
+	struct tlsf_block null_block;   /* terminates free lists */
+	unsigned long fl_bitmap;
+	unsigned long sl_bitmap[FL_COUNT];
+	struct tlsf_block *blocks[FL_COUNT][SL_COUNT];
+	int count;                      /* currently allocated blocks */
+};
+
+static inline size_t block_size(const struct tlsf_block *block) {
+	return block->size & ~(size_t) (BLOCK_FREE | BLOCK_PREV_FREE);
+}
+
+static inline void block_set_size(struct tlsf_block *block, size_t size) {
+	block->size = size | (block->size & (BLOCK_FREE | BLOCK_PREV_FREE));
+}
+
+static inline int block_is_last(const struct tlsf_block *block) {
+	return block_size(block) == 0;
+}
+
+static inline int block_is_free(const struct tlsf_block *block) {
+	return block->size & BLOCK_FREE;
+}
+
+static inline int block_is_prev_free(const struct tlsf_block *block) {
+	return block->size & BLOCK_PREV_FREE;
+}
+
+static inline void *block_to_ptr(const struct tlsf_block *block) {
+	return (char *) block + BLOCK_START;
+}
+
+static inline struct tlsf_block *block_from_ptr(const void *ptr) {
+	return (struct tlsf_block *) ((char *) ptr - BLOCK_START);
+}
+
+static inline struct tlsf_block *block_next(const struct tlsf_block *block) {
+	assert(!block_is_last(block));
+	return (struct tlsf_block *) ((char *) block_to_ptr(block) +
+			block_size(block) - sizeof(struct tlsf_block *));
+}
+
+static inline struct tlsf_block *block_link_next(struct tlsf_block *block) {
+	struct tlsf_block *next = block_next(block);
+
+	next->prev_phys = block;
+	return next;
+}
+
+static void block_mark_as_free(struct tlsf_block *block) {
+	struct tlsf_block *next = block_link_next(block);
+
+	next->size |= BLOCK_PREV_FREE;
+	block->size |= BLOCK_FREE;
+}
+
+static void block_mark_as_used(struct tlsf_block *block) {
+	struct tlsf_block *next = block_next(block);
+
+	next->size &= ~BLOCK_PREV_FREE;
+	block->size &= ~BLOCK_FREE;
+}
+
+static size_t adjust_request_size(size_t size) {
+	if (size == 0 || size >= BLOCK_SIZE_MAX) {
+		return 0;
+	}
+	size = align_up(size, TLSF_ALIGN);
+
+	return size < BLOCK_SIZE_MIN ? BLOCK_SIZE_MIN : size;
+}
+
+static void mapping_insert(size_t size, int *fl, int *sl) {
+	int f, s;
+
+	if (size < SMALL_BLOCK_SIZE) {
+		f = 0;
+		s = size / (SMALL_BLOCK_SIZE / SL_COUNT);
+	} else {
+		f = bit_fls(size) - 1;
+		s = (size >> (f - SL_COUNT_LOG2)) ^ SL_COUNT;
+		f -= FL_SHIFT - 1;
+	}
+
+	*fl = f;
+	*sl = s;
+}
+
+/* Round @c size up to the next list, so any block found there fits */
+static void mapping_search(size_t size, int *fl, int *sl) {
+	if (size >= SMALL_BLOCK_SIZE) {
+		size += ((size_t) 1 << (bit_fls(size) - 1 - SL_COUNT_LOG2)) - 1;
+	}
+	mapping_insert(size, fl, sl);
+}
+
+static struct tlsf_block *search_suitable_block(struct tlsf_heap *heap,
+		int *fl, int *sl) {
+	unsigned long sl_map, fl_map;
+	int f = *fl;
+
+	sl_map = heap->sl_bitmap[f] & (~0UL << *sl);
+	if (!sl_map) {
+		fl_map = heap->fl_bitmap & (~0UL << (f + 1));
+		if (!fl_map) {
+			return NULL;
+		}
+		f = bit_ctz(fl_map);
+		*fl = f;
+		sl_map = heap->sl_bitmap[f];
+	}
+	*sl = bit_ctz(sl_map);
+
+	return heap->blocks[f][*sl];
+}
+
+static void remove_free_block(struct tlsf_heap *heap, struct tlsf_block *block,
+		int fl, int sl) {
+	struct tlsf_block *prev = block->prev_free;
+	struct tlsf_block *next = block->next_free;
+
+	next->prev_free = prev;
+	prev->next_free = next;
+
+	if (heap->blocks[fl][sl] == block) {
+		heap->blocks[fl][sl] = next;
+		if (next == &heap->null_block) {
+			heap->sl_bitmap[fl] &= ~(1UL << sl);
+			if (!heap->sl_bitmap[fl]) {
+				heap->fl_bitmap &= ~(1UL << fl);
+			}
+		}
+	}
+}
+
+static void insert_free_block(struct tlsf_heap *heap, struct tlsf_block *block,
+		int fl, int sl) {
+	struct tlsf_block *current = heap->blocks[fl][sl];
+
+	block->next_free = current;
+	block->prev_free = &heap->null_block;
+	current->prev_free = block;
+
+	heap->blocks[fl][sl] = block;
+	heap->fl_bitmap |= 1UL << fl;
+	heap->sl_bitmap[fl] |= 1UL << sl;
+}
+
+static void block_remove(struct tlsf_heap *heap, struct tlsf_block *block) {
+	int fl, sl;
+
+	mapping_insert(block_size(block), &fl, &sl);
+	remove_free_block(heap, block, fl, sl);
+}
+
+static void block_insert(struct tlsf_heap *heap, struct tlsf_block *block) {
+	int fl, sl;
+
+	mapping_insert(block_size(block), &fl, &sl);
+	insert_free_block(heap, block, fl, sl);
+}
+
+static int block_can_split(struct tlsf_block *block, size_t size) {
+	return block_size(block) >= size + BLOCK_OVERHEAD + BLOCK_SIZE_MIN;
+}
+
+/* Cut @c block to @c size and return the free remainder */
+static struct tlsf_block *block_split(struct tlsf_block *block, size_t size) {
+	struct tlsf_block *remaining;
+
+	remaining = (struct tlsf_block *) ((char *) block_to_ptr(block) +
+			size - sizeof(struct tlsf_block *));
+	remaining->size = block_size(block) - (size + BLOCK_OVERHEAD);
+	assert(block_size(remaining) >= BLOCK_SIZE_MIN);
+
+	block_set_size(block, size);
+	block_mark_as_free(remaining);
+
+	return remaining;
+}
+
+static struct tlsf_block *block_absorb(struct tlsf_block *prev,
+		struct tlsf_block *block) {
+	assert(!block_is_last(prev));
+	prev->size += block_size(block) + BLOCK_OVERHEAD;
+	block_link_next(prev);
+
+	return prev;
+}
+
+static struct tlsf_block *block_merge_prev(struct tlsf_heap *heap,
+		struct tlsf_block *block) {
+	struct tlsf_block *prev;
+
+	if (block_is_prev_free(block)) {
+		prev = block->prev_phys;
+		assert(block_is_free(prev));
+		block_remove(heap, prev);
+		block = block_absorb(prev, block);
+	}
+
+	return block;
+}
+
+static struct tlsf_block *block_merge_next(struct tlsf_heap *heap,
+		struct tlsf_block *block) {
+	struct tlsf_block *next = block_next(block);
+
+	if (block_is_free(next)) {
+		assert(!block_is_last(block));
+		block_remove(heap, next);
+		block = block_absorb(block, next);
+	}
+
+	return block;
+}
+
+static void block_trim_free(struct tlsf_heap *heap, struct tlsf_block *block,
+		size_t size) {
+	struct tlsf_block *remaining;
+
+	assert(block_is_free(block));
+	if (block_can_split(block, size)) {
+		remaining = block_split(block, size);
+		block_link_next(block);
+		remaining->size |= BLOCK_PREV_FREE;
+		block_insert(heap, remaining);
+	}
+}
+
+static void block_trim_used(struct tlsf_heap *heap, struct tlsf_block *block,
+		size_t size) {
+	struct tlsf_block *remaining;
+
+	assert(!block_is_free(block));
+	if (block_can_split(block, size)) {
+		remaining = block_split(block, size);
+		remaining->size &= ~BLOCK_PREV_FREE;
+		remaining = block_merge_next(heap, remaining);
+		block_insert(heap, remaining);
+	}
+}
+
+/* Give the first @c gap bytes of a free block back to the heap */
+static struct tlsf_block *block_trim_free_leading(struct tlsf_heap *heap,
+		struct tlsf_block *block, size_t gap) {
+	struct tlsf_block *remaining = block;
+
+	if (block_can_split(block, gap - BLOCK_OVERHEAD)) {
+		remaining = block_split(block, gap - BLOCK_OVERHEAD);
+		remaining->size |= BLOCK_PREV_FREE;
+		block_link_next(block);
+		block_insert(heap, block);
+	}
+
+	return remaining;
+}
+
+static struct tlsf_block *block_locate_free(struct tlsf_heap *heap, size_t size) {
+	struct tlsf_block *block;
+	int fl, sl;
+
+	if (!size) {
+		return NULL;
+	}
+
+	mapping_search(size, &fl, &sl);
+	if (fl >= FL_COUNT) {
+		return NULL;
+	}
+
+	block = search_suitable_block(heap, &fl, &sl);
+	if (!block || block == &heap->null_block) {
+		return NULL;
+	}
+	assert(block_size(block) >= size);
+	remove_free_block(heap, block, fl, sl);
+
+	return block;
+}
+
+static void *block_prepare_used(struct tlsf_heap *heap,
+		struct tlsf_block *block, size_t size) {
+	if (!block) {
+		return NULL;
+	}
+
+	block_trim_free(heap, block, size);
+	block_mark_as_used(block);
+	heap->count++;
+
+	return block_to_ptr(block);
+}
+
+size_t tlsf_control_size(void) {
+	return align_up(sizeof(struct tlsf_heap), TLSF_ALIGN);
+}
+
+size_t tlsf_pool_size(size_t boundary, size_t size) {
+	size_t adjust = adjust_request_size(size);
+
+	if (boundary > TLSF_ALIGN) {
+		adjust = adjust_request_size(adjust + boundary + GAP_MIN);
+	}
+	/* Search rounds up to the next second level list */
+	adjust += adjust >> SL_COUNT_LOG2;
+
+	return align_up(adjust, TLSF_ALIGN) + BLOCK_SIZE_MIN + 2 * BLOCK_OVERHEAD;
+}
+
+void tlsf_add_pool(void *heap, void *mem, size_t size) {
+	struct tlsf_block *block, *next;
+	size_t pool_bytes;
+
+	assert(((uintptr_t) mem & (TLSF_ALIGN - 1)) == 0);
+	assert(size >= BLOCK_SIZE_MIN + 2 * BLOCK_OVERHEAD);
+
+	pool_bytes = align_down(size - 2 * BLOCK_OVERHEAD, TLSF_ALIGN);
+	if (pool_bytes >= BLOCK_SIZE_MAX) {
+		pool_bytes = BLOCK_SIZE_MAX - TLSF_ALIGN;
+	}
+
+	/* prev_phys of the first block lies before the pool and is never used */
+	block = (struct tlsf_block *) ((char *) mem - sizeof(struct tlsf_block *));
+	block->size = pool_bytes | BLOCK_FREE;
+	block_insert(heap, block);
+
+	next = block_link_next(block);
+	next->size = BLOCK_PREV_FREE;
+}
+
+int tlsf_pool_is_free(void *mem) {
+	struct tlsf_block *block;
+
+	block = (struct tlsf_block *) ((char *) mem - sizeof(struct tlsf_block *));
+
+	return block_is_free(block) && block_is_last(block_next(block));
+}
+
+void tlsf_remove_pool(void *heap, void *mem) {
+	struct tlsf_block *block;
+
+	assert(tlsf_pool_is_free(mem));
+
+	block = (struct tlsf_block *) ((char *) mem - sizeof(struct tlsf_block *));
+	block_remove(heap, block);
+}
+
+void tlsf_init(void *heap, size_t size) {
+	struct tlsf_heap *tlsf = heap;
+	int i, j;
+
+	tlsf->null_block.next_free = &tlsf->null_block;
+	tlsf->null_block.prev_free = &tlsf->null_block;
+	tlsf->fl_bitmap = 0;
+	for (i = 0; i < FL_COUNT; i++) {
+		tlsf->sl_bitmap[i] = 0;
+		for (j = 0; j < SL_COUNT; j++) {
+			tlsf->blocks[i][j] = &tlsf->null_block;
+		}
+	}
+	tlsf->count = 0;
+
+	if (size >= tlsf_control_size() + BLOCK_SIZE_MIN + 2 * BLOCK_OVERHEAD) {
+		tlsf_add_pool(heap, (char *) heap + tlsf_control_size(),
+				size - tlsf_control_size());
+	}
+}
+
+void *tlsf_memalign(void *heap, size_t boundary, size_t size) {
+	struct tlsf_block *block;
+	size_t adjust, aligned_size, gap;
+	uintptr_t ptr, aligned;
+
+	adjust = adjust_request_size(size);
+	if (boundary <= TLSF_ALIGN) {
+		return block_prepare_used(heap, block_locate_free(heap, adjust), adjust);
+	}
+	assert((boundary & (boundary - 1)) == 0);
+
+	/* Ask for enough to cut off a leading free block of at least GAP_MIN */
+	aligned_size = adjust ? adjust_request_size(adjust + boundary + GAP_MIN) : 0;
+
+	block = block_locate_free(heap, aligned_size);
+	if (block) {
+		ptr = (uintptr_t) block_to_ptr(block);
+		aligned = align_up(ptr, boundary);
+		gap = aligned - ptr;
+
+		if (gap && gap < GAP_MIN) {
+			aligned = align_up(ptr + GAP_MIN, boundary);
+			gap = aligned - ptr;
+		}
+		if (gap) {
+			block = block_trim_free_leading(heap, block, gap);
+		}
+	}
+
+	return block_prepare_used(heap, block, adjust);
+}
+
+void tlsf_free(void *heap, void *ptr) {
+	struct tlsf_heap *tlsf = heap;
+	struct tlsf_block *block;
+
+	assert(ptr);
+
+	block = block_from_ptr(ptr);
+	if (block_is_free(block)) {
+		printk("***** free(): the block not busy\n");
+		return; /* if we try to free block more than once */
+	}
+
+	tlsf->count--;
+
+	afterfree(ptr, block_size(block));
+
+	block_mark_as_free(block);
+	block = block_merge_prev(heap, block);
+	block = block_merge_next(heap, block);
+	block_insert(heap, block);
+}
+
+void *tlsf_realloc(void *heap, void *ptr, size_t size) {
+	struct tlsf_block *block, *next;
+	size_t cur_size, combined, adjust;
+	void *p;
+
+	if (ptr && size == 0) {
+		tlsf_free(heap, ptr);
+		return NULL;
+	}
+	if (!ptr) {
+		return tlsf_memalign(heap, TLSF_ALIGN, size);
+	}
+
+	block = block_from_ptr(ptr);
+	next = block_next(block);
+	cur_size = block_size(block);
+	combined = cur_size + block_size(next) + BLOCK_OVERHEAD;
+	adjust = adjust_request_size(size);
+	if (!adjust) {
+		return NULL;
+	}
+
+	if (adjust > cur_size && (!block_is_free(next) || adjust > combined)) {
+		p = tlsf_memalign(heap, TLSF_ALIGN, size);
+		if (p) {
+			memcpy(p, ptr, cur_size < size ? cur_size : size);
+			tlsf_free(heap, ptr);
+		}
+		return p;
+	}
+
+	if (adjust > cur_size) {
+		block_merge_next(heap, block);
+		block_mark_as_used(block);
+	}
+	block_trim_used(heap, block, adjust);
+
+	return ptr;
+}
+
+size_t tlsf_block_size(void *ptr) {
+	return block_size(block_from_ptr(ptr));
+}
+
+int tlsf_heap_is_empty(void *heap) {
+	struct tlsf_heap *tlsf = heap;
+
+	return tlsf->count == 0;
+}
+
+void tlsf_free_stats(void *heap, size_t *free_bytes, size_t *largest) {
+	struct tlsf_heap *tlsf = heap;
+	struct tlsf_block *block;
+	int fl, sl;
+
+	for (fl = 0; fl < FL_COUNT; fl++) {
+		if (!(tlsf->fl_bitmap & (1UL << fl))) {
+			continue;
+		}
+		for (sl = 0; sl < SL_COUNT; sl++) {
+			for (block = tlsf->blocks[fl][sl]; block != &tlsf->null_block;
+					block = block->next_free) {
+				*free_bytes += block_size(block);
+				if (block_size(block) > *largest) {
+					*largest = block_size(block);
+				}
+			}
+		}
+	}
+}
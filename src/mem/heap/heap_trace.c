@@ -0,0 +1,291 @@
+/**
+ * @file
+ * @brief Heap allocation tracing with call site attribution
+ * @details
+ *    Every traced block is kept in an open addressing table keyed by its
+ *    address together with the requested size, the allocation time and
+ *    the call site. A call site is the few innermost return addresses
+ *    above the allocator, sites are kept in a second table which only
+ *    grows until a reset.
+ *
+ *    With sample_period N above one only one of N allocations is traced.
+ *    Frees still look their block up, which takes a probe or two as the
+ *    table is kept at most three quarters full.
+ *
+ * @date 19.10.2026
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <execinfo.h>
+#include <hal/clock.h>
+#include <framework/mod/options.h>
+#include <kernel/spinlock.h>
+
+#include <mem/heap_trace.h>
+#include <mem/heap/mspace_malloc.h>
+
+#define SITES_MAX    OPTION_GET(NUMBER, max_sites)
+#define BLOCKS_MAX   OPTION_GET(NUMBER, max_blocks)
+#define BLOCKS_LIMIT (BLOCKS_MAX / 4 * 3)
+#define BT_MAX       16
+
+static_assert(SITES_MAX <= 0x10000, "site index must fit in 16 bits");
+
+struct heap_trace_block {
+	void *ptr;                  /* NULL if the entry is empty */
+	uint32_t size;
+	uint32_t slack;
+	clock_t stamp;
+	uint16_t site;
+};
+
+static struct heap_trace_site trace_sites[SITES_MAX];
+static struct heap_trace_block trace_blocks[BLOCKS_MAX];
+static unsigned int trace_sites_n;
+static unsigned int trace_blocks_n;
+static unsigned long trace_dropped;
+
+static int trace_enabled = OPTION_GET(BOOLEAN, enabled);
+static unsigned int trace_period = OPTION_GET(NUMBER, sample_period);
+static unsigned int trace_count;
+
+static spinlock_t trace_lock = SPIN_STATIC_UNLOCKED;
+
+static inline unsigned int hash_ptr(void *ptr) {
+	return (((uintptr_t) ptr >> 3) * 2654435761u) % BLOCKS_MAX;
+}
+
+static unsigned int hash_pcs(void *const *pc) {
+	uintptr_t h = 0;
+	int i;
+
+	for (i = 0; i < HEAP_TRACE_DEPTH && pc[i]; i++) {
+		h = (h ^ (uintptr_t) pc[i]) * 2654435761u;
+	}
+
+	return h % SITES_MAX;
+}
+
+/* Fills @c pc with the return addresses starting from @c caller */
+static void site_capture(void **pc, void *caller) {
+	void *bt[BT_MAX];
+	int n, i, j;
+
+	memset(pc, 0, HEAP_TRACE_DEPTH * sizeof(*pc));
+
+	n = backtrace(bt, BT_MAX);
+	for (i = 0; i < n; i++) {
+		if (bt[i] == caller) {
+			break;
+		}
+	}
+
+	if (i == n) {
+		/* Frames are not walkable here, the direct caller is still known */
+		pc[0] = caller;
+		return;
+	}
+
+	for (j = 0; j < HEAP_TRACE_DEPTH && i < n; j++, i++) {
+		pc[j] = bt[i];
+	}
+}
+
+/* Called with trace_lock held, returns -1 if the table is full */
+static int site_get(void *const *pc) {
+	unsigned int i, n;
+
+	i = hash_pcs(pc);
+	for (n = 0; n < SITES_MAX; n++, i = (i + 1) % SITES_MAX) {
+		if (!trace_sites[i].pc[0]) {
+			memcpy(trace_sites[i].pc, pc, sizeof(trace_sites[i].pc));
+			trace_sites_n++;
+			return i;
+		}
+		if (!memcmp(trace_sites[i].pc, pc, sizeof(trace_sites[i].pc))) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/* Called with trace_lock held */
+static int block_find(void *ptr) {
+	unsigned int i;
+
+	for (i = hash_ptr(ptr); trace_blocks[i].ptr; i = (i + 1) % BLOCKS_MAX) {
+		if (trace_blocks[i].ptr == ptr) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/* Called with trace_lock held. Entries after the removed one are shifted
+ * back unless it would move them before their home slot */
+static void block_remove(unsigned int i) {
+	unsigned int j, k;
+
+	for (j = i;;) {
+		j = (j + 1) % BLOCKS_MAX;
+		if (!trace_blocks[j].ptr) {
+			break;
+		}
+		k = hash_ptr(trace_blocks[j].ptr);
+		if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) {
+			continue;
+		}
+		trace_blocks[i] = trace_blocks[j];
+		i = j;
+	}
+
+	trace_blocks[i].ptr = NULL;
+	trace_blocks_n--;
+}
+
+void heap_trace_alloc(void *ptr, size_t size, void *caller) {
+	struct heap_trace_site *site;
+	void *pc[HEAP_TRACE_DEPTH];
+	unsigned int i;
+	ipl_t ipl;
+	int s;
+
+	if (!trace_enabled || !ptr) {
+		return;
+	}
+	if (trace_period > 1
+			&& __sync_fetch_and_add(&trace_count, 1) % trace_period) {
+		return;
+	}
+
+	site_capture(pc, caller);
+
+	ipl = spin_lock_ipl(&trace_lock);
+
+	s = -1;
+	if (trace_blocks_n < BLOCKS_LIMIT) {
+		s = site_get(pc);
+	}
+	if (s < 0) {
+		trace_dropped++;
+		spin_unlock_ipl(&trace_lock, ipl);
+		return;
+	}
+
+	i = hash_ptr(ptr);
+	while (trace_blocks[i].ptr) {
+		i = (i + 1) % BLOCKS_MAX;
+	}
+	trace_blocks[i].ptr = ptr;
+	trace_blocks[i].size = size;
+	trace_blocks[i].slack = mspace_block_size(ptr) - size;
+	trace_blocks[i].site = s;
+	trace_blocks[i].stamp = clock_sys_ticks();
+	trace_blocks_n++;
+
+	site = &trace_sites[s];
+	site->allocs++;
+	site->alloc_bytes += size;
+	site->live_bytes += size;
+	site->live_slack += trace_blocks[i].slack;
+	site->live_blocks++;
+
+	spin_unlock_ipl(&trace_lock, ipl);
+}
+
+void heap_trace_free(void *ptr) {
+	struct heap_trace_site *site;
+	struct heap_trace_block *b;
+	ipl_t ipl;
+	int i;
+
+	if (!ptr || !trace_blocks_n) {
+		return;
+	}
+
+	ipl = spin_lock_ipl(&trace_lock);
+
+	i = block_find(ptr);
+	if (i >= 0) {
+		b = &trace_blocks[i];
+		site = &trace_sites[b->site];
+		site->frees++;
+		site->live_bytes -= b->size;
+		site->live_slack -= b->slack;
+		site->live_blocks--;
+
+		block_remove(i);
+	}
+
+	spin_unlock_ipl(&trace_lock, ipl);
+}
+
+void heap_trace_enable(int enable) {
+	trace_enabled = enable;
+}
+
+void heap_trace_set_period(unsigned int period) {
+	trace_period = period ? period : 1;
+}
+
+void heap_trace_reset(void) {
+	ipl_t ipl;
+
+	ipl = spin_lock_ipl(&trace_lock);
+
+	memset(trace_sites, 0, sizeof(trace_sites));
+	memset(trace_blocks, 0, sizeof(trace_blocks));
+	trace_sites_n = 0;
+	trace_blocks_n = 0;
+	trace_dropped = 0;
+
+	spin_unlock_ipl(&trace_lock, ipl);
+}
+
+void heap_trace_stats(struct heap_trace_stats *st) {
+	st->enabled = trace_enabled;
+	st->sample_period = trace_period;
+	st->sites = trace_sites_n;
+	st->live_blocks = trace_blocks_n;
+	st->dropped = trace_dropped;
+}
+
+int heap_trace_sites(struct heap_trace_site *sites, int max) {
+	struct heap_trace_block *b;
+	clock_t now;
+	ipl_t ipl;
+	int i, n;
+
+	now = clock_sys_ticks();
+
+	ipl = spin_lock_ipl(&trace_lock);
+
+	for (i = 0; i < SITES_MAX; i++) {
+		trace_sites[i].oldest = now;
+	}
+	for (i = 0; i < BLOCKS_MAX; i++) {
+		b = &trace_blocks[i];
+		if (b->ptr && b->stamp < trace_sites[b->site].oldest) {
+			trace_sites[b->site].oldest = b->stamp;
+		}
+	}
+
+	for (i = 0, n = 0; i < SITES_MAX; i++) {
+		if (!trace_sites[i].pc[0]) {
+			continue;
+		}
+		if (n < max) {
+			sites[n] = trace_sites[i];
+		}
+		n++;
+	}
+
+	spin_unlock_ipl(&trace_lock, ipl);
+
+	return n;
+}
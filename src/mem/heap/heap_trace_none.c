@@ -0,0 +1,33 @@
+/**
+ * @file
+ * @brief Heap allocation tracing is off
+ *
+ * @date 19.10.2026
+ */
+
+#include <string.h>
+
+#include <mem/heap_trace.h>
+
+void heap_trace_alloc(void *ptr, size_t size, void *caller) {
+}
+
+void heap_trace_free(void *ptr) {
+}
+
+void heap_trace_enable(int enable) {
+}
+
+void heap_trace_set_period(unsigned int period) {
+}
+
+void heap_trace_reset(void) {
+}
+
+void heap_trace_stats(struct heap_trace_stats *st) {
+	memset(st, 0, sizeof(*st));
+}
+
+int heap_trace_sites(struct heap_trace_site *sites, int max) {
+	return 0;
+}
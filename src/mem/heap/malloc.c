@@ -7,6 +7,8 @@
  */
 
 #include <errno.h>
+#include <stdint.h>
+#include <string.h>
 #include <util/err.h>
 #include <unistd.h>
 #include <lib/libds/dlist.h>
@@ -14,9 +16,24 @@
 #include <kernel/task.h>
 #include <kernel/task/kernel_task.h>
 #include <kernel/task/resource/task_heap.h>
+#include <kernel/kcounter.h>
 #include <kernel/printk.h>
+#include <mem/heap_trace.h>
 
 #include "mspace_malloc.h"
+#include "malloc_cache.h"
+
+KCOUNTER_DEF(heap_alloc, "heap.alloc");
+KCOUNTER_DEF(heap_free, "heap.free");
+KCOUNTER_DEF(heap_fail, "heap.fail");
+
+static inline void heap_count_alloc(void *ptr) {
+	if (ptr) {
+		kcounter_inc(heap_alloc);
+	} else {
+		kcounter_inc(heap_fail);
+	}
+}
 
 static struct dlist_head *task_self_mspace(void) {
 	struct task_heap *task_heap;
@@ -33,18 +50,23 @@ static struct dlist_head *kernel_task_mspace(void) {
 }
 
 void *memalign(size_t boundary, size_t size) {
-	return mspace_memalign(boundary, size, task_self_mspace());
+	void *ptr;
+
+	ptr = mspace_memalign(boundary, size, task_self_mspace());
+	heap_count_alloc(ptr);
+	heap_trace_alloc(ptr, size, __builtin_return_address(0));
+
+	return ptr;
 }
 
-void *malloc(size_t size) {
+static void *task_malloc(size_t size) {
 	void *ptr;
 
-	if (size == 0) {
-		return NULL;
+	ptr = malloc_cache_alloc(size, task_self_mspace());
+	if (ptr == NULL) {
+		ptr = mspace_malloc(size, task_self_mspace());
 	}
 
-	ptr = mspace_malloc(size, task_self_mspace());
-
 	if (ptr == NULL) {
 		SET_ERRNO(ENOMEM);
 	}
@@ -52,9 +74,28 @@ void *malloc(size_t size) {
 	return ptr;
 }
 
+void *malloc(size_t size) {
+	void *ptr;
+
+	if (size == 0) {
+		return NULL;
+	}
+
+	ptr = task_malloc(size);
+	heap_count_alloc(ptr);
+	heap_trace_alloc(ptr, size, __builtin_return_address(0));
+
+	return ptr;
+}
+
 void free(void *ptr) {
 	if (ptr == NULL)
 		return;
+	kcounter_inc(heap_free);
+	heap_trace_free(ptr);
+	if (0 == malloc_cache_free(ptr, task_self_mspace())) {
+		return;
+	}
 	/* XXX this workaround for such situation:
 	 * module ConstructionGlobal invokes constructors inside kernel task for all applications,
 	 * and call malloc. After a while Qt application call realloc() on some memory previously
@@ -71,11 +112,16 @@ void *realloc(void *ptr, size_t size) {
 	void *ret;
 
 	if (size == 0 && ptr != NULL) {
+		kcounter_inc(heap_free);
+		heap_trace_free(ptr);
 		mspace_free(ptr, task_self_mspace());
 		return NULL; /* ok */
 	}
 	if (ptr == NULL) {
-		return malloc(size);
+		ret = task_malloc(size);
+		heap_count_alloc(ret);
+		heap_trace_alloc(ret, size, __builtin_return_address(0));
+		return ret;
 	}
 	/* XXX same as in free() above */
 	if (0 > ptr2err(ret = mspace_realloc(ptr, size, task_self_mspace()))) {
@@ -84,14 +130,42 @@ void *realloc(void *ptr, size_t size) {
 			assert(0);
 		}
 	}
+	if (ret == NULL) {
+		/* The old block stays allocated and traced */
+		kcounter_inc(heap_fail);
+		SET_ERRNO(ENOMEM);
+		return NULL;
+	}
+	kcounter_inc(heap_free);
+	heap_trace_free(ptr);
+	heap_count_alloc(ret);
+	heap_trace_alloc(ret, size, __builtin_return_address(0));
 
 	return ret;
 }
 
 void *calloc(size_t nmemb, size_t size) {
+	void *ptr;
+
 	if (nmemb == 0 || size == 0)
 		return NULL; /* ok */
-	return mspace_calloc(nmemb, size, task_self_mspace());
+
+	if (nmemb > SIZE_MAX / size) {
+		kcounter_inc(heap_fail);
+		SET_ERRNO(ENOMEM);
+		return NULL;
+	}
+
+	ptr = malloc_cache_alloc(nmemb * size, task_self_mspace());
+	if (ptr != NULL) {
+		memset(ptr, 0, nmemb * size);
+	} else {
+		ptr = mspace_calloc(nmemb, size, task_self_mspace());
+	}
+	heap_count_alloc(ptr);
+	heap_trace_alloc(ptr, nmemb * size, __builtin_return_address(0));
+
+	return ptr;
 }
 
 int posix_memalign(void **memptr, size_t alignment, size_t size) {
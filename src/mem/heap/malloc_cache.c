@@ -0,0 +1,211 @@
+/**
+ * @file
+ * @brief Per-CPU caches of small blocks in front of the task heap
+ * @details
+ *    Every task has a cache per CPU with a stack of free blocks for each
+ *    power of two size class. A cache is touched only by the CPU it
+ *    belongs to with preemption disabled, so hits take no lock. Misses
+ *    refill half a stack from the heap taking the heap lock once, and a
+ *    full stack flushes its older half back the same way.
+ *
+ *    Cached blocks stay allocated in the task heap, so they go away with
+ *    the task's heap segments when the task exits. For the same reason
+ *    heap statistics count them as used, see malloc_cache_bytes().
+ *
+ * @date 19.10.2026
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include <hal/cpu.h>
+#include <framework/mod/options.h>
+#include <kernel/sched/sched_lock.h>
+#include <kernel/task.h>
+#include <kernel/task/resource.h>
+
+#include <mem/heap/mspace_malloc.h>
+#include "malloc_cache.h"
+
+#define CACHE_DEPTH      OPTION_GET(NUMBER, cache_depth)
+#define CACHE_BATCH      (CACHE_DEPTH / 2)
+#define CLASS_MIN_SHIFT  4    /* 16 bytes */
+#define CLASS_COUNT      7    /* up to 1024 bytes */
+#define CLASS_SIZE(c)    ((size_t) 1 << (CLASS_MIN_SHIFT + (c)))
+
+#if CACHE_DEPTH
+
+struct malloc_bin {
+	int count;
+	void *blocks[CACHE_DEPTH];
+};
+
+struct malloc_cpu_cache {
+	struct malloc_bin bins[CLASS_COUNT];
+};
+
+struct task_malloc_cache {
+	struct malloc_cpu_cache cpu[NCPU];
+};
+
+TASK_RESOURCE_DEF(task_malloc_cache_desc, struct task_malloc_cache);
+
+static size_t task_malloc_cache_offset;
+
+static void task_malloc_cache_init(const struct task *task, void *cache) {
+	memset(cache, 0, sizeof(struct task_malloc_cache));
+}
+
+static const struct task_resource_desc task_malloc_cache_desc = {
+	.init = task_malloc_cache_init,
+	.resource_size = sizeof(struct task_malloc_cache),
+	.resource_offset = &task_malloc_cache_offset
+};
+
+/* Called with preemption disabled */
+static struct malloc_bin *malloc_bin_get(int c) {
+	struct task_malloc_cache *cache;
+
+	cache = (void *) task_self()->resources + task_malloc_cache_offset;
+
+	return &cache->cpu[cpu_get_id()].bins[c];
+}
+
+/* Smallest class which fits @c size */
+static int class_of_request(size_t size) {
+	int c;
+
+	for (c = 0; c < CLASS_COUNT; c++) {
+		if (size <= CLASS_SIZE(c)) {
+			return c;
+		}
+	}
+
+	return -1;
+}
+
+/* Largest class a block of @c size can serve, not too wasteful */
+static int class_of_block(size_t size) {
+	int c;
+
+	if (size < CLASS_SIZE(0) || size >= 2 * CLASS_SIZE(CLASS_COUNT - 1)) {
+		return -1;
+	}
+
+	for (c = CLASS_COUNT - 1; c > 0; c--) {
+		if (size >= CLASS_SIZE(c)) {
+			break;
+		}
+	}
+
+	return c;
+}
+
+void *malloc_cache_alloc(size_t size, struct dlist_head *mspace) {
+	void *batch[CACHE_BATCH];
+	struct malloc_bin *bin;
+	void *ptr = NULL;
+	int c, n, i;
+
+	c = class_of_request(size);
+	if (c < 0) {
+		return NULL;
+	}
+
+	sched_lock();
+	bin = malloc_bin_get(c);
+	if (bin->count) {
+		ptr = bin->blocks[--bin->count];
+	}
+	sched_unlock();
+
+	if (ptr) {
+		return ptr;
+	}
+
+	n = mspace_alloc_batch(CLASS_SIZE(c), batch, CACHE_BATCH, mspace);
+	if (!n) {
+		return NULL;
+	}
+
+	/* We might have moved to another CPU, take its bin */
+	sched_lock();
+	bin = malloc_bin_get(c);
+	for (i = 1; i < n && bin->count < CACHE_DEPTH; i++) {
+		bin->blocks[bin->count++] = batch[i];
+	}
+	sched_unlock();
+
+	if (i < n) {
+		mspace_free_batch(&batch[i], n - i, mspace);
+	}
+
+	return batch[0];
+}
+
+size_t malloc_cache_bytes(const struct task *task) {
+	struct task_malloc_cache *cache;
+	size_t bytes = 0;
+	int cpu, c;
+
+	cache = (void *) task->resources + task_malloc_cache_offset;
+
+	/* Bins of other CPUs change under us, this is a snapshot */
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		for (c = 0; c < CLASS_COUNT; c++) {
+			bytes += cache->cpu[cpu].bins[c].count * CLASS_SIZE(c);
+		}
+	}
+
+	return bytes;
+}
+
+int malloc_cache_free(void *ptr, struct dlist_head *mspace) {
+	void *batch[CACHE_BATCH];
+	struct malloc_bin *bin;
+	int c, n = 0;
+
+	if (!mspace_owns(ptr, mspace)) {
+		return -1;
+	}
+
+	c = class_of_block(mspace_block_size(ptr));
+	if (c < 0) {
+		return -1;
+	}
+
+	sched_lock();
+	bin = malloc_bin_get(c);
+	if (bin->count == CACHE_DEPTH) {
+		/* Flush the older half, recently freed blocks are still hot */
+		n = CACHE_BATCH;
+		memcpy(batch, bin->blocks, n * sizeof(void *));
+		memmove(bin->blocks, bin->blocks + n,
+				(CACHE_DEPTH - n) * sizeof(void *));
+		bin->count -= n;
+	}
+	bin->blocks[bin->count++] = ptr;
+	sched_unlock();
+
+	if (n) {
+		mspace_free_batch(batch, n, mspace);
+	}
+
+	return 0;
+}
+
+#else /* !CACHE_DEPTH */
+
+void *malloc_cache_alloc(size_t size, struct dlist_head *mspace) {
+	return NULL;
+}
+
+int malloc_cache_free(void *ptr, struct dlist_head *mspace) {
+	return -1;
+}
+
+size_t malloc_cache_bytes(const struct task *task) {
+	return 0;
+}
+
+#endif /* CACHE_DEPTH */
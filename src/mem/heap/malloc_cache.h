@@ -0,0 +1,36 @@
+/**
+ * @file
+ * @brief Per-CPU caches of small blocks in front of the task heap
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef MEM_HEAP_MALLOC_CACHE_H_
+#define MEM_HEAP_MALLOC_CACHE_H_
+
+#include <stddef.h>
+
+struct dlist_head;
+struct task;
+
+/**
+ * Takes a block of at least @a size bytes from the cache of the current CPU,
+ * refilling it from @a mspace. Returns NULL if @a size is not cached or the
+ * heap is exhausted.
+ */
+extern void *malloc_cache_alloc(size_t size, struct dlist_head *mspace);
+
+/**
+ * Puts @a ptr to the cache of the current CPU. Returns -1 if @a ptr does not
+ * belong to @a mspace or is too large to be cached.
+ */
+extern int malloc_cache_free(void *ptr, struct dlist_head *mspace);
+
+/**
+ * Bytes held by the caches of @a task, at least the size classes of the
+ * cached blocks. The blocks are free for malloc() but allocated in the task
+ * heap, so mspace_stats() does not count them as free.
+ */
+extern size_t malloc_cache_bytes(const struct task *task);
+
+#endif /* MEM_HEAP_MALLOC_CACHE_H_ */
@@ -18,6 +18,23 @@ extern int   mspace_free(void *ptr, struct dlist_head *mspace);
 extern void *mspace_calloc(size_t nmemb, size_t size, struct dlist_head *mspace);
 extern void *mspace_realloc(void *ptr, size_t size, struct dlist_head *mspace);
 
+/* Allocate up to @c n blocks of @c size taking the heap lock once,
+ * returns number of blocks allocated */
+extern int   mspace_alloc_batch(size_t size, void **blocks, int n, struct dlist_head *mspace);
+extern void  mspace_free_batch(void **blocks, int n, struct dlist_head *mspace);
+/* Usable size of an allocated block, at least the requested size */
+extern size_t mspace_block_size(void *ptr);
+/* Block at @c ptr was allocated from @c mspace */
+extern int   mspace_owns(void *ptr, struct dlist_head *mspace);
+
+struct mspace_stats {
+	size_t total;         /* bytes taken from the page allocator */
+	size_t free;          /* bytes in free blocks */
+	size_t largest_free;  /* the largest free block */
+	int segments;
+};
+extern void  mspace_stats(struct dlist_head *mspace, struct mspace_stats *st);
+
 typedef enum heap_type {
 	HEAP_RAM = 0,
 	HEAP_FAST_RAM = 1,
@@ -0,0 +1,288 @@
+/**
+ * @file
+ * @brief Page-allocated segments backing task heaps
+ * @details Shared by all mspace implementations: segments come from the
+ *    heap page allocators and are linked into the task's mspace list.
+ *    Each page allocator has a map from its pages to the segments, so the
+ *    segment of a pointer is found without walking the list. The map is
+ *    allocated from the allocator itself when its first segment is mapped.
+ *
+ * @date 07.04.2014
+ * @author Alexander Kalmuk
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include <mem/page.h>
+#include <kernel/sched/sched_lock.h>
+#include <lib/libds/dlist.h>
+#include <lib/libds/array.h>
+#include <util/log.h>
+#include <util/member.h>
+
+#include <mem/heap/mspace_malloc.h>
+#include "mspace_segment.h"
+
+extern struct page_allocator *__heap_pgallocator;
+extern struct page_allocator *__heap_pgallocator2 __attribute__((weak));
+extern struct page_allocator *__heap_fixed_pgallocator __attribute__((weak));
+
+struct mm_heap_allocator {
+	struct page_allocator **pg_allocator;
+	heap_type_t type;
+};
+
+static struct mm_heap_allocator const mm_page_allocs[] = {
+	{ &__heap_pgallocator, HEAP_RAM },
+	{ &__heap_pgallocator2, HEAP_FAST_RAM },
+	{ &__heap_fixed_pgallocator, HEAP_EXTERN_MEM },
+};
+
+static struct mm_heap_allocator const *mm_cur_allocator =
+	&mm_page_allocs[0];
+
+/* Segment of every page of the corresponding allocator */
+static struct mm_segment **mm_page_map[ARRAY_SIZE(mm_page_allocs)];
+static int mm_page_map_failed[ARRAY_SIZE(mm_page_allocs)];
+
+static int mm_allocator_of(void *ptr) {
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(mm_page_allocs); i++) {
+		if (mm_page_allocs[i].pg_allocator && *mm_page_allocs[i].pg_allocator
+				&& page_belong(*mm_page_allocs[i].pg_allocator, ptr)) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static inline size_t mm_map_pages(struct page_allocator *allocator) {
+	return (allocator->pages_n * sizeof(struct mm_segment *)
+			+ allocator->page_size - 1) / allocator->page_size;
+}
+
+static inline size_t mm_page_index(struct page_allocator *allocator, void *ptr) {
+	return ((char *) ptr - (char *) allocator->pages_start) / allocator->page_size;
+}
+
+/* Called under sched_lock(), as all the page allocator calls */
+static struct mm_segment **mm_page_map_get(int i) {
+	struct page_allocator *allocator = *mm_page_allocs[i].pg_allocator;
+
+	if (!mm_page_map[i] && !mm_page_map_failed[i]) {
+		mm_page_map[i] = page_alloc_zero(allocator, mm_map_pages(allocator));
+		/* Without a map segments are looked up by walking the list */
+		mm_page_map_failed[i] = !mm_page_map[i];
+	}
+
+	return mm_page_map[i];
+}
+
+static void mm_page_map_set(void *segment, size_t size, struct mm_segment *mm) {
+	struct page_allocator *allocator;
+	struct mm_segment **map;
+	size_t first, last;
+	int i;
+
+	i = mm_allocator_of(segment);
+	if (i < 0 || !(map = mm_page_map_get(i))) {
+		return;
+	}
+
+	allocator = *mm_page_allocs[i].pg_allocator;
+	first = mm_page_index(allocator, segment);
+	last = mm_page_index(allocator, (char *) segment + size - 1);
+	for (; first <= last; first++) {
+		map[first] = mm;
+	}
+}
+
+void mm_segment_map(struct mm_segment *mm, struct dlist_head *mspace) {
+	mm->mspace = mspace;
+	sched_lock();
+	mm_page_map_set(mm, mm->size, mm);
+	sched_unlock();
+}
+
+struct mm_segment *mm_segment_find(void *ptr, struct dlist_head *mspace) {
+	struct page_allocator *allocator;
+	struct mm_segment *mm;
+	int i;
+
+	i = mm_allocator_of(ptr);
+	if (i >= 0 && mm_page_map[i]) {
+		allocator = *mm_page_allocs[i].pg_allocator;
+		mm = mm_page_map[i][mm_page_index(allocator, ptr)];
+
+		if (mm && mm->mspace == mspace && (char *) ptr > (char *) mm) {
+			return mm;
+		}
+		return NULL;
+	}
+
+	dlist_foreach_entry(mm, mspace, link) {
+		if ((char *) ptr > (char *) mm && (char *) ptr < (char *) mm + mm->size) {
+			return mm;
+		}
+	}
+
+	return NULL;
+}
+
+void *mm_segment_alloc(int page_cnt) {
+	void *ret;
+	int i;
+
+	ret = page_alloc(*mm_cur_allocator->pg_allocator, page_cnt);
+	if (ret) {
+		return ret;
+	}
+
+	/* Requsted memory wasn't allocated by mm_cur_allocator->pg_allocator above,
+	 * because due to there is no more free memory. Try find new allocator */
+	for (i = 0; i < ARRAY_SIZE(mm_page_allocs); i++) {
+		if (mm_page_allocs[i].pg_allocator
+				&& *mm_page_allocs[i].pg_allocator) {
+			ret = page_alloc(*mm_page_allocs[i].pg_allocator, page_cnt);
+			if (ret) {
+				mm_cur_allocator = &mm_page_allocs[i];
+				break;
+			}
+		}
+	}
+
+	return ret;
+}
+
+/* XXX This functionality is experimental and currently only used
+ * in PISJP (stm32f7-discovery). Please, be careful if you want to use
+ * this function. */
+int mspace_set_heap(heap_type_t type, heap_type_t *prev_type) {
+	if (prev_type) {
+		*prev_type = mm_cur_allocator->type;
+	}
+
+	switch (type) {
+	case HEAP_FAST_RAM:
+	case HEAP_RAM:
+	case HEAP_EXTERN_MEM:
+		if (!mm_page_allocs[type].pg_allocator) {
+			return -1;
+		}
+		mm_cur_allocator = &mm_page_allocs[type];
+		break;
+	default:
+		log_error("Unknown heap type - %d\n", type);
+		return -1;
+	}
+
+	return 0;
+}
+
+void mm_segment_free(void *segment, int page_cnt) {
+	int i;
+
+	sched_lock();
+	mm_page_map_set(segment, page_cnt * PAGE_SIZE(), NULL);
+	sched_unlock();
+
+	for (i = 0; i < ARRAY_SIZE(mm_page_allocs); i++) {
+		if (mm_page_allocs[i].pg_allocator &&
+				page_belong(*mm_page_allocs[i].pg_allocator, segment)) {
+			page_free(*mm_page_allocs[i].pg_allocator, segment, page_cnt);
+			break;
+		}
+	}
+}
+
+int mspace_owns(void *ptr, struct dlist_head *mspace) {
+	return mm_segment_find(ptr, mspace) != NULL;
+}
+
+int mspace_init(struct dlist_head *mspace) {
+	dlist_init(mspace);
+	return 0;
+}
+
+int mspace_fini(struct dlist_head *mspace) {
+	struct mm_segment *mm = NULL;
+
+	dlist_foreach_entry(mm, mspace, link) {
+		mm_segment_free(mm, mm->size / PAGE_SIZE());
+	}
+
+	return 0;
+}
+
+size_t mspace_deep_copy_size(struct dlist_head *mspace) {
+	struct mm_segment *mm = NULL;
+	size_t ret;
+
+	ret = 0;
+	dlist_foreach_entry(mm, mspace, link) {
+		ret += mm->size;
+	}
+	return ret;
+}
+
+
+void mspace_deep_store(struct dlist_head *mspace, struct dlist_head *store_space, void *buf) {
+	struct mm_segment *mm = NULL;
+	void *p;
+
+	dlist_init(store_space);
+
+	/* if mspace is empty list manipulation is illegal */
+	if (dlist_empty(mspace)) {
+		return;
+	}
+
+	dlist_del(mspace);
+	dlist_add_prev(store_space, mspace->next);
+
+	p = buf;
+	dlist_foreach_entry(mm, store_space, link) {
+		memcpy(p, mm, mm->size);
+		p += mm->size;
+	}
+
+	dlist_del(store_space);
+	dlist_add_prev(mspace, mspace->next);
+}
+
+void mspace_deep_restore(struct dlist_head *mspace, struct dlist_head *store_space, void *buf) {
+	struct dlist_head *raw_mm;
+	void *p;
+
+	assert(mspace);
+	assert(store_space);
+	assert(buf);
+
+	dlist_init(mspace);
+
+	p = buf;
+	raw_mm = store_space->next;
+
+	/* can't use foreach, since it stores next pointer in accumulator */
+	while (raw_mm != store_space) {
+		struct mm_segment *buf_mm, *mm;
+
+		buf_mm = p;
+
+		mm = member_cast_out(raw_mm, struct mm_segment, link);
+		memcpy(mm, buf_mm, buf_mm->size);
+		/* Segments may come from a copy of another task's heap */
+		mm_segment_map(mm, mspace);
+
+		p += buf_mm->size;
+		raw_mm = raw_mm->next;
+	}
+
+	if (!dlist_empty(store_space)) {
+		dlist_del(store_space);
+		dlist_add_prev(mspace, store_space->next);
+	}
+}
@@ -0,0 +1,28 @@
+/**
+ * @file
+ * @brief Page-allocated segments backing task heaps
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef MSPACE_SEGMENT_H_
+#define MSPACE_SEGMENT_H_
+
+#include <defines/size_t.h>
+#include <lib/libds/dlist.h>
+
+struct mm_segment {
+	struct dlist_head link;
+	size_t size;
+	struct dlist_head *mspace; /* owner */
+};
+
+extern void *mm_segment_alloc(int page_cnt);
+extern void mm_segment_free(void *segment, int page_cnt);
+
+/** Record @c mm, with its size set, as a segment of @c mspace */
+extern void mm_segment_map(struct mm_segment *mm, struct dlist_head *mspace);
+/** Segment of @c mspace containing @c ptr or NULL */
+extern struct mm_segment *mm_segment_find(void *ptr, struct dlist_head *mspace);
+
+#endif /* MSPACE_SEGMENT_H_ */
@@ -0,0 +1,343 @@
+/**
+ * @file
+ * @brief Task heaps on top of the TLSF allocator
+ * @details
+ *    All segments of a task heap are pools of a single TLSF heap, so an
+ *    allocation does not depend on the number of segments or on
+ *    fragmentation. The first segment also holds the heap control and the
+ *    per-heap lock, and lives until the task exits:
+ *    |struct mm_tlsf_home|tlsf control| *** pool *** |
+ *    Other segments are released as soon as they are completely free:
+ *    |struct mm_segment| *** pool *** |
+ *
+ * @date 19.10.2026
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <util/err.h>
+#include <util/binalign.h>
+#include <lib/libds/dlist.h>
+#include <framework/mod/options.h>
+
+#include <kernel/panic.h>
+#include <kernel/spinlock.h>
+#include <kernel/sched/sched_lock.h>
+
+#include <mem/page.h>
+#include <mem/heap_tlsf.h>
+#include <mem/heap/mspace_malloc.h>
+#include "mspace_segment.h"
+
+#define GROW_SIZE OPTION_GET(NUMBER, grow_size)
+
+struct mm_tlsf_home {
+	struct mm_segment seg;
+	spinlock_t lock;
+};
+
+#define MM_HOME_SIZE binalign_bound(sizeof(struct mm_tlsf_home), TLSF_ALIGN)
+#define MM_SEG_SIZE  binalign_bound(sizeof(struct mm_segment), TLSF_ALIGN)
+
+static inline struct mm_tlsf_home *mm_home(struct dlist_head *mspace) {
+	return dlist_first_entry_or_null(mspace, struct mm_tlsf_home, seg.link);
+}
+
+static inline void *mm_home_heap(struct mm_tlsf_home *home) {
+	return (char *) home + MM_HOME_SIZE;
+}
+
+static inline void *mm_pool(struct mm_segment *mm) {
+	return (char *) mm + MM_SEG_SIZE;
+}
+
+static struct mm_segment *mm_tlsf_segment_alloc(size_t size) {
+	struct mm_segment *mm;
+	size_t pages, grow_pages;
+
+	pages = (size + PAGE_SIZE() - 1) / PAGE_SIZE();
+	grow_pages = (GROW_SIZE + PAGE_SIZE() - 1) / PAGE_SIZE();
+
+	/* Page allocators are serialized by the scheduler lock */
+	sched_lock();
+	mm = NULL;
+	if (pages < grow_pages) {
+		mm = mm_segment_alloc(grow_pages);
+		if (mm) {
+			pages = grow_pages;
+		}
+	}
+	if (!mm) {
+		mm = mm_segment_alloc(pages);
+	}
+	sched_unlock();
+
+	if (mm) {
+		mm->size = pages * PAGE_SIZE();
+	}
+	return mm;
+}
+
+static void mm_tlsf_segment_free(struct mm_segment *mm) {
+	sched_lock();
+	mm_segment_free(mm, mm->size / PAGE_SIZE());
+	sched_unlock();
+}
+
+static struct mm_tlsf_home *mm_home_get(struct dlist_head *mspace,
+		size_t boundary, size_t size) {
+	struct mm_tlsf_home *home;
+
+	home = mm_home(mspace);
+	if (home) {
+		return home;
+	}
+
+	/* First allocation of the task, the heap lock does not exist yet */
+	sched_lock();
+	home = mm_home(mspace);
+	if (!home) {
+		home = (struct mm_tlsf_home *) mm_tlsf_segment_alloc(MM_HOME_SIZE +
+				tlsf_control_size() + tlsf_pool_size(boundary, size));
+		if (home) {
+			spin_init(&home->lock, __SPIN_UNLOCKED);
+			tlsf_init(mm_home_heap(home), home->seg.size - MM_HOME_SIZE);
+			dlist_head_init(&home->seg.link);
+			dlist_add_next(&home->seg.link, mspace);
+			mm_segment_map(&home->seg, mspace);
+		}
+	}
+	sched_unlock();
+
+	return home;
+}
+
+/* Called with the heap lock held */
+static int mm_grow(struct dlist_head *mspace, struct mm_tlsf_home *home,
+		size_t boundary, size_t size) {
+	struct mm_segment *mm;
+
+	mm = mm_tlsf_segment_alloc(MM_SEG_SIZE + tlsf_pool_size(boundary, size));
+	if (!mm) {
+		return -ENOMEM;
+	}
+
+	tlsf_add_pool(mm_home_heap(home), mm_pool(mm), mm->size - MM_SEG_SIZE);
+	dlist_head_init(&mm->link);
+	dlist_add_prev(&mm->link, mspace);
+	mm_segment_map(mm, mspace);
+
+	return 0;
+}
+
+/* Called with the heap lock held */
+static void mm_shrink(struct mm_tlsf_home *home, struct mm_segment *mm) {
+	if (mm == &home->seg || !tlsf_pool_is_free(mm_pool(mm))) {
+		return;
+	}
+
+	tlsf_remove_pool(mm_home_heap(home), mm_pool(mm));
+	dlist_del(&mm->link);
+	mm_tlsf_segment_free(mm);
+}
+
+void *mspace_memalign(size_t boundary, size_t size, struct dlist_head *mspace) {
+	struct mm_tlsf_home *home;
+	void *block;
+
+	assert(mspace);
+
+	if (size == 0) {
+		return NULL;
+	}
+
+	home = mm_home_get(mspace, boundary, size);
+	if (!home) {
+		return NULL;
+	}
+
+	spin_lock(&home->lock);
+
+	block = tlsf_memalign(mm_home_heap(home), boundary, size);
+	if (!block && !mm_grow(mspace, home, boundary, size)) {
+		block = tlsf_memalign(mm_home_heap(home), boundary, size);
+		if (!block) {
+			panic("new memory block is not sufficient to allocate requested size");
+		}
+	}
+
+	spin_unlock(&home->lock);
+
+	return block;
+}
+
+void *mspace_malloc(size_t size, struct dlist_head *mspace) {
+	assert(mspace);
+	return mspace_memalign(TLSF_ALIGN, size, mspace);
+}
+
+int mspace_free(void *ptr, struct dlist_head *mspace) {
+	struct mm_tlsf_home *home;
+	struct mm_segment *mm;
+
+	assert(ptr);
+	assert(mspace);
+
+	home = mm_home(mspace);
+	if (!home) {
+		return -1;
+	}
+
+	spin_lock(&home->lock);
+
+	mm = mm_segment_find(ptr, mspace);
+	if (mm == NULL) {
+		/* No segment containing pointer @c ptr was found. */
+		spin_unlock(&home->lock);
+		return -1;
+	}
+
+	tlsf_free(mm_home_heap(home), ptr);
+	mm_shrink(home, mm);
+
+	spin_unlock(&home->lock);
+
+	return 0;
+}
+
+int mspace_alloc_batch(size_t size, void **blocks, int n,
+		struct dlist_head *mspace) {
+	struct mm_tlsf_home *home;
+	int i;
+
+	assert(mspace);
+
+	home = mm_home_get(mspace, TLSF_ALIGN, size);
+	if (!home) {
+		return 0;
+	}
+
+	spin_lock(&home->lock);
+	for (i = 0; i < n; i++) {
+		blocks[i] = tlsf_memalign(mm_home_heap(home), TLSF_ALIGN, size);
+		if (!blocks[i]) {
+			if (mm_grow(mspace, home, TLSF_ALIGN, size * (n - i))) {
+				break;
+			}
+			blocks[i] = tlsf_memalign(mm_home_heap(home), TLSF_ALIGN, size);
+			if (!blocks[i]) {
+				break;
+			}
+		}
+	}
+	spin_unlock(&home->lock);
+
+	return i;
+}
+
+void mspace_free_batch(void **blocks, int n, struct dlist_head *mspace) {
+	struct mm_tlsf_home *home;
+	struct mm_segment *mm;
+	int i;
+
+	assert(mspace);
+
+	home = mm_home(mspace);
+	if (!home) {
+		return;
+	}
+
+	spin_lock(&home->lock);
+	for (i = 0; i < n; i++) {
+		mm = mm_segment_find(blocks[i], mspace);
+		if (mm) {
+			tlsf_free(mm_home_heap(home), blocks[i]);
+			mm_shrink(home, mm);
+		}
+	}
+	spin_unlock(&home->lock);
+}
+
+size_t mspace_block_size(void *ptr) {
+	return tlsf_block_size(ptr);
+}
+
+void mspace_stats(struct dlist_head *mspace, struct mspace_stats *st) {
+	struct mm_tlsf_home *home;
+	struct mm_segment *mm;
+
+	memset(st, 0, sizeof(*st));
+
+	home = mm_home(mspace);
+	if (!home) {
+		return;
+	}
+
+	spin_lock(&home->lock);
+	dlist_foreach_entry(mm, mspace, link) {
+		st->total += mm->size;
+		st->segments++;
+	}
+	tlsf_free_stats(mm_home_heap(home), &st->free, &st->largest_free);
+	spin_unlock(&home->lock);
+}
+
+void *mspace_realloc(void *ptr, size_t size, struct dlist_head *mspace) {
+	struct mm_tlsf_home *home;
+	struct mm_segment *mm;
+	void *ret;
+
+	assert(mspace);
+	assert(size != 0 || ptr == NULL);
+
+	if (ptr == NULL) {
+		return mspace_malloc(size, mspace);
+	}
+
+	home = mm_home(mspace);
+	if (!home) {
+		return err2ptr(EINVAL);
+	}
+
+	spin_lock(&home->lock);
+
+	mm = mm_segment_find(ptr, mspace);
+	if (mm == NULL) {
+		spin_unlock(&home->lock);
+		return err2ptr(EINVAL);
+	}
+
+	/* Grows in place into a free neighbour, otherwise moves */
+	ret = tlsf_realloc(mm_home_heap(home), ptr, size);
+	if (!ret && !mm_grow(mspace, home, TLSF_ALIGN, size)) {
+		ret = tlsf_realloc(mm_home_heap(home), ptr, size);
+	}
+	if (ret && ret != ptr) {
+		mm_shrink(home, mm);
+	}
+
+	spin_unlock(&home->lock);
+
+	return ret;
+}
+
+void *mspace_calloc(size_t nmemb, size_t size, struct dlist_head *mspace) {
+	void *ret;
+	size_t total_size;
+
+	total_size = nmemb * size;
+
+	assert(mspace);
+	assert(total_size > 0);
+
+	ret = mspace_malloc(total_size, mspace);
+	if (ret == NULL) {
+		return NULL; /* error: errno set in malloc */
+	}
+
+	memset(ret, 0, total_size);
+	return ret;
+}
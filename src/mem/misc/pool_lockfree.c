@@ -0,0 +1,123 @@
+/**
+ * @file
+ * @brief Fixed-size pool which is safe to use from any context without locks
+ * @details Free blocks are kept in a Treiber stack. The top of the stack is
+ *     a single word holding the index of the top block and a generation tag,
+ *     which is incremented by every change of the top. So a block which was
+ *     popped and pushed back while we were looking at it makes our
+ *     compare-and-swap fail instead of corrupting the stack (ABA problem).
+ *     Blocks never handed out yet are taken by moving @c bound_free with
+ *     compare-and-swap as well.
+ *
+ *     Reading the link of a block which is concurrently popped by somebody
+ *     else is fine: the memory belongs to the pool forever, and the tag
+ *     check throws away what was read.
+ *
+ *     The top is 64 bits wide on every target, 32-bit ones update it with a
+ *     double-width compare-and-swap (cmpxchg8b on x86). The index takes the
+ *     low half and the tag the high one, so the tag wraps around only after
+ *     2^32 changes of the top, which is the window a preempted pool_alloc()
+ *     would have to sleep through to be fooled.
+ *
+ * @see For more information see pool.c
+ *
+ * @date 19.10.2026
+ */
+
+#include <mem/misc/pool.h>
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define POOL_IDX_BITS 32
+#define POOL_IDX_MASK ((UINT64_C(1) << POOL_IDX_BITS) - 1)
+#define POOL_TAG_ONE  (UINT64_C(1) << POOL_IDX_BITS)
+
+/* Blocks are numbered from 1, so 0 means empty stack */
+static inline void *pool_block(struct pool *pl, uint64_t top) {
+	return pl->memory + ((size_t) (top & POOL_IDX_MASK) - 1) * pl->obj_size;
+}
+
+static inline unsigned long pool_block_idx(struct pool *pl, void *obj) {
+	return (obj - pl->memory) / pl->obj_size + 1;
+}
+
+static inline uint64_t pool_top_next(uint64_t top, unsigned long idx) {
+	return ((top & ~POOL_IDX_MASK) + POOL_TAG_ONE) | idx;
+}
+
+/* A plain load of a double word may be torn on 32-bit targets */
+static inline uint64_t pool_top_load(struct pool *pl) {
+	if (sizeof(unsigned long) < sizeof(uint64_t)) {
+		return __sync_val_compare_and_swap(&pl->free_top, 0, 0);
+	}
+	return *(volatile uint64_t *) &pl->free_top;
+}
+
+static void *pool_pop(struct pool *pl) {
+	uint64_t top;
+	unsigned long next;
+	void *obj;
+
+	do {
+		top = pool_top_load(pl);
+		if (!(top & POOL_IDX_MASK)) {
+			return NULL;
+		}
+		obj = pool_block(pl, top);
+		next = *(volatile unsigned long *) obj;
+	} while (!__sync_bool_compare_and_swap(&pl->free_top, top,
+			pool_top_next(top, next)));
+
+	return obj;
+}
+
+static void pool_push(struct pool *pl, void *obj) {
+	uint64_t top;
+	unsigned long idx;
+
+	idx = pool_block_idx(pl, obj);
+
+	do {
+		top = pool_top_load(pl);
+		*(volatile unsigned long *) obj = (unsigned long) (top & POOL_IDX_MASK);
+	} while (!__sync_bool_compare_and_swap(&pl->free_top, top,
+			pool_top_next(top, idx)));
+}
+
+void *pool_alloc(struct pool *pl) {
+	void *obj;
+
+	assert(pl != NULL);
+	assert(pl->pool_size / pl->obj_size <= POOL_IDX_MASK);
+
+	obj = pool_pop(pl);
+	if (obj) {
+		return obj;
+	}
+
+	do {
+		obj = *(void * volatile *) &pl->bound_free;
+		if (obj == pl->memory + pl->pool_size) {
+			return NULL;
+		}
+	} while (!__sync_bool_compare_and_swap(&pl->bound_free, obj,
+			obj + pl->obj_size));
+
+	return obj;
+}
+
+void pool_free(struct pool *pl, void *obj) {
+	assert(pl != NULL);
+	assert(obj != NULL);
+	assert(pool_belong(pl, obj));
+
+	pool_push(pl, obj);
+}
+
+int pool_belong(const struct pool *pl, const void *obj) {
+	return (pl->memory <= obj)
+			&& (obj + pl->obj_size <= pl->memory + pl->pool_size)
+			&& ((obj - pl->memory) % pl->obj_size == 0);
+}
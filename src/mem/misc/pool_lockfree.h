@@ -0,0 +1,15 @@
+/**
+ * @file
+ * @brief Lock-free version of pool.c
+ *
+ * @see For more information see pool_lockfree.c
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef POOL_LOCKFREE_H_
+#define POOL_LOCKFREE_H_
+
+#define POOL_LOCKFREE
+
+#endif /* POOL_LOCKFREE_H_ */
@@ -1,6 +1,19 @@
 /**
  * @file
  * @brief SLAB allocator
+ * @details
+ *    Objects are kept in slabs of 2^slab_order pages. Slabs and a depot of
+ *    magazines are protected by a per-cache spinlock with interrupts
+ *    disabled, so caches can be used from interrupt handlers.
+ *
+ *    In front of the slabs every CPU has two magazines, small stacks of
+ *    free objects. Most allocations and frees only touch the magazines of
+ *    the current CPU, and the lock is taken to exchange a full or empty
+ *    magazine with the depot or when the depot has nothing to offer.
+ *
+ *    Slabs are colored: the first object of consecutive slabs is shifted
+ *    by SLAB_COLOR_ALIGN bytes within the slab wastage, so hot objects of
+ *    different slabs do not compete for the same cache lines.
  *
  * @date 14.12.10
  * @author Dmitry Zubarevich
@@ -18,6 +31,10 @@
 #include <lib/libds/slist.h>
 #include <util/binalign.h>
 
+#include <hal/cpu.h>
+#include <hal/ipl.h>
+#include <kernel/spinlock.h>
+
 #include <mem/misc/slab.h>
 #include <mem/page.h>
 #include <mem/heap.h>
@@ -25,6 +42,7 @@
 #include <mem/phymem.h>
 
 #include <embox/unit.h>
+#include <fs/procfs.h>
 
 EMBOX_UNIT_INIT(slab_init);
 
@@ -42,11 +60,26 @@ typedef struct slab {
 
 /* some information about page  */
 typedef struct page_info {
+	/* NULL for pages allocated by kmem_alloc() directly */
 	cache_t *cache;
-	slab_t *slab;
+	union {
+		slab_t *slab;
+		size_t pages;
+	};
 } page_info_t;
 
+#define SLAB_HDR_SIZE binalign_bound(sizeof(slab_t), sizeof(void *))
+
+/* Objects and magazines left in the depot before flushing to the slabs */
+#define SLAB_DEPOT_MAX 8
+
+/* Generic caches are 2^KMEM_MIN_SHIFT .. 2^KMEM_MAX_SHIFT bytes */
+#define KMEM_MIN_SHIFT 4
+#define KMEM_MAX_SHIFT 12
+#define KMEM_CACHES    (KMEM_MAX_SHIFT - KMEM_MIN_SHIFT + 1)
+
 static struct page_allocator *slab_pa;
+static spinlock_t slab_pa_lock = SPIN_STATIC_UNLOCKED;
 
 #if 0
 # define SLAB_ALLOCATOR_DEBUG
@@ -54,9 +87,10 @@ static struct page_allocator *slab_pa;
 
 #define HEAP_SIZE OPTION_MODULE_GET(embox__mem__slab,NUMBER,heap_size)
 
-static char *heap_start_ptr;
+static page_info_t *pages;
 
-static page_info_t pages[HEAP_SIZE / PAGE_SIZE()];
+static cache_t magazine_cache;
+static cache_t kmem_caches[KMEM_CACHES];
 
 /* macros to finding the cache and slab which an obj belongs to */
 #define SET_PAGE_CACHE(pg, x)  ((pg)->cache = (x))
@@ -80,26 +114,53 @@ void print_slab_info(cache_t *cachep, slab_t *slabp) {
 
 /* return information about page which an object belongs to */
 static page_info_t* ptr_to_page(void *objp) {
-	unsigned int index = ((uintptr_t) objp - (uintptr_t) heap_start_ptr)
+	unsigned int index = ((uintptr_t) objp - (uintptr_t) slab_pa->pages_start)
 			/ PAGE_SIZE();
 	return &(pages[index]);
 }
 
+static void *slab_pages_alloc(size_t page_q) {
+	void *ptr;
+	ipl_t ipl;
+
+	if (!slab_pa) {
+		return NULL;
+	}
+
+	ipl = spin_lock_ipl(&slab_pa_lock);
+	ptr = page_alloc(slab_pa, page_q);
+	spin_unlock_ipl(&slab_pa_lock, ipl);
+
+	return ptr;
+}
+
+static void slab_pages_free(void *ptr, size_t page_q) {
+	ipl_t ipl;
+
+	ipl = spin_lock_ipl(&slab_pa_lock);
+	page_free(slab_pa, ptr, page_q);
+	spin_unlock_ipl(&slab_pa_lock, ipl);
+}
+
 /* main cache which will contain another descriptors of caches */
 cache_t cache_chain = {
 	.name = "__cache_chain",
-	.num  = (PAGE_SIZE() * CACHE_CHAIN_SIZE
-				- binalign_bound(sizeof(slab_t), 4))
-				/ binalign_bound(sizeof(cache_t), 4),
-	.obj_size = binalign_bound(sizeof(cache_t), sizeof(struct slist_link)),
+	.num  = (PAGE_SIZE() * CACHE_CHAIN_SIZE - SLAB_HDR_SIZE)
+				/ binalign_bound(sizeof(cache_t), sizeof(void *)),
+	.obj_size = binalign_bound(sizeof(cache_t), sizeof(void *)),
 	.slabs_full = DLIST_INIT(cache_chain.slabs_full),
 	.slabs_free = DLIST_INIT(cache_chain.slabs_free),
 	.slabs_partial = DLIST_INIT(cache_chain.slabs_partial),
 	.next = DLIST_INIT(cache_chain.next),
 	.slab_order = CACHE_CHAIN_SIZE,
-	.growing = true
+	.growing = true,
+	.lock = SPIN_STATIC_UNLOCKED,
+	.color_max = 1,
 };
 
+/* protects the list of caches */
+static spinlock_t cache_chain_lock = SPIN_STATIC_UNLOCKED;
+
 /** Initialize cache according to storage data in info structure */
 static int cache_member_init(const struct mod_member *info);
 
@@ -117,12 +178,18 @@ static int cache_member_init(const struct mod_member *info) {
  * @param slab_ptr the pointer to slab which must be deleted
  */
 static void cache_slab_destroy(cache_t *cachep, slab_t *slabp) {
-	page_free(slab_pa, slabp, slabp->inuse);
+	cachep->slabs_nr--;
+	slab_pages_free(slabp, 1 << cachep->slab_order);
 }
 
 /* init slab descriptor and slab objects */
 static void cache_slab_init(cache_t *cachep, slab_t *slabp) {
-	char *elem = (char*) slabp + binalign_bound(sizeof(slab_t), 4);
+	char *elem = (char*) slabp + SLAB_HDR_SIZE;
+
+	elem += cachep->color_next * SLAB_COLOR_ALIGN;
+	if (++cachep->color_next >= cachep->color_max) {
+		cachep->color_next = 0;
+	}
 
 	slabp->inuse = 0;
 	dlist_head_init(&slabp->cache_link);
@@ -135,14 +202,15 @@ static void cache_slab_init(cache_t *cachep, slab_t *slabp) {
 	}
 }
 
-/* grow (by 1) the number of slabs within a cache */
+/* grow (by 1) the number of slabs within a cache,
+ * called with the cache lock held */
 static int cache_grow(cache_t *cachep) {
 	int pages_count;
 	page_info_t *page;
 	slab_t * slabp;
 	size_t slab_size = 1 << cachep->slab_order;
 
-	if (!(slabp = (slab_t*) page_alloc(slab_pa, slab_size)))
+	if (!(slabp = (slab_t*) slab_pages_alloc(slab_size)))
 		return 0;
 
 	page = ptr_to_page(slabp);
@@ -157,6 +225,7 @@ static int cache_grow(cache_t *cachep) {
 	cache_slab_init(cachep, slabp);
 
 	dlist_add_prev(&slabp->cache_link, &cachep->slabs_free);
+	cachep->slabs_nr++;
 
 	return 1;
 }
@@ -172,14 +241,11 @@ static void cache_estimate(unsigned int gfporder, size_t size,
 		size_t *left_over, unsigned int *num) {
 	int count;
 	size_t wastage = PAGE_SIZE() << gfporder; /* total size being asked for */
-	size_t base = 0;
-
-	base = sizeof(slab_t);
 
 	/* calculate the number of objects that will fit inside the slab, including the
 	 * base slab_t */
 	count = 0;
-	while (count * size + binalign_bound(base, 4) <= wastage)
+	while (count * size + SLAB_HDR_SIZE <= wastage)
 		count++;
 	if (count > 0)
 		count--;
@@ -187,12 +253,205 @@ static void cache_estimate(unsigned int gfporder, size_t size,
 	/* return number objects that fit, and total space wasted */
 	*num = count;
 	wastage -= count * size;
-	wastage -= binalign_bound(base, 4);
+	wastage -= SLAB_HDR_SIZE;
 	*left_over = wastage;
 }
 
+/* Take an object from slabs, called with the cache lock held */
+static void *slab_obj_alloc(cache_t *cachep) {
+	slab_t * slabp;
+	void *objp;
+
+	/* getting slab */
+	if (dlist_empty(&cachep->slabs_partial)) {
+		if (dlist_empty(&cachep->slabs_free)) {
+			if (cachep->growing == false || !cache_grow(cachep)) {
+				cachep->alloc_failed++;
+				return NULL;
+			}
+		}
+		slabp = dlist_entry(cachep->slabs_free.next, slab_t, cache_link);
+	} else {
+		slabp = dlist_entry(cachep->slabs_partial.next, slab_t, cache_link);
+	}
+
+	objp = (void *)slist_remove_first_link(&slabp->free_blocks);
+
+	slabp->inuse++;
+	if (slabp->inuse == cachep->num) {
+		dlist_del(&slabp->cache_link);
+		dlist_add_prev(&slabp->cache_link, &cachep->slabs_full);
+	} else if (slabp->inuse == 1) {
+		dlist_del(&slabp->cache_link);
+		dlist_add_prev(&slabp->cache_link, &cachep->slabs_partial);
+	}
+
+	cachep->objs_inuse++;
+	cachep->slab_allocs++;
+
+#ifdef SLAB_ALLOCATOR_DEBUG
+	printf("\n\nSlab info after allocating object:");
+	print_slab_info(cachep, slabp);
+#endif
+
+	return objp;
+}
+
+/* Return an object to its slab, called with the cache lock held */
+static void slab_obj_free(cache_t *cachep, void *objp) {
+	slab_t * slabp;
+	page_info_t* page;
+
+	page = ptr_to_page(objp);
+	assert(GET_PAGE_CACHE(page) == cachep);
+	slabp = GET_PAGE_SLAB(page);
+	slist_add_first_link(slist_link_init((struct slist_link *)objp),
+			&slabp->free_blocks);
+	slabp->inuse--;
+	cachep->objs_inuse--;
+
+	if (slabp->inuse == 0) {
+		dlist_del(&slabp->cache_link);
+		dlist_add_next(&slabp->cache_link, &cachep->slabs_free);
+	} else if (slabp->inuse + 1 == cachep->num) {
+		dlist_del(&slabp->cache_link);
+		dlist_add_next(&slabp->cache_link, &cachep->slabs_partial);
+	}
+
+#ifdef SLAB_ALLOCATOR_DEBUG
+	printf("\n\nSlab info after freeing object:");
+	print_slab_info(cachep, slabp);
+#endif
+}
+
+/* Called with the cache lock held */
+static void magazine_flush(cache_t *cachep, struct slab_magazine *mag) {
+	while (mag->rounds) {
+		slab_obj_free(cachep, mag->objs[--mag->rounds]);
+	}
+}
+
+/* Called with the cache lock held */
+static void depot_put(struct slab_magazine **depot, unsigned int *nr,
+		struct slab_magazine *mag) {
+	mag->next = *depot;
+	*depot = mag;
+	(*nr)++;
+}
+
+/* Called with the cache lock held */
+static struct slab_magazine *depot_get(struct slab_magazine **depot,
+		unsigned int *nr) {
+	struct slab_magazine *mag = *depot;
+
+	if (mag) {
+		*depot = mag->next;
+		(*nr)--;
+	}
+	return mag;
+}
+
+/* Called with interrupts disabled */
+static void *magazine_alloc(cache_t *cachep, struct slab_cpu_cache *cc) {
+	struct slab_magazine *mag;
+
+	if (!cc->loaded || !cc->loaded->rounds) {
+		if (cc->previous && cc->previous->rounds) {
+			mag = cc->loaded;
+			cc->loaded = cc->previous;
+			cc->previous = mag;
+		} else {
+			/* Exchange the empty previous one for a full one */
+			spin_lock(&cachep->lock);
+			mag = depot_get(&cachep->depot_full, &cachep->depot_full_nr);
+			if (mag && cc->previous) {
+				depot_put(&cachep->depot_empty, &cachep->depot_empty_nr,
+						cc->previous);
+			}
+			spin_unlock(&cachep->lock);
+
+			if (!mag) {
+				return NULL;
+			}
+			cc->previous = cc->loaded;
+			cc->loaded = mag;
+		}
+	}
+
+	cc->hits++;
+	return cc->loaded->objs[--cc->loaded->rounds];
+}
+
+/* Called with interrupts disabled */
+static int magazine_free(cache_t *cachep, struct slab_cpu_cache *cc,
+		void *objp) {
+	struct slab_magazine *mag;
+
+	if (!cc->loaded || cc->loaded->rounds == SLAB_MAGAZINE_SIZE) {
+		if (cc->previous && !cc->previous->rounds) {
+			mag = cc->loaded;
+			cc->loaded = cc->previous;
+			cc->previous = mag;
+		} else {
+			spin_lock(&cachep->lock);
+			mag = depot_get(&cachep->depot_empty, &cachep->depot_empty_nr);
+			spin_unlock(&cachep->lock);
+
+			if (!mag) {
+				mag = cache_alloc(&magazine_cache);
+				if (!mag) {
+					return -ENOMEM;
+				}
+				mag->rounds = 0;
+			}
+
+			/* The full previous one goes to the depot */
+			if (cc->previous) {
+				spin_lock(&cachep->lock);
+				if (cachep->depot_full_nr >= SLAB_DEPOT_MAX) {
+					magazine_flush(cachep, cc->previous);
+					depot_put(&cachep->depot_empty, &cachep->depot_empty_nr,
+							cc->previous);
+				} else {
+					depot_put(&cachep->depot_full, &cachep->depot_full_nr,
+							cc->previous);
+				}
+				spin_unlock(&cachep->lock);
+			}
+			cc->previous = cc->loaded;
+			cc->loaded = mag;
+		}
+	}
+
+	cc->hits++;
+	cc->loaded->objs[cc->loaded->rounds++] = objp;
+	return 0;
+}
+
+/* Return objects of the magazine to the slabs and the magazine itself to
+ * the magazine cache. Called with the cache lock held */
+static void magazine_destroy(cache_t *cachep, struct slab_magazine *mag) {
+	if (mag) {
+		magazine_flush(cachep, mag);
+		cache_free(&magazine_cache, mag);
+	}
+}
+
+/* Called with the cache lock held */
+static void depot_drain(cache_t *cachep) {
+	struct slab_magazine *mag;
+
+	while ((mag = depot_get(&cachep->depot_full, &cachep->depot_full_nr))) {
+		magazine_destroy(cachep, mag);
+	}
+	while ((mag = depot_get(&cachep->depot_empty, &cachep->depot_empty_nr))) {
+		magazine_destroy(cachep, mag);
+	}
+}
+
 int cache_init(cache_t *cachep, size_t obj_size, size_t obj_num) {
 	size_t left_over;
+	ipl_t ipl;
 
 	assert(cachep != NULL);
 
@@ -225,13 +484,30 @@ int cache_init(cache_t *cachep, size_t obj_size, size_t obj_num) {
 	}
 
 	cachep->growing = true;
+	/* The magazine cache itself takes no magazines */
+	cachep->magazines = (cachep != &magazine_cache);
+	spin_init(&cachep->lock, __SPIN_UNLOCKED);
+	cachep->color_max = left_over / SLAB_COLOR_ALIGN + 1;
+	cachep->color_next = 0;
+	cachep->depot_full = cachep->depot_empty = NULL;
+	cachep->depot_full_nr = cachep->depot_empty_nr = 0;
+	memset(cachep->cpu, 0, sizeof(cachep->cpu));
+	cachep->slabs_nr = 0;
+	cachep->objs_inuse = 0;
+	cachep->slab_allocs = 0;
+	cachep->alloc_failed = 0;
+
 	dlist_init(&cachep->slabs_full);
 	dlist_init(&cachep->slabs_partial);
 	dlist_init(&cachep->slabs_free);
 	dlist_head_init(&cachep->next);
+
+	ipl = spin_lock_ipl(&cache_chain_lock);
 	dlist_add_prev(&cachep->next, &(cache_chain.next));
+	spin_unlock_ipl(&cache_chain_lock, ipl);
 
 	/* Reserve memory for minimum count of objects (obj_num) */
+	ipl = spin_lock_ipl(&cachep->lock);
 	while (obj_num >= cachep->num) {
 		cache_grow(cachep);
 		obj_num -= cachep->num;
@@ -240,6 +516,7 @@ int cache_init(cache_t *cachep, size_t obj_size, size_t obj_num) {
 	if (obj_num != 0) {
 		cache_grow(cachep);
 	}
+	spin_unlock_ipl(&cachep->lock, ipl);
 
 #ifdef SLAB_ALLOCATOR_DEBUG
 	printf("\n\nCreating cache with name \"%s\"\n", cachep->name);
@@ -286,112 +563,313 @@ static void destroy_slabs(cache_t *cachep, struct dlist_head *slabs) {
 }
 
 int cache_destroy(cache_t *cachep) {
+	ipl_t ipl;
+	int cpu;
+
 	assert(cachep);
 
+	ipl = spin_lock_ipl(&cache_chain_lock);
+	dlist_del(&cachep->next);
+	spin_unlock_ipl(&cache_chain_lock, ipl);
+
+	/* Nobody uses the cache anymore, magazines of all CPUs can go */
+	ipl = spin_lock_ipl(&cachep->lock);
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		magazine_destroy(cachep, cachep->cpu[cpu].loaded);
+		magazine_destroy(cachep, cachep->cpu[cpu].previous);
+		cachep->cpu[cpu].loaded = cachep->cpu[cpu].previous = NULL;
+	}
+	depot_drain(cachep);
+
 	destroy_slabs(cachep, &cachep->slabs_free);
 	destroy_slabs(cachep, &cachep->slabs_full);
 	destroy_slabs(cachep, &cachep->slabs_partial);
+	spin_unlock_ipl(&cachep->lock, ipl);
 
-	dlist_del(&cachep->next);
 	cache_free(&cache_chain, cachep);
 
 	return 0;
 }
 
 void *cache_alloc(cache_t *cachep) {
-	slab_t * slabp;
-	void *objp;
+	void *objp = NULL;
+	struct slab_cpu_cache *cc;
+	ipl_t ipl;
 
 	assert(cachep);
 
-	/* getting slab */
-	if (dlist_empty(&cachep->slabs_partial)) {
-		if (dlist_empty(&cachep->slabs_free)) {
-			if (cachep->growing == false || !cache_grow(cachep)) {
-				return NULL;
-			}
-		}
-		slabp = dlist_entry(cachep->slabs_free.next, slab_t, cache_link);
-	} else {
-		slabp = dlist_entry(cachep->slabs_partial.next, slab_t, cache_link);
+	ipl = ipl_save();
+	cc = &cachep->cpu[cpu_get_id()];
+	cc->allocs++;
+	if (cachep->magazines) {
+		objp = magazine_alloc(cachep, cc);
 	}
+	ipl_restore(ipl);
 
-	objp = (void *)slist_remove_first_link(&slabp->free_blocks);
-
-	slabp->inuse++;
-	if (slabp->inuse == cachep->num) {
-		dlist_del(&slabp->cache_link);
-		dlist_add_prev(&slabp->cache_link, &cachep->slabs_full);
-	} else if (slabp->inuse == 1) {
-		dlist_del(&slabp->cache_link);
-		dlist_add_prev(&slabp->cache_link, &cachep->slabs_partial);
+	if (objp) {
+		return objp;
 	}
 
-#ifdef SLAB_ALLOCATOR_DEBUG
-	printf("\n\nSlab info after allocating object:");
-	print_slab_info(cachep, slabp);
-#endif
+	ipl = spin_lock_ipl(&cachep->lock);
+	objp = slab_obj_alloc(cachep);
+	spin_unlock_ipl(&cachep->lock, ipl);
 
 	return objp;
 }
 
 void cache_free(cache_t *cachep, void* objp) {
-	slab_t * slabp;
-	page_info_t* page;
+	struct slab_cpu_cache *cc;
+	ipl_t ipl;
+	int err = -1;
 
 	assert(cachep);
 
 	if (objp == NULL)
 		return;
 
-	page = ptr_to_page(objp);
-	slabp = GET_PAGE_SLAB(page);
-	slist_add_first_link(slist_link_init((struct slist_link *)objp),
-			&slabp->free_blocks);
-	slabp->inuse--;
+	assert(GET_PAGE_CACHE(ptr_to_page(objp)) == cachep);
 
-	if (slabp->inuse == 0) {
-		dlist_del(&slabp->cache_link);
-		dlist_add_next(&slabp->cache_link, &cachep->slabs_free);
-	} else if (slabp->inuse + 1 == cachep->num) {
-		dlist_del(&slabp->cache_link);
-		dlist_add_next(&slabp->cache_link, &cachep->slabs_partial);
+	ipl = ipl_save();
+	cc = &cachep->cpu[cpu_get_id()];
+	cc->frees++;
+	if (cachep->magazines) {
+		err = magazine_free(cachep, cc, objp);
 	}
+	ipl_restore(ipl);
 
-#ifdef SLAB_ALLOCATOR_DEBUG
-	printf("\n\nSlab info after freeing object:");
-	print_slab_info(cachep, slabp);
-#endif
+	if (!err) {
+		return;
+	}
+
+	ipl = spin_lock_ipl(&cachep->lock);
+	slab_obj_free(cachep, objp);
+	spin_unlock_ipl(&cachep->lock, ipl);
 }
 
 int cache_shrink(cache_t *cachep) {
 	slab_t * slabp;
 	int ret = 0;
+	ipl_t ipl;
 
 	assert(cachep);
 
+	/* Magazines of the other CPUs are in use, only the depot is flushed */
+	ipl = spin_lock_ipl(&cachep->lock);
+	depot_drain(cachep);
+
 	dlist_foreach_entry(slabp, &cachep->slabs_free, cache_link) {
 		dlist_del(&slabp->cache_link);
 		cache_slab_destroy(cachep, slabp);
 		ret++;
 	}
+	spin_unlock_ipl(&cachep->lock, ipl);
 
 	return ret;
 }
 
+static void cache_stats_fill(cache_t *cachep, struct cache_stats *st) {
+	struct slab_magazine *mag;
+	int cpu;
+
+	memset(st, 0, sizeof(*st));
+	strncpy(st->name, cachep->name, sizeof(st->name) - 1);
+	st->obj_size = cachep->obj_size;
+	st->num = cachep->num;
+	st->slab_order = cachep->slab_order;
+
+	spin_lock(&cachep->lock);
+	st->slabs = cachep->slabs_nr;
+	st->objs_inuse = cachep->objs_inuse;
+	st->alloc_failed = cachep->alloc_failed;
+	for (mag = cachep->depot_full; mag; mag = mag->next) {
+		st->objs_cached += mag->rounds;
+	}
+	spin_unlock(&cachep->lock);
+
+	/* Per-CPU parts are a snapshot */
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		struct slab_cpu_cache *cc = &cachep->cpu[cpu];
+
+		st->allocs += cc->allocs;
+		st->frees += cc->frees;
+		st->hits += cc->hits;
+		if (cc->loaded) {
+			st->objs_cached += cc->loaded->rounds;
+		}
+		if (cc->previous) {
+			st->objs_cached += cc->previous->rounds;
+		}
+	}
+}
+
+int cache_stats_get(struct cache_stats *stats, int max) {
+	cache_t *cachep;
+	ipl_t ipl;
+	int n = 0;
+
+	ipl = spin_lock_ipl(&cache_chain_lock);
+	if (n < max) {
+		cache_stats_fill(&cache_chain, &stats[n]);
+	}
+	n++;
+	dlist_foreach_entry(cachep, &cache_chain.next, next) {
+		if (n < max) {
+			cache_stats_fill(cachep, &stats[n]);
+		}
+		n++;
+	}
+	spin_unlock_ipl(&cache_chain_lock, ipl);
+
+	return n;
+}
+
+static int cache_stats_append(char *buf, size_t size, int len,
+		const struct cache_stats *st) {
+	unsigned long ops = st->allocs + st->frees;
+	int n;
+
+	n = snprintf((size_t) len < size ? buf + len : NULL,
+			(size_t) len < size ? size - len : 0,
+			"%-16s %6zu %5u %5u %6u %8u %7u %9lu %9lu %4lu%% %6lu\n",
+			st->name, st->obj_size, st->num, 1u << st->slab_order,
+			st->slabs, st->objs_inuse, st->objs_cached,
+			st->allocs, st->frees, ops ? st->hits * 100 / ops : 0,
+			st->alloc_failed);
+
+	return n < 0 ? n : len + n;
+}
+
+int cache_stats_print(char *buf, size_t size) {
+	struct cache_stats st;
+	cache_t *cachep;
+	ipl_t ipl;
+	int len;
+
+	len = snprintf(buf, size, "%-16s %6s %5s %5s %6s %8s %7s %9s %9s %5s %6s\n",
+			"name", "size", "objs", "pages", "slabs", "inuse", "cached",
+			"allocs", "frees", "hits", "failed");
+
+	ipl = spin_lock_ipl(&cache_chain_lock);
+	cache_stats_fill(&cache_chain, &st);
+	len = cache_stats_append(buf, size, len, &st);
+	dlist_foreach_entry(cachep, &cache_chain.next, next) {
+		if (len < 0) {
+			break;
+		}
+		cache_stats_fill(cachep, &st);
+		len = cache_stats_append(buf, size, len, &st);
+	}
+	spin_unlock_ipl(&cache_chain_lock, ipl);
+
+	return len;
+}
+
+PROCFS_FILE_DEF("slabinfo", cache_stats_print);
+
+static cache_t *kmem_cache(size_t size) {
+	int i;
+
+	for (i = 0; i < KMEM_CACHES; i++) {
+		if (size <= (1 << (KMEM_MIN_SHIFT + i))) {
+			return &kmem_caches[i];
+		}
+	}
+
+	return NULL;
+}
+
+void *kmem_alloc(size_t size) {
+	cache_t *cachep;
+	page_info_t *page;
+	size_t page_q;
+	void *ptr;
+
+	if (size == 0) {
+		return NULL;
+	}
+
+	cachep = kmem_cache(size);
+	if (cachep) {
+		return cache_alloc(cachep);
+	}
+
+	page_q = (size + PAGE_SIZE() - 1) / PAGE_SIZE();
+	ptr = slab_pages_alloc(page_q);
+	if (ptr) {
+		page = ptr_to_page(ptr);
+		SET_PAGE_CACHE(page, NULL);
+		page->pages = page_q;
+	}
+
+	return ptr;
+}
+
+void *kmem_zalloc(size_t size) {
+	void *ptr;
+
+	ptr = kmem_alloc(size);
+	if (ptr) {
+		memset(ptr, 0, size);
+	}
+
+	return ptr;
+}
+
+void kmem_free(void *ptr) {
+	page_info_t *page;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	page = ptr_to_page(ptr);
+	if (GET_PAGE_CACHE(page)) {
+		cache_free(GET_PAGE_CACHE(page), ptr);
+	} else {
+		slab_pages_free(ptr, page->pages);
+	}
+}
+
 static int slab_init(void) {
 	extern struct page_allocator *__heap_pgallocator;
-	int page_cnt = (HEAP_SIZE / PAGE_SIZE() - 2);
-
-	heap_start_ptr = page_alloc(__heap_pgallocator, page_cnt);
+	size_t page_cnt = HEAP_SIZE / PAGE_SIZE();
+	size_t info_pages;
+	char *heap_start_ptr;
+	int i;
+
+	/* Table of page_info is placed in front of the slab pages */
+	info_pages = (page_cnt * sizeof(page_info_t) + PAGE_SIZE() - 1) / PAGE_SIZE();
+	if (page_cnt <= info_pages + 2) {
+		return -ENOMEM;
+	}
+	page_cnt -= info_pages;
 
+	heap_start_ptr = page_alloc(__heap_pgallocator, info_pages + page_cnt);
 	if (NULL == heap_start_ptr) {
 		return -1;
 	}
 
+	pages = (page_info_t *) heap_start_ptr;
+	memset(pages, 0, info_pages * PAGE_SIZE());
+	heap_start_ptr += info_pages * PAGE_SIZE();
+
 	slab_pa = page_allocator_init(heap_start_ptr, page_cnt * PAGE_SIZE(), PAGE_SIZE());
+	if (NULL == slab_pa) {
+		return -ENOMEM;
+	}
 
-	heap_start_ptr += PAGE_SIZE();
+	strcpy(magazine_cache.name, "__magazines");
+	if (cache_init(&magazine_cache, sizeof(struct slab_magazine), 0)) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < KMEM_CACHES; i++) {
+		snprintf(kmem_caches[i].name, __CACHE_NAMELEN, "kmem-%d",
+				1 << (KMEM_MIN_SHIFT + i));
+		if (cache_init(&kmem_caches[i], 1 << (KMEM_MIN_SHIFT + i), 0)) {
+			return -ENOMEM;
+		}
+	}
 
 	return 0;
 }
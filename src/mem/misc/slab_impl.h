@@ -11,6 +11,8 @@
 
 #include <lib/libds/dlist.h>
 #include <framework/mod/self.h>
+#include <hal/cpu.h>
+#include <kernel/spinlock.h>
 #include <stddef.h>
 #include <stdbool.h>
 
@@ -28,6 +30,30 @@
 /** use to search a fit cache for object */
 #define MAX_OBJECT_ALIGN 0
 
+/** number of objects in a magazine */
+#define SLAB_MAGAZINE_SIZE 15
+/** step of slab coloring, in bytes */
+#define SLAB_COLOR_ALIGN 32
+
+/** stack of free objects, exchanged between CPUs through the depot */
+struct slab_magazine {
+	struct slab_magazine *next;
+	int rounds;
+	void *objs[SLAB_MAGAZINE_SIZE];
+};
+
+/** per-CPU layer, touched only by its CPU with interrupts disabled */
+struct slab_cpu_cache {
+	/** magazine objects are allocated from and freed to */
+	struct slab_magazine *loaded;
+	/** either full or empty, swapped with the loaded one */
+	struct slab_magazine *previous;
+	unsigned long allocs;
+	unsigned long frees;
+	/** allocations and frees which did not reach the slabs */
+	unsigned long hits;
+};
+
 /** cache descriptor */
 struct cache {
 	/** pointer to other caches */
@@ -48,12 +74,36 @@ struct cache {
 	unsigned int slab_order;
 	/** Indicates weather cache can growing or not. All caches are growing by default */
 	bool growing;
+	/** Whether objects are cached in per-CPU magazines */
+	bool magazines;
+
+	/** protects slabs and the depot */
+	spinlock_t lock;
+	/** number of different offsets of the first object in a slab */
+	unsigned int color_max;
+	/** offset of the first object in the next slab, in SLAB_COLOR_ALIGN */
+	unsigned int color_next;
+
+	/** full and empty magazines not loaded on any CPU */
+	struct slab_magazine *depot_full;
+	struct slab_magazine *depot_empty;
+	unsigned int depot_full_nr;
+	unsigned int depot_empty_nr;
+
+	struct slab_cpu_cache cpu[NCPU];
+
+	/** slabs allocated and objects handed out from them */
+	unsigned int slabs_nr;
+	unsigned int objs_inuse;
+	unsigned long slab_allocs;
+	unsigned long alloc_failed;
 };
 
 #define __CACHE_DEF(cache_nm, object_t, objects_nr) \
 	static struct cache cache_nm =  {                      \
 		.num = (objects_nr),              \
 		.obj_size = sizeof(object_t),                  \
+		.lock = SPIN_STATIC_UNLOCKED,                  \
 	};                                                     \
 	extern const struct mod_member_ops __cache_member_ops; \
 	MOD_MEMBER_BIND(&__cache_member_ops, &cache_nm)
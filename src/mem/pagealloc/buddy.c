@@ -0,0 +1,502 @@
+/**
+ * @file
+ * @brief Buddy page allocator
+ * @details
+ *    Free memory is kept as blocks of 2^order pages, aligned to their size
+ *    relative to the first page, in a list per order. A free block starts
+ *    with struct page_buddy_block and its first page is marked in the
+ *    allocator bitmap, so the buddy of a freed block is checked in O(1)
+ *    and blocks are coalesced on free in O(log n).
+ *
+ *    Allocations of a number of pages which is not a power of two take
+ *    the next order block and return its tail, frees split the range back
+ *    into aligned blocks. So page_free() only needs the page count, as
+ *    before.
+ *
+ *    A request no single free block is large enough for falls back to
+ *    looking for a run of adjacent free blocks.
+ *
+ *    Single pages are also cached per CPU. The lists are refilled from and
+ *    flushed to the buddy lists in batches, and are drained when a larger
+ *    allocation fails.
+ *
+ * @date 19.10.2026
+ */
+
+#include <util/log.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <string.h>
+#include <util/binalign.h>
+#include <lib/libds/bitmap.h>
+
+#include <hal/cpu.h>
+#include <hal/ipl.h>
+#include <kernel/spinlock.h>
+
+#include <mem/page.h>
+
+#define HOT_PAGES OPTION_GET(NUMBER, hot_pages)
+#define HOT_BATCH ((HOT_PAGES + 1) / 2)
+
+struct page_buddy_block {
+	struct page_buddy_block *next;
+	struct page_buddy_block *prev;
+	unsigned int order;
+};
+
+static inline unsigned int page_ptr2i(struct page_allocator *allocator,
+		void *page) {
+	return ((char *) page - (char *) allocator->pages_start)
+		/ allocator->page_size;
+}
+
+static inline struct page_buddy_block *page_i2block(
+		struct page_allocator *allocator, unsigned int i) {
+	return (void *) ((char *) allocator->pages_start
+		+ (size_t) i * allocator->page_size);
+}
+
+static unsigned int order_of(size_t page_q) {
+	unsigned int order = 0;
+
+	while (((size_t) 1 << order) < page_q) {
+		order++;
+	}
+
+	return order;
+}
+
+/* Called with the allocator lock held */
+static void block_insert(struct page_allocator *allocator, unsigned int i,
+		unsigned int order) {
+	struct page_buddy *buddy = &allocator->buddy;
+	struct page_buddy_block *block = page_i2block(allocator, i);
+
+	block->order = order;
+	block->prev = NULL;
+	block->next = buddy->free_list[order];
+	if (block->next) {
+		block->next->prev = block;
+	}
+	buddy->free_list[order] = block;
+	buddy->nr_free[order]++;
+
+	bitmap_set_bit(allocator->bitmap, i);
+}
+
+/* Called with the allocator lock held */
+static void block_remove(struct page_allocator *allocator, unsigned int i) {
+	struct page_buddy *buddy = &allocator->buddy;
+	struct page_buddy_block *block = page_i2block(allocator, i);
+
+	if (block->prev) {
+		block->prev->next = block->next;
+	} else {
+		buddy->free_list[block->order] = block->next;
+	}
+	if (block->next) {
+		block->next->prev = block->prev;
+	}
+	buddy->nr_free[block->order]--;
+
+	bitmap_clear_bit(allocator->bitmap, i);
+}
+
+static inline int block_is_free(struct page_allocator *allocator,
+		unsigned int i, unsigned int order) {
+	return bitmap_test_bit(allocator->bitmap, i)
+		&& page_i2block(allocator, i)->order == order;
+}
+
+/* Called with the allocator lock held */
+static void block_free(struct page_allocator *allocator, unsigned int i,
+		unsigned int order) {
+	unsigned int buddy_i;
+
+	while (order < PAGE_BUDDY_ORDERS - 1) {
+		buddy_i = i ^ (1u << order);
+		if (buddy_i + (1u << order) > allocator->pages_n
+				|| !block_is_free(allocator, buddy_i, order)) {
+			break;
+		}
+		block_remove(allocator, buddy_i);
+		i &= ~(1u << order);
+		order++;
+	}
+
+	block_insert(allocator, i, order);
+}
+
+/* Called with the allocator lock held */
+static void range_free(struct page_allocator *allocator, unsigned int i,
+		unsigned int page_q) {
+	unsigned int order;
+
+	allocator->free += (size_t) page_q * allocator->page_size;
+
+	while (page_q) {
+		/* Largest block aligned at @c i which fits the range */
+		order = 0;
+		while (order < PAGE_BUDDY_ORDERS - 1
+				&& !(i & (1u << order))
+				&& (2u << order) <= page_q) {
+			order++;
+		}
+
+		block_free(allocator, i, order);
+		i += 1u << order;
+		page_q -= 1u << order;
+	}
+}
+
+/* Looks for @c page_q pages in adjacent free blocks, for the requests
+ * which no single block is large enough for.
+ * Called with the allocator lock held */
+static void *range_alloc_scan(struct page_allocator *allocator, size_t page_q) {
+	unsigned int start, i, order;
+
+	i = 0;
+	while (i < allocator->pages_n) {
+		i = bitmap_find_bit(allocator->bitmap, allocator->pages_n, i);
+		if (i >= allocator->pages_n) {
+			break;
+		}
+
+		start = i;
+		while (i < allocator->pages_n && bitmap_test_bit(allocator->bitmap, i)
+				&& i - start < page_q) {
+			i += 1u << page_i2block(allocator, i)->order;
+		}
+		if (i - start < page_q) {
+			continue;
+		}
+
+		for (i = start; i < start + page_q; i += 1u << order) {
+			order = page_i2block(allocator, i)->order;
+			block_remove(allocator, i);
+		}
+		allocator->free -= (size_t) (i - start) * allocator->page_size;
+
+		if (i - start > page_q) {
+			range_free(allocator, start + page_q, i - start - page_q);
+		}
+
+		return page_i2block(allocator, start);
+	}
+
+	return NULL;
+}
+
+/* Called with the allocator lock held */
+static void *range_alloc(struct page_allocator *allocator, size_t page_q) {
+	struct page_buddy *buddy = &allocator->buddy;
+	unsigned int order, k, i;
+
+	order = order_of(page_q);
+	for (k = order; k < PAGE_BUDDY_ORDERS; k++) {
+		if (buddy->free_list[k]) {
+			break;
+		}
+	}
+	if (k == PAGE_BUDDY_ORDERS) {
+		return range_alloc_scan(allocator, page_q);
+	}
+
+	i = page_ptr2i(allocator, buddy->free_list[k]);
+	block_remove(allocator, i);
+
+	/* Split down to the order we need */
+	while (k > order) {
+		k--;
+		block_insert(allocator, i + (1u << k), k);
+	}
+
+	allocator->free -= ((size_t) 1 << order) * allocator->page_size;
+
+	/* Give back the tail we do not need */
+	if (page_q < (1u << order)) {
+		range_free(allocator, i + page_q, (1u << order) - page_q);
+	}
+
+	return page_i2block(allocator, i);
+}
+
+static void page_buddy_setup(struct page_allocator *allocator) {
+	struct page_buddy *buddy = &allocator->buddy;
+	ipl_t ipl;
+	int cpu;
+
+	ipl = spin_lock_ipl(&buddy->lock);
+	if (!buddy->ready) {
+		memset(buddy->free_list, 0, sizeof(buddy->free_list));
+		memset(buddy->nr_free, 0, sizeof(buddy->nr_free));
+		buddy->alloc_failed = 0;
+		for (cpu = 0; cpu < NCPU; cpu++) {
+			spin_init(&buddy->hot[cpu].lock, __SPIN_UNLOCKED);
+			buddy->hot[cpu].pages = NULL;
+			buddy->hot[cpu].count = 0;
+		}
+
+		bitmap_clear_all(allocator->bitmap, allocator->pages_n);
+		allocator->free = 0;
+		range_free(allocator, 0, allocator->pages_n);
+
+		buddy->ready = 1;
+	}
+	spin_unlock_ipl(&buddy->lock, ipl);
+}
+
+static inline void page_buddy_check(struct page_allocator *allocator) {
+	if (!allocator->buddy.ready) {
+		page_buddy_setup(allocator);
+	}
+}
+
+/* Called with the hot list lock held */
+static void hot_flush(struct page_allocator *allocator,
+		struct page_buddy_hot *hot, unsigned int n) {
+	void *page;
+
+	spin_lock(&allocator->buddy.lock);
+	while (n-- && hot->pages) {
+		page = hot->pages;
+		hot->pages = *(void **) page;
+		hot->count--;
+		range_free(allocator, page_ptr2i(allocator, page), 1);
+	}
+	spin_unlock(&allocator->buddy.lock);
+}
+
+/* Called with the hot list lock held */
+static void hot_refill(struct page_allocator *allocator,
+		struct page_buddy_hot *hot) {
+	void *page;
+	int n;
+
+	spin_lock(&allocator->buddy.lock);
+	for (n = 0; n < HOT_BATCH; n++) {
+		page = range_alloc(allocator, 1);
+		if (!page) {
+			break;
+		}
+		*(void **) page = hot->pages;
+		hot->pages = page;
+		hot->count++;
+	}
+	spin_unlock(&allocator->buddy.lock);
+}
+
+static void *hot_alloc(struct page_allocator *allocator) {
+	struct page_buddy_hot *hot;
+	void *page;
+	ipl_t ipl;
+
+	ipl = ipl_save();
+	hot = &allocator->buddy.hot[cpu_get_id()];
+	spin_lock(&hot->lock);
+
+	if (!hot->pages) {
+		hot_refill(allocator, hot);
+	}
+	page = hot->pages;
+	if (page) {
+		hot->pages = *(void **) page;
+		hot->count--;
+	}
+
+	spin_unlock(&hot->lock);
+	ipl_restore(ipl);
+
+	return page;
+}
+
+static void hot_free(struct page_allocator *allocator, void *page) {
+	struct page_buddy_hot *hot;
+	ipl_t ipl;
+
+	ipl = ipl_save();
+	hot = &allocator->buddy.hot[cpu_get_id()];
+	spin_lock(&hot->lock);
+
+	if (hot->count >= HOT_PAGES) {
+		hot_flush(allocator, hot, HOT_BATCH);
+	}
+	*(void **) page = hot->pages;
+	hot->pages = page;
+	hot->count++;
+
+	spin_unlock(&hot->lock);
+	ipl_restore(ipl);
+}
+
+/* Returns pages cached on all CPUs to the buddy lists */
+static void hot_drain(struct page_allocator *allocator) {
+	struct page_buddy_hot *hot;
+	ipl_t ipl;
+	int cpu;
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		hot = &allocator->buddy.hot[cpu];
+		ipl = spin_lock_ipl(&hot->lock);
+		hot_flush(allocator, hot, hot->count);
+		spin_unlock_ipl(&hot->lock, ipl);
+	}
+}
+
+static void *buddy_alloc(struct page_allocator *allocator, size_t page_q) {
+	void *page;
+	ipl_t ipl;
+
+	ipl = spin_lock_ipl(&allocator->buddy.lock);
+	page = range_alloc(allocator, page_q);
+	spin_unlock_ipl(&allocator->buddy.lock, ipl);
+
+	return page;
+}
+
+void *page_alloc(struct page_allocator *allocator, size_t page_q) {
+	void *page = NULL;
+	ipl_t ipl;
+
+	assert(allocator);
+
+	if (page_q == 0 || order_of(page_q) >= PAGE_BUDDY_ORDERS
+			|| page_q > allocator->pages_n) {
+		return NULL;
+	}
+
+	page_buddy_check(allocator);
+
+	if (HOT_PAGES && page_q == 1) {
+		page = hot_alloc(allocator);
+	}
+	if (!page) {
+		page = buddy_alloc(allocator, page_q);
+	}
+	if (!page && HOT_PAGES) {
+		hot_drain(allocator);
+		page = buddy_alloc(allocator, page_q);
+	}
+
+	if (!page) {
+		ipl = spin_lock_ipl(&allocator->buddy.lock);
+		allocator->buddy.alloc_failed++;
+		spin_unlock_ipl(&allocator->buddy.lock, ipl);
+		log_debug("allocator(%p) failed to allocate %zu pages",
+				allocator, page_q);
+	}
+
+	return page;
+}
+
+void *page_alloc_zero(struct page_allocator *allocator, size_t page_q) {
+	char *page_p;
+
+	if (NULL != (page_p = page_alloc(allocator, page_q))) {
+		memset(page_p, 0, page_q * allocator->page_size);
+	}
+
+	return page_p;
+}
+
+void page_free(struct page_allocator *allocator, void *page, size_t page_q) {
+	ipl_t ipl;
+
+	assert(allocator);
+	assert(page_belong(allocator, page));
+	assert(page_ptr2i(allocator, page) + page_q <= allocator->pages_n);
+
+	if (page_q == 0) {
+		return;
+	}
+
+	page_buddy_check(allocator);
+
+	if (HOT_PAGES && page_q == 1) {
+		hot_free(allocator, page);
+		return;
+	}
+
+	ipl = spin_lock_ipl(&allocator->buddy.lock);
+	range_free(allocator, page_ptr2i(allocator, page), page_q);
+	spin_unlock_ipl(&allocator->buddy.lock, ipl);
+}
+
+struct page_allocator *page_allocator_init(char *start, size_t len, size_t page_size) {
+	char *pages_start;
+	struct page_allocator *allocator;
+	unsigned int pages;
+	size_t bitmap_len;
+
+	if (len < page_size + sizeof(struct page_allocator)
+			|| page_size < sizeof(struct page_buddy_block)) {
+		return NULL;
+	}
+
+	start = (char *) binalign_bound((uintptr_t) start, 16);
+	pages = len / page_size;
+	pages_start = (char *) binalign_bound((uintptr_t) start, page_size);
+
+	bitmap_len = sizeof(unsigned long) * BITMAP_SIZE(pages);
+
+	while (sizeof(struct page_allocator) + bitmap_len > pages_start - start) {
+		pages_start += page_size;
+		pages--;
+		if (pages <= 0) {
+			return NULL;
+		}
+	}
+
+	allocator = (struct page_allocator *) start;
+	log_debug("allocator(%p)", allocator);
+
+	allocator->pages_start = pages_start;
+	allocator->pages_n = pages;
+	allocator->page_size = page_size;
+	allocator->bitmap_len = bitmap_len;
+	allocator->bitmap = (unsigned long *) (allocator + 1);
+
+	log_debug("allocator->bitmap(%p) bitmap_len(%zu)", allocator->bitmap,
+			bitmap_len);
+
+	allocator->buddy.ready = 0;
+	spin_init(&allocator->buddy.lock, __SPIN_UNLOCKED);
+	page_buddy_setup(allocator);
+
+	return allocator;
+}
+
+int page_belong(struct page_allocator *allocator, void *page) {
+	void *pages_end = allocator->pages_start + allocator->pages_n * allocator->page_size;
+	return allocator->pages_start <= page && page < pages_end;
+}
+
+void page_buddy_stats(struct page_allocator *allocator,
+		struct page_buddy_stats *stats) {
+	struct page_buddy *buddy = &allocator->buddy;
+	ipl_t ipl;
+	int k, cpu;
+
+	page_buddy_check(allocator);
+
+	memset(stats, 0, sizeof(*stats));
+	stats->largest_order = -1;
+
+	ipl = spin_lock_ipl(&buddy->lock);
+	for (k = 0; k < PAGE_BUDDY_ORDERS; k++) {
+		stats->free_blocks[k] = buddy->nr_free[k];
+		stats->free_pages += (size_t) buddy->nr_free[k] << k;
+		if (buddy->nr_free[k]) {
+			stats->largest_order = k;
+		}
+	}
+	stats->alloc_failed = buddy->alloc_failed;
+	spin_unlock_ipl(&buddy->lock, ipl);
+
+	/* Just a snapshot, no need to stop the other CPUs */
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		stats->hot_pages += buddy->hot[cpu].count;
+	}
+}
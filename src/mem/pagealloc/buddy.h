@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @brief Buddy page allocator
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef MEM_PAGEALLOC_BUDDY_H_
+#define MEM_PAGEALLOC_BUDDY_H_
+
+#define PAGE_SIZE() OPTION_MODULE_GET(embox__mem__buddy,NUMBER,page_size)
+
+#ifndef __LDS__
+
+#include <stddef.h>
+
+#include <hal/cpu.h>
+#include <kernel/spinlock.h>
+
+/* Blocks are up to 2^(PAGE_BUDDY_ORDERS - 1) pages */
+#define PAGE_BUDDY_ORDERS 21
+
+struct page_buddy_block;
+
+/* Single pages recently freed on a CPU, linked through the pages */
+struct page_buddy_hot {
+	spinlock_t lock;
+	void *pages;
+	unsigned int count;
+};
+
+struct page_buddy {
+	int ready;
+	spinlock_t lock;
+	struct page_buddy_block *free_list[PAGE_BUDDY_ORDERS];
+	unsigned int nr_free[PAGE_BUDDY_ORDERS];
+	unsigned long alloc_failed;
+	struct page_buddy_hot hot[NCPU];
+};
+
+#define PAGE_ALLOCATOR_PRIVATE      struct page_buddy buddy;
+#define PAGE_ALLOCATOR_PRIVATE_INIT { 0, SPIN_STATIC_UNLOCKED }
+
+struct page_buddy_stats {
+	unsigned int free_blocks[PAGE_BUDDY_ORDERS];
+	size_t free_pages;      /* in free blocks, @c free_blocks */
+	size_t hot_pages;       /* in per-CPU lists */
+	int largest_order;      /* -1 if there are no free blocks */
+	unsigned long alloc_failed;
+};
+
+struct page_allocator;
+
+extern void page_buddy_stats(struct page_allocator *allocator,
+		struct page_buddy_stats *stats);
+
+#endif /* __LDS__ */
+
+#endif /* MEM_PAGEALLOC_BUDDY_H_ */
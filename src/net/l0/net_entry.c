@@ -22,9 +22,12 @@
 #include <net/l0/net_rx.h>
 #include <kernel/sched/schedee_priority.h>
 #include <kernel/lthread/lthread.h>
+#include <kernel/kcounter.h>
 
 #define NETIF_RX_HND_PRIORITY OPTION_GET(NUMBER, hnd_priority)
 
+KCOUNTER_DEF(net_drop_tx_err, "net.drop.tx_err");
+
 static DLIST_DEFINE(netif_rx_list);
 
 static int netif_rx_action(struct lthread *self);
@@ -104,6 +107,7 @@ static int netif_tx_action(struct lthread *self) {
 					log_debug("xmit = %d", ret);
 					skb_free(skb);
 					dev->stats.tx_err++;
+					kcounter_inc(net_drop_tx_err);
 					continue;
 				}
 
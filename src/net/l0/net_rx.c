@@ -21,6 +21,11 @@
 #include <net/netdevice.h>
 #include <net/skbuff.h>
 #include <net/socket/packet.h>
+#include <kernel/kcounter.h>
+
+KCOUNTER_DEF(net_drop_l2_len, "net.drop.l2_len");
+KCOUNTER_DEF(net_drop_not_for_us, "net.drop.not_for_us");
+KCOUNTER_DEF(net_drop_l3_proto, "net.drop.l3_proto");
 
 int net_rx(struct sk_buff *skb) {
 	const struct net_pack *npack;
@@ -31,6 +36,7 @@ int net_rx(struct sk_buff *skb) {
 	assert(skb->dev != NULL);
 	if (skb->len < skb->dev->hdr_len) {
 		log_error("%p invalid length %zu", skb, skb->len);
+		kcounter_inc(net_drop_l2_len);
 		skb_free(skb);
 		return 0; /* error: invalid size */
 	}
@@ -41,6 +47,7 @@ int net_rx(struct sk_buff *skb) {
 	switch (pkt_type(skb)) {
 	default:
 		log_debug("%p not for us", skb);
+		kcounter_inc(net_drop_not_for_us);
 		skb_free(skb);
 		return 0; /* ok, but: not for us */
 	case PACKET_HOST:
@@ -71,6 +78,7 @@ int net_rx(struct sk_buff *skb) {
 	npack = net_pack_lookup(type);
 	if (npack == NULL) {
 		log_debug("%p unknown type %#.6hx", skb, type);
+		kcounter_inc(net_drop_l3_proto);
 		skb_free(skb);
 		return 0; /* ok, but: not supported */
 	}
@@ -37,6 +37,15 @@ int net_tx_direct(struct sk_buff *skb) {
 		return -ENETDOWN;
 	}
 
+	if (skb->frags != NULL && !(dev->features & NETIF_F_SG)) {
+		/* The driver sends linear data only */
+		if (skb_linearize(skb) != 0) {
+			log_error("no memory to linearize skb");
+			skb_free(skb);
+			return -ENOMEM;
+		}
+	}
+
 	log_debug("%p len %zu type %#.6hx", skb, skb->len, ntohs(skb->mac.ethh->h_proto));
 
 	/*
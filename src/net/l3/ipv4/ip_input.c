@@ -29,6 +29,13 @@
 
 #include <embox/net/proto.h>
 #include <embox/net/pack.h>
+#include <kernel/kcounter.h>
+
+KCOUNTER_DEF(net_drop_ip_hdr, "net.drop.ip_hdr");
+KCOUNTER_DEF(net_drop_ip_csum, "net.drop.ip_csum");
+KCOUNTER_DEF(net_drop_netfilter, "net.drop.netfilter");
+KCOUNTER_DEF(net_drop_no_inetdev, "net.drop.no_inetdev");
+KCOUNTER_DEF(net_drop_l4_proto, "net.drop.l4_proto");
 
 EMBOX_NET_PACK(ETH_P_IP, ip_rcv);
 
@@ -54,6 +61,7 @@ static int ip_rcv(struct sk_buff *skb, struct net_device *dev) {
 			|| skb->len < dev->hdr_len + IP_HEADER_SIZE(iph)) {
 		log_debug("ip_rcv: invalid IPv4 header length");
 		stats->rx_length_errors++;
+		kcounter_inc(net_drop_ip_hdr);
 		skb_free(skb);
 		return 0; /* error: invalid header length */
 	}
@@ -62,6 +70,7 @@ static int ip_rcv(struct sk_buff *skb, struct net_device *dev) {
 	if (iph->version != 4) {
 		log_debug("ip_rcv: invalid IPv4 version");
 		stats->rx_err++;
+		kcounter_inc(net_drop_ip_hdr);
 		skb_free(skb);
 		return 0; /* error: not ipv4 */
 	}
@@ -72,6 +81,7 @@ static int ip_rcv(struct sk_buff *skb, struct net_device *dev) {
 		log_debug("ip_rcv: invalid checksum %hx(%hx)",
 				ntohs(old_check), ntohs(iph->check));
 		stats->rx_crc_errors++;
+		kcounter_inc(net_drop_ip_csum);
 		skb_free(skb);
 		return 0; /* error: invalid crc */
 	}
@@ -81,6 +91,7 @@ static int ip_rcv(struct sk_buff *skb, struct net_device *dev) {
 			|| skb->len < dev->hdr_len + ip_len) {
 		log_debug("ip_rcv: invalid IPv4 length");
 		stats->rx_length_errors++;
+		kcounter_inc(net_drop_ip_hdr);
 		skb_free(skb);
 		return 0; /* error: invalid length */
 	}
@@ -92,6 +103,7 @@ static int ip_rcv(struct sk_buff *skb, struct net_device *dev) {
 	if (0 != nf_test_skb(NF_CHAIN_INPUT, NF_TARGET_ACCEPT, skb)) {
 		log_debug("ip_rcv: dropped by input netfilter");
 		stats->rx_dropped++;
+		kcounter_inc(net_drop_netfilter);
 		skb_free(skb);
 		return 0; /* error: dropped */
 	}
@@ -100,6 +112,7 @@ static int ip_rcv(struct sk_buff *skb, struct net_device *dev) {
 	assert(skb->dev);
 	if (!inetdev_get_by_dev(skb->dev)) {
 		log_debug("ip_rcv: dropped by input  because inet_dev is not set");
+		kcounter_inc(net_drop_no_inetdev);
 		skb_free(skb);
 		return 0; /* didn't set inet dev yet */
 	}
@@ -123,6 +136,7 @@ static int ip_rcv(struct sk_buff *skb, struct net_device *dev) {
 			if (0 != nf_test_skb(NF_CHAIN_FORWARD, NF_TARGET_ACCEPT, skb)) {
 				log_debug("ip_rcv: dropped by forward netfilter");
 				stats->rx_dropped++;
+				kcounter_inc(net_drop_netfilter);
 				skb_free(skb);
 				return 0; /* error: dropped */
 			}
@@ -145,6 +159,7 @@ static int ip_rcv(struct sk_buff *skb, struct net_device *dev) {
 		if (ip_options_compile(skb, opts)) {
 			log_debug("ip_rcv: invalid options");
 			stats->rx_err++;
+			kcounter_inc(net_drop_ip_hdr);
 			skb_free(skb);
 			return 0; /* error: bad ops */
 		}
@@ -181,6 +196,7 @@ static int ip_rcv(struct sk_buff *skb, struct net_device *dev) {
 	}
 
 	log_debug("ip_rcv: unknown protocol %d", iph->proto);
+	kcounter_inc(net_drop_l4_proto);
 	skb_free(skb);
 	return 0; /* error: nobody wants this packet */
 }
@@ -28,8 +28,14 @@
 #include <net/lib/ipv4.h>
 #include <net/lib/ipv6.h>
 
+#include <kernel/kcounter.h>
+
 #define MODOPS_VERIFY_CHKSUM OPTION_GET(BOOLEAN, verify_chksum)
 
+KCOUNTER_DEF(net_drop_udp_csum, "net.drop.udp_csum");
+KCOUNTER_DEF(net_drop_udp_dst, "net.drop.udp_dst");
+KCOUNTER_DEF(net_drop_udp_no_port, "net.drop.udp_no_port");
+
 EMBOX_NET_PROTO(ETH_P_IP, IPPROTO_UDP, udp_rcv, udp_err);
 EMBOX_NET_PROTO(ETH_P_IPV6, IPPROTO_UDP, udp_rcv,
 		net_proto_handle_error_none);
@@ -91,6 +97,7 @@ static int udp_rcv(struct sk_buff *skb) {
 		old_check = skb->h.uh->check;
 		udp_set_check_field(skb->h.uh, skb->nh.raw);
 		if (old_check != skb->h.uh->check) {
+			kcounter_inc(net_drop_udp_csum);
 			return 0; /* error: bad checksum */
 		}
 	}
@@ -107,10 +114,12 @@ static int udp_rcv(struct sk_buff *skb) {
 					udp_data_length(udp_hdr(skb)));
 		}
 		else {
+			kcounter_inc(net_drop_udp_dst);
 			skb_free(skb);
 		}
 	}
 	else {
+		kcounter_inc(net_drop_udp_no_port);
 		icmp_discard(skb, ICMP_DEST_UNREACH, ICMP_PORT_UNREACH);
 	}
 
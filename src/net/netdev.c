@@ -65,6 +65,7 @@ static int netdev_init(struct net_device *dev, const char *name,
 	memset(&dev->stats, 0, sizeof dev->stats);
 	skb_queue_init(&dev->dev_queue);
 	skb_queue_init(&dev->dev_queue_tx);
+	dev->features = 0;
 
 	if (priv_size != 0) {
 		dev->priv = sysmalloc(priv_size);
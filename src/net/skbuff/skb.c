@@ -9,6 +9,7 @@
 */
 
 #include <assert.h>
+#include <errno.h>
 #include <string.h>
 #include <stdint.h>
 #include <sys/uio.h>
@@ -29,7 +30,59 @@
 #include <framework/mod/options.h>
 
 #define MODOPS_AMOUNT_SKB       OPTION_GET(NUMBER, amount_skb)
+#define MODOPS_AMOUNT_SKB_FRAGS OPTION_GET(NUMBER, amount_skb_frags)
+
 POOL_DEF(skb_pool, struct sk_buff, MODOPS_AMOUNT_SKB);
+#if MODOPS_AMOUNT_SKB_FRAGS
+POOL_DEF(skb_frags_pool, struct sk_buff_frags, MODOPS_AMOUNT_SKB_FRAGS);
+#endif
+
+static void skb_frags_get(struct sk_buff_frags *frags) {
+	ipl_t sp;
+
+	sp = ipl_save();
+	{
+		++frags->links;
+	}
+	ipl_restore(sp);
+}
+
+static void skb_frags_put(struct sk_buff_frags *frags) {
+	ipl_t sp;
+	int i, links;
+
+	sp = ipl_save();
+	{
+		links = --frags->links;
+	}
+	ipl_restore(sp);
+
+	assert(links >= 0);
+	if (links) {
+		return;
+	}
+
+	for (i = 0; i < frags->nr; i++) {
+		if (frags->frag[i].release) {
+			frags->frag[i].release(frags->frag[i].data);
+		}
+	}
+
+#if MODOPS_AMOUNT_SKB_FRAGS
+	sp = ipl_save();
+	{
+		pool_free(&skb_frags_pool, frags);
+	}
+	ipl_restore(sp);
+#endif
+}
+
+static void skb_drop_frags(struct sk_buff *skb) {
+	if (skb->frags) {
+		skb_frags_put(skb->frags);
+		skb->frags = NULL;
+	}
+}
 
 struct sk_buff * skb_wrap(size_t size, struct sk_buff_data *skb_data) {
 	return skb_wrap_local(size, skb_data, &skb_pool);
@@ -68,6 +121,7 @@ struct sk_buff * skb_wrap_local(size_t size, struct sk_buff_data *skb_data,
 	skb->len = size;
 	skb->nh.raw = skb->h.raw = NULL;
 	skb->data = skb_data;
+	skb->frags = NULL;
 	skb->mac.raw = skb_get_data_pointner(skb_data);
 	skb->p_data = skb->p_data_end = NULL;
 	skb->pl = pl;
@@ -98,10 +152,26 @@ struct sk_buff * skb_alloc_local(size_t size, struct pool *pl) {
 }
 
 struct sk_buff * skb_realloc(size_t size, struct sk_buff *skb) {
+	struct sk_buff_data *skb_data;
+
 	if (skb == NULL) {
 		return skb_alloc(size);
 	}
 
+	if (size > skb_data_size(skb->data)) {
+		/* Data may come from a smaller size class */
+		skb_data = skb_data_alloc(size);
+		if (skb_data == NULL) {
+			skb_free(skb);
+			return NULL; /* error: no memory */
+		}
+		memcpy(skb_get_data_pointner(skb_data),
+				skb_get_data_pointner(skb->data), skb_data_size(skb->data));
+		skb_data_free(skb->data);
+		skb->data = skb_data;
+	}
+
+	skb_drop_frags(skb);
 	list_del_init((struct list_head *) skb);
 	skb->dev = NULL;
 	skb->len = size;
@@ -119,6 +189,7 @@ void skb_free(struct sk_buff *skb) {
 	}
 
 	skb_data_free(skb->data);
+	skb_drop_frags(skb);
 
 	sp = ipl_save();
 	{
@@ -148,6 +219,12 @@ static void skb_copy_ref(struct sk_buff *to, const struct sk_buff *from) {
 		to->h.raw = from->h.raw + offset;
 	}
 	to->p_data = to->p_data_end = NULL;
+
+	/* Fragments are never written to, so they are shared */
+	if (from->frags != NULL) {
+		skb_frags_get(from->frags);
+		to->frags = from->frags;
+	}
 }
 
 static void skb_shift_ref(struct sk_buff *skb, ptrdiff_t offset) {
@@ -177,11 +254,12 @@ struct sk_buff * skb_copy(const struct sk_buff *skb) {
 
 	assert(skb != NULL);
 
-	copied = skb_alloc(skb->len);
+	copied = skb_alloc(skb_data_size(skb->data));
 	if (copied == NULL) {
 		return NULL; /* error: no memory */
 	}
 
+	copied->len = skb->len;
 	skb_copy_ref(copied, skb);
 	skb_copy_data(copied->data, skb);
 
@@ -223,7 +301,7 @@ struct sk_buff * skb_declone(struct sk_buff *skb) {
 			goto out;
 		}
 
-		decloned_data = skb_data_alloc(skb->len);
+		decloned_data = skb_data_alloc(skb_data_size(skb->data));
 		if (decloned_data == NULL) {
 			skb = NULL;
 			goto out;
@@ -244,13 +322,97 @@ out:
 }
 
 void skb_rshift(struct sk_buff *skb, size_t count) {
+	size_t size;
+
 	assert(skb != NULL);
 	assert(skb->data != NULL);
-	assert(count < skb_max_size());
+
+	size = skb_data_size(skb->data);
+	assert(count < size);
 	memmove(skb_get_data_pointner(skb->data) + count,
 			skb_get_data_pointner(skb->data),
-			min(skb->len, skb_max_size() - count));
-	skb->len += min(count, skb_max_size() - count);
+			min(skb->len, size - count));
+	skb->len += min(count, size - count);
+}
+
+int skb_add_frag(struct sk_buff *skb, void *data, size_t len,
+		void (*release)(void *data)) {
+	struct sk_buff_frags *frags;
+	struct sk_buff_frag *frag;
+	ipl_t sp;
+
+	assert(skb != NULL);
+	assert(data != NULL);
+
+	frags = skb->frags;
+	if (frags == NULL) {
+#if MODOPS_AMOUNT_SKB_FRAGS
+		sp = ipl_save();
+		{
+			frags = pool_alloc(&skb_frags_pool);
+		}
+		ipl_restore(sp);
+#endif
+		if (frags == NULL) {
+			return -ENOMEM;
+		}
+		frags->links = 1;
+		frags->nr = 0;
+		frags->len = 0;
+		skb->frags = frags;
+	}
+
+	/* The list may be shared with clones which must not see the change */
+	if (frags->links != 1 || frags->nr == SKB_FRAGS_MAX) {
+		return -ENOSPC;
+	}
+
+	frag = &frags->frag[frags->nr++];
+	frag->data = data;
+	frag->len = len;
+	frag->release = release;
+	frags->len += len;
+
+	return 0;
+}
+
+int skb_linearize(struct sk_buff *skb) {
+	struct sk_buff_data *skb_data;
+	struct sk_buff_frags *frags;
+	unsigned char *tail;
+	int i;
+
+	assert(skb != NULL);
+
+	frags = skb->frags;
+	if (frags == NULL) {
+		return 0;
+	}
+
+	skb_data = skb->data;
+	if (skb_data_cloned(skb_data)
+			|| skb->len + frags->len > skb_data_size(skb_data)) {
+		skb_data = skb_data_alloc(skb->len + frags->len);
+		if (skb_data == NULL) {
+			return -ENOMEM;
+		}
+		skb_shift_ref(skb, skb_get_data_pointner(skb_data)
+				- skb_get_data_pointner(skb->data));
+		skb_copy_data(skb_data, skb);
+		skb_data_free(skb->data);
+		skb->data = skb_data;
+	}
+
+	tail = skb_get_data_pointner(skb->data) + skb->len;
+	for (i = 0; i < frags->nr; i++) {
+		memcpy(tail, frags->frag[i].data, frags->frag[i].len);
+		tail += frags->frag[i].len;
+	}
+	skb->len += frags->len;
+
+	skb_drop_frags(skb);
+
+	return 0;
 }
 
 size_t skb_read(struct sk_buff *skb, char *buff, size_t buff_sz) {
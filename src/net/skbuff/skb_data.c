@@ -1,6 +1,9 @@
 /**
  * @file
- * @details sk_buff management API implementation.
+ * @details sk_buff data allocation. Data comes from the smallest size
+ *    class which fits: a pool of small buffers for ACKs and other short
+ *    frames, a pool of MTU sized buffers, or whole pages for larger
+ *    frames up to large_data_size.
  * @date 20.10.09
  *
  * @author Anton Bondarev
@@ -22,6 +25,7 @@
 #include <hal/ipl.h>
 
 #include <mem/misc/pool.h>
+#include <mem/page.h>
 
 #include <net/skbuff.h>
 
@@ -31,47 +35,66 @@
 #define MODOPS_DATA_SIZE        OPTION_GET(NUMBER, data_size)
 #define MODOPS_DATA_ALIGN       OPTION_GET(NUMBER, data_align)
 #define MODOPS_DATA_PADTO       OPTION_GET(NUMBER, data_padto)
+#define MODOPS_AMOUNT_SMALL     OPTION_GET(NUMBER, amount_small_skb_data)
+#define MODOPS_SMALL_SIZE       OPTION_GET(NUMBER, small_data_size)
+#define MODOPS_LARGE_SIZE       OPTION_GET(NUMBER, large_data_size)
 
 #define IP_ALIGN_SIZE \
 	(OPTION_GET(BOOLEAN, ip_align) ? 2 : 0)
 
-#define DATA_PAD_SIZE \
-	PAD_SIZE(IP_ALIGN_SIZE + MODOPS_DATA_SIZE, MODOPS_DATA_PADTO)
 #if MODOPS_DATA_ALIGN > 1
 #define DATA_ATTR \
 	__attribute__((aligned(MODOPS_DATA_ALIGN)))
 #else
 #define DATA_ATTR
 #endif
-#define SKB_DATA_SIZE(size) \
-	IP_ALIGN_SIZE + MODOPS_DATA_SIZE + (size) + sizeof(size_t)
 
-#define ALLOCATED_POOL 0
+/* Data follows the header, IP_ALIGN_SIZE bytes are left before it */
+#define SKB_DATA_OFFSET \
+	binalign_bound(sizeof(struct sk_buff_data) + IP_ALIGN_SIZE, \
+			MODOPS_DATA_ALIGN)
+
+#define SKB_DATA_ENTRY_SIZE(size) \
+	(SKB_DATA_OFFSET + (size) \
+		+ PAD_SIZE(IP_ALIGN_SIZE + (size), MODOPS_DATA_PADTO))
+
+#define ALLOCATED_POOL   0
 #define ALLOCATED_MALLOC 1
+#define ALLOCATED_SMALL  2
+#define ALLOCATED_PAGES  3
 
-struct sk_buff_data_fixed {
+struct sk_buff_data {
 	int links;
 	int alloc_type;
-
-	char __ip_align[IP_ALIGN_SIZE];
-	unsigned char data[MODOPS_DATA_SIZE] DATA_ATTR;
-	char __data_pad[DATA_PAD_SIZE];
+	size_t size;       /* usable bytes of data */
 };
 
+struct sk_buff_data_fixed {
+	char space[SKB_DATA_ENTRY_SIZE(MODOPS_DATA_SIZE)];
+} DATA_ATTR;
+
 POOL_DEF(skb_data_pool, struct sk_buff_data_fixed, MODOPS_AMOUNT_SKB_DATA);
 
-void *skb_get_data_pointner(struct sk_buff_data *data) {
-	struct sk_buff_data_fixed *skb_data = (void *)data;
+#if MODOPS_AMOUNT_SMALL
+struct sk_buff_data_small {
+	char space[SKB_DATA_ENTRY_SIZE(MODOPS_SMALL_SIZE)];
+} DATA_ATTR;
+
+POOL_DEF(skb_data_small_pool, struct sk_buff_data_small, MODOPS_AMOUNT_SMALL);
+#endif
+
+extern struct page_allocator *__heap_pgallocator;
 
-	return skb_data->data;
+void *skb_get_data_pointner(struct sk_buff_data *data) {
+	return (void *) data + SKB_DATA_OFFSET;
 }
 
 size_t skb_max_size(void) {
 	return MODOPS_DATA_SIZE;
 }
 
-static inline bool skb_data_is_huge(size_t size) {
-	return size > skb_max_size();
+size_t skb_data_size(const struct sk_buff_data *data) {
+	return data->size;
 }
 
 void * skb_data_cast_in(struct sk_buff_data *skb_data) {
@@ -81,23 +104,66 @@ void * skb_data_cast_in(struct sk_buff_data *skb_data) {
 
 struct sk_buff_data * skb_data_cast_out(void *data) {
 	assert(data != NULL);
-	return (void *)member_cast_out(data - IP_ALIGN_SIZE, struct sk_buff_data_fixed, __ip_align);
+	return data - SKB_DATA_OFFSET;
+}
+
+static inline size_t skb_data_pages(size_t size) {
+	return (SKB_DATA_OFFSET + size + PAGE_SIZE() - 1) / PAGE_SIZE();
+}
+
+/* Called with interrupts disabled. Takes the smallest class which fits
+ * @c size, small requests go to the next class if their pool is empty */
+static struct sk_buff_data *skb_data_do_alloc(size_t size) {
+	struct sk_buff_data *skb_data;
+	size_t pages;
+
+#if MODOPS_AMOUNT_SMALL
+	if (size <= MODOPS_SMALL_SIZE) {
+		skb_data = pool_alloc(&skb_data_small_pool);
+		if (skb_data) {
+			skb_data->alloc_type = ALLOCATED_SMALL;
+			skb_data->size = MODOPS_SMALL_SIZE;
+			return skb_data;
+		}
+	}
+#endif
+
+	if (size <= MODOPS_DATA_SIZE) {
+		skb_data = pool_alloc(&skb_data_pool);
+		if (skb_data) {
+			skb_data->alloc_type = ALLOCATED_POOL;
+			skb_data->size = MODOPS_DATA_SIZE;
+		}
+		return skb_data;
+	}
+
+	if (size <= MODOPS_LARGE_SIZE) {
+		/* Whole pages keep large frames off the general heap */
+		pages = skb_data_pages(size);
+		skb_data = page_alloc(__heap_pgallocator, pages);
+		if (skb_data) {
+			skb_data->alloc_type = ALLOCATED_PAGES;
+			skb_data->size = pages * PAGE_SIZE() - SKB_DATA_OFFSET;
+			return skb_data;
+		}
+	}
+
+	skb_data = sysmalloc(SKB_DATA_OFFSET + size);
+	if (skb_data) {
+		skb_data->alloc_type = ALLOCATED_MALLOC;
+		skb_data->size = size;
+	}
+
+	return skb_data;
 }
 
 struct sk_buff_data * skb_data_alloc(size_t size) {
 	ipl_t sp;
-	struct sk_buff_data_fixed *skb_data;
-	int alloc_type = -1;
+	struct sk_buff_data *skb_data;
 
 	sp = ipl_save();
 	{
-		if (!skb_data_is_huge(size)) {
-			skb_data = pool_alloc(&skb_data_pool);
-			alloc_type = ALLOCATED_POOL;
-		} else {
-			skb_data = sysmalloc(SKB_DATA_SIZE(size));
-			alloc_type = ALLOCATED_MALLOC;
-		}
+		skb_data = skb_data_do_alloc(size);
 	}
 	ipl_restore(sp);
 
@@ -106,14 +172,12 @@ struct sk_buff_data * skb_data_alloc(size_t size) {
 		return NULL; /* error: no memory */
 	}
 
-	skb_data->alloc_type = alloc_type;
 	skb_data->links = 1;
 
-	return (void *)skb_data;
+	return skb_data;
 }
 
-struct sk_buff_data * skb_data_clone(struct sk_buff_data *data) {
-	struct sk_buff_data_fixed *skb_data = (void *)data;
+struct sk_buff_data * skb_data_clone(struct sk_buff_data *skb_data) {
 	ipl_t sp;
 
 	assert(skb_data != NULL);
@@ -124,16 +188,14 @@ struct sk_buff_data * skb_data_clone(struct sk_buff_data *data) {
 	}
 	ipl_restore(sp);
 
-	return (void *)skb_data;
+	return skb_data;
 }
 
-int skb_data_cloned(const struct sk_buff_data *data) {
-	struct sk_buff_data_fixed *skb_data = (void *)data;
+int skb_data_cloned(const struct sk_buff_data *skb_data) {
 	return skb_data->links != 1;
 }
 
-void skb_data_free(struct sk_buff_data *data) {
-	struct sk_buff_data_fixed *skb_data = (void *)data;
+void skb_data_free(struct sk_buff_data *skb_data) {
 	ipl_t sp;
 
 	assert(skb_data != NULL);
@@ -148,6 +210,15 @@ void skb_data_free(struct sk_buff_data *data) {
 			case ALLOCATED_POOL:
 				pool_free(&skb_data_pool, skb_data);
 				break;
+#if MODOPS_AMOUNT_SMALL
+			case ALLOCATED_SMALL:
+				pool_free(&skb_data_small_pool, skb_data);
+				break;
+#endif
+			case ALLOCATED_PAGES:
+				page_free(__heap_pgallocator, skb_data,
+						skb_data_pages(skb_data->size));
+				break;
 			case ALLOCATED_MALLOC:
 				sysfree(skb_data);
 				break;
@@ -0,0 +1,108 @@
+/**
+ * @file
+ * @brief Page fragments for sk_buff data
+ * @details
+ *    Small buffers are carved one after another from the current page,
+ *    every buffer holds a reference on its page. The allocator holds one
+ *    more until it moves to a new page, so a page is freed once all its
+ *    buffers are freed and nothing more will be carved from it.
+ *
+ * @date 19.10.2026
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <util/binalign.h>
+#include <util/log.h>
+
+#include <hal/ipl.h>
+
+#include <mem/page.h>
+
+#include <net/skbuff.h>
+
+#define FRAG_ALIGN sizeof(void *)
+
+struct skb_page_frag_hdr {
+	int refs;
+};
+
+#define FRAG_HDR_SIZE \
+	binalign_bound(sizeof(struct skb_page_frag_hdr), FRAG_ALIGN)
+
+extern struct page_allocator *__heap_pgallocator;
+
+static struct skb_page_frag_hdr *frag_page;
+static size_t frag_off;
+
+/* Pages of the heap page allocator are aligned to their size */
+static inline struct skb_page_frag_hdr *frag_page_of(void *data) {
+	return (void *) ((uintptr_t) data & ~((uintptr_t) PAGE_SIZE() - 1));
+}
+
+/* Called with interrupts disabled */
+static void frag_page_put(struct skb_page_frag_hdr *page) {
+	assert(page->refs > 0);
+	if (--page->refs == 0) {
+		page_free(__heap_pgallocator, page, 1);
+	}
+}
+
+void *skb_page_frag_alloc(size_t size) {
+	void *data;
+	ipl_t sp;
+
+	size = binalign_bound(size, FRAG_ALIGN);
+	if (size == 0 || size > PAGE_SIZE() - FRAG_HDR_SIZE) {
+		return NULL;
+	}
+
+	sp = ipl_save();
+	{
+		if (frag_page == NULL || frag_off + size > PAGE_SIZE()) {
+			if (frag_page != NULL) {
+				frag_page_put(frag_page);
+			}
+			frag_page = page_alloc(__heap_pgallocator, 1);
+			if (frag_page == NULL) {
+				ipl_restore(sp);
+				log_error("no memory for a fragment page");
+				return NULL;
+			}
+			frag_page->refs = 1;
+			frag_off = FRAG_HDR_SIZE;
+		}
+
+		data = (void *) frag_page + frag_off;
+		frag_off += size;
+		frag_page->refs++;
+	}
+	ipl_restore(sp);
+
+	return data;
+}
+
+void skb_page_frag_get(void *data) {
+	ipl_t sp;
+
+	assert(data != NULL);
+
+	sp = ipl_save();
+	{
+		frag_page_of(data)->refs++;
+	}
+	ipl_restore(sp);
+}
+
+void skb_page_frag_free(void *data) {
+	ipl_t sp;
+
+	assert(data != NULL);
+
+	sp = ipl_save();
+	{
+		frag_page_put(frag_page_of(data));
+	}
+	ipl_restore(sp);
+}
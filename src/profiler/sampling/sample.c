@@ -1,72 +1,130 @@
-#include <stdio.h>
-#include <stdlib.h>
+/**
+ * @file
+ * @brief Sampling profiler with per-CPU rings of raw addresses
+ * @details
+ *    The timer handler only walks the stack and copies the return
+ *    addresses, so a sample costs about as much as backtrace() itself.
+ *    Every CPU has a single producer ring written by the handler only.
+ *    A full ring overwrites its oldest samples, so a long run keeps the
+ *    latest ones; readers throw away the records the handler overwrote
+ *    while they were copied.
+ *
+ * @date 15.12.2013
+ */
+
 #include <errno.h>
 #include <string.h>
 
 #include <execinfo.h>
 
+#include <lib/libds/array.h>
+#include <util/math.h>
+
 #include <kernel/time/timer.h>
 #include <kernel/printk.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread.h>
+#include <kernel/task.h>
+#include <kernel/cpu/cpudata.h>
+#include <lib/libds/spsc_ring.h>
+#include <hal/cpu.h>
 
-#include <embox/unit.h>
+#include <framework/mod/options.h>
 
 #include <profiler/sampling/sample.h>
 
-#include <module/embox/arch/stackframe.h>
-
-static int hash_array[SAMPLE_HASH_SIZE];
-static int pow[SAMPLE_HASH_SIZE], base = 101;
-static char sample_strings[SAMPLE_HASH_SIZE][100];
-//static int shift = 8;
-static int shift = 0;
+#define RING_SZ     OPTION_GET(NUMBER, ring_size)
+/* Frames of the timer dispatch above the sampler, innermost */
+#define SKIP_FRAMES OPTION_GET(NUMBER, skip_frames)
+/* Enough for backtrace() and the handler itself */
+#define SELF_FRAMES 4
+
+struct sample_ring {
+	struct spsc_ring ring;
+	unsigned long dropped; /* overwritten before read, written by readers */
+	uint64_t last;
+	struct sample_record rec[RING_SZ];
+};
+
+static struct sample_ring sample_ring __cpudata__;
+static spinlock_t sample_read_lock = SPIN_STATIC_UNLOCKED;
 static bool is_running = false;
 static sys_timer_t *sampling_timer;
 
-static int get_hash(char *str) {
-	/* TODO More effective hash generating algorithm */
-	int res = 0, i = 0;
-	while (str[i] != 0) {
-		res += pow[i] * str[i];
-		i++;
+static void sampling_timer_handler(sys_timer_t* timer, void *param) {
+	struct sample_ring *ring;
+	struct sample_record *rec;
+	struct thread *t;
+	void *bt[SELF_FRAMES + SKIP_FRAMES + SAMPLE_DEPTH];
+	void *self_ret;
+	uint64_t now;
+	int i, n;
+
+	ring = cpudata_ptr(&sample_ring);
+	now = sample_source_read();
+
+	rec = &ring->rec[ring->ring.head % RING_SZ];
+	spsc_ring_overwrite_begin(&ring->ring);
+
+	/* Everything up to the return address of this handler is backtrace()
+	 * and the sampler itself, however the compiler inlined them */
+	self_ret = __builtin_return_address(0);
+	n = backtrace(bt, ARRAY_SIZE(bt));
+	for (i = 0; i < n && i < SELF_FRAMES; i++) {
+		if (bt[i] == self_ret) {
+			break;
+		}
+	}
+	i = (i < n && i < SELF_FRAMES ? i : -1) + 1 + SKIP_FRAMES;
+
+	n = min(n - i, SAMPLE_DEPTH);
+	if (n < 0) {
+		n = 0;
 	}
-	return res;
+	memcpy(rec->pc, bt + i, n * sizeof(rec->pc[0]));
+	rec->depth = n;
+
+	t = thread_self();
+	rec->tid = t->id;
+	rec->task_id = task_get_id(t->task);
+	rec->stamp = now;
+	rec->weight = ring->last ? now - ring->last : 0;
+	ring->last = now;
+
+	spsc_ring_publish(&ring->ring, 1);
 }
 
-static void sampling_timer_handler(sys_timer_t* timer, void *param) {
-	int i, nptrs, hash;
-	void *buffer[100];
-	char bt_str[64];
-
-	nptrs = backtrace(buffer, 100);
-
-	/* It makes sense to start not from 0 element,
-	 * because the top of the callstack is always the same
-	 * as we call backtrace from the same function every time
-	 *
-	 * Common non-informative top of the callstack looks like this:
-	 *
-	 * 0x001467f6 <backtrace+0x20>
-	 * 0x00146860 <sampling_timer_handler+0x1f>
-	 * 0x00112e54 <timer_strat_sched+0x85>
-	 * 0x001793d2 <clock_handler+0xb>
-	 * 0x001112fd <lthread_process+0x5e>
-	 * 0x00181947 <__schedule+0x99>
-	 * 0x001819a2 <sched_preempt+0x17>
-	 * 0x00145a2f <critical_dispatch_pending+0x5c>
-	 * 0x00100b88 <irq_handler+0x76>
-	 * 0xdeadbabe <some_interesting_stuff_here+0x11>  That's where should we start
-	 */
-
-	for (i = shift; i < nptrs; i++) {
-		backtrace_symbol_buf(buffer[i], bt_str, sizeof(bt_str));
-		bt_str[sizeof(bt_str) - 1] = '\0';
-
-		hash = get_hash(bt_str) % SAMPLE_HASH_SIZE;
-		if (hash_array[hash] == 0) {
-			strcpy(sample_strings[hash], bt_str);
-		}
-		hash_array[hash]++;
+int sample_read(struct sample_record *buf, int max) {
+	struct sample_ring *ring;
+	int cpu, n = 0;
+
+	spin_lock(&sample_read_lock);
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		ring = cpudata_cpu_ptr(cpu, &sample_ring);
+		n += spsc_ring_read_overwrite(&ring->ring, ring->rec,
+				sizeof(ring->rec[0]), RING_SZ, buf + n, max - n,
+				&ring->dropped);
+	}
+
+	spin_unlock(&sample_read_lock);
+
+	return n;
+}
+
+unsigned long sample_dropped(void) {
+	unsigned long dropped = 0;
+	int cpu;
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		dropped += cpudata_cpu_ptr(cpu, &sample_ring)->dropped;
 	}
+
+	return dropped;
+}
+
+int sample_capacity(void) {
+	return RING_SZ * NCPU;
 }
 
 static int sampling_profiler_set(int interval) {
@@ -83,32 +141,27 @@ static int sampling_profiler_set(int interval) {
 	return ENOERR;
 }
 
-
-int *get_counters(void) {
-	return hash_array;
-}
-
-char *get_name(int ind) {
-	return sample_strings[ind];
-}
-
 bool sampling_profiler_is_running(void){
 	return is_running;
 }
 
 int start_profiler(int interval) {
-	int i;
+	struct sample_ring *ring;
+	int cpu;
 
 	if (is_running) {
 		stop_profiler();
 	}
 
-	is_running = true;
-	pow[0] = 1, hash_array[0] = 0;
-	for (i = 1; i < SAMPLE_HASH_SIZE; i++) {
-		pow[i] = (pow[i - 1] * base) % SAMPLE_HASH_SIZE; 	/* initialize hash */
-		hash_array[i] = 0;
+	/* The timer is stopped, nobody writes the rings */
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		ring = cpudata_cpu_ptr(cpu, &sample_ring);
+		spsc_ring_init(&ring->ring);
+		ring->dropped = 0;
+		ring->last = 0;
 	}
+
+	is_running = true;
 	sampling_profiler_set(interval);
 	return ENOERR;
 }
@@ -1,19 +1,53 @@
+/**
+ * @file
+ * @brief Sampling profiler
+ * @details
+ *    A periodic timer records the raw return addresses of the interrupted
+ *    context into a per-CPU ring. Nothing is symbolized while sampling,
+ *    readers drain the rings and resolve addresses themselves.
+ *
+ * @date 15.12.2013
+ */
+
 #ifndef PROFILER_SAMPLING_SAMPLE_H_
 #define PROFILER_SAMPLING_SAMPLE_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #define SAMPLE_TIMER_INTERVAL 500
-#define SAMPLE_HASH_SIZE 997
 
-struct function_sample_info {
-	const char *name;
-	int counter;
+/** Number of return addresses kept for a sample */
+#define SAMPLE_DEPTH 16
+
+struct sample_record {
+	uint64_t stamp;            /* sample_source_read() at the sample */
+	uint32_t weight;           /* source units since the previous sample
+	                              on the CPU, 0 for the first one */
+	int tid;
+	int task_id;
+	int depth;
+	void *pc[SAMPLE_DEPTH];    /* innermost first */
 };
 
 extern int start_profiler(int interval);
 extern int stop_profiler(void);
-
-extern int *get_counters(void);
-extern char *get_name(int ind);
 extern bool sampling_profiler_is_running(void);
 
+/**
+ * Move up to @c max samples taken since the previous call to @c buf
+ *
+ * @return number of samples moved
+ */
+extern int sample_read(struct sample_record *buf, int max);
+/** Samples overwritten in a full ring before they were read */
+extern unsigned long sample_dropped(void);
+/** Capacity of all the rings together */
+extern int sample_capacity(void);
+
+/** Current value of the sample time source */
+extern uint64_t sample_source_read(void);
+/** Units of the sample time source, e.g. "ticks" */
+extern const char *sample_source_unit(void);
+
 #endif /* PROFILER_SAMPLING_SAMPLE_H_ */
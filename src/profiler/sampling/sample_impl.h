@@ -1,7 +0,0 @@
-
-
-#ifndef PROFILING_SAMPLING_SAMPLE_IMPL_H_
-#define PROFILING_SAMPLING_SAMPLE_IMPL_H_
-
-
-#endif /* PROFILING_SAMPLING_SAMPLE_IMPL_H_ */
@@ -0,0 +1,25 @@
+/**
+ * @file
+ * @brief CPU cycle counter as the sample time source
+ * @details
+ *    Samples are still triggered by the timer, the counter gives each of
+ *    them the exact number of cycles since the previous one. Weighting
+ *    by cycles keeps the profile right when timer interrupts are delayed
+ *    by code running with interrupts disabled.
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdint.h>
+
+#include <lib/libcpu_info.h>
+
+#include <profiler/sampling/sample.h>
+
+uint64_t sample_source_read(void) {
+	return get_cpu_counter();
+}
+
+const char *sample_source_unit(void) {
+	return "cycles";
+}
@@ -0,0 +1,20 @@
+/**
+ * @file
+ * @brief System ticks as the sample time source
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdint.h>
+
+#include <hal/clock.h>
+
+#include <profiler/sampling/sample.h>
+
+uint64_t sample_source_read(void) {
+	return clock_sys_ticks();
+}
+
+const char *sample_source_unit(void) {
+	return "ticks";
+}
@@ -26,8 +26,10 @@
 #include <kernel/time/clock_source.h>
 #include <kernel/time/ktime.h>
 #include <kernel/time/itimer.h>
+#include <kernel/cpu/cpudata.h>
 
 #include <profiler/tracing/trace.h>
+#include <profiler/tracing/tracebuf.h>
 
 #include <embox/unit.h>
 #include "cyg_profile.h"
@@ -46,6 +48,20 @@ POOL_DEF(st_pool, struct tb_time, TB_MAX_DEPTH);
 
 POOL_DEF(tb_ht_pool, struct hashtable_item, FUNC_QUANTITY);
 
+/* Set while this CPU records a function hook. Anything tracebuf_write()
+ * calls may be instrumented itself, its hooks are then not recorded. */
+static int tracebuf_busy __cpudata__;
+
+#define TRACEBUF_WRITE_FUNC(type, func, caller) \
+	do { \
+		int *busy = cpudata_ptr(&tracebuf_busy); \
+		if (!*busy) { \
+			*busy = 1; \
+			tracebuf_write(type, 0, (uintptr_t) (func), (uintptr_t) (caller)); \
+			*busy = 0; \
+		} \
+	} while (0)
+
 /* This variable contains current profiling mode (see profiler/tracing/trace.h) */
 static profiling_mode p_mode;
 profiling_mode get_profiling_mode(void) {
@@ -61,6 +77,8 @@ void cyg_tracing_profiler_enter(void *func, void *caller) {
 	 * every call of instrumented funcion.
 	 * You can try to get more info by searching for "-finstrument-functions" GCC flag
 	 */
+	TRACEBUF_WRITE_FUNC(TRACEBUF_FUNC_ENTER, func, caller);
+
 	if (get_profiling_mode() == CYG_PROFILING) {
 		set_profiling_mode(DISABLED);
 		trace_block_func_enter(func);
@@ -73,6 +91,8 @@ void cyg_tracing_profiler_exit(void *func, void *caller) {
 	 * exit from instrumented funcion.
 	 * You can try to get more info by searching for "-finstrument-functions" GCC flag
 	 */
+	TRACEBUF_WRITE_FUNC(TRACEBUF_FUNC_EXIT, func, caller);
+
 	 if (get_profiling_mode() == CYG_PROFILING) {
 		set_profiling_mode(DISABLED);
 		trace_block_func_exit(func);
@@ -116,6 +136,8 @@ static struct clock_source *tb_cs = NULL;
 void __tracepoint_handle(struct __trace_point *tp) {
 	if (tp->active) {
 		tp->count++;
+		tracebuf_write(TRACEBUF_TRACE_POINT, 0, (uintptr_t) tp->name,
+				(uintptr_t) tp);
 	}
 }
 
@@ -123,6 +145,13 @@ void trace_block_enter(struct __trace_block *tb) {
 	/* Necessary actions to capture information on trace_block enter */
 	time64_t cur_time;
 	struct tb_time *t;
+
+	/* Blocks of functions are recorded by the function hooks */
+	if (tb->active && tb->name) {
+		tracebuf_write(TRACEBUF_BLOCK_ENTER, 0, (uintptr_t) tb->name,
+				(uintptr_t) tb);
+	}
+
 	if (tb->active && tb_cs) {
 		tb->count++;
 		tb->depth++;
@@ -140,6 +169,12 @@ void trace_block_leave(struct __trace_block *tb) {
 	/* Necessary actions to capture information on trace_block exit */
 	time64_t cur_time;
 	struct tb_time *p;
+
+	if (tb->active && tb->name) {
+		tracebuf_write(TRACEBUF_BLOCK_LEAVE, 0, (uintptr_t) tb->name,
+				(uintptr_t) tb);
+	}
+
 	if (tb->active && tb_cs) {
 
 		/* When cyg_profiling was enabled during trace_block,
@@ -220,6 +255,7 @@ void trace_block_func_enter(void *func) {
 
 		tb = (struct __trace_block*) pool_alloc (&tb_pool);
 
+		tb->name = NULL;
 		tb->func = func;
 		tb->time = tb->max_time = tb->count = tb->depth = 0;
 		tb->time_list_head = NULL;
@@ -0,0 +1,141 @@
+/**
+ * @file
+ * @brief Per-CPU buffer of binary trace events
+ * @details
+ *    Every CPU writes its own ring with interrupts disabled only for the
+ *    few stores of a record, so writers never wait for each other. A full
+ *    ring drops new events and counts them.
+ *
+ * @date 19.10.2026
+ */
+
+#include <string.h>
+
+#include <hal/cpu.h>
+#include <hal/ipl.h>
+#include <kernel/spinlock.h>
+#include <kernel/cpu/cpudata.h>
+#include <lib/libds/spsc_ring.h>
+
+#include <framework/mod/options.h>
+
+#include <profiler/tracing/tracebuf.h>
+
+#define RING_SZ OPTION_GET(NUMBER, ring_size)
+
+struct tracebuf_ring {
+	struct spsc_ring ring;
+	unsigned long dropped;
+	struct tracebuf_rec rec[RING_SZ];
+};
+
+int __tracebuf_enabled = OPTION_GET(BOOLEAN, enabled);
+
+static struct tracebuf_ring tracebuf_ring __cpudata__;
+static spinlock_t tracebuf_read_lock = SPIN_STATIC_UNLOCKED;
+
+void tracebuf_write(int event, uint32_t arg0, uintptr_t arg1,
+		uintptr_t arg2) {
+	struct tracebuf_ring *ring;
+	struct tracebuf_rec *rec;
+	ipl_t ipl;
+
+	if (!tracebuf_enabled()) {
+		return;
+	}
+
+	ipl = ipl_save();
+
+	ring = cpudata_ptr(&tracebuf_ring);
+
+	if (!spsc_ring_room(&ring->ring, RING_SZ)) {
+		ring->dropped++;
+		ipl_restore(ipl);
+		return;
+	}
+
+	rec = &ring->rec[ring->ring.head % RING_SZ];
+	rec->stamp = tracebuf_clock();
+	rec->event = event;
+	rec->cpu = cpu_get_id();
+	rec->arg0 = arg0;
+	rec->arg1 = arg1;
+	rec->arg2 = arg2;
+
+	spsc_ring_publish(&ring->ring, 1);
+
+	ipl_restore(ipl);
+}
+
+void tracebuf_enable(int enable) {
+	__tracebuf_enabled = enable;
+}
+
+void tracebuf_reset(void) {
+	struct tracebuf_ring *ring;
+	int cpu;
+
+	spin_lock(&tracebuf_read_lock);
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		ring = cpudata_cpu_ptr(cpu, &tracebuf_ring);
+		spsc_ring_release(&ring->ring, spsc_ring_head(&ring->ring));
+		ring->dropped = 0;
+	}
+
+	spin_unlock(&tracebuf_read_lock);
+}
+
+int tracebuf_read(struct tracebuf_rec *buf, int max) {
+	struct tracebuf_ring *ring;
+	int cpu, n = 0;
+
+	spin_lock(&tracebuf_read_lock);
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		ring = cpudata_cpu_ptr(cpu, &tracebuf_ring);
+		n += spsc_ring_read(&ring->ring, ring->rec, sizeof(ring->rec[0]),
+				RING_SZ, buf + n, max - n);
+	}
+
+	spin_unlock(&tracebuf_read_lock);
+
+	return n;
+}
+
+unsigned long tracebuf_dropped(void) {
+	unsigned long dropped = 0;
+	int cpu;
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		dropped += cpudata_cpu_ptr(cpu, &tracebuf_ring)->dropped;
+	}
+
+	return dropped;
+}
+
+int tracebuf_capacity(void) {
+	return RING_SZ * NCPU;
+}
+
+/* Events of a CPU are read in order and may have equal stamps, so the sort
+ * has to be stable */
+void tracebuf_sort(struct tracebuf_rec *recs, struct tracebuf_rec *tmp,
+		int n) {
+	int width, lo, mid, hi, i, j, k;
+
+	for (width = 1; width < n; width *= 2) {
+		for (lo = 0; lo < n; lo += 2 * width) {
+			mid = lo + width < n ? lo + width : n;
+			hi = lo + 2 * width < n ? lo + 2 * width : n;
+			for (i = lo, j = mid, k = lo; k < hi; k++) {
+				if (i < mid && (j == hi || recs[i].stamp <= recs[j].stamp)) {
+					tmp[k] = recs[i++];
+				} else {
+					tmp[k] = recs[j++];
+				}
+			}
+		}
+		memcpy(recs, tmp, n * sizeof(*recs));
+	}
+}
@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @brief Per-CPU buffer of binary trace events
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef PROFILER_TRACING_TRACEBUF_H_
+#define PROFILER_TRACING_TRACEBUF_H_
+
+#include <stdint.h>
+
+enum tracebuf_event {
+	TRACEBUF_SCHED_SWITCH = 1, /* arg0: prev still runnable,
+	                              arg1: prev thread id, arg2: next thread id */
+	TRACEBUF_SCHED_WAKEUP,     /* arg0: woken from IRQ handler,
+	                              arg1: woken thread id, arg2: waker id */
+	TRACEBUF_WAITQ_WAKEUP,     /* arg0: nr, arg1: waitq */
+	TRACEBUF_MUTEX_BLOCK,      /* arg1: mutex, arg2: holder thread id */
+	TRACEBUF_MUTEX_ACQUIRE,    /* arg1: mutex */
+	TRACEBUF_MUTEX_RELEASE,    /* arg1: mutex */
+	TRACEBUF_IRQ_ENTER,        /* arg0: IRQ number */
+	TRACEBUF_IRQ_EXIT,         /* arg0: IRQ number */
+	TRACEBUF_TRACE_POINT,      /* arg1: name, arg2: trace point */
+	TRACEBUF_BLOCK_ENTER,      /* arg1: name, arg2: trace block */
+	TRACEBUF_BLOCK_LEAVE,      /* arg1: name, arg2: trace block */
+	TRACEBUF_FUNC_ENTER,       /* arg1: function, arg2: call site */
+	TRACEBUF_FUNC_EXIT,        /* arg1: function, arg2: call site */
+};
+
+/* Thread id recorded for lightweight threads and other non-thread schedees */
+#define TRACEBUF_ID_NONE ((uintptr_t) -1)
+
+struct tracebuf_rec {
+	uint64_t stamp;            /* tracebuf_clock() */
+	uint16_t event;
+	uint16_t cpu;
+	uint32_t arg0;
+	uintptr_t arg1;
+	uintptr_t arg2;
+};
+
+extern int __tracebuf_enabled;
+
+static inline int tracebuf_enabled(void) {
+	return __builtin_expect(__tracebuf_enabled, 0);
+}
+
+/** Records an event if tracing is enabled, callable from any context */
+extern void tracebuf_write(int event, uint32_t arg0, uintptr_t arg1,
+		uintptr_t arg2);
+
+extern void tracebuf_enable(int enable);
+/** Drops all recorded events */
+extern void tracebuf_reset(void);
+
+/**
+ * Move up to @c max events recorded since the previous call to @c buf.
+ * Events come CPU after CPU, in order within a CPU.
+ *
+ * @return number of events moved
+ */
+extern int tracebuf_read(struct tracebuf_rec *buf, int max);
+/** Events lost because a buffer was full */
+extern unsigned long tracebuf_dropped(void);
+/** Capacity of all the buffers together */
+extern int tracebuf_capacity(void);
+
+/**
+ * Stable sort of @c n events by time stamp, e.g. of all CPUs after
+ * tracebuf_read(). @c tmp is scratch space for @c n events.
+ */
+extern void tracebuf_sort(struct tracebuf_rec *recs, struct tracebuf_rec *tmp,
+		int n);
+
+/** Current value of the event time stamp clock */
+extern uint64_t tracebuf_clock(void);
+/** Units of the time stamps, e.g. "ns" */
+extern const char *tracebuf_clock_unit(void);
+/** Time stamp units per second */
+extern uint64_t tracebuf_clock_hz(void);
+
+#endif /* PROFILER_TRACING_TRACEBUF_H_ */
@@ -0,0 +1,28 @@
+/**
+ * @file
+ * @brief CPU cycle counter as trace time stamps
+ * @details
+ *    Cheaper and finer than the system clock, but the counters of
+ *    different CPUs must be in sync for events of several CPUs to be
+ *    ordered right.
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdint.h>
+
+#include <lib/libcpu_info.h>
+
+#include <profiler/tracing/tracebuf.h>
+
+uint64_t tracebuf_clock(void) {
+	return get_cpu_counter();
+}
+
+const char *tracebuf_clock_unit(void) {
+	return "cycles";
+}
+
+uint64_t tracebuf_clock_hz(void) {
+	return cpu_counter_hz();
+}
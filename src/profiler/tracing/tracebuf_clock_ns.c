@@ -0,0 +1,24 @@
+/**
+ * @file
+ * @brief Monotonic nanoseconds as trace time stamps
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdint.h>
+
+#include <kernel/time/ktime.h>
+
+#include <profiler/tracing/tracebuf.h>
+
+uint64_t tracebuf_clock(void) {
+	return ktime_get_ns();
+}
+
+const char *tracebuf_clock_unit(void) {
+	return "ns";
+}
+
+uint64_t tracebuf_clock_hz(void) {
+	return 1000000000ULL;
+}
@@ -0,0 +1,338 @@
+/**
+ * @file
+ * @brief Export of trace buffer events to standard trace formats
+ * @details
+ *    Chrome JSON puts threads into process 0, where every thread has a
+ *    "run" slice for each time it is on a CPU, and events which are not
+ *    tied to a thread into process 1 with a track per CPU: IRQ handlers,
+ *    trace blocks, instrumented functions and instant events.
+ *
+ *    CTF output is the raw records: every event has a 16 bit id, a 64 bit
+ *    time stamp, the CPU and the three arguments, all in native byte
+ *    order and without padding.
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <debug/symbol.h>
+#include <hal/cpu.h>
+#include <lib/libds/array.h>
+
+#include <profiler/tracing/tracebuf.h>
+#include <profiler/tracing/tracebuf_export.h>
+
+#define OUT_BUF_SZ 512
+
+#define CTF_MAGIC  0xc1fc1fc1
+
+struct out {
+	int fd;
+	int len;
+	int err;
+	char buf[OUT_BUF_SZ];
+};
+
+static const char *const event_names[] = {
+	[TRACEBUF_SCHED_SWITCH]  = "sched_switch",
+	[TRACEBUF_SCHED_WAKEUP]  = "sched_wakeup",
+	[TRACEBUF_WAITQ_WAKEUP]  = "waitq_wakeup",
+	[TRACEBUF_MUTEX_BLOCK]   = "mutex_block",
+	[TRACEBUF_MUTEX_ACQUIRE] = "mutex_acquire",
+	[TRACEBUF_MUTEX_RELEASE] = "mutex_release",
+	[TRACEBUF_IRQ_ENTER]     = "irq_enter",
+	[TRACEBUF_IRQ_EXIT]      = "irq_exit",
+	[TRACEBUF_TRACE_POINT]   = "trace_point",
+	[TRACEBUF_BLOCK_ENTER]   = "block_enter",
+	[TRACEBUF_BLOCK_LEAVE]   = "block_leave",
+	[TRACEBUF_FUNC_ENTER]    = "func_enter",
+	[TRACEBUF_FUNC_EXIT]     = "func_exit",
+};
+
+static void out_flush(struct out *o) {
+	int off, res;
+
+	for (off = 0; off < o->len && !o->err; off += res) {
+		res = write(o->fd, o->buf + off, o->len - off);
+		if (res <= 0) {
+			o->err = res < 0 ? -errno : -EIO;
+		}
+	}
+	o->len = 0;
+}
+
+static void out_bytes(struct out *o, const void *data, int len) {
+	int n;
+
+	while (len > 0) {
+		if (o->len == OUT_BUF_SZ) {
+			out_flush(o);
+		}
+		n = OUT_BUF_SZ - o->len < len ? OUT_BUF_SZ - o->len : len;
+		memcpy(o->buf + o->len, data, n);
+		o->len += n;
+		data += n;
+		len -= n;
+	}
+}
+
+static void out_printf(struct out *o, const char *fmt, ...) {
+	char line[128];
+	va_list args;
+	int len;
+
+	va_start(args, fmt);
+	len = vsnprintf(line, sizeof(line), fmt, args);
+	va_end(args);
+
+	if (len >= sizeof(line)) {
+		len = sizeof(line) - 1;
+	}
+	out_bytes(o, line, len);
+}
+
+/* Writes @c s as a JSON string, dropping anything which needs escaping */
+static void out_json_str(struct out *o, const char *s) {
+	out_bytes(o, "\"", 1);
+	for (; *s; s++) {
+		if (*s != '"' && *s != '\\' && *s >= ' ') {
+			out_bytes(o, s, 1);
+		}
+	}
+	out_bytes(o, "\"", 1);
+}
+
+static void out_json_func(struct out *o, uintptr_t addr) {
+	const struct symbol *s;
+	char name[2 + 2 * sizeof(addr) + 1];
+
+	s = symbol_lookup((void *) addr);
+	if (s && s->addr == (void *) addr) {
+		out_json_str(o, s->name);
+	} else {
+		snprintf(name, sizeof(name), "%p", (void *) addr);
+		out_json_str(o, name);
+	}
+}
+
+static void out_json_head(struct out *o, const char *ph, double ts, int pid,
+		uintptr_t tid) {
+	out_printf(o, ",\n{\"ph\":\"%s\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d",
+			ph, ts, pid, (int) tid);
+}
+
+static void out_json_event(struct out *o, const struct tracebuf_rec *r,
+		double ts, uintptr_t *running) {
+	switch (r->event) {
+	case TRACEBUF_SCHED_SWITCH:
+		if (running[r->cpu] != TRACEBUF_ID_NONE) {
+			out_json_head(o, "E", ts, 0, running[r->cpu]);
+			out_printf(o, "}");
+		}
+		running[r->cpu] = r->arg2;
+		if (r->arg2 != TRACEBUF_ID_NONE) {
+			out_json_head(o, "B", ts, 0, r->arg2);
+			out_printf(o, ",\"name\":\"run\",\"args\":{\"cpu\":%d}}", r->cpu);
+		}
+		break;
+	case TRACEBUF_SCHED_WAKEUP:
+		if (r->arg1 == TRACEBUF_ID_NONE) {
+			break;
+		}
+		out_json_head(o, "i", ts, 0, r->arg1);
+		out_printf(o, ",\"s\":\"t\",\"name\":\"wakeup\","
+				"\"args\":{\"waker\":%d,\"irq\":%d}}",
+				(int) r->arg2, (int) r->arg0);
+		break;
+	case TRACEBUF_WAITQ_WAKEUP:
+	case TRACEBUF_MUTEX_BLOCK:
+	case TRACEBUF_MUTEX_ACQUIRE:
+	case TRACEBUF_MUTEX_RELEASE:
+		out_json_head(o, "i", ts, 1, r->cpu);
+		out_printf(o, ",\"s\":\"t\",\"name\":\"%s\",\"args\":{\"object\":",
+				event_names[r->event]);
+		out_json_func(o, r->arg1);
+		if (r->event == TRACEBUF_MUTEX_BLOCK) {
+			out_printf(o, ",\"holder\":%d", (int) r->arg2);
+		}
+		out_printf(o, "}}");
+		break;
+	case TRACEBUF_IRQ_ENTER:
+	case TRACEBUF_IRQ_EXIT:
+		out_json_head(o, r->event == TRACEBUF_IRQ_ENTER ? "B" : "E", ts,
+				1, r->cpu);
+		out_printf(o, ",\"name\":\"irq %d\"}", (int) r->arg0);
+		break;
+	case TRACEBUF_TRACE_POINT:
+		out_json_head(o, "i", ts, 1, r->cpu);
+		out_printf(o, ",\"s\":\"t\",\"name\":");
+		out_json_str(o, (const char *) r->arg1);
+		out_printf(o, "}");
+		break;
+	case TRACEBUF_BLOCK_ENTER:
+	case TRACEBUF_BLOCK_LEAVE:
+		out_json_head(o, r->event == TRACEBUF_BLOCK_ENTER ? "B" : "E", ts,
+				1, r->cpu);
+		out_printf(o, ",\"name\":");
+		out_json_str(o, (const char *) r->arg1);
+		out_printf(o, "}");
+		break;
+	case TRACEBUF_FUNC_ENTER:
+	case TRACEBUF_FUNC_EXIT:
+		out_json_head(o, r->event == TRACEBUF_FUNC_ENTER ? "B" : "E", ts,
+				1, r->cpu);
+		out_printf(o, ",\"name\":");
+		out_json_func(o, r->arg1);
+		out_printf(o, "}");
+		break;
+	default:
+		break;
+	}
+}
+
+int tracebuf_export_json(int fd, const struct tracebuf_rec *recs, int n) {
+	uintptr_t running[NCPU];  /* thread on each CPU */
+	struct out *o;
+	double us_per_unit;
+	int i, err;
+
+	o = malloc(sizeof(*o));
+	if (!o) {
+		return -ENOMEM;
+	}
+	o->fd = fd;
+	o->len = o->err = 0;
+
+	for (i = 0; i < NCPU; i++) {
+		running[i] = TRACEBUF_ID_NONE;
+	}
+
+	us_per_unit = 1000000.0 / tracebuf_clock_hz();
+
+	out_printf(o, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+			"{\"ph\":\"M\",\"pid\":0,\"name\":\"process_name\","
+			"\"args\":{\"name\":\"threads\"}},\n"
+			"{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\","
+			"\"args\":{\"name\":\"cpus\"}}");
+
+	for (i = 0; i < NCPU; i++) {
+		out_printf(o, ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+				"\"name\":\"thread_name\",\"args\":{\"name\":\"cpu %d\"}}",
+				i, i);
+	}
+
+	for (i = 0; i < n && !o->err; i++) {
+		if (recs[i].cpu >= NCPU || recs[i].event >= ARRAY_SIZE(event_names)) {
+			continue;
+		}
+		out_json_event(o, &recs[i], (recs[i].stamp - recs[0].stamp)
+				* us_per_unit, running);
+	}
+
+	out_printf(o, "\n]}\n");
+	out_flush(o);
+
+	err = o->err;
+	free(o);
+
+	return err;
+}
+
+int tracebuf_export_ctf_metadata(int fd) {
+	struct out *o;
+	int i, err;
+
+	o = malloc(sizeof(*o));
+	if (!o) {
+		return -ENOMEM;
+	}
+	o->fd = fd;
+	o->len = o->err = 0;
+
+	out_printf(o, "/* CTF 1.8 */\n\n"
+			"typealias integer { size = 8; align = 8; signed = false; }"
+			" := uint8_t;\n"
+			"typealias integer { size = 16; align = 8; signed = false; }"
+			" := uint16_t;\n"
+			"typealias integer { size = 32; align = 8; signed = false; }"
+			" := uint32_t;\n"
+			"typealias integer { size = 64; align = 8; signed = false; }"
+			" := uint64_t;\n\n");
+	out_printf(o, "trace {\n\tmajor = 1;\n\tminor = 8;\n"
+			"\tbyte_order = %s;\n"
+			"\tpacket.header := struct { uint32_t magic; };\n};\n\n",
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			"be");
+#else
+			"le");
+#endif
+	out_printf(o, "clock {\n\tname = tracebuf;\n\tfreq = %llu;\n};\n\n",
+			(unsigned long long) tracebuf_clock_hz());
+	out_printf(o, "typealias integer { size = 64; align = 8; signed = false;"
+			" map = clock.tracebuf.value; } := uint64_clock_t;\n\n");
+	out_printf(o, "stream {\n"
+			"\tevent.header := struct {\n"
+			"\t\tuint16_t id;\n"
+			"\t\tuint64_clock_t timestamp;\n\t};\n"
+			"\tevent.context := struct { uint16_t cpu; };\n};\n\n");
+
+	for (i = 0; i < ARRAY_SIZE(event_names); i++) {
+		if (!event_names[i]) {
+			continue;
+		}
+		out_printf(o, "event {\n\tname = %s;\n\tid = %d;\n"
+				"\tfields := struct {\n"
+				"\t\tuint32_t arg0;\n"
+				"\t\tuint64_t arg1;\n"
+				"\t\tuint64_t arg2;\n\t};\n};\n\n", event_names[i], i);
+	}
+
+	out_flush(o);
+
+	err = o->err;
+	free(o);
+
+	return err;
+}
+
+int tracebuf_export_ctf_stream(int fd, const struct tracebuf_rec *recs,
+		int n) {
+	struct out *o;
+	uint32_t magic = CTF_MAGIC;
+	uint64_t arg;
+	int i, err;
+
+	o = malloc(sizeof(*o));
+	if (!o) {
+		return -ENOMEM;
+	}
+	o->fd = fd;
+	o->len = o->err = 0;
+
+	out_bytes(o, &magic, sizeof(magic));
+
+	for (i = 0; i < n && !o->err; i++) {
+		out_bytes(o, &recs[i].event, sizeof(recs[i].event));
+		out_bytes(o, &recs[i].stamp, sizeof(recs[i].stamp));
+		out_bytes(o, &recs[i].cpu, sizeof(recs[i].cpu));
+		out_bytes(o, &recs[i].arg0, sizeof(recs[i].arg0));
+		arg = recs[i].arg1;
+		out_bytes(o, &arg, sizeof(arg));
+		arg = recs[i].arg2;
+		out_bytes(o, &arg, sizeof(arg));
+	}
+
+	out_flush(o);
+
+	err = o->err;
+	free(o);
+
+	return err;
+}
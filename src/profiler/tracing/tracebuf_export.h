@@ -0,0 +1,33 @@
+/**
+ * @file
+ * @brief Export of trace buffer events to standard trace formats
+ *
+ * @date 19.10.2026
+ */
+
+#ifndef PROFILER_TRACING_TRACEBUF_EXPORT_H_
+#define PROFILER_TRACING_TRACEBUF_EXPORT_H_
+
+#include <profiler/tracing/tracebuf.h>
+
+/**
+ * Write @c n events sorted by time stamp to @c fd as a Chrome trace event
+ * JSON document, which Perfetto and chrome://tracing open.
+ *
+ * @return 0 on success, negative errno otherwise
+ */
+extern int tracebuf_export_json(int fd, const struct tracebuf_rec *recs,
+		int n);
+
+/**
+ * Write the CTF metadata describing tracebuf_export_ctf_stream() output
+ */
+extern int tracebuf_export_ctf_metadata(int fd);
+
+/**
+ * Write @c n events as a CTF stream of a single packet
+ */
+extern int tracebuf_export_ctf_stream(int fd, const struct tracebuf_rec *recs,
+		int n);
+
+#endif /* PROFILER_TRACING_TRACEBUF_EXPORT_H_ */
@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @brief Heap allocator and memcpy benchmarks
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <framework/test/bench.h>
+
+static char src[4096], dst[4096];
+
+static void malloc_free(unsigned long iters, size_t size) {
+	void *p;
+
+	while (iters--) {
+		p = malloc(size);
+		free(p);
+	}
+}
+
+EMBOX_BENCH("mem.malloc_free_64", iters) {
+	malloc_free(iters, 64);
+}
+
+EMBOX_BENCH("mem.malloc_free_4k", iters) {
+	malloc_free(iters, 4096);
+}
+
+/* Frees in allocation order, so blocks are not just reused */
+EMBOX_BENCH("mem.malloc_burst_16x256", iters) {
+	void *p[16];
+	int i;
+
+	while (iters--) {
+		for (i = 0; i < 16; i++) {
+			p[i] = malloc(256);
+		}
+		for (i = 0; i < 16; i++) {
+			free(p[i]);
+		}
+	}
+}
+
+EMBOX_BENCH("mem.memcpy_64", iters) {
+	while (iters--) {
+		memcpy(dst, src, 64);
+		__asm__ __volatile__("" : : "r" (dst) : "memory");
+	}
+}
+
+EMBOX_BENCH("mem.memcpy_4k", iters) {
+	while (iters--) {
+		memcpy(dst, src, sizeof(dst));
+		__asm__ __volatile__("" : : "r" (dst) : "memory");
+	}
+}
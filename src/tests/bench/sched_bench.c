@@ -0,0 +1,108 @@
+/**
+ * @file
+ * @brief Context switch and mutex handoff benchmarks
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+
+#include <framework/test/bench.h>
+#include <kernel/sched/schedee_priority.h>
+#include <kernel/thread.h>
+#include <kernel/thread/sync/mutex.h>
+#include <kernel/thread/waitq.h>
+#include <util/err.h>
+
+static struct thread *peer;
+static struct waitq ping_wq, pong_wq;
+static volatile unsigned long ping, pong;
+static volatile int stop;
+
+static struct mutex handoff_mutex;
+
+/* Answers every ping, so an iteration is two switches */
+static void *pingpong_peer(void *arg) {
+	while (1) {
+		WAITQ_WAIT(&ping_wq, ping != pong || stop);
+		if (stop) {
+			break;
+		}
+		pong = ping;
+		waitq_wakeup_all(&pong_wq);
+	}
+
+	return NULL;
+}
+
+/* Waits for a go, then takes the mutex from the benchmark thread */
+static void *handoff_peer(void *arg) {
+	while (1) {
+		WAITQ_WAIT(&ping_wq, ping != pong || stop);
+		if (stop) {
+			break;
+		}
+		mutex_lock(&handoff_mutex);
+		pong = ping;
+		mutex_unlock(&handoff_mutex);
+		waitq_wakeup_all(&pong_wq);
+	}
+
+	return NULL;
+}
+
+static int peer_start(void *(*run)(void *), int prio_boost) {
+	struct schedee *self = &thread_self()->schedee;
+
+	waitq_init(&ping_wq);
+	waitq_init(&pong_wq);
+	ping = pong = 0;
+	stop = 0;
+
+	peer = thread_create(THREAD_FLAG_SUSPENDED, run, NULL);
+	if (ptr2err(peer)) {
+		return ptr2err(peer);
+	}
+
+	schedee_priority_set(&peer->schedee,
+			schedee_priority_get(self) + prio_boost);
+	thread_launch(peer);
+
+	return 0;
+}
+
+static int peer_stop(void) {
+	stop = 1;
+	waitq_wakeup_all(&ping_wq);
+
+	return thread_join(peer, NULL);
+}
+
+static int pingpong_setup(void) {
+	return peer_start(pingpong_peer, 0);
+}
+
+EMBOX_BENCH_FIXTURE("sched.context_switch", iters, pingpong_setup, peer_stop) {
+	while (iters--) {
+		ping++;
+		waitq_wakeup_all(&ping_wq);
+		WAITQ_WAIT(&pong_wq, pong == ping);
+	}
+}
+
+static int handoff_setup(void) {
+	mutex_init(&handoff_mutex);
+
+	/* The peer must preempt us to block on the mutex we hold */
+	return peer_start(handoff_peer, 1);
+}
+
+EMBOX_BENCH_FIXTURE("sched.mutex_handoff", iters, handoff_setup, peer_stop) {
+	while (iters--) {
+		mutex_lock(&handoff_mutex);
+		ping++;
+		waitq_wakeup_all(&ping_wq);
+		mutex_unlock(&handoff_mutex);
+		WAITQ_WAIT(&pong_wq, pong == ping);
+	}
+}
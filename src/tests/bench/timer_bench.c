@@ -0,0 +1,54 @@
+/**
+ * @file
+ * @brief System timer benchmarks
+ *
+ * @date 19.10.2026
+ */
+
+#include <framework/test/bench.h>
+#include <kernel/thread/waitq.h>
+#include <kernel/time/timer.h>
+
+static struct sys_timer tmr;
+static struct waitq fired_wq;
+static volatile unsigned long fired;
+
+static void timer_handler(struct sys_timer *timer, void *param) {
+	fired++;
+	waitq_wakeup_all(&fired_wq);
+}
+
+static int timer_bench_setup(void) {
+	waitq_init(&fired_wq);
+	fired = 0;
+
+	return timer_init(&tmr, TIMER_ONESHOT, timer_handler, NULL);
+}
+
+static int timer_bench_teardown(void) {
+	timer_stop(&tmr);
+
+	return 0;
+}
+
+/* The timer never fires, it is stopped right after it is armed */
+EMBOX_BENCH_FIXTURE("timer.arm_cancel", iters, timer_bench_setup,
+		timer_bench_teardown) {
+	while (iters--) {
+		timer_start(&tmr, 1000);
+		timer_stop(&tmr);
+	}
+}
+
+/* Arming for one tick to the wakeup of the waiting thread, mostly the wait
+ * for the next tick */
+EMBOX_BENCH_FIXTURE("timer.fire_1_tick", iters, timer_bench_setup,
+		timer_bench_teardown) {
+	unsigned long n;
+
+	while (iters--) {
+		n = fired;
+		timer_start(&tmr, 1);
+		WAITQ_WAIT(&fired_wq, fired != n);
+	}
+}
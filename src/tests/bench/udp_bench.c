@@ -0,0 +1,77 @@
+/**
+ * @file
+ * @brief UDP over the loopback interface benchmark
+ *
+ * @date 19.10.2026
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <framework/test/bench.h>
+
+#define PORT 7777
+/* A datagram lost on the loopback fails the benchmark instead of hanging */
+#define RECV_TIMEOUT_MS 1000
+
+static int sock = -1;
+static struct sockaddr_in addr;
+/* The first error of the body, reported by the teardown */
+static int udp_bench_err;
+
+static int udp_bench_setup(void) {
+	struct timeval tv = {
+		.tv_sec = RECV_TIMEOUT_MS / 1000,
+		.tv_usec = (RECV_TIMEOUT_MS % 1000) * 1000,
+	};
+
+	udp_bench_err = 0;
+
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(PORT);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	if (bind(sock, (struct sockaddr *) &addr, sizeof(addr)) < 0
+			|| setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
+		udp_bench_err = -errno;
+		close(sock);
+		return udp_bench_err;
+	}
+
+	return 0;
+}
+
+static int udp_bench_teardown(void) {
+	close(sock);
+
+	return udp_bench_err;
+}
+
+/* An iteration is one 64 byte datagram sent to the socket itself and
+ * received back */
+EMBOX_BENCH_FIXTURE("net.udp_loopback_64", iters, udp_bench_setup,
+		udp_bench_teardown) {
+	char buf[64] = { 0 };
+	ssize_t n;
+
+	while (iters-- && !udp_bench_err) {
+		n = sendto(sock, buf, sizeof(buf), 0, (struct sockaddr *) &addr,
+				sizeof(addr));
+		if (n == sizeof(buf)) {
+			/* Fails with EAGAIN after RECV_TIMEOUT_MS */
+			n = recv(sock, buf, sizeof(buf), 0);
+		}
+		if (n != sizeof(buf)) {
+			udp_bench_err = n < 0 ? -errno : -EIO;
+		}
+	}
+}
@@ -0,0 +1,161 @@
+/**
+ * @file
+ * @brief Test for FAT file growth, overwrite and truncate
+ *
+ * @date 19.10.2026
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <drivers/block_dev/ramdisk/ramdisk.h>
+#include <embox/test.h>
+#include <fs/fsop.h>
+#include <fs/mount.h>
+#include <mem/page.h>
+#include <util/err.h>
+
+EMBOX_TEST_SUITE("FAT file data test");
+
+TEST_SETUP_SUITE(setup_suite);
+
+TEST_TEARDOWN_SUITE(teardown_suite);
+
+#define FAT_TEST_FS      "vfat"
+#define FAT_TEST_DEV     "/dev/ramdisk"
+#define FAT_TEST_BLOCKS  124
+#define FAT_TEST_DIR     "/mnt/fat_test"
+#define FAT_TEST_FILE    FAT_TEST_DIR "/file.bin"
+
+/* Spans several clusters and ends in the middle of a sector */
+#define FAT_TEST_LEN     (24 * 1024 + 100)
+
+static char fat_test_buf[FAT_TEST_LEN];
+static char fat_test_rbuf[FAT_TEST_LEN];
+
+static void fat_test_pattern(char *buf, int len, int seed) {
+	int i;
+
+	for (i = 0; i < len; i++) {
+		buf[i] = (char) (i * 7 + seed);
+	}
+}
+
+static void fat_test_check(int fd, off_t off, const char *expect, int len) {
+	test_assert_equal(off, lseek(fd, off, SEEK_SET));
+	test_assert_equal(len, read(fd, fat_test_rbuf, len));
+	test_assert_zero(memcmp(fat_test_rbuf, expect, len));
+}
+
+TEST_CASE("Growing a file in small writes keeps the data") {
+	int fd, done;
+
+	fat_test_pattern(fat_test_buf, FAT_TEST_LEN, 1);
+
+	fd = open(FAT_TEST_FILE, O_CREAT | O_RDWR, 0666);
+	test_assert(fd >= 0);
+
+	for (done = 0; done < FAT_TEST_LEN; done += 1000) {
+		int n = FAT_TEST_LEN - done < 1000 ? FAT_TEST_LEN - done : 1000;
+
+		test_assert_equal(n, write(fd, fat_test_buf + done, n));
+	}
+
+	fat_test_check(fd, 0, fat_test_buf, FAT_TEST_LEN);
+
+	close(fd);
+	test_assert_zero(unlink(FAT_TEST_FILE));
+}
+
+TEST_CASE("Overwriting the middle of a file changes only that range") {
+	int fd;
+
+	fat_test_pattern(fat_test_buf, FAT_TEST_LEN, 1);
+
+	fd = open(FAT_TEST_FILE, O_CREAT | O_RDWR, 0666);
+	test_assert(fd >= 0);
+	test_assert_equal(FAT_TEST_LEN, write(fd, fat_test_buf, FAT_TEST_LEN));
+
+	/* Crosses a cluster boundary */
+	fat_test_pattern(fat_test_buf + 4000, 5000, 2);
+	test_assert_equal(4000, lseek(fd, 4000, SEEK_SET));
+	test_assert_equal(5000, write(fd, fat_test_buf + 4000, 5000));
+
+	fat_test_check(fd, 0, fat_test_buf, FAT_TEST_LEN);
+
+	close(fd);
+	test_assert_zero(unlink(FAT_TEST_FILE));
+}
+
+TEST_CASE("Truncate and grow again") {
+	struct stat st;
+	int fd;
+
+	fat_test_pattern(fat_test_buf, FAT_TEST_LEN, 1);
+
+	fd = open(FAT_TEST_FILE, O_CREAT | O_RDWR, 0666);
+	test_assert(fd >= 0);
+	test_assert_equal(FAT_TEST_LEN, write(fd, fat_test_buf, FAT_TEST_LEN));
+
+	test_assert_zero(ftruncate(fd, 3000));
+	test_assert_zero(fstat(fd, &st));
+	test_assert_equal(3000, st.st_size);
+	fat_test_check(fd, 0, fat_test_buf, 3000);
+
+	fat_test_pattern(fat_test_buf + 3000, FAT_TEST_LEN - 3000, 3);
+	test_assert_equal(3000, lseek(fd, 3000, SEEK_SET));
+	test_assert_equal(FAT_TEST_LEN - 3000,
+			write(fd, fat_test_buf + 3000, FAT_TEST_LEN - 3000));
+
+	fat_test_check(fd, 0, fat_test_buf, FAT_TEST_LEN);
+
+	close(fd);
+	test_assert_zero(unlink(FAT_TEST_FILE));
+}
+
+TEST_CASE("Data written before fsync survives remount") {
+	int fd;
+
+	fat_test_pattern(fat_test_buf, FAT_TEST_LEN, 4);
+
+	fd = open(FAT_TEST_FILE, O_CREAT | O_RDWR, 0666);
+	test_assert(fd >= 0);
+	test_assert_equal(FAT_TEST_LEN, write(fd, fat_test_buf, FAT_TEST_LEN));
+	test_assert_zero(fsync(fd));
+	close(fd);
+
+	test_assert_zero(umount(FAT_TEST_DIR));
+	test_assert_zero(mount(FAT_TEST_DEV, FAT_TEST_DIR, FAT_TEST_FS));
+
+	fd = open(FAT_TEST_FILE, O_RDONLY);
+	test_assert(fd >= 0);
+	fat_test_check(fd, 0, fat_test_buf, FAT_TEST_LEN);
+	close(fd);
+
+	test_assert_zero(unlink(FAT_TEST_FILE));
+}
+
+static int setup_suite(void) {
+	int res;
+
+	res = ptr2err(ramdisk_create(FAT_TEST_DEV, FAT_TEST_BLOCKS * PAGE_SIZE()));
+	if (res) {
+		return res;
+	}
+
+	if ((res = format(FAT_TEST_DEV, FAT_TEST_FS))) {
+		return res;
+	}
+
+	mkdir(FAT_TEST_DIR, 0777);
+
+	return mount(FAT_TEST_DEV, FAT_TEST_DIR, FAT_TEST_FS);
+}
+
+static int teardown_suite(void) {
+	umount(FAT_TEST_DIR);
+
+	return ramdisk_delete(FAT_TEST_DEV);
+}
@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @brief Test for dentries cached for failed lookups
+ *
+ * @date 19.10.2026
+ */
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <embox/test.h>
+
+EMBOX_TEST_SUITE("Negative dentry test");
+
+#define NEG_TEST_MOUNTPOINT "/mnt"
+#define NEG_TEST_DIR        NEG_TEST_MOUNTPOINT "/neg_test_dir"
+#define NEG_TEST_MODE       0777
+
+TEST_CASE("File created after a failed lookup is found") {
+	static const char file [] = NEG_TEST_DIR "/file";
+	struct stat st;
+	int fd;
+
+	test_assert_zero(mkdir(NEG_TEST_DIR, NEG_TEST_MODE));
+
+	test_assert_not_equal(0, stat(file, &st));
+	test_assert_not_equal(0, stat(file, &st));
+
+	fd = open(file, O_CREAT | O_RDWR, NEG_TEST_MODE);
+	test_assert(fd >= 0);
+	close(fd);
+
+	test_assert_zero(stat(file, &st));
+
+	test_assert_zero(unlink(file));
+	test_assert_not_equal(0, stat(file, &st));
+
+	test_assert_zero(rmdir(NEG_TEST_DIR));
+}
+
+TEST_CASE("Directory is removed after failed lookups in it") {
+	static const char missing1 [] = NEG_TEST_DIR "/missing1";
+	static const char missing2 [] = NEG_TEST_DIR "/missing2";
+	struct stat st;
+
+	test_assert_zero(mkdir(NEG_TEST_DIR, NEG_TEST_MODE));
+
+	test_assert_not_equal(0, stat(missing1, &st));
+	test_assert_not_equal(0, stat(missing2, &st));
+	test_assert_not_equal(0, stat(missing1, &st));
+
+	test_assert_zero(rmdir(NEG_TEST_DIR));
+	test_assert_not_equal(0, stat(NEG_TEST_DIR, &st));
+
+	/* The negatives of the removed directory don't outlive it */
+	test_assert_zero(mkdir(NEG_TEST_DIR, NEG_TEST_MODE));
+	test_assert_not_equal(0, stat(missing1, &st));
+	test_assert_zero(rmdir(NEG_TEST_DIR));
+}
@@ -0,0 +1,157 @@
+/**
+ * @file
+ * @brief Test for tmpfs mappings and the per-mount quota
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <embox/test.h>
+#include <framework/mod/options.h>
+#include <mem/page.h>
+
+#include <fs/mount.h>
+
+#include <module/embox/fs/driver/tmpfs.h>
+
+EMBOX_TEST_SUITE("tmpfs test");
+
+TEST_SETUP_SUITE(setup_suite);
+
+TEST_TEARDOWN_SUITE(teardown_suite);
+
+#define TMPFS_TEST_LIMIT \
+	OPTION_MODULE_GET(embox__fs__driver__tmpfs, NUMBER, size_limit)
+
+#define TMPFS_TEST_DIR   "/mnt/tmpfs_test"
+#define TMPFS_TEST_FILE  TMPFS_TEST_DIR "/file"
+#define TMPFS_TEST_FILE2 TMPFS_TEST_DIR "/file2"
+
+static char tmpfs_test_buf[PAGE_SIZE()];
+
+static int tmpfs_test_mapped(void *p) {
+	return p != NULL && p != MAP_FAILED;
+}
+
+/* Writes pages until the mount is full, returns the number written */
+static int tmpfs_test_fill(const char *path) {
+	int fd, n;
+
+	fd = open(path, O_CREAT | O_RDWR, 0666);
+	test_assert(fd >= 0);
+
+	for (n = 0; ; n++) {
+		if (write(fd, tmpfs_test_buf, PAGE_SIZE()) != PAGE_SIZE()) {
+			break;
+		}
+	}
+
+	close(fd);
+
+	return n;
+}
+
+TEST_CASE("Shared mapping and read/write access the same data") {
+	char *p;
+	int fd;
+
+	memset(tmpfs_test_buf, 'a', PAGE_SIZE());
+
+	fd = open(TMPFS_TEST_FILE, O_CREAT | O_RDWR, 0666);
+	test_assert(fd >= 0);
+	test_assert_equal(PAGE_SIZE(), write(fd, tmpfs_test_buf, PAGE_SIZE()));
+	test_assert_equal(PAGE_SIZE(), write(fd, tmpfs_test_buf, PAGE_SIZE()));
+
+	p = mmap(NULL, 2 * PAGE_SIZE(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	test_assert(tmpfs_test_mapped(p));
+	test_assert_equal('a', p[PAGE_SIZE() + 1]);
+
+	p[PAGE_SIZE() + 1] = 'b';
+
+	test_assert_equal(PAGE_SIZE() + 1, lseek(fd, PAGE_SIZE() + 1, SEEK_SET));
+	test_assert_equal(1, read(fd, tmpfs_test_buf, 1));
+	test_assert_equal('b', tmpfs_test_buf[0]);
+
+	munmap(p, 2 * PAGE_SIZE());
+	close(fd);
+
+	test_assert_zero(unlink(TMPFS_TEST_FILE));
+}
+
+TEST_CASE("Private mapping is not written back") {
+	char *p;
+	int fd;
+
+	memset(tmpfs_test_buf, 'a', PAGE_SIZE());
+
+	fd = open(TMPFS_TEST_FILE, O_CREAT | O_RDWR, 0666);
+	test_assert(fd >= 0);
+	test_assert_equal(PAGE_SIZE(), write(fd, tmpfs_test_buf, PAGE_SIZE()));
+
+	p = mmap(NULL, PAGE_SIZE(), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	test_assert(tmpfs_test_mapped(p));
+	test_assert_equal('a', p[0]);
+
+	p[0] = 'b';
+
+	test_assert_equal(1, pread(fd, tmpfs_test_buf, 1, 0));
+	test_assert_equal('a', tmpfs_test_buf[0]);
+
+	munmap(p, PAGE_SIZE());
+	close(fd);
+
+	test_assert_zero(unlink(TMPFS_TEST_FILE));
+}
+
+TEST_CASE("Unlink gives mapped pages and private copies back to the quota") {
+	int fd, full, n;
+	void *p;
+
+	if (TMPFS_TEST_LIMIT == 0) {
+		/* Nothing to fill up */
+		return;
+	}
+
+	full = tmpfs_test_fill(TMPFS_TEST_FILE);
+	test_assert(full > 0);
+	test_assert_zero(unlink(TMPFS_TEST_FILE));
+
+	/* Leaves two free pages, the page tables take as many as before */
+	fd = open(TMPFS_TEST_FILE, O_CREAT | O_RDWR, 0666);
+	test_assert(fd >= 0);
+	for (n = 0; n < full - 2; n++) {
+		test_assert_equal(PAGE_SIZE(), write(fd, tmpfs_test_buf, PAGE_SIZE()));
+	}
+
+	p = mmap(NULL, PAGE_SIZE(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	test_assert(tmpfs_test_mapped(p));
+
+	p = mmap(NULL, PAGE_SIZE(), PROT_READ, MAP_PRIVATE, fd, 0);
+	test_assert(tmpfs_test_mapped(p));
+
+	/* The private copy is charged to the mount */
+	p = mmap(NULL, 2 * PAGE_SIZE(), PROT_READ, MAP_PRIVATE, fd, 0);
+	test_assert_false(tmpfs_test_mapped(p));
+
+	close(fd);
+	test_assert_zero(unlink(TMPFS_TEST_FILE));
+
+	test_assert_equal(full, tmpfs_test_fill(TMPFS_TEST_FILE2));
+	test_assert_zero(unlink(TMPFS_TEST_FILE2));
+}
+
+static int setup_suite(void) {
+	mkdir(TMPFS_TEST_DIR, 0777);
+
+	return mount(NULL, TMPFS_TEST_DIR, "tmpfs");
+}
+
+static int teardown_suite(void) {
+	return umount(TMPFS_TEST_DIR);
+}
@@ -0,0 +1,144 @@
+/**
+ * @file
+ *
+ * @brief
+ *
+ * @date 19.10.2026
+ */
+#include <stdint.h>
+#include <embox/test.h>
+#include <mem/heap_tlsf.h>
+#include <mem/page.h>
+
+EMBOX_TEST_SUITE("heap_tlsf test");
+
+#define SIZE_128_B            128
+
+extern struct page_allocator *__heap_pgallocator;
+
+static void *heap;
+static size_t heap_size;
+
+TEST_SETUP(heap_setup);
+TEST_TEARDOWN(heap_teardown);
+
+static size_t largest_block(void) {
+	void *ptr;
+	size_t size;
+
+	/* Dummy search for the possible largest size to allocate */
+	for (size = heap_size; size > 0; size -= TLSF_ALIGN) {
+		ptr = tlsf_memalign(heap, TLSF_ALIGN, size);
+		if (ptr) {
+			tlsf_free(heap, ptr);
+			break;
+		}
+	}
+
+	return size;
+}
+
+TEST_CASE("Check if heap_tlsf concatenates free blocks") {
+	void *ptr, *ptr1, *ptr2;
+	size_t size;
+
+	size = largest_block();
+	/* Search rounds requests up to a list, so a bit is always unusable */
+	test_assert(size > (heap_size - tlsf_control_size()) * 7 / 8);
+
+	ptr = tlsf_memalign(heap, TLSF_ALIGN, SIZE_128_B);
+	test_assert_not_null(ptr);
+	ptr1 = tlsf_memalign(heap, TLSF_ALIGN, SIZE_128_B);
+	test_assert_not_null(ptr1);
+	ptr2 = tlsf_memalign(heap, TLSF_ALIGN, SIZE_128_B);
+	test_assert_not_null(ptr2);
+
+	/* Middle block is merged with both neighbours */
+	tlsf_free(heap, ptr);
+	tlsf_free(heap, ptr2);
+	tlsf_free(heap, ptr1);
+	test_assert(tlsf_heap_is_empty(heap));
+
+	test_assert_equal(largest_block(), size);
+}
+
+TEST_CASE("Check if heap_tlsf returns aligned blocks") {
+	void *ptr[4];
+	size_t boundary;
+	int i;
+
+	for (i = 0, boundary = 16; i < 4; i++, boundary <<= 2) {
+		ptr[i] = tlsf_memalign(heap, boundary, SIZE_128_B + i);
+		test_assert_not_null(ptr[i]);
+		test_assert_zero((uintptr_t) ptr[i] & (boundary - 1));
+		test_assert(tlsf_block_size(ptr[i]) >= SIZE_128_B + i);
+	}
+
+	for (i = 0; i < 4; i++) {
+		tlsf_free(heap, ptr[i]);
+	}
+	test_assert(tlsf_heap_is_empty(heap));
+}
+
+TEST_CASE("Check if heap_tlsf reallocates in place") {
+	char *ptr, *ptr1;
+	int i;
+
+	ptr = tlsf_memalign(heap, TLSF_ALIGN, SIZE_128_B);
+	test_assert_not_null(ptr);
+	for (i = 0; i < SIZE_128_B; i++) {
+		ptr[i] = i;
+	}
+
+	/* Free space follows the block, so it grows without moving */
+	ptr1 = tlsf_realloc(heap, ptr, 4 * SIZE_128_B);
+	test_assert_equal(ptr1, ptr);
+	test_assert(tlsf_block_size(ptr1) >= 4 * SIZE_128_B);
+
+	ptr1 = tlsf_realloc(heap, ptr, SIZE_128_B / 2);
+	test_assert_equal(ptr1, ptr);
+	for (i = 0; i < SIZE_128_B / 2; i++) {
+		test_assert_equal(ptr1[i], (char) i);
+	}
+
+	tlsf_free(heap, ptr1);
+	test_assert(tlsf_heap_is_empty(heap));
+}
+
+TEST_CASE("Check if heap_tlsf releases an added pool") {
+	void *pool, *ptr;
+
+	pool = page_alloc(__heap_pgallocator, 1);
+	test_assert_not_null(pool);
+	tlsf_add_pool(heap, pool, PAGE_SIZE());
+
+	/* Does not fit into the first pool anymore */
+	ptr = tlsf_memalign(heap, TLSF_ALIGN, heap_size);
+	test_assert_null(ptr);
+	/* Best fit is the block of the new pool */
+	ptr = tlsf_memalign(heap, TLSF_ALIGN, PAGE_SIZE() / 2);
+	test_assert_not_null(ptr);
+	test_assert((char *) ptr > (char *) pool);
+	test_assert((char *) ptr < (char *) pool + PAGE_SIZE());
+	tlsf_free(heap, ptr);
+
+	test_assert(tlsf_pool_is_free(pool));
+	tlsf_remove_pool(heap, pool);
+	page_free(__heap_pgallocator, pool, 1);
+}
+
+static int heap_setup(void) {
+	heap_size = 2 * PAGE_SIZE();
+	heap = page_alloc(__heap_pgallocator, 2);
+	if (!heap) {
+		return -1;
+	}
+
+	tlsf_init(heap, heap_size);
+	return 0;
+}
+
+static int heap_teardown(void) {
+	page_free(__heap_pgallocator, heap, 2);
+	return 0;
+}
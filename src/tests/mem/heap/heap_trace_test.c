@@ -0,0 +1,119 @@
+/**
+ * @file
+ *
+ * @brief
+ *
+ * @date 19.10.2026
+ */
+#include <stdlib.h>
+#include <embox/test.h>
+#include <mem/heap_trace.h>
+
+EMBOX_TEST_SUITE("heap_trace test");
+
+#define SITES_MAX 64
+#define OBJ_SIZE  100
+#define OBJ_COUNT 8
+
+TEST_SETUP(trace_setup);
+
+static struct heap_trace_site sites[SITES_MAX];
+
+static int trace_setup(void) {
+	heap_trace_reset();
+	heap_trace_set_period(1);
+	heap_trace_enable(1);
+	return 0;
+}
+
+static void *__attribute__((noinline)) alloc_site(size_t size) {
+	return malloc(size);
+}
+
+static struct heap_trace_site *site_of_size(size_t size, int n) {
+	int i;
+
+	for (i = 0; i < n && i < SITES_MAX; i++) {
+		if (sites[i].alloc_bytes % size == 0 && sites[i].allocs
+				&& sites[i].alloc_bytes / sites[i].allocs == size) {
+			return &sites[i];
+		}
+	}
+
+	return NULL;
+}
+
+TEST_CASE("Blocks from one call site are accounted to one site") {
+	struct heap_trace_site *site;
+	void *objs[OBJ_COUNT];
+	int i, n;
+
+	for (i = 0; i < OBJ_COUNT; i++) {
+		objs[i] = alloc_site(OBJ_SIZE);
+		test_assert_not_null(objs[i]);
+	}
+
+	n = heap_trace_sites(sites, SITES_MAX);
+	site = site_of_size(OBJ_SIZE, n);
+	test_assert_not_null(site);
+	test_assert_equal(site->allocs, OBJ_COUNT);
+	test_assert_equal(site->live_blocks, OBJ_COUNT);
+	test_assert_equal(site->live_bytes, OBJ_COUNT * OBJ_SIZE);
+
+	for (i = 0; i < OBJ_COUNT / 2; i++) {
+		free(objs[i]);
+	}
+
+	n = heap_trace_sites(sites, SITES_MAX);
+	site = site_of_size(OBJ_SIZE, n);
+	test_assert_not_null(site);
+	test_assert_equal(site->frees, OBJ_COUNT / 2);
+	test_assert_equal(site->live_blocks, OBJ_COUNT - OBJ_COUNT / 2);
+
+	for (; i < OBJ_COUNT; i++) {
+		free(objs[i]);
+	}
+
+	n = heap_trace_sites(sites, SITES_MAX);
+	site = site_of_size(OBJ_SIZE, n);
+	test_assert_not_null(site);
+	test_assert_zero(site->live_blocks);
+	test_assert_zero(site->live_bytes);
+}
+
+TEST_CASE("Sampling traces one of period allocations") {
+	struct heap_trace_stats st;
+	void *objs[OBJ_COUNT];
+	int i;
+
+	heap_trace_set_period(OBJ_COUNT / 2);
+
+	for (i = 0; i < OBJ_COUNT; i++) {
+		objs[i] = alloc_site(OBJ_SIZE);
+		test_assert_not_null(objs[i]);
+	}
+
+	heap_trace_stats(&st);
+	test_assert_equal(st.live_blocks, 2);
+
+	for (i = 0; i < OBJ_COUNT; i++) {
+		free(objs[i]);
+	}
+
+	heap_trace_stats(&st);
+	test_assert_zero(st.live_blocks);
+}
+
+TEST_CASE("Nothing is traced while disabled") {
+	struct heap_trace_stats st;
+	void *obj;
+
+	heap_trace_enable(0);
+	obj = alloc_site(OBJ_SIZE);
+	test_assert_not_null(obj);
+
+	heap_trace_stats(&st);
+	test_assert_zero(st.live_blocks);
+
+	free(obj);
+}
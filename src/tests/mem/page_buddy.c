@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @brief Tests of the buddy page allocator
+ *
+ * @date 19.10.2026
+ */
+
+#include <embox/test.h>
+#include <mem/page.h>
+
+EMBOX_TEST_SUITE("buddy page allocator test");
+
+#define TEST_PAGE_SIZE 64
+#define TEST_PAGES     64
+
+static char buff[TEST_PAGE_SIZE * (TEST_PAGES + 2)];
+
+static struct page_allocator *allocator;
+
+TEST_SETUP(setup);
+
+static int setup(void) {
+	allocator = page_allocator_init(buff, sizeof(buff), TEST_PAGE_SIZE);
+	return 0;
+}
+
+static size_t free_pages(void) {
+	struct page_buddy_stats stats;
+
+	page_buddy_stats(allocator, &stats);
+	return stats.free_pages + stats.hot_pages;
+}
+
+TEST_CASE("Freed blocks are coalesced") {
+	void *pages[TEST_PAGES];
+	size_t total;
+	int i;
+
+	test_assert_not_null(allocator);
+	total = free_pages();
+	test_assert(total >= TEST_PAGES);
+
+	for (i = 0; i < total; i++) {
+		pages[i] = page_alloc(allocator, 1);
+		test_assert_not_null(pages[i]);
+	}
+	test_assert_null(page_alloc(allocator, 1));
+
+	/* Free in an order which does not follow addresses */
+	for (i = 0; i < total; i += 2) {
+		page_free(allocator, pages[i], 1);
+	}
+	for (i = 1; i < total; i += 2) {
+		page_free(allocator, pages[i], 1);
+	}
+
+	/* Whole memory must be available as one run again */
+	pages[0] = page_alloc(allocator, total);
+	test_assert_not_null(pages[0]);
+	page_free(allocator, pages[0], total);
+}
+
+TEST_CASE("Tail of a non power of two allocation is returned") {
+	void *a;
+	size_t total;
+
+	total = free_pages();
+
+	a = page_alloc(allocator, 3);
+	test_assert_not_null(a);
+	test_assert_equal(free_pages(), total - 3);
+
+	page_free(allocator, a, 3);
+	test_assert_equal(free_pages(), total);
+
+	a = page_alloc(allocator, total);
+	test_assert_not_null(a);
+	page_free(allocator, a, total);
+}
+
+TEST_CASE("Partial free of a run") {
+	char *a;
+	size_t total;
+
+	total = free_pages();
+
+	a = page_alloc(allocator, 8);
+	test_assert_not_null(a);
+
+	page_free(allocator, a, 5);
+	page_free(allocator, a + 5 * TEST_PAGE_SIZE, 3);
+
+	a = page_alloc(allocator, total);
+	test_assert_not_null(a);
+	page_free(allocator, a, total);
+}
@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @brief Stress test of the lock-free pool from timer and thread contexts
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdint.h>
+
+#include <embox/test.h>
+#include <kernel/thread.h>
+#include <kernel/time/timer.h>
+#include <mem/misc/pool.h>
+#include <util/err.h>
+
+#define OBJECTS_QUANTITY 32
+#define THREADS_QUANTITY 3
+#define THREAD_ITERS     20000
+#define THREAD_BATCH     4
+#define IRQ_BATCH        2
+#define IRQ_ROUNDS_MIN   20
+
+struct test_obj {
+	/* Overwritten by the pool while the object is free */
+	unsigned long link;
+	volatile int owner;
+};
+
+POOL_DEF(stress_pool, struct test_obj, OBJECTS_QUANTITY);
+
+static volatile int errors;
+static volatile int irq_rounds;
+
+EMBOX_TEST_SUITE("lock-free pool stress test");
+
+static struct test_obj *take(int owner) {
+	struct test_obj *obj;
+
+	obj = pool_alloc(&stress_pool);
+	if (obj) {
+		if (obj->owner != 0) {
+			/* Handed out twice */
+			errors++;
+		}
+		obj->owner = owner;
+	}
+
+	return obj;
+}
+
+static void put(struct test_obj *obj, int owner) {
+	if (obj->owner != owner) {
+		errors++;
+	}
+	obj->owner = 0;
+	pool_free(&stress_pool, obj);
+}
+
+static void stress_timer_handler(sys_timer_t *timer, void *param) {
+	struct test_obj *objs[IRQ_BATCH];
+	int i;
+
+	for (i = 0; i < IRQ_BATCH; i++) {
+		objs[i] = take(-1);
+	}
+	for (i = 0; i < IRQ_BATCH; i++) {
+		if (objs[i]) {
+			put(objs[i], -1);
+		}
+	}
+
+	irq_rounds++;
+}
+
+static void *stress_thread(void *arg) {
+	struct test_obj *objs[THREAD_BATCH];
+	int owner = (int) (intptr_t) arg;
+	int i, j;
+
+	for (i = 0; i < THREAD_ITERS
+			|| (irq_rounds < IRQ_ROUNDS_MIN && i < 100 * THREAD_ITERS); i++) {
+		for (j = 0; j < THREAD_BATCH; j++) {
+			objs[j] = take(owner);
+		}
+		for (j = 0; j < THREAD_BATCH; j++) {
+			if (objs[j]) {
+				put(objs[j], owner);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+TEST_CASE("Objects are never handed out twice or lost when allocated "
+		"from timer handler and threads at once") {
+	struct thread *threads[THREADS_QUANTITY];
+	struct test_obj *objs[OBJECTS_QUANTITY + 1];
+	sys_timer_t *timer;
+	int i;
+
+	errors = 0;
+	irq_rounds = 0;
+
+	test_assert_zero(timer_set(&timer, TIMER_PERIODIC, 1,
+			stress_timer_handler, NULL));
+
+	for (i = 0; i < THREADS_QUANTITY; i++) {
+		threads[i] = thread_create(0, stress_thread, (void *) (intptr_t) (i + 1));
+		test_assert_zero(ptr2err(threads[i]));
+	}
+	for (i = 0; i < THREADS_QUANTITY; i++) {
+		thread_join(threads[i], NULL);
+	}
+
+	timer_close(timer);
+
+	test_assert_zero(errors);
+
+	/* Every object is back in the pool */
+	for (i = 0; i < OBJECTS_QUANTITY; i++) {
+		objs[i] = pool_alloc(&stress_pool);
+		test_assert_not_null(objs[i]);
+	}
+	objs[i] = pool_alloc(&stress_pool);
+	test_assert_null(objs[i]);
+
+	for (i = 0; i < OBJECTS_QUANTITY; i++) {
+		pool_free(&stress_pool, objs[i]);
+	}
+}
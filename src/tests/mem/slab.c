@@ -7,7 +7,10 @@
  * @author Alexander Kalmuk
  */
 
+#include <string.h>
+
 #include <embox/test.h>
+#include <lib/libds/array.h>
 #include <mem/misc/slab.h>
 #include <lib/libds/dlist.h>
 #include <mem/page.h>
@@ -148,6 +151,85 @@ TEST_CASE("Cache's growing.") {
 	cache_destroy(cache);
 #endif
 }
+
+TEST_CASE("Freed object is handed out again from the magazine.") {
+	void *obj, *obj2;
+	cache_t *cache;
+
+	cache = cache_create("test_mag", 32, 0);
+	test_assert_not_null(cache);
+
+	obj = cache_alloc(cache);
+	test_assert_not_null(obj);
+	cache_free(cache, obj);
+
+	obj2 = cache_alloc(cache);
+	test_assert_equal(obj, obj2);
+	cache_free(cache, obj2);
+
+	cache_destroy(cache);
+}
+
+TEST_CASE("Cache statistics count allocations and objects in use.") {
+	struct cache_stats *stats, *st = NULL;
+	void *obj[4];
+	cache_t *cache;
+	int i, n, max;
+
+	cache = cache_create("test_stats", 64, 0);
+	test_assert_not_null(cache);
+
+	for (i = 0; i < 4; i++) {
+		obj[i] = cache_alloc(cache);
+		test_assert_not_null(obj[i]);
+	}
+
+	max = cache_stats_get(NULL, 0);
+	stats = kmem_alloc(max * sizeof(*stats));
+	test_assert_not_null(stats);
+	n = cache_stats_get(stats, max);
+	test_assert_equal(n, max);
+
+	for (i = 0; i < n; i++) {
+		if (!strcmp(stats[i].name, "test_stats")) {
+			st = &stats[i];
+		}
+	}
+	test_assert_not_null(st);
+	test_assert_equal(st->allocs, 4);
+	test_assert_equal(st->frees, 0);
+	test_assert_equal(st->objs_inuse, 4);
+	test_assert(st->slabs >= 1);
+
+	kmem_free(stats);
+	for (i = 0; i < 4; i++) {
+		cache_free(cache, obj[i]);
+	}
+	cache_destroy(cache);
+}
+
+TEST_CASE("kmem_alloc serves small sizes from caches and large from pages.") {
+	size_t sizes[] = { 1, 16, 17, 100, 1000, 4096, 4097, 3 * PAGE_SIZE() };
+	char *ptr[ARRAY_SIZE(sizes)];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		ptr[i] = kmem_zalloc(sizes[i]);
+		test_assert_not_null(ptr[i]);
+		test_assert_zero(ptr[i][sizes[i] - 1]);
+		memset(ptr[i], i, sizes[i]);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		test_assert_equal(ptr[i][0], i);
+		test_assert_equal(ptr[i][sizes[i] - 1], i);
+		kmem_free(ptr[i]);
+	}
+
+	test_assert_null(kmem_alloc(0));
+	kmem_free(NULL);
+}
+
 #if 0
 static size_t list_length(struct dlist_head *head) {
 	struct dlist_head *pos;
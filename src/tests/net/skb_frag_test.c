@@ -0,0 +1,81 @@
+/**
+ * @file
+ * @brief Tests for sk_buff data size classes and fragments
+ *
+ * @date 19.10.2026
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <net/skbuff.h>
+#include <embox/test.h>
+
+EMBOX_TEST_SUITE("skbuff data classes and fragments");
+
+static int released;
+
+static void frag_release(void *data) {
+	released++;
+}
+
+TEST_CASE("sk_buff data should hold at least the requested size") {
+	static const size_t sizes[] = { 1, 64, 256, 1514, 4000, 9014 };
+	struct sk_buff *skb;
+	int i;
+
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		skb = skb_alloc(sizes[i]);
+		test_assert_not_null(skb);
+		test_assert(skb_data_size(skb->data) >= sizes[i]);
+		memset(skb->mac.raw, 0x5a, sizes[i]);
+		skb_free(skb);
+	}
+}
+
+TEST_CASE("linearize should append fragments after the data") {
+	struct sk_buff *skb, *clone;
+
+	released = 0;
+
+	skb = skb_alloc(4);
+	test_assert_not_null(skb);
+	memcpy(skb->mac.raw, "head", 4);
+
+	test_assert_zero(skb_add_frag(skb, "abc", 3, frag_release));
+	test_assert_zero(skb_add_frag(skb, "defg", 4, frag_release));
+	test_assert_equal(skb_frags_len(skb), 7);
+
+	clone = skb_clone(skb);
+	test_assert_not_null(clone);
+	/* The shared list must not change under the clone */
+	test_assert_equal(skb_add_frag(skb, "x", 1, NULL), -ENOSPC);
+
+	test_assert_zero(skb_linearize(skb));
+	test_assert_null(skb->frags);
+	test_assert_equal(skb->len, 11);
+	test_assert_zero(memcmp(skb->mac.raw, "headabcdefg", 11));
+	test_assert_zero(memcmp(clone->mac.raw, "head", 4));
+	test_assert_equal(released, 0);
+
+	skb_free(clone);
+	test_assert_equal(released, 2);
+	skb_free(skb);
+}
+
+TEST_CASE("page fragment should be freed with its last user") {
+	char *a, *b;
+
+	a = skb_page_frag_alloc(100);
+	test_assert_not_null(a);
+	b = skb_page_frag_alloc(100);
+	test_assert_not_null(b);
+	test_assert(b >= a + 100);
+
+	memset(a, 'a', 100);
+	skb_page_frag_get(a);
+	skb_page_frag_free(a);
+	memset(a, 'a', 100);
+	skb_page_frag_free(a);
+	skb_page_frag_free(b);
+}
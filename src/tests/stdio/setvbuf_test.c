@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @brief Tests of buffered stdio input
+ *
+ * @date 19.10.2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <embox/test.h>
+
+EMBOX_TEST_SUITE("stdio/setvbuf test");
+
+/* File's content is "qwer\nasdf\n\nzxcv" */
+#define TEST_FILE_NAME    "/test_setvbuf.txt"
+#define TEST_FILE_CONTENT "qwer\nasdf\n\nzxcv"
+
+static FILE *test_open(void) {
+	FILE *fp;
+
+	if (NULL == (fp = fopen(TEST_FILE_NAME, "r"))) {
+		test_fail("cannot open " TEST_FILE_NAME);
+	}
+
+	return fp;
+}
+
+TEST_CASE("fgetc through a buffer smaller than the file reads it all") {
+	const char *content = TEST_FILE_CONTENT;
+	FILE *fp = test_open();
+	int i, c;
+
+	test_assert_zero(setvbuf(fp, NULL, _IOFBF, 3));
+
+	for (i = 0; (c = fgetc(fp)) != EOF; i++) {
+		test_assert_equal(c, content[i]);
+		test_assert_equal(ftell(fp), i + 1);
+	}
+	test_assert_equal(i, strlen(content));
+	test_assert_not_zero(feof(fp));
+
+	fclose(fp);
+}
+
+TEST_CASE("user buffer holds data read ahead") {
+	char buf[8];
+	FILE *fp = test_open();
+
+	memset(buf, 0, sizeof(buf));
+	test_assert_zero(setvbuf(fp, buf, _IOFBF, sizeof(buf)));
+
+	test_assert_equal(fgetc(fp), 'q');
+	test_assert_zero(memcmp(buf, TEST_FILE_CONTENT, sizeof(buf)));
+
+	fclose(fp);
+}
+
+TEST_CASE("fseek and ungetc see the position of the reader, not of the file") {
+	char line[8];
+	FILE *fp = test_open();
+
+	test_assert_zero(setvbuf(fp, NULL, _IOFBF, 4));
+
+	test_assert_equal(fgetc(fp), 'q');
+	test_assert_equal(ftell(fp), 1);
+
+	test_assert_zero(fseek(fp, 5, SEEK_SET));
+	test_assert_equal(fgetc(fp), 'a');
+
+	test_assert_zero(fseek(fp, 1, SEEK_CUR));
+	test_assert_equal(fgetc(fp), 'd');
+
+	test_assert_equal(ftell(fp), 8);
+
+	test_assert_equal(ungetc('D', fp), 'D');
+	test_assert_equal(ftell(fp), 7);
+	test_assert_not_null(fgets(line, sizeof(line), fp));
+	test_assert_str_equal(line, "Df\n");
+
+	test_assert_equal(fread(line, 1, sizeof(line), fp), 5);
+	test_assert_zero(memcmp(line, "\nzxcv", 5));
+
+	fclose(fp);
+}
+
+TEST_CASE("unbuffered stream reads the same") {
+	char line[32];
+	FILE *fp = test_open();
+
+	test_assert_zero(setvbuf(fp, NULL, _IONBF, 0));
+
+	test_assert_equal(fread(line, 1, sizeof(line), fp),
+			strlen(TEST_FILE_CONTENT));
+	test_assert_zero(memcmp(line, TEST_FILE_CONTENT,
+			strlen(TEST_FILE_CONTENT)));
+
+	fclose(fp);
+}